@@ -0,0 +1,737 @@
+/*
+High-level overview
+-------------------
+Throughput benchmark for the three renderers. Every case but `invoice_3_file_<policy>` renders
+into a reused in-memory `PdfBuffer`, so the numbers reflect PDF generation rather than disk
+speed.
+
+1) Run each case once to warm up, then repeat it until both the minimum iteration count and
+   the minimum wall time are reached.
+2) Collect per-phase timings (init, setup, draw, serialize, write), drawing operations,
+   libHaru's own allocations and output size through `RenderMetrics`, and C++ heap
+   allocation counts through the replaced global `operator new`. The `invoice_100_<policy>`
+   cases route libHaru's allocations through each `PdfAllocatorPolicy` for comparison, and the
+   `*_context` cases render through one kept `RenderContext` instead of a fresh document.
+   `layout_invoice_<n>` renders the same invoices from `examples/layout/invoice.layout`, and
+   `invoice_3_letter` / `invoice_3_a4_landscape` use the other compile-time page layouts.
+   `invoice_3_file_<policy>` saves invoice_3 to a file through a `FileWriter` with each
+   `FsyncPolicy` (never, per_file, per_batch).
+   `clinical_report_gray16` embeds a 2048x2048 16-bit frame windowed at full resolution,
+   `clinical_report_gray16_150dpi` area-averages it down first, and
+   `clinical_report_sheets_24` puts 24 such frames on contact sheets at 150 dpi.
+   `clinical_report_encrypted`, `clinical_report_encrypted_per_document`,
+   `clinical_report_frame_encrypted` and `clinical_reports_100_encrypted` add 128-bit RC4
+   encryption to `clinical_report`, `clinical_report_frame` and `clinical_reports_100`.
+   `invoice_3_cached` serves invoice_3 from a `RenderCache` (every timed iteration is a hit).
+   `server_invoice_3` sends invoice_3 to a `RenderServer` over a kept socket connection.
+   `statement_1000` merges 1000 `invoice_3` invoices into one `InvoiceStatement`;
+   `statement_4000_<n>t` and `text_file_<n>t` render on n threads and join the parts with
+   `assemble_pdf`.
+3) Time string measurement on its own: the precomputed `FontMetrics` tables against
+   `HPDF_Font_TextWidth` / `HPDF_Font_MeasureText` on the same corpus (`text_width` section),
+   and `Money` formatting against the former `std::ostringstream` path (`money` section).
+4) Emit one JSON document so results from two builds can be diffed mechanically.
+
+Usage
+-----
+  libharu_examples_bench [--min-time SECONDS] [--min-iterations N] [--filter TEXT]
+                         [--output FILE]
+
+Without `--output` the JSON report goes to stdout.
+*/
+#include "libharu_examples/clinical_report_example.h"
+#include "libharu_examples/file_writer.h"
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/layout_template.h"
+#include "libharu_examples/money.h"
+#include "libharu_examples/pdf_allocator.h"
+#include "libharu_examples/pdf_output.h"
+#include "libharu_examples/pdf_text_example.h"
+#include "libharu_examples/render_cache.h"
+#include "libharu_examples/render_context.h"
+#include "libharu_examples/render_metrics.h"
+#include "libharu_examples/render_server.h"
+#include "libharu_examples/text_metrics.h"
+
+#include <hpdf.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+std::atomic<std::size_t> g_allocated_bytes{0};
+volatile std::uint64_t g_measure_sink = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* block = std::malloc(size == 0 ? 1 : size)) {
+    return block;
+  }
+  throw std::bad_alloc();
+}
+
+// GCC does not see that the operator new above allocates with malloc, so it flags the
+// matching free as a mismatched deallocation.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* block) noexcept {
+  std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+  std::free(block);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+using libharu_examples::ClinicalReportExample;
+using libharu_examples::InvoiceExample;
+using libharu_examples::PdfBuffer;
+
+struct BenchOptions {
+  double min_seconds = 1.0;
+  std::size_t min_iterations = 5;
+  std::string filter;
+  std::string output_path;
+};
+
+struct BenchCase {
+  std::string name;
+  std::function<bool(PdfBuffer&)> render;
+};
+
+struct CaseResult {
+  std::string name;
+  bool ok = true;
+  std::size_t documents = 0;
+  double wall_seconds = 0.0;
+  libharu_examples::RenderMetrics metrics;
+  std::size_t allocations = 0;
+  std::size_t allocated_bytes = 0;
+};
+
+struct MeasureCase {
+  std::string name;
+  std::function<std::uint64_t(const std::string&)> measure;
+};
+
+struct MoneyCase {
+  std::string name;
+  std::function<std::uint64_t(double)> measure;
+};
+
+struct MeasureResult {
+  std::string name;
+  std::size_t samples = 0;
+  double wall_seconds = 0.0;
+};
+
+std::vector<InvoiceExample::Item> make_items(const std::size_t count) {
+  std::vector<InvoiceExample::Item> items;
+  items.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    items.push_back({"Line item " + std::to_string(i) + " - professional services",
+                     static_cast<int>(1 + i % 9),
+                     12.5 + static_cast<double>(i % 100)});
+  }
+  return items;
+}
+
+std::shared_ptr<libharu_examples::LayoutTemplate> load_invoice_layout() {
+  std::ifstream input(LIBHARU_EXAMPLES_LAYOUT_DIR "/invoice.layout", std::ios::binary);
+  std::ostringstream source;
+  source << input.rdbuf();
+  auto layout = std::make_shared<libharu_examples::LayoutTemplate>();
+  std::string error;
+  if (!input || !libharu_examples::LayoutTemplate::compile(source.str(), *layout, &error)) {
+    std::cerr << "invoice.layout: " << (error.empty() ? "cannot read" : error) << '\n';
+    return nullptr;
+  }
+  return layout;
+}
+
+// Binds an invoice by slot, formatting amounts the way createInvoidcw does.
+void bind_invoice_record(const std::vector<InvoiceExample::Item>& items,
+                         libharu_examples::LayoutRecord& record) {
+  using libharu_examples::format_money;
+  using libharu_examples::Money;
+
+  record.clear();
+  record.set("provider.name", "Example Provider Ltd.");
+  record.set("client.name", "Client Co.");
+  record.set("invoice.number", "INV-" + std::to_string(items.size()) + "-2026");
+  Money subtotal;
+  for (const InvoiceExample::Item& item : items) {
+    Money unit_price;
+    Money amount;
+    Money::from_double(item.unit_price, unit_price);
+    unit_price.multiply(item.quantity, amount);
+    subtotal.add(amount, subtotal);
+    record.add_row(std::size_t{0},
+                   {std::to_string(item.quantity),
+                    item.description,
+                    format_money(unit_price).view(),
+                    format_money(amount).view()});
+  }
+  Money tax;
+  Money total;
+  subtotal.percentage(500, tax);
+  subtotal.add(tax, total);
+  record.set("subtotal", format_money(subtotal).view());
+  record.set("tax", format_money(tax).view());
+  record.set("total", format_money(total, {"$"}).view());
+}
+
+// Log-like lines in the temp directory, written once per run.
+std::string write_bench_text_file(const std::size_t lines) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "libharu_examples_bench_text.txt").string();
+  std::ofstream output(path, std::ios::binary);
+  for (std::size_t i = 0; i < lines; ++i) {
+    output << "2024-01-01T00:00:00Z worker-" << (i % 16) << " request " << i
+           << " completed in " << (i * 7 % 1000) << " ms\n";
+  }
+  return path;
+}
+
+std::vector<BenchCase> make_cases() {
+  static const InvoiceExample invoice;
+  static const ClinicalReportExample clinical;
+  static const InvoiceExample::Provider provider{
+      "Example Provider Ltd.", "42 Provider Street, Example City", "accounts@provider.example"};
+  static const InvoiceExample::Client client{
+      "Client Co.", "100 Client Avenue, Demo Town", "billing@client.example"};
+  static const ClinicalReportExample::Patient patient{"Yashvi M. Patel", 21, "Female", "555"};
+  static const ClinicalReportExample::ReferringDoctor doctor{"Dr. Hiren Shah", "Radiologist"};
+
+  std::vector<BenchCase> cases;
+  cases.push_back({"text", [](PdfBuffer& out) {
+                     return libharu_examples::create_text_pdf(
+                         out, libharu_examples::default_example_text());
+                   }});
+  for (const std::size_t count : {std::size_t{3}, std::size_t{100}, std::size_t{10000}}) {
+    auto items = std::make_shared<std::vector<InvoiceExample::Item>>(make_items(count));
+    cases.push_back({"invoice_" + std::to_string(count), [items](PdfBuffer& out) {
+                       return invoice.createInvoidcw(provider, client, *items, out);
+                     }});
+  }
+  // The same 100-item invoice with libHaru allocating through each allocator policy.
+  const auto items_100 = std::make_shared<std::vector<InvoiceExample::Item>>(make_items(100));
+  for (const auto& [suffix, policy] :
+       {std::make_pair("system", libharu_examples::PdfAllocatorPolicy::System),
+        std::make_pair("arena", libharu_examples::PdfAllocatorPolicy::Arena),
+        std::make_pair("pool", libharu_examples::PdfAllocatorPolicy::Pool)}) {
+    std::shared_ptr<libharu_examples::PdfAllocator> allocator =
+        libharu_examples::make_pdf_allocator(policy);
+    cases.push_back({std::string("invoice_100_") + suffix, [items_100, allocator](PdfBuffer& out) {
+                       libharu_examples::ScopedPdfAllocator scope(*allocator);
+                       return invoice.createInvoidcw(provider, client, *items_100, out);
+                     }});
+  }
+  // invoice_3 again on the other compile-time page layouts; each should match invoice_3.
+  const auto items_3 = std::make_shared<std::vector<InvoiceExample::Item>>(make_items(3));
+  for (const auto& [suffix, format] :
+       {std::make_pair("letter", libharu_examples::PageFormat::LetterPortrait),
+        std::make_pair("a4_landscape", libharu_examples::PageFormat::A4Landscape)}) {
+    const auto formatted = std::make_shared<const InvoiceExample>(format);
+    cases.push_back({std::string("invoice_3_") + suffix, [items_3, formatted](PdfBuffer& out) {
+                       return formatted->createInvoidcw(provider, client, *items_3, out);
+                     }});
+  }
+  // invoice_3 saved to a file in the temp directory through a FileWriter with each fsync
+  // policy; `out` stays empty. The difference to invoice_3 is the cost of the file itself.
+  const auto file_directory = std::make_shared<std::filesystem::path>(
+      std::filesystem::temp_directory_path() / "libharu_examples_bench_files");
+  std::filesystem::create_directories(*file_directory);
+  for (const auto& [suffix, policy] :
+       {std::make_pair("never", libharu_examples::FsyncPolicy::Never),
+        std::make_pair("per_file", libharu_examples::FsyncPolicy::PerFile),
+        std::make_pair("per_batch", libharu_examples::FsyncPolicy::PerBatch)}) {
+    libharu_examples::FileWriterOptions options;
+    options.fsync = policy;
+    const auto writer = std::make_shared<libharu_examples::FileWriter>(options);
+    const auto path = std::make_shared<std::string>(
+        (*file_directory / (std::string("invoice_3_") + suffix + ".pdf")).string());
+    cases.push_back({std::string("invoice_3_file_") + suffix,
+                     [items_3, writer, path](PdfBuffer& out) {
+                       out.clear();
+                       libharu_examples::ScopedFileWriter scope(*writer);
+                       return invoice.createInvoidcw(provider, client, *items_3, *path);
+                     }});
+  }
+  cases.push_back({"clinical_report", [](PdfBuffer& out) {
+                     return clinical.create_clinical_report_pdf(patient, doctor, out);
+                   }});
+  // The report with a 512x512 grayscale frame embedded straight from memory.
+  const auto frame_pixels = std::make_shared<std::vector<unsigned char>>(512 * 512, 0x60);
+  cases.push_back({"clinical_report_frame", [frame_pixels](PdfBuffer& out) {
+                     const ClinicalReportExample::ImageFrame frame{
+                         ClinicalReportExample::ImageFrame::Format::Gray8, frame_pixels->data(),
+                         frame_pixels->size(), 512, 512};
+                     return clinical.create_clinical_report_pdf(patient, doctor, {frame}, out);
+                   }});
+  // A 2048x2048 16-bit frame (a diagonal ramp), windowed to 8 bits at full resolution and
+  // prepared for 150 dpi; then 24 such frames, one in the box and the rest on contact sheets.
+  auto ramp = std::make_shared<std::vector<unsigned char>>(std::size_t{2048} * 2048 * 2);
+  for (std::size_t i = 0; i < ramp->size() / 2; ++i) {
+    const auto value = static_cast<std::uint16_t>((i % 2048 + i / 2048) * 8);
+    std::memcpy(ramp->data() + 2 * i, &value, sizeof(value));
+  }
+  ClinicalReportExample::ImageOptions prepared_options;
+  prepared_options.dpi = 150.0F;
+  const auto prepared = std::make_shared<const ClinicalReportExample>(
+      libharu_examples::PageFormat::A4Portrait, libharu_examples::TrueTypeFontSet{},
+      prepared_options);
+  prepared_options.box_frames = 1;
+  const auto sheets = std::make_shared<const ClinicalReportExample>(
+      libharu_examples::PageFormat::A4Portrait, libharu_examples::TrueTypeFontSet{},
+      prepared_options);
+  const auto ramp_frames = [ramp](const std::size_t count) {
+    std::vector<ClinicalReportExample::ImageFrame> frames(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      frames[i] = {ClinicalReportExample::ImageFrame::Format::Gray16, ramp->data(), ramp->size(),
+                   2048, 2048};
+      // Distinct windows keep every frame a separate image.
+      frames[i].window_width = 32768.0F + static_cast<float>(i);
+    }
+    return frames;
+  };
+  const auto one_frame = ramp_frames(1);
+  const auto sheet_frames = ramp_frames(24);
+  cases.push_back({"clinical_report_gray16", [ramp, one_frame](PdfBuffer& out) {
+                     return clinical.create_clinical_report_pdf(patient, doctor, one_frame, out);
+                   }});
+  cases.push_back({"clinical_report_gray16_150dpi", [ramp, prepared, one_frame](PdfBuffer& out) {
+                     return prepared->create_clinical_report_pdf(patient, doctor, one_frame, out);
+                   }});
+  cases.push_back({"clinical_report_sheets_24", [ramp, sheets, sheet_frames](PdfBuffer& out) {
+                     return sheets->create_clinical_report_pdf(patient, doctor, sheet_frames, out);
+                   }});
+  // Encrypted reports: a shared password, a password derived per document, the 512x512 frame
+  // encrypted along with the page, and a 100-report document under one key. Compare with
+  // clinical_report, clinical_report_frame and clinical_reports_100.
+  using Passwords = ClinicalReportExample::Encryption::Passwords;
+  ClinicalReportExample::Encryption encryption;
+  encryption.passwords = Passwords::Shared;
+  encryption.owner_password = "bench-owner";
+  encryption.user_password = "bench-user";
+  const auto encrypted = std::make_shared<const ClinicalReportExample>(
+      libharu_examples::PageFormat::A4Portrait, libharu_examples::TrueTypeFontSet{},
+      ClinicalReportExample::ImageOptions{}, encryption);
+  encryption.passwords = Passwords::PerDocument;
+  encryption.user_password_for = [](const ClinicalReportExample::Patient& p) {
+    return "pid-" + p.patient_id;
+  };
+  const auto per_document = std::make_shared<const ClinicalReportExample>(
+      libharu_examples::PageFormat::A4Portrait, libharu_examples::TrueTypeFontSet{},
+      ClinicalReportExample::ImageOptions{}, encryption);
+  cases.push_back({"clinical_report_encrypted", [encrypted](PdfBuffer& out) {
+                     return encrypted->create_clinical_report_pdf(patient, doctor, out);
+                   }});
+  cases.push_back({"clinical_report_encrypted_per_document", [per_document](PdfBuffer& out) {
+                     return per_document->create_clinical_report_pdf(patient, doctor, out);
+                   }});
+  cases.push_back({"clinical_report_frame_encrypted", [encrypted, frame_pixels](PdfBuffer& out) {
+                     const ClinicalReportExample::ImageFrame frame{
+                         ClinicalReportExample::ImageFrame::Format::Gray8, frame_pixels->data(),
+                         frame_pixels->size(), 512, 512};
+                     return encrypted->create_clinical_report_pdf(patient, doctor, {frame}, out);
+                   }});
+  auto reports = std::make_shared<std::vector<ClinicalReportExample::Report>>();
+  for (int i = 0; i < 100; ++i) {
+    reports->push_back(
+        {{patient.full_name, patient.age, patient.sex, std::to_string(i)}, doctor, {}});
+  }
+  cases.push_back({"clinical_reports_100", [reports](PdfBuffer& out) {
+                     return clinical.create_clinical_reports_pdf(*reports, out);
+                   }});
+  cases.push_back({"clinical_reports_100_encrypted", [encrypted, reports](PdfBuffer& out) {
+                     return encrypted->create_clinical_reports_pdf(*reports, out);
+                   }});
+  // The same invoices from the compiled layout template, bound to a record per render.
+  if (const auto layout = load_invoice_layout()) {
+    for (const std::size_t count : {std::size_t{3}, std::size_t{100}}) {
+      auto items = std::make_shared<std::vector<InvoiceExample::Item>>(make_items(count));
+      auto record = std::make_shared<libharu_examples::LayoutRecord>(*layout);
+      cases.push_back({"layout_invoice_" + std::to_string(count), [items, record](PdfBuffer& out) {
+                         bind_invoice_record(*items, *record);
+                         return libharu_examples::render_layout_pdf(*record, out);
+                       }});
+    }
+  }
+  // Small documents again, each case reusing one warm document for every iteration.
+  const auto invoice_context = std::make_shared<libharu_examples::RenderContext>();
+  cases.push_back({"invoice_3_context", [items_3, invoice_context](PdfBuffer& out) {
+                     libharu_examples::ScopedRenderContext scope(*invoice_context);
+                     return invoice.createInvoidcw(provider, client, *items_3, out);
+                   }});
+  const auto clinical_context = std::make_shared<libharu_examples::RenderContext>();
+  cases.push_back({"clinical_report_context", [clinical_context](PdfBuffer& out) {
+                     libharu_examples::ScopedRenderContext scope(*clinical_context);
+                     return clinical.create_clinical_report_pdf(patient, doctor, out);
+                   }});
+  // invoice_3 served from a RenderCache: after the warm-up run every iteration is a hit, so
+  // this is the cost of hashing the inputs and copying the stored document.
+  const auto cache = std::make_shared<libharu_examples::RenderCache>();
+  cases.push_back({"invoice_3_cached", [items_3, cache](PdfBuffer& out) {
+                     libharu_examples::ScopedRenderCache scope(*cache);
+                     return invoice.createInvoidcw(provider, client, *items_3, out);
+                   }});
+  // invoice_3 as a request to a RenderServer over a kept Unix socket connection; the
+  // difference to invoice_3_context is the daemon's per-request cost.
+  libharu_examples::RenderServerOptions server_options;
+  server_options.socket_path =
+      (std::filesystem::temp_directory_path() / "libharu_examples_bench.sock").string();
+  server_options.workers = 1;
+  const auto server = std::make_shared<libharu_examples::RenderServer>(server_options);
+  const auto server_client = std::make_shared<libharu_examples::RenderClient>();
+  if (server->start() && server_client->connect(server_options.socket_path)) {
+    auto request = std::make_shared<libharu_examples::RenderRequest>();
+    request->kind = libharu_examples::RenderKind::Invoice;
+    request->provider = provider;
+    request->client = client;
+    request->items = *items_3;
+    cases.push_back({"server_invoice_3", [server, server_client, request](PdfBuffer& out) {
+                       return server_client->render(*request, out);
+                     }});
+  }
+  // 1000 three-item invoices merged into one statement per iteration; compare time and bytes
+  // with 1000 x invoice_3.
+  cases.push_back({"statement_1000", [items_3](PdfBuffer& out) {
+                     libharu_examples::InvoiceStatement statement;
+                     for (int i = 0; i < 1000; ++i) {
+                       if (!statement.add_invoice(provider, client, *items_3)) {
+                         return false;
+                       }
+                     }
+                     return statement.save(out);
+                   }});
+  // Serial against parallel rendering of one large document: a 4000-invoice statement and a
+  // 60k-line log file (about 1000 pages).
+  auto entries = std::make_shared<std::vector<InvoiceExample::StatementEntry>>();
+  for (int i = 0; i < 4000; ++i) {
+    entries->push_back(
+        {provider, {client.name + " #" + std::to_string(i), client.address, client.email},
+         *items_3, ""});
+  }
+  const auto text_path = std::make_shared<std::string>(write_bench_text_file(60000));
+  for (const std::size_t threads : {std::size_t{1}, std::size_t{4}}) {
+    const std::string suffix = "_" + std::to_string(threads) + "t";
+    cases.push_back({"statement_4000" + suffix, [entries, threads](PdfBuffer& out) {
+                       return invoice.createStatement(*entries, out, threads);
+                     }});
+    cases.push_back({"text_file" + suffix, [text_path, threads](PdfBuffer& out) {
+                       libharu_examples::TextPdfOptions options;
+                       options.render_threads = threads;
+                       out.clear();
+                       return libharu_examples::create_text_file_pdf(
+                           *text_path,
+                           [&out](const unsigned char* data, const std::size_t size) {
+                             out.insert(out.end(), data, data + size);
+                             return true;
+                           },
+                           options);
+                     }});
+  }
+  return cases;
+}
+
+// Invoice-description-like strings from 8 to ~120 bytes.
+std::vector<std::string> make_measure_corpus() {
+  std::vector<std::string> corpus;
+  corpus.reserve(1000);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::string text = "Line item " + std::to_string(i) + " - professional services";
+    text.resize(8 + (i * 37) % 113, 'x');
+    corpus.push_back(std::move(text));
+  }
+  return corpus;
+}
+
+std::vector<MeasureCase> make_measure_cases(HPDF_Font font) {
+  const libharu_examples::FontMetrics& metrics =
+      libharu_examples::FontMetrics::get(libharu_examples::StandardFont::Helvetica);
+  const auto bytes = [](const std::string& text) {
+    return reinterpret_cast<const HPDF_BYTE*>(text.data());
+  };
+
+  std::vector<MeasureCase> cases;
+  cases.push_back({"text_width_metrics", [&metrics](const std::string& text) {
+                     return std::uint64_t{metrics.width_units(text)};
+                   }});
+  cases.push_back({"text_width_hpdf", [font, bytes](const std::string& text) {
+                     return std::uint64_t{
+                         HPDF_Font_TextWidth(font, bytes(text), static_cast<HPDF_UINT>(text.size()))
+                             .width};
+                   }});
+  cases.push_back({"break_position_metrics", [&metrics](const std::string& text) {
+                     return std::uint64_t{metrics.break_position(text, 11.0F, 200.0F)};
+                   }});
+  cases.push_back({"break_position_hpdf", [font, bytes](const std::string& text) {
+                     return std::uint64_t{HPDF_Font_MeasureText(font,
+                                                                bytes(text),
+                                                                static_cast<HPDF_UINT>(text.size()),
+                                                                200.0F,
+                                                                11.0F,
+                                                                0.0F,
+                                                                0.0F,
+                                                                HPDF_TRUE,
+                                                                nullptr)};
+                   }});
+  return cases;
+}
+
+// Unit prices and line amounts from cents up to a million.
+std::vector<double> make_money_corpus() {
+  std::vector<double> corpus;
+  corpus.reserve(1000);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    corpus.push_back(static_cast<double>((i * 7919) % 100000000) / 100.0);
+  }
+  return corpus;
+}
+
+std::vector<MoneyCase> make_money_cases() {
+  std::vector<MoneyCase> cases;
+  // The formatting invoice_example.cpp used before Money: one stream per cell.
+  cases.push_back({"money_format_stream", [](const double amount) {
+                     std::ostringstream stream;
+                     stream << std::fixed << std::setprecision(2) << amount;
+                     return std::uint64_t{stream.str().size()};
+                   }});
+  cases.push_back({"money_format_chars", [](const double amount) {
+                     libharu_examples::Money money;
+                     libharu_examples::Money::from_double(amount, money);
+                     return std::uint64_t{libharu_examples::format_money(money).size()};
+                   }});
+  return cases;
+}
+
+template <typename Case, typename Value>
+MeasureResult run_measure_case(const Case& measure_case,
+                               const std::vector<Value>& corpus,
+                               const BenchOptions& options) {
+  MeasureResult result;
+  result.name = measure_case.name;
+
+  std::uint64_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  std::size_t rounds = 0;
+  double elapsed = 0.0;
+  while (rounds < options.min_iterations || elapsed < options.min_seconds) {
+    for (const Value& value : corpus) {
+      checksum += measure_case.measure(value);
+    }
+    ++rounds;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  g_measure_sink = checksum;
+  result.samples = rounds * corpus.size();
+  result.wall_seconds = elapsed;
+  return result;
+}
+
+CaseResult run_case(const BenchCase& bench_case, const BenchOptions& options) {
+  CaseResult result;
+  result.name = bench_case.name;
+
+  PdfBuffer buffer;
+  if (!bench_case.render(buffer)) {
+    result.ok = false;
+    return result;
+  }
+
+  const std::size_t allocations_before = g_allocations.load();
+  const std::size_t bytes_before = g_allocated_bytes.load();
+  const auto start = std::chrono::steady_clock::now();
+  {
+    libharu_examples::ScopedRenderMetrics scope(result.metrics);
+    double elapsed = 0.0;
+    while (result.documents < options.min_iterations || elapsed < options.min_seconds) {
+      if (!bench_case.render(buffer)) {
+        result.ok = false;
+        break;
+      }
+      ++result.documents;
+      elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    result.wall_seconds = elapsed;
+  }
+  // Parallel cases save their parts on worker threads, outside this thread's metrics scope;
+  // report the size of the finished document instead.
+  result.metrics.output_bytes = buffer.size() * result.documents;
+  result.allocations = g_allocations.load() - allocations_before;
+  result.allocated_bytes = g_allocated_bytes.load() - bytes_before;
+  return result;
+}
+
+double per_document(const double total, const std::size_t documents) {
+  return documents == 0 ? 0.0 : total / static_cast<double>(documents);
+}
+
+// One JSON object per measurement; `unit` names what was measured ("strings", "values").
+void append_measurements(std::ostream& json,
+                         const std::vector<MeasureResult>& measurements,
+                         const std::string& unit) {
+  for (std::size_t i = 0; i < measurements.size(); ++i) {
+    const MeasureResult& m = measurements[i];
+    json << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << m.name << "\", \"" << unit
+         << "\": " << m.samples << ", \"" << unit << "_per_second\": "
+         << (m.wall_seconds > 0.0 ? static_cast<double>(m.samples) / m.wall_seconds : 0.0)
+         << ", \"ns_per_" << unit.substr(0, unit.size() - 1)
+         << "\": " << per_document(m.wall_seconds * 1e9, m.samples) << "}";
+  }
+}
+
+std::string to_json(const std::vector<CaseResult>& results,
+                    const std::vector<MeasureResult>& measurements,
+                    const std::vector<MeasureResult>& money_measurements,
+                    const BenchOptions& options) {
+  std::ostringstream json;
+  json.setf(std::ios::fixed);
+  json.precision(3);
+  json << "{\n  \"benchmark\": \"libharu_examples_bench\",\n"
+       << "  \"min_seconds\": " << options.min_seconds << ",\n"
+       << "  \"min_iterations\": " << options.min_iterations << ",\n  \"cases\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const CaseResult& r = results[i];
+    const auto ns = [&r](const std::chrono::nanoseconds total) {
+      return per_document(static_cast<double>(total.count()), r.documents);
+    };
+    json << (i == 0 ? "\n" : ",\n") << "    {\n"
+         << "      \"name\": \"" << r.name << "\",\n"
+         << "      \"ok\": " << (r.ok ? "true" : "false") << ",\n"
+         << "      \"documents\": " << r.documents << ",\n"
+         << "      \"wall_seconds\": " << r.wall_seconds << ",\n"
+         << "      \"documents_per_second\": "
+         << (r.wall_seconds > 0.0 ? static_cast<double>(r.documents) / r.wall_seconds : 0.0)
+         << ",\n"
+         << "      \"bytes_per_document\": "
+         << per_document(static_cast<double>(r.metrics.output_bytes), r.documents) << ",\n"
+         << "      \"phase_ns_per_document\": {\"init\": " << ns(r.metrics.init_time)
+         << ", \"setup\": " << ns(r.metrics.setup_time) << ", \"draw\": " << ns(r.metrics.draw_time)
+         << ", \"serialize\": " << ns(r.metrics.serialize_time)
+         << ", \"write\": " << ns(r.metrics.write_time) << "},\n"
+         << "      \"draw_operations_per_document\": "
+         << per_document(static_cast<double>(r.metrics.draw_operations), r.documents) << ",\n"
+         << "      \"hpdf_allocations_per_document\": "
+         << per_document(static_cast<double>(r.metrics.allocations), r.documents) << ",\n"
+         << "      \"allocations_per_document\": "
+         << per_document(static_cast<double>(r.allocations), r.documents) << ",\n"
+         << "      \"allocated_bytes_per_document\": "
+         << per_document(static_cast<double>(r.allocated_bytes), r.documents) << "\n    }";
+  }
+  json << "\n  ],\n  \"text_width\": [";
+  append_measurements(json, measurements, "strings");
+  json << "\n  ],\n  \"money\": [";
+  append_measurements(json, money_measurements, "values");
+  json << "\n  ]\n}\n";
+  return json.str();
+}
+
+bool parse_options(const int argc, char** argv, BenchOptions& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--min-time" && has_value) {
+      options.min_seconds = std::atof(argv[++i]);
+    } else if (arg == "--min-iterations" && has_value) {
+      options.min_iterations = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--filter" && has_value) {
+      options.filter = argv[++i];
+    } else if (arg == "--output" && has_value) {
+      options.output_path = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parse_options(argc, argv, options)) {
+    std::cerr << "usage: " << argv[0]
+              << " [--min-time SECONDS] [--min-iterations N] [--filter TEXT] [--output FILE]\n";
+    return 2;
+  }
+
+  std::vector<CaseResult> results;
+  bool all_ok = true;
+  for (const BenchCase& bench_case : make_cases()) {
+    if (!options.filter.empty() && bench_case.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    results.push_back(run_case(bench_case, options));
+    all_ok = all_ok && results.back().ok;
+    std::cerr << results.back().name << ": " << results.back().documents << " documents in "
+              << results.back().wall_seconds << " s\n";
+  }
+
+  std::vector<MeasureResult> measurements;
+  HPDF_Doc measure_doc = HPDF_New(nullptr, nullptr);
+  HPDF_Font font = HPDF_GetFont(measure_doc, "Helvetica", nullptr);
+  const std::vector<std::string> corpus = make_measure_corpus();
+  for (const MeasureCase& measure_case : make_measure_cases(font)) {
+    if (!options.filter.empty() && measure_case.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    measurements.push_back(run_measure_case(measure_case, corpus, options));
+    std::cerr << measurements.back().name << ": " << measurements.back().samples << " strings in "
+              << measurements.back().wall_seconds << " s\n";
+  }
+  HPDF_Free(measure_doc);
+
+  std::vector<MeasureResult> money_measurements;
+  const std::vector<double> money_corpus = make_money_corpus();
+  for (const MoneyCase& money_case : make_money_cases()) {
+    if (!options.filter.empty() && money_case.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    money_measurements.push_back(run_measure_case(money_case, money_corpus, options));
+    std::cerr << money_measurements.back().name << ": " << money_measurements.back().samples
+              << " values in " << money_measurements.back().wall_seconds << " s\n";
+  }
+
+  const std::string report = to_json(results, measurements, money_measurements, options);
+  if (options.output_path.empty()) {
+    std::cout << report;
+  } else {
+    std::ofstream output(options.output_path);
+    output << report;
+    if (!output) {
+      std::cerr << "Failed to write benchmark report: " << options.output_path << '\n';
+      return 1;
+    }
+  }
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+/*
+High-level overview
+-------------------
+This executable is the long-running render daemon: it serves text, invoice and clinical
+report renders over a Unix domain socket until SIGINT or SIGTERM.
+
+1) Resolve the socket path, worker count, optional output directory, optional TrueType font
+   and optional render cache directory from the command line. Documents carry fixed metadata
+   and repeated requests are served from an in-memory render cache, backed by that directory
+   when one is given.
+2) Block the shutdown signals before any thread starts, so only the main thread sees them.
+3) Start the `RenderServer`, wait for a signal, stop it and print its counters.
+
+libHaru logic addressed by this executable
+------------------------------------------
+- None directly: the server keeps one warm libHaru document per worker (see
+  `src/render_server.cpp`); clients use `RenderClient` or the framing in `render_server.h`.
+*/
+#include "libharu_examples/render_server.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <signal.h>
+
+int main(int argc, char** argv) {
+  // Step 1: Resolve the server options from CLI arguments.
+  libharu_examples::RenderServerOptions options;
+  options.socket_path = (argc > 1) ? argv[1] : "/tmp/libharu_examples.sock";
+  if (argc > 2) {
+    options.workers = static_cast<std::size_t>(std::strtoul(argv[2], nullptr, 10));
+  }
+  if (argc > 3) {
+    options.output_directory = argv[3];
+  }
+  if (argc > 4) {
+    std::string error;
+    options.fonts.regular = libharu_examples::TrueTypeFont::load(argv[4], &error);
+    if (!options.fonts.regular) {
+      std::cerr << "Failed to load font: " << error << '\n';
+      return 1;
+    }
+  }
+  libharu_examples::RenderCacheOptions cache_options;
+  if (argc > 5) {
+    cache_options.directory = argv[5];
+  }
+  libharu_examples::RenderCache cache(cache_options);
+  options.cache = &cache;
+  options.document_info = libharu_examples::DocumentInfo{};
+
+  // Step 2: Worker threads inherit this mask, so the signals are only taken by `sigwait`.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  // Step 3: Serve until asked to stop.
+  libharu_examples::RenderServer server(options);
+  std::string error;
+  if (!server.start(&error)) {
+    std::cerr << "Failed to start render server: " << error << '\n';
+    return 1;
+  }
+  std::cout << "Render server listening on " << options.socket_path << '\n';
+  int received = 0;
+  sigwait(&signals, &received);
+
+  const libharu_examples::RenderServerStats stats = server.stats();
+  server.stop();
+  std::cout << "Stopped: " << stats.requests << " requests on " << stats.connections
+            << " connections, " << stats.bad_requests << " bad, " << stats.failed_requests
+            << " failed, " << stats.output_bytes << " bytes returned\n";
+  const libharu_examples::RenderCacheStats cached = cache.stats();
+  std::cout << "Cache: " << cached.memory_hits << " memory hits, " << cached.disk_hits
+            << " disk hits, " << cached.misses << " misses\n";
+  return 0;
+}
@@ -1,13 +1,14 @@
 /*
 High-level overview
 -------------------
-This executable is the command-line driver for the minimal text-to-PDF example.
-It demonstrates how user input (a text file) is transformed into a PDF through the
-library function `libharu_examples::create_text_pdf(...)`.
+This executable is the command-line driver for the text-to-PDF example.
+It demonstrates how user input (a text file of any size) is transformed into a PDF through
+the library function `libharu_examples::create_text_file_pdf(...)`.
 
-1) Read text content from a file path (or use a fallback default string).
-2) Invoke the library wrapper that internally performs libHaru PDF creation.
-3) Report success/failure to the console and return an appropriate process code.
+1) Resolve the input file, output path, optional pages-per-file limit and render threads.
+2) Stream the file into paginated PDF output (or render the default string when the input is
+   missing or empty).
+3) Report success/failure, line/page counts and throughput in MB/s.
 
 libHaru logic addressed by this executable
 ------------------------------------------
@@ -17,34 +18,59 @@ libHaru logic addressed by this executable
 */
 #include "libharu_examples/pdf_text_example.h"
 
-#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
-#include <iterator>
 #include <string>
+#include <system_error>
 
 int main(int argc, char** argv) {
   // Step 1: Resolve input/output paths from CLI arguments with sensible defaults.
   const std::string text_file = (argc > 1) ? argv[1] : "text/hello_world.txt";
   const std::string output_pdf = (argc > 2) ? argv[2] : "text_example.pdf";
 
-  // Step 2: Load text from disk; if unavailable, defer to library default text.
-  std::ifstream input(text_file);
-  std::string text;
-  if (input) {
-    text.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  libharu_examples::TextPdfOptions options;
+  if (argc > 3) {
+    options.max_pages_per_file = static_cast<std::size_t>(std::strtoul(argv[3], nullptr, 10));
+  }
+  if (argc > 4) {
+    options.render_threads = static_cast<std::size_t>(std::strtoul(argv[4], nullptr, 10));
   }
 
-  if (text.empty()) {
-    text = libharu_examples::default_example_text();
+  // Step 2: Without usable input, fall back to the library default text.
+  std::error_code error;
+  const auto input_size = std::filesystem::file_size(text_file, error);
+  if (error || input_size == 0) {
+    if (!libharu_examples::create_text_pdf(output_pdf,
+                                           libharu_examples::default_example_text())) {
+      std::cerr << "Failed to generate PDF from default text\n";
+      return 1;
+    }
+    std::cout << "Created PDF: " << output_pdf << '\n';
+    return 0;
   }
 
-  // Step 3: Call the PDF creation API and expose result as command status.
-  const bool created = libharu_examples::create_text_pdf(output_pdf, text);
+  // Step 3: Stream the file and expose result as command status.
+  libharu_examples::TextPdfStats stats;
+  const auto start = std::chrono::steady_clock::now();
+  const bool created =
+      libharu_examples::create_text_file_pdf(text_file, output_pdf, options, &stats);
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
   if (!created) {
     std::cerr << "Failed to generate PDF from text file: " << text_file << '\n';
     return 1;
   }
 
-  std::cout << "Created PDF: " << output_pdf << '\n';
+  const double megabytes = static_cast<double>(stats.input_bytes) / (1024.0 * 1024.0);
+  std::cout << "Created PDF: " << output_pdf;
+  if (stats.files > 1) {
+    std::cout << " (" << stats.files << " files)";
+  }
+  std::cout << '\n'
+            << stats.source_lines << " lines -> " << stats.output_lines << " rows on "
+            << stats.pages << " pages; " << megabytes << " MB in " << seconds << " s ("
+            << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)\n";
   return 0;
 }
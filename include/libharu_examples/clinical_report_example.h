@@ -1,11 +1,63 @@
 #pragma once
 
+#include "libharu_examples/page_format.h"
+#include "libharu_examples/pdf_output.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace libharu_examples {
 
 class ClinicalReportExample {
  public:
+  // How raw frames are prepared and placed.
+  struct ImageOptions {
+    // Raw frames are area-averaged down to about this resolution at the size they are drawn
+    // (never below it), so the PDF holds only the pixels the page can show; 0 embeds every
+    // source pixel. JPEG frames are always embedded unchanged.
+    float dpi = 0.0F;
+    // With a value above 0, the imaging box holds only the first `box_frames` frames and the
+    // rest follow the report on contact-sheet pages, `sheet_columns` x `sheet_rows` to a page.
+    // 0 tiles every frame into the imaging box.
+    std::size_t box_frames = 0;
+    unsigned sheet_columns = 3;
+    unsigned sheet_rows = 4;
+  };
+
+  // Optional document encryption; defined below, after Patient.
+  struct Encryption;
+
+  // Reports are laid out for `page_format`. Only portrait formats have a report layout; with
+  // a landscape format every create call returns false.
+  explicit ClinicalReportExample(PageFormat page_format = PageFormat::A4Portrait)
+      : format_(page_format) {}
+  // Draws every report in `fonts` (bold text falls back to `fonts.regular`), so patient and
+  // doctor names may be any UTF-8 the fonts cover. The fonts are shared, not copied.
+  ClinicalReportExample(PageFormat page_format, TrueTypeFontSet fonts)
+      : format_(page_format), fonts_(std::move(fonts)) {}
+  // Create calls return false when `images` is invalid (negative dpi, an empty sheet grid).
+  ClinicalReportExample(PageFormat page_format, TrueTypeFontSet fonts, ImageOptions images)
+      : format_(page_format), fonts_(std::move(fonts)), images_(images) {}
+  // Encrypts every document (see Encryption). Create calls return false when `encryption` is
+  // incomplete: no owner password, owner and shared user password equal, or PerDocument
+  // without `user_password_for`.
+  ClinicalReportExample(PageFormat page_format,
+                        TrueTypeFontSet fonts,
+                        ImageOptions images,
+                        Encryption encryption)
+      : format_(page_format),
+        fonts_(std::move(fonts)),
+        images_(images),
+        encryption_(std::move(encryption)) {}
+
+  PageFormat page_format() const { return format_; }
+  const ImageOptions& image_options() const { return images_; }
+  const Encryption& encryption() const { return encryption_; }
+
   struct Patient {
     std::string full_name;
     int age;
@@ -18,9 +70,103 @@ class ClinicalReportExample {
     std::string specialty;
   };
 
+  // Reports carry patient data, so documents can be encrypted with libHaru's standard
+  // security handler (revision 3: RC4 with a 128-bit key) and opened with restricted
+  // permissions. The key is set up once per document, so a multi-report document pays for
+  // it once for the whole batch. Encrypted reports bypass the ScopedRenderCache.
+  struct Encryption {
+    enum class Passwords {
+      // Unencrypted output.
+      None,
+      // Every document opens with `user_password`, e.g. one secret per nightly batch.
+      Shared,
+      // Each document opens with `user_password_for(patient)`, called with its patient (the
+      // first report's patient in a multi-report document). It may run on several threads
+      // at once, and a result equal to the owner password fails the render.
+      PerDocument,
+    };
+
+    Passwords passwords = Passwords::None;
+    // Grants every permission; required when encrypting.
+    std::string owner_password;
+    // Empty opens the document without a prompt, still with only the permissions below.
+    std::string user_password;
+    std::function<std::string(const Patient& patient)> user_password_for;
+    bool allow_print = true;
+    bool allow_copy = false;
+    bool allow_edit = false;
+  };
+
+  // One ultrasound frame borrowed from the caller; the bytes must stay valid until the call
+  // returns. Raw frames are tightly packed rows (`width * height` bytes for Gray8, three times
+  // that for Rgb8, twice that for Gray16). JPEG bytes are embedded as-is, and `width`/`height`
+  // are ignored.
+  struct ImageFrame {
+    enum class Format {
+      Gray8,
+      Rgb8,
+      Jpeg,
+      // 16-bit samples in host byte order (no alignment needed), mapped to 8 bits through the
+      // window below before embedding.
+      Gray16,
+    };
+
+    Format format = Format::Gray8;
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+    unsigned width = 0;
+    unsigned height = 0;
+    // Gray16 only: samples in [center - width / 2, center + width / 2] map linearly onto
+    // black..white and the rest are clamped. The default shows the full 16-bit range; `width`
+    // must be positive.
+    float window_center = 32768.0F;
+    float window_width = 65536.0F;
+  };
+
+  struct Report {
+    Patient patient;
+    ReferringDoctor doctor;
+    std::vector<ImageFrame> frames;
+  };
+
   bool create_clinical_report_pdf(const Patient& patient,
                                   const ReferringDoctor& doctor,
                                   const std::string& output_pdf_path) const;
+  bool create_clinical_report_pdf(const Patient& patient,
+                                  const ReferringDoctor& doctor,
+                                  PdfBuffer& output) const;
+  bool create_clinical_report_pdf(const Patient& patient,
+                                  const ReferringDoctor& doctor,
+                                  const PdfSink& sink) const;
+
+  // Same report with `frames` tiled into the imaging box instead of the empty placeholder, or
+  // partly on contact sheets (see ImageOptions).
+  bool create_clinical_report_pdf(const Patient& patient,
+                                  const ReferringDoctor& doctor,
+                                  const std::vector<ImageFrame>& frames,
+                                  const std::string& output_pdf_path) const;
+  bool create_clinical_report_pdf(const Patient& patient,
+                                  const ReferringDoctor& doctor,
+                                  const std::vector<ImageFrame>& frames,
+                                  PdfBuffer& output) const;
+  bool create_clinical_report_pdf(const Patient& patient,
+                                  const ReferringDoctor& doctor,
+                                  const std::vector<ImageFrame>& frames,
+                                  const PdfSink& sink) const;
+
+  // Renders one page per report into a single document. The static report template is
+  // emitted once per document and shared by every page; each report's frames are drawn on its
+  // own page (and its contact sheets), and a frame whose bytes are shared between reports is
+  // embedded only once.
+  bool create_clinical_reports_pdf(const std::vector<Report>& reports,
+                                   const std::string& output_pdf_path) const;
+  bool create_clinical_reports_pdf(const std::vector<Report>& reports, PdfBuffer& output) const;
+
+ private:
+  PageFormat format_;
+  TrueTypeFontSet fonts_;
+  ImageOptions images_;
+  Encryption encryption_;
 };
 
 }  // namespace libharu_examples
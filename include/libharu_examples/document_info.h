@@ -0,0 +1,45 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace libharu_examples {
+
+// A UTC timestamp for the document information dictionary.
+struct DocumentDate {
+  int year = 2026;
+  int month = 1;
+  int day = 1;
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+};
+
+// Document information dictionary entries. Renders under a ScopedDocumentInfo write exactly
+// these values, so the output depends only on the inputs: Producer no longer names the
+// libHaru build, and the creation date is the one given (or absent) rather than a clock
+// reading. Empty strings are left out.
+struct DocumentInfo {
+  std::string producer = "libHaru_examples";
+  std::string creator;
+  std::string author;
+  std::string title;
+  std::string subject;
+  std::optional<DocumentDate> creation_date;
+};
+
+// Documents created on the current thread while the scope is alive carry `info`. Scopes
+// nest; the innermost one wins. `info` must outlive the scope.
+class ScopedDocumentInfo {
+ public:
+  explicit ScopedDocumentInfo(const DocumentInfo& info);
+  ~ScopedDocumentInfo();
+
+  ScopedDocumentInfo(const ScopedDocumentInfo&) = delete;
+  ScopedDocumentInfo& operator=(const ScopedDocumentInfo&) = delete;
+
+ private:
+  const DocumentInfo* previous_;
+};
+
+}  // namespace libharu_examples
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "libharu_examples/pdf_output.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace libharu_examples {
+
+namespace detail {
+struct WriterState;
+}  // namespace detail
+
+// When file output is forced to stable storage. Every policy writes a document to a
+// temporary file next to its path and renames it into place, so the path either holds the
+// previous file or the complete new one, never a truncated PDF.
+enum class FsyncPolicy {
+  // No fsync. A crashed process leaves no partial file, but a power loss may lose files
+  // written shortly before it (or, on some file systems, leave them empty).
+  Never,
+  // fsync each file before its rename and its directory after it: a save is durable when it
+  // returns true. Costs two fsyncs per document.
+  PerFile,
+  // Files are staged under their temporary names and published together by `commit` (or
+  // once `batch_files` are staged): one fsync per file, then the renames, then one fsync per
+  // directory. Until then a staged file is not visible under its path.
+  PerBatch,
+};
+
+struct FileWriterOptions {
+  FsyncPolicy fsync = FsyncPolicy::PerFile;
+  // User-space buffer streamed documents are collected in; a document that fits reaches the
+  // kernel in one write. Renderers fill it from libHaru's memory stream, which holds the whole
+  // serialized PDF until the document is freed.
+  std::size_t buffer_bytes = std::size_t{1} << 20;
+  // PerBatch: staged files (and open descriptors) before `write` commits on its own.
+  std::size_t batch_files = 256;
+};
+
+struct FileWriterStats {
+  // Files renamed into place (and, under PerFile and PerBatch, with their directory synced),
+  // and their bytes.
+  std::size_t files = 0;
+  std::size_t bytes = 0;
+  // Files that could not be written, synced or renamed. Only a failed directory sync leaves
+  // one behind: it is in place under its path but may not survive a power loss, so the save
+  // (or `commit`) returns false and the file counts here rather than in `files`.
+  std::size_t failed = 0;
+  // System calls that decide throughput on network volumes.
+  std::size_t write_calls = 0;
+  std::size_t fsync_calls = 0;
+};
+
+// Durable output for finished PDFs: temporary file, optional fsync, atomic rename. Not
+// thread-safe; use one writer per thread. The destructor commits staged files.
+class FileWriter {
+ public:
+  explicit FileWriter(FileWriterOptions options = {});
+  ~FileWriter();
+
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  // Writes `document` to `path`. With PerBatch, true means the file is staged.
+  bool write(const std::string& path, const PdfBuffer& document);
+  // Publishes the staged files (PerBatch; otherwise nothing is staged). False if any of them
+  // failed.
+  bool commit();
+
+  const FileWriterOptions& options() const;
+  FileWriterStats stats() const;
+
+ private:
+  friend class ScopedFileWriter;
+
+  std::unique_ptr<detail::WriterState> state_;
+};
+
+// While the scope is alive, every renderer on the current thread saves to a file path
+// through `writer`. Without a scope, files go through a per-thread writer with
+// FsyncPolicy::Never. Scopes nest; the innermost one wins. `writer` must outlive the scope.
+class ScopedFileWriter {
+ public:
+  explicit ScopedFileWriter(FileWriter& writer);
+  ~ScopedFileWriter();
+
+  ScopedFileWriter(const ScopedFileWriter&) = delete;
+  ScopedFileWriter& operator=(const ScopedFileWriter&) = delete;
+
+ private:
+  detail::WriterState* previous_;
+};
+
+}  // namespace libharu_examples
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "libharu_examples/file_writer.h"
+#include "libharu_examples/page_format.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace libharu_examples {
+
+enum class BulkInputFormat {
+  // `.jsonl` / `.ndjson` files are read as JSON Lines, anything else as CSV.
+  Auto,
+  Csv,
+  Jsonl,
+};
+
+struct InvoiceBulkStats {
+  std::size_t input_bytes = 0;
+  std::size_t rows = 0;
+  // Invoices written, and invoices skipped because a row was malformed or incomplete.
+  std::size_t invoices = 0;
+  std::size_t rejected = 0;
+  // Invoices that parsed but could not be rendered or written.
+  std::size_t failed = 0;
+  std::size_t output_bytes = 0;
+  double seconds = 0.0;
+  // Busy time per stage; render time is summed over the render workers.
+  double parse_seconds = 0.0;
+  double render_seconds = 0.0;
+  double write_seconds = 0.0;
+  // First rejected or failed invoice, e.g. "line 12: quantity is not a positive integer".
+  std::string first_error;
+};
+
+// Settings for the bulk invoice pipeline. `progress` is called from the writer thread every
+// `progress_interval` written invoices (and once at the end) with the counters so far.
+struct InvoiceBulkOptions {
+  BulkInputFormat input_format = BulkInputFormat::Auto;
+  PageFormat page_format = PageFormat::A4Portrait;
+  // Optional TrueType fonts for UTF-8 invoice text (see InvoiceExample).
+  TrueTypeFontSet fonts;
+  // 0 = one render worker per hardware thread, less the parse and write threads.
+  std::size_t render_workers = 0;
+  // Invoices allowed in flight between two stages; bounds memory for any input size, apart
+  // from the file names already used.
+  std::size_t queue_depth = 64;
+  // How the writer stage publishes files. With FsyncPolicy::PerBatch, progress reports count
+  // staged files in `invoices`; the final stats count only the committed ones.
+  FileWriterOptions output{FsyncPolicy::Never};
+  std::size_t progress_interval = 1000;
+  std::function<void(const InvoiceBulkStats& progress)> progress;
+};
+
+// Renders one invoice PDF per invoice in `input_path` into `output_dir` (created if missing),
+// named after the invoice id. Ids that are not safe file names as they stand are sanitized
+// and get a short hash of the raw id appended; an invoice whose name was already used in the
+// run (a repeated invoice_id) is rejected. The input has one line item per row with the columns
+// invoice_id, provider_name, provider_address, provider_email, client_name, client_address,
+// client_email, description, quantity and unit_price; consecutive rows with the same
+// invoice_id make up one invoice. CSV input needs a header row naming the columns (in any
+// order); JSON Lines input has one flat object per line.
+//
+// Returns false only if the input cannot be read, the CSV header lacks a column or the
+// output directory cannot be created. Bad invoices are skipped and counted in `stats`.
+bool create_invoices_from_file(const std::string& input_path,
+                               const std::string& output_dir,
+                               const InvoiceBulkOptions& options = {},
+                               InvoiceBulkStats* stats = nullptr);
+
+}  // namespace libharu_examples
@@ -1,12 +1,36 @@
 #pragma once
 
+#include "libharu_examples/page_format.h"
+#include "libharu_examples/pdf_allocator.h"
+#include "libharu_examples/pdf_output.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace libharu_examples {
 
+namespace detail {
+struct StatementState;
+}  // namespace detail
+
 class InvoiceExample {
  public:
+  // Every document this instance renders uses `page_format`; each format has its own
+  // compile-time layout.
+  explicit InvoiceExample(PageFormat page_format = PageFormat::A4Portrait)
+      : format_(page_format) {}
+  // Draws every invoice in `fonts` (bold and italic text fall back to `fonts.regular`), so
+  // parties and item descriptions may be any UTF-8 the fonts cover.
+  InvoiceExample(PageFormat page_format, TrueTypeFontSet fonts)
+      : format_(page_format), fonts_(std::move(fonts)) {}
+
+  PageFormat page_format() const { return format_; }
+
   struct Client {
     std::string name;
     std::string address;
@@ -25,10 +49,134 @@ class InvoiceExample {
     double unit_price;
   };
 
+  // Pulls the next item into `item`; returns false once the source is exhausted.
+  using ItemSource = std::function<bool(Item& item)>;
+
+  struct BatchJob {
+    Provider provider;
+    Client client;
+    std::vector<Item> items;
+    std::string output_pdf_path;
+  };
+
+  enum class JobStatus {
+    Ok,
+    InvalidInput,
+    RenderFailed,
+    SaveFailed,
+  };
+
+  // One invoice of a statement; `bookmark` is its outline title (empty = the client name).
+  struct StatementEntry {
+    Provider provider;
+    Client client;
+    std::vector<Item> items;
+    std::string bookmark;
+  };
+
+  // Tuning for createInvoiceBatch. Every worker thread owns one allocator of the `allocator`
+  // policy; when `allocator_stats` is set, the workers' counters are summed into it (the peak
+  // is the largest single worker's).
+  struct BatchOptions {
+    std::size_t worker_count = 0;
+    PdfAllocatorPolicy allocator = PdfAllocatorPolicy::Default;
+    PdfAllocatorStats* allocator_stats = nullptr;
+  };
+
   bool createInvoidcw(const Provider& provider,
                       const Client& client,
                       const std::vector<Item>& items,
                       const std::string& output_pdf_path) const;
+  bool createInvoidcw(const Provider& provider,
+                      const Client& client,
+                      const std::vector<Item>& items,
+                      PdfBuffer& output) const;
+  bool createInvoidcw(const Provider& provider,
+                      const Client& client,
+                      const std::vector<Item>& items,
+                      const PdfSink& sink) const;
+
+  // Multi-page invoice for arbitrarily long item lists. Items are pulled one at a time from
+  // `next_item`, so the caller never needs to materialize them. Every page repeats the table
+  // header, page breaks carry the running subtotal, and totals close the last page. Returns
+  // false if the source yields no items or an invalid one.
+  bool createPaginatedInvoice(const Provider& provider,
+                              const Client& client,
+                              const ItemSource& next_item,
+                              const std::string& output_pdf_path) const;
+  bool createPaginatedInvoice(const Provider& provider,
+                              const Client& client,
+                              const ItemSource& next_item,
+                              PdfBuffer& output) const;
+  bool createPaginatedInvoice(const Provider& provider,
+                              const Client& client,
+                              const ItemSource& next_item,
+                              const PdfSink& sink) const;
+
+  // Renders every job on a pool of `worker_count` threads (0 = one per hardware thread) and
+  // returns one status per job, in job order. InvoiceExample holds only its page format and
+  // read-only fonts, so any of its methods may be called concurrently; each render owns its
+  // libHaru document.
+  // Jobs must not share an output path.
+  std::vector<JobStatus> createInvoiceBatch(const std::vector<BatchJob>& jobs,
+                                            std::size_t worker_count = 0) const;
+  std::vector<JobStatus> createInvoiceBatch(const std::vector<BatchJob>& jobs,
+                                            const BatchOptions& options) const;
+
+  // All `entries` in one statement document (see InvoiceStatement), rendered as contiguous
+  // runs of invoices on `worker_count` threads (0 = one per hardware thread) and joined with
+  // `assemble_pdf`, so fonts and the shared header and footer are still stored once. Returns
+  // false if any entry is invalid.
+  bool createStatement(const std::vector<StatementEntry>& entries,
+                       PdfBuffer& output,
+                       std::size_t worker_count = 0) const;
+  bool createStatement(const std::vector<StatementEntry>& entries,
+                       const std::string& output_pdf_path,
+                       std::size_t worker_count = 0) const;
+
+ private:
+  PageFormat format_;
+  TrueTypeFontSet fonts_;
+};
+
+// Many invoices in one document, e.g. a monthly statement. Each invoice starts on a new page,
+// runs over as many pages as its items need (like createPaginatedInvoice) and gets an outline
+// entry pointing at its first page. Fonts are loaded once per document, and the parts of the
+// layout that never change (title, logo, labels, table header, footer) are emitted once and
+// shared by every invoice's pages. libHaru holds the whole document until it is saved.
+//
+// Use from one thread at a time. The document is created in the constructor, under that
+// thread's ScopedPdfAllocator or ScopedRenderContext if one is active, which must then outlive
+// the statement.
+class InvoiceStatement {
+ public:
+  explicit InvoiceStatement(PageFormat page_format = PageFormat::A4Portrait);
+  // Every invoice in `fonts`, as for InvoiceExample; each font is embedded once.
+  InvoiceStatement(PageFormat page_format, TrueTypeFontSet fonts);
+  ~InvoiceStatement();
+
+  InvoiceStatement(const InvoiceStatement&) = delete;
+  InvoiceStatement& operator=(const InvoiceStatement&) = delete;
+
+  // Appends one invoice; `bookmark` is its outline title (empty = the client name). Invalid
+  // input returns false and leaves the statement unchanged. If libHaru fails part-way through
+  // an invoice the document cannot be repaired, and this and every later call return false.
+  bool add_invoice(const InvoiceExample::Provider& provider,
+                   const InvoiceExample::Client& client,
+                   const std::vector<InvoiceExample::Item>& items,
+                   const std::string& bookmark = {});
+
+  std::size_t invoice_count() const;
+  std::size_t page_count() const;
+
+  // Writes every invoice added so far; false if there are none. More invoices may be added
+  // and the statement saved again afterwards.
+  bool save(const std::string& output_pdf_path);
+  bool save(PdfBuffer& output);
+  bool save(const PdfSink& sink);
+
+ private:
+  std::unique_ptr<detail::StatementState> state_;
 };
 
 }  // namespace libharu_examples
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "libharu_examples/pdf_output.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libharu_examples {
+
+namespace detail {
+struct LayoutProgram;
+struct LayoutAccess;
+}  // namespace detail
+
+// A document layout written in the small line-based template language described in
+// Readme.md ("Layout templates"), compiled once into a validated draw program. Copies share
+// the compiled program, and a template may be rendered from any number of threads at once.
+class LayoutTemplate {
+ public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  // Parses and validates `source`. On failure returns false, leaves `out` unchanged and, when
+  // `error` is set, describes the first problem ("line 12: unknown font 'bld'").
+  static bool compile(std::string_view source, LayoutTemplate& out, std::string* error = nullptr);
+
+  bool valid() const { return program_ != nullptr; }
+
+  // Slots for binding records without name lookups; npos when the name is not used.
+  std::size_t field(std::string_view name) const;
+  std::size_t table(std::string_view name) const;
+  std::size_t column_count(std::size_t table) const;
+
+ private:
+  friend class LayoutRecord;
+
+  std::shared_ptr<const detail::LayoutProgram> program_;
+};
+
+// Values for one document: one string per field and a list of rows per table. Reuse a record
+// across documents with `clear`, which keeps every buffer's capacity.
+class LayoutRecord {
+ public:
+  explicit LayoutRecord(const LayoutTemplate& layout);
+
+  // By name: false when the template has no such field, table or the row has the wrong
+  // number of cells. By slot: the slot must come from the same template.
+  bool set(std::string_view field, std::string_view value);
+  void set(std::size_t field, std::string_view value);
+  bool add_row(std::string_view table, std::initializer_list<std::string_view> cells);
+  bool add_row(std::size_t table, std::initializer_list<std::string_view> cells);
+
+  void clear();
+
+ private:
+  friend struct detail::LayoutAccess;
+
+  std::shared_ptr<const detail::LayoutProgram> program_;
+  std::vector<std::string> fields_;
+  // Row-major cells per table; only the first `cell_counts_[table]` are in use.
+  std::vector<std::vector<std::string>> tables_;
+  std::vector<std::size_t> cell_counts_;
+};
+
+bool render_layout_pdf(const LayoutRecord& record, const std::string& output_pdf_path);
+bool render_layout_pdf(const LayoutRecord& record, PdfBuffer& output);
+bool render_layout_pdf(const LayoutRecord& record, const PdfSink& sink);
+
+}  // namespace libharu_examples
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace libharu_examples {
+
+// An amount in integer cents. Sums, products and percentages are exact (or rounded once, to
+// the cent, where stated); nothing passes through binary floating point after `from_double`.
+class Money {
+ public:
+  constexpr Money() = default;
+
+  static constexpr Money from_cents(const std::int64_t cents) { return Money(cents); }
+  // Rounds the shortest decimal form of `amount` (1.005 reads as "1.005", not as the binary
+  // 1.00499...) to the nearest cent, halves away from zero. False for NaN, infinities and
+  // amounts beyond ±10^15; `out` is left untouched then.
+  static bool from_double(double amount, Money& out);
+
+  constexpr std::int64_t cents() const { return cents_; }
+
+  // Checked arithmetic: false (with `out` untouched) when the result overflows.
+  bool add(Money other, Money& out) const;
+  bool multiply(std::int64_t factor, Money& out) const;
+
+  // `basis_points / 10000` of this amount (500 = 5%), rounded to the cent, halves away from
+  // zero.
+  bool percentage(std::int32_t basis_points, Money& out) const;
+
+  friend constexpr bool operator==(const Money a, const Money b) { return a.cents_ == b.cents_; }
+  friend constexpr bool operator!=(const Money a, const Money b) { return a.cents_ != b.cents_; }
+  friend constexpr bool operator<(const Money a, const Money b) { return a.cents_ < b.cents_; }
+
+ private:
+  explicit constexpr Money(const std::int64_t cents) : cents_(cents) {}
+
+  std::int64_t cents_ = 0;
+};
+
+// `symbol` is written as-is between the sign and the digits, so it must be encodable in the
+// font's encoding (`$`, or `\xA3`/`\xA5` for pound/yen in StandardEncoding). A zero
+// `thousands_separator` disables grouping.
+struct MoneyFormat {
+  std::string_view symbol;
+  char thousands_separator = ',';
+  char decimal_point = '.';
+};
+
+// Formatted amount held in a fixed inline buffer; formatting never allocates.
+class MoneyText {
+ public:
+  static constexpr std::size_t kMaxSymbolSize = 8;
+
+  const char* c_str() const { return buffer_.data(); }
+  std::string_view view() const { return {buffer_.data(), size_}; }
+  std::size_t size() const { return size_; }
+
+ private:
+  friend MoneyText format_money(Money amount, const MoneyFormat& format);
+
+  // Sign, symbol, 19 digits with 6 separators, decimal point, 2 decimals and the terminator.
+  std::array<char, 1 + kMaxSymbolSize + 19 + 6 + 1 + 2 + 1> buffer_{};
+  std::size_t size_ = 0;
+};
+
+// "-$1,234.56" style. Symbols longer than MoneyText::kMaxSymbolSize are truncated.
+MoneyText format_money(Money amount, const MoneyFormat& format = {});
+
+}  // namespace libharu_examples
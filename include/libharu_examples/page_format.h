@@ -0,0 +1,15 @@
+#pragma once
+
+namespace libharu_examples {
+
+// Paper size and orientation of a rendered document. Each format has its own compile-time
+// layout (see `src/page_geometry.h`); renderers pick one when the call starts and do no
+// geometry arithmetic while drawing.
+enum class PageFormat {
+  A4Portrait,
+  A4Landscape,
+  LetterPortrait,
+  LetterLandscape,
+};
+
+}  // namespace libharu_examples
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace libharu_examples {
+
+// Counters kept by every PdfAllocator. `system_allocations` counts the calls the policy itself
+// made to malloc (chunks, slabs, oversized blocks); `resets` counts arena rewinds.
+struct PdfAllocatorStats {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytes_allocated = 0;
+  std::size_t bytes_in_use = 0;
+  std::size_t peak_bytes_in_use = 0;
+  std::size_t system_allocations = 0;
+  std::size_t resets = 0;
+
+  // Sums the counters of another allocator (e.g. one per batch worker), except the peak: the
+  // result keeps the highest single-allocator peak, not a combined one.
+  PdfAllocatorStats& operator+=(const PdfAllocatorStats& other);
+};
+
+// Memory policy for libHaru documents, plugged into `HPDF_NewEx`'s alloc/free hooks. An
+// allocator serves one thread at a time and must outlive every document created with it.
+class PdfAllocator {
+ public:
+  virtual ~PdfAllocator() = default;
+
+  void* allocate(std::size_t size);
+  void deallocate(void* block, std::size_t size);
+
+  const PdfAllocatorStats& stats() const { return stats_; }
+  void reset_stats();
+
+ protected:
+  virtual void* do_allocate(std::size_t size) = 0;
+  virtual void do_deallocate(void* block, std::size_t size) = 0;
+  // Called when the last outstanding block has been returned.
+  virtual void on_idle() {}
+
+  PdfAllocatorStats stats_;
+
+ private:
+  std::size_t live_blocks_ = 0;
+};
+
+// Plain malloc/free with statistics; the baseline the other policies are measured against.
+class SystemPdfAllocator : public PdfAllocator {
+ protected:
+  void* do_allocate(std::size_t size) override;
+  void do_deallocate(void* block, std::size_t size) override;
+};
+
+// Bump allocator over a list of chunks. Individual frees are no-ops; once every block of the
+// document has been returned (`HPDF_Free`) the arena rewinds to its first chunk in O(1) and
+// keeps the chunks for the next document.
+class ArenaPdfAllocator : public PdfAllocator {
+ public:
+  explicit ArenaPdfAllocator(std::size_t chunk_size = 256U * 1024U);
+  ~ArenaPdfAllocator() override;
+
+  ArenaPdfAllocator(const ArenaPdfAllocator&) = delete;
+  ArenaPdfAllocator& operator=(const ArenaPdfAllocator&) = delete;
+
+ protected:
+  void* do_allocate(std::size_t size) override;
+  void do_deallocate(void* block, std::size_t size) override;
+  void on_idle() override;
+
+ private:
+  struct Chunk {
+    unsigned char* data;
+    std::size_t size;
+  };
+
+  std::size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  std::size_t current_ = 0;
+  std::size_t offset_ = 0;
+};
+
+// Segregated free lists for power-of-two size classes from 16 bytes to 4 KiB, carved from
+// 64 KiB slabs. Freed blocks go back to their class list; larger requests use malloc.
+class PoolPdfAllocator : public PdfAllocator {
+ public:
+  PoolPdfAllocator();
+  ~PoolPdfAllocator() override;
+
+  PoolPdfAllocator(const PoolPdfAllocator&) = delete;
+  PoolPdfAllocator& operator=(const PoolPdfAllocator&) = delete;
+
+ protected:
+  void* do_allocate(std::size_t size) override;
+  void do_deallocate(void* block, std::size_t size) override;
+
+ private:
+  static constexpr std::size_t kClassCount = 9;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  FreeBlock* free_lists_[kClassCount] = {};
+  std::vector<unsigned char*> slabs_;
+  unsigned char* slab_cursor_ = nullptr;
+  std::size_t slab_remaining_ = 0;
+};
+
+// `Default` leaves libHaru on its built-in malloc/free with no hooks and no statistics.
+enum class PdfAllocatorPolicy {
+  Default,
+  System,
+  Arena,
+  Pool,
+};
+
+// Returns nullptr for PdfAllocatorPolicy::Default.
+std::unique_ptr<PdfAllocator> make_pdf_allocator(PdfAllocatorPolicy policy);
+
+// Documents created on the current thread while the scope is alive allocate through
+// `allocator`. Scopes nest; the innermost one wins. Without a scope libHaru uses malloc.
+class ScopedPdfAllocator {
+ public:
+  explicit ScopedPdfAllocator(PdfAllocator& allocator);
+  ~ScopedPdfAllocator();
+
+  ScopedPdfAllocator(const ScopedPdfAllocator&) = delete;
+  ScopedPdfAllocator& operator=(const ScopedPdfAllocator&) = delete;
+
+ private:
+  PdfAllocator* previous_;
+};
+
+}  // namespace libharu_examples
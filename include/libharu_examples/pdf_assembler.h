@@ -0,0 +1,29 @@
+#pragma once
+
+#include "libharu_examples/pdf_output.h"
+
+#include <string>
+#include <vector>
+
+namespace libharu_examples {
+
+// Joins complete PDFs written by libHaru into one document with their pages in order, so page
+// ranges can be rendered into separate documents on separate threads and stitched afterwards.
+// Every object reachable from the pages (content streams, fonts, images) is renumbered into
+// one object space; small identical objects such as font dictionaries and shared content
+// streams are stored once. Top-level outline entries of all parts are chained into one
+// outline, and the document info comes from the first part.
+//
+// Only classic xref tables are read; encrypted or incrementally updated parts are rejected.
+// On failure returns false and, when `error` is set, says which part failed and why.
+bool assemble_pdf(const std::vector<PdfBuffer>& parts,
+                  PdfBuffer& output,
+                  std::string* error = nullptr);
+bool assemble_pdf(const std::vector<PdfBuffer>& parts,
+                  const PdfSink& sink,
+                  std::string* error = nullptr);
+bool assemble_pdf(const std::vector<PdfBuffer>& parts,
+                  const std::string& output_pdf_path,
+                  std::string* error = nullptr);
+
+}  // namespace libharu_examples
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace libharu_examples {
+
+// Growable output buffer for in-memory rendering. Renderers replace its contents and keep
+// its capacity, so one buffer can be reused across many documents.
+using PdfBuffer = std::vector<unsigned char>;
+
+// Receives the serialized document in order, one chunk at a time. Returning false aborts
+// the render.
+using PdfSink = std::function<bool(const unsigned char* data, std::size_t size)>;
+
+}  // namespace libharu_examples
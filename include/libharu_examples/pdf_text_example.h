@@ -1,10 +1,62 @@
 #pragma once
 
+#include "libharu_examples/pdf_output.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <cstddef>
+#include <memory>
 #include <string>
 
 namespace libharu_examples {
 
+// Page layout and volume settings for the streaming text-file renderer.
+struct TextPdfOptions {
+  float font_size = 9.0F;
+  float leading = 11.0F;
+  float margin = 40.0F;
+  std::size_t read_chunk_size = 1U << 20U;
+  // libHaru keeps every page in memory until the document is saved, and the save holds the
+  // serialized file as well, so this (0 = one file) is what bounds memory for very large
+  // inputs. Ignored by the sink overload.
+  std::size_t max_pages_per_file = 0;
+  // Above 1, page ranges are rendered on this many threads and joined with `assemble_pdf`
+  // (single-file output only). The input is mapped and all ranges stay in memory until then.
+  std::size_t render_threads = 1;
+  // When set, the input is UTF-8 text drawn in this font instead of Helvetica.
+  std::shared_ptr<const TrueTypeFont> font;
+};
+
+struct TextPdfStats {
+  std::size_t input_bytes = 0;
+  std::size_t source_lines = 0;
+  std::size_t output_lines = 0;
+  std::size_t pages = 0;
+  std::size_t files = 0;
+};
+
 std::string default_example_text();
-bool create_text_pdf(const std::string& output_pdf_path, const std::string& text);
+// Draws `text` as one line on an A4 page. Only `options.font` applies here; the layout and
+// volume fields belong to the text-file renderer below.
+bool create_text_pdf(const std::string& output_pdf_path,
+                     const std::string& text,
+                     const TextPdfOptions& options = {});
+bool create_text_pdf(PdfBuffer& output,
+                     const std::string& text,
+                     const TextPdfOptions& options = {});
+bool create_text_pdf(const PdfSink& sink,
+                     const std::string& text,
+                     const TextPdfOptions& options = {});
+
+// Reads `input_path` in fixed-size chunks, splits it on '\n', wraps lines at the text width
+// and paginates onto A4 pages. With `max_pages_per_file` set, the output is split into
+// `<stem>_0001<ext>`, `<stem>_0002<ext>`, ... next to `output_pdf_path`.
+bool create_text_file_pdf(const std::string& input_path,
+                          const std::string& output_pdf_path,
+                          const TextPdfOptions& options = {},
+                          TextPdfStats* stats = nullptr);
+bool create_text_file_pdf(const std::string& input_path,
+                          const PdfSink& sink,
+                          const TextPdfOptions& options = {},
+                          TextPdfStats* stats = nullptr);
 
 }  // namespace libharu_examples
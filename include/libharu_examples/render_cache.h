@@ -0,0 +1,83 @@
+#pragma once
+
+#include "libharu_examples/pdf_output.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace libharu_examples {
+
+namespace detail {
+struct CacheState;
+}  // namespace detail
+
+struct RenderCacheOptions {
+  // Budget for PDF bytes held in memory; least recently used documents are dropped first.
+  // 0 keeps nothing in memory (disk only, if `directory` is set).
+  std::size_t memory_bytes = std::size_t{64} << 20;
+  // Optional second tier: one `<key>.pdf` per document, kept across processes and never
+  // pruned. Empty = memory only.
+  std::string directory;
+};
+
+struct RenderCacheStats {
+  std::size_t memory_hits = 0;
+  std::size_t disk_hits = 0;
+  std::size_t misses = 0;
+  std::size_t stores = 0;
+  std::size_t evictions = 0;
+  // Documents and bytes currently held in memory.
+  std::size_t entries = 0;
+  std::size_t memory_bytes = 0;
+};
+
+// Finished PDFs keyed by a SHA-256 of everything that determines their bytes: the renderer
+// and its revision, page format, fonts (by content), document info, compression and the
+// canonicalized inputs. A hit returns the stored bytes without touching libHaru, so repeated
+// statements, reprints and retries cost a copy instead of a render. Thread-safe; one cache
+// may serve any number of threads through their own ScopedRenderCache.
+//
+// Keys are hex digests. `lookup` and `store` are public for callers that cache their own
+// documents; the renderers below compute keys themselves.
+class RenderCache {
+ public:
+  explicit RenderCache(RenderCacheOptions options = {});
+  ~RenderCache();
+
+  RenderCache(const RenderCache&) = delete;
+  RenderCache& operator=(const RenderCache&) = delete;
+
+  // Copies the document stored under `key` into `output`: memory first, then the disk tier
+  // (promoting the document to memory). False on a miss.
+  bool lookup(const std::string& key, PdfBuffer& output);
+  // Keeps `document` under `key` in memory and, with a directory, on disk. A document larger
+  // than the memory budget only goes to disk.
+  void store(const std::string& key, const PdfBuffer& document);
+  // Drops the memory tier; disk files stay.
+  void clear();
+
+  RenderCacheStats stats() const;
+
+ private:
+  std::unique_ptr<detail::CacheState> state_;
+};
+
+// While the scope is alive, these renders on the current thread consult `cache` before
+// rendering and store what they render: `createInvoidcw`, `create_clinical_report_pdf` and
+// `create_text_pdf`, for every output form. Streamed and multi-document renders (paginated
+// invoices, statements, batches, text files, layout templates) are not cached. Scopes nest;
+// the innermost one wins.
+class ScopedRenderCache {
+ public:
+  explicit ScopedRenderCache(RenderCache& cache);
+  ~ScopedRenderCache();
+
+  ScopedRenderCache(const ScopedRenderCache&) = delete;
+  ScopedRenderCache& operator=(const ScopedRenderCache&) = delete;
+
+ private:
+  RenderCache* previous_;
+};
+
+}  // namespace libharu_examples
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace libharu_examples {
+
+namespace detail {
+struct ContextState;
+}  // namespace detail
+
+enum class PdfCompression {
+  None,
+  Text,
+  All,
+};
+
+struct RenderContextOptions {
+  PdfCompression compression = PdfCompression::None;
+};
+
+// A libHaru document kept alive across renders. Between documents it is cleared with
+// `HPDF_FreeDoc` and re-initialised with `HPDF_NewDoc`, so the document object, error handler,
+// compression setting and libHaru's font-definition and encoder caches survive from one
+// render to the next. Use from one thread at a time, through ScopedRenderContext.
+class RenderContext {
+ public:
+  explicit RenderContext(const RenderContextOptions& options = {});
+  ~RenderContext();
+
+  RenderContext(const RenderContext&) = delete;
+  RenderContext& operator=(const RenderContext&) = delete;
+
+  // Documents served from the kept document (every render after the first).
+  std::size_t reused_documents() const;
+
+ private:
+  friend class ScopedRenderContext;
+
+  std::unique_ptr<detail::ContextState> state_;
+};
+
+// Renders on the current thread use `context` until the scope ends. Scopes nest; the
+// innermost one wins. A render started while the context's document is already in use (for
+// example from inside a PdfSink callback) falls back to a fresh document.
+class ScopedRenderContext {
+ public:
+  explicit ScopedRenderContext(RenderContext& context);
+  ~ScopedRenderContext();
+
+  ScopedRenderContext(const ScopedRenderContext&) = delete;
+  ScopedRenderContext& operator=(const ScopedRenderContext&) = delete;
+
+ private:
+  detail::ContextState* previous_;
+};
+
+}  // namespace libharu_examples
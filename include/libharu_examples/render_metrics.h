@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+namespace libharu_examples {
+
+// Phases of one document, in the order the renderers pass through them.
+enum class RenderPhase {
+  // `HPDF_New` / `HPDF_NewDoc`.
+  Init,
+  // First page, page size and font loading.
+  Setup,
+  // Everything drawn onto the pages.
+  Draw,
+  // `HPDF_SaveToStream`: the document serialized into libHaru's memory stream.
+  Serialize,
+  // Copying the stream into the caller's buffer, sink or file, including the file's fsync
+  // and rename (see FileWriter).
+  Write,
+};
+
+inline constexpr std::size_t kRenderPhaseCount = 5;
+
+// A libHaru error as passed to the document's error handler: `code` is the HPDF error number
+// (e.g. 0x1017 `HPDF_FILE_IO_ERROR`), `detail` the error's detail number. `code == 0` means
+// no error.
+struct RenderError {
+  unsigned long code = 0;
+  unsigned long detail = 0;
+  RenderPhase phase = RenderPhase::Init;
+};
+
+// Counters for one document. `allocations` counts libHaru's own allocations; they are only
+// seen for documents created while metrics are collected.
+struct DocumentTrace {
+  bool saved = false;
+  std::size_t output_bytes = 0;
+  std::size_t draw_operations = 0;
+  std::size_t allocations = 0;
+  std::size_t allocated_bytes = 0;
+  // Indexed by RenderPhase.
+  std::chrono::nanoseconds phase_time[kRenderPhaseCount] = {};
+  std::size_t errors = 0;
+  RenderError first_error;
+
+  std::chrono::nanoseconds time(const RenderPhase phase) const {
+    return phase_time[static_cast<std::size_t>(phase)];
+  }
+};
+
+// Totals accumulated over every document rendered on one thread while a ScopedRenderMetrics
+// is alive. A document counts as saved once its bytes reach the caller, and as failed when it
+// is released without a successful save. `draw_operations` counts the path, text and graphics
+// state operators the renderers issue.
+struct RenderMetrics {
+  std::size_t documents = 0;
+  std::size_t failed_documents = 0;
+  std::size_t output_bytes = 0;
+  std::size_t draw_operations = 0;
+  std::size_t allocations = 0;
+  std::size_t allocated_bytes = 0;
+  std::chrono::nanoseconds init_time{0};
+  std::chrono::nanoseconds setup_time{0};
+  std::chrono::nanoseconds draw_time{0};
+  std::chrono::nanoseconds serialize_time{0};
+  std::chrono::nanoseconds write_time{0};
+  std::size_t errors = 0;
+  RenderError last_error;
+  // Called on the rendering thread when a document is saved or given up, e.g. to log slow
+  // or failed renders. Renders started from inside the callback are not traced.
+  std::function<void(const DocumentTrace& document)> trace;
+};
+
+// Routes metrics for renders on the current thread into `metrics` until destroyed. Scopes
+// nest; the innermost one wins. Without an active scope the renderers take no timestamps and
+// count nothing.
+class ScopedRenderMetrics {
+ public:
+  explicit ScopedRenderMetrics(RenderMetrics& metrics);
+  ~ScopedRenderMetrics();
+
+  ScopedRenderMetrics(const ScopedRenderMetrics&) = delete;
+  ScopedRenderMetrics& operator=(const ScopedRenderMetrics&) = delete;
+
+ private:
+  RenderMetrics* previous_;
+};
+
+}  // namespace libharu_examples
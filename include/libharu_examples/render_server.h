@@ -0,0 +1,176 @@
+#pragma once
+
+#include "libharu_examples/clinical_report_example.h"
+#include "libharu_examples/document_info.h"
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/page_format.h"
+#include "libharu_examples/pdf_output.h"
+#include "libharu_examples/render_cache.h"
+#include "libharu_examples/render_context.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace libharu_examples {
+
+namespace detail {
+struct ServerState;
+}  // namespace detail
+
+// Wire protocol of the render server, over a Unix domain stream socket. Every message is a
+// frame: a 4-byte big-endian payload length, then the payload. A connection carries any
+// number of request/response pairs, one at a time.
+//
+// Request payload (integers big-endian, `str` = u32 length + bytes):
+//   u8 version (1), u8 RenderKind, u8 PageFormat, str output_name, then per kind:
+//   Text:     str text
+//   Invoice:  str provider name, address, email; str client name, address, email;
+//             u32 item count; per item: str description, i32 quantity, f64 unit price
+//             (IEEE 754 bits as u64)
+//   Clinical: str full name, u32 age, str sex, str patient id; str doctor name, specialty;
+//             u32 frame count; per frame: u8 format (0 Gray8, 1 Rgb8, 2 Jpeg), u32 width,
+//             u32 height, str bytes
+// An empty output_name asks for the PDF bytes; otherwise the server writes the PDF to that
+// file in its output directory.
+//
+// Response payload: u8 RenderStatus, then the PDF bytes (Ok, in memory), the written path
+// (Ok, to a file) or an error message.
+enum class RenderKind : std::uint8_t {
+  Text = 1,
+  Invoice = 2,
+  Clinical = 3,
+};
+
+enum class RenderStatus : std::uint8_t {
+  Ok = 0,
+  // Malformed or oversized request, unknown kind or format, or an output name the server
+  // does not accept. Oversized requests also close the connection.
+  BadRequest = 1,
+  // The renderer rejected the input (e.g. an invalid item or a landscape clinical report).
+  RenderFailed = 2,
+};
+
+// One document to render. Only the fields of `kind` are sent; frames are borrowed until the
+// request has been sent.
+struct RenderRequest {
+  RenderKind kind = RenderKind::Text;
+  PageFormat page_format = PageFormat::A4Portrait;
+  std::string text;
+  InvoiceExample::Provider provider;
+  InvoiceExample::Client client;
+  std::vector<InvoiceExample::Item> items;
+  ClinicalReportExample::Patient patient{};
+  ClinicalReportExample::ReferringDoctor doctor;
+  std::vector<ClinicalReportExample::ImageFrame> frames;
+};
+
+struct RenderServerOptions {
+  std::string socket_path;
+  // Render threads, each with its own warm RenderContext; 0 = one per hardware thread. This
+  // is the number of documents rendered at once.
+  std::size_t workers = 0;
+  // Requests read from clients but waiting for a worker. When it is full the server stops
+  // reading from clients, and when `max_connections` are open it stops accepting, so a
+  // client that outpaces the workers blocks in its socket instead of growing server memory.
+  std::size_t queue_depth = 64;
+  std::size_t max_connections = 256;
+  // Larger requests are answered with BadRequest and the connection is closed.
+  std::size_t max_request_bytes = std::size_t{64} << 20;
+  // Time allowed to receive a whole request, and again to send its whole response; a client
+  // that stalls or trickles bytes holds a worker for at most twice this plus the render.
+  // 0 = no limit.
+  int io_timeout_ms = 5000;
+  // Directory for requests with an output name; empty = only in-memory responses.
+  std::string output_directory;
+  // Optional TrueType fonts for every renderer; text requests use `regular`.
+  TrueTypeFontSet fonts;
+  // Encrypts every clinical report served; a PerDocument callback runs on the workers.
+  ClinicalReportExample::Encryption clinical_encryption;
+  RenderContextOptions context;
+  // Shared by every worker when set; must outlive the server.
+  RenderCache* cache = nullptr;
+  // Pins the metadata of every document served (see ScopedDocumentInfo), so identical
+  // requests get identical bytes.
+  std::optional<DocumentInfo> document_info;
+  // Each worker renders one document of every kind before serving, so the first requests do
+  // not pay for font loading and first-touch page faults.
+  bool warm_up = true;
+};
+
+struct RenderServerStats {
+  std::size_t connections = 0;
+  std::size_t requests = 0;
+  std::size_t bad_requests = 0;
+  std::size_t failed_requests = 0;
+  std::size_t output_bytes = 0;
+};
+
+// A long-running renderer behind a Unix domain socket. Fonts are parsed once per process,
+// each worker keeps its libHaru document between requests, and clients keep their
+// connection open, so a small document costs one render rather than a process start.
+class RenderServer {
+ public:
+  explicit RenderServer(RenderServerOptions options);
+  // Stops the server if it is running.
+  ~RenderServer();
+
+  RenderServer(const RenderServer&) = delete;
+  RenderServer& operator=(const RenderServer&) = delete;
+
+  // Binds the socket (replacing a stale socket file nobody listens on), warms up the workers
+  // and returns while they serve in the background. False, with `error` set, if the socket
+  // cannot be created or the server is already running.
+  bool start(std::string* error = nullptr);
+  // Stops accepting, finishes the requests already read, closes every connection and removes
+  // the socket file.
+  void stop();
+
+  RenderServerStats stats() const;
+
+ private:
+  RenderServerOptions options_;
+  std::unique_ptr<detail::ServerState> state_;
+};
+
+// One connection to a RenderServer. Not thread-safe; use one client per thread.
+class RenderClient {
+ public:
+  RenderClient() = default;
+  ~RenderClient();
+
+  RenderClient(const RenderClient&) = delete;
+  RenderClient& operator=(const RenderClient&) = delete;
+
+  bool connect(const std::string& socket_path, std::string* error = nullptr);
+  void close();
+  bool connected() const { return fd_ >= 0; }
+
+  // Renders `request` into `output`. False with `error` set when the server refuses or fails
+  // the request (see `last_status`) or the connection breaks.
+  bool render(const RenderRequest& request, PdfBuffer& output, std::string* error = nullptr);
+  // Has the server write the PDF to `output_name` in its output directory; `written_path` is
+  // the file it wrote.
+  bool render_to_file(const RenderRequest& request,
+                      const std::string& output_name,
+                      std::string& written_path,
+                      std::string* error = nullptr);
+
+  RenderStatus last_status() const { return last_status_; }
+
+ private:
+  bool exchange(const RenderRequest& request,
+                const std::string& output_name,
+                PdfBuffer& body,
+                std::string* error);
+
+  int fd_ = -1;
+  std::vector<unsigned char> frame_;
+  RenderStatus last_status_ = RenderStatus::Ok;
+};
+
+}  // namespace libharu_examples
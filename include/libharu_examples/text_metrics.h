@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace libharu_examples {
+
+enum class StandardFont {
+  Helvetica,
+  HelveticaBold,
+  HelveticaOblique,
+};
+
+// Glyph advance widths for a base-14 font in libHaru's default StandardEncoding, in 1/1000
+// text-space units (the AFM convention, as returned by `HPDF_Font_TextWidth`). The tables are
+// built at compile time; lookups need no libHaru document and are safe from any thread.
+class FontMetrics {
+ public:
+  static const FontMetrics& get(StandardFont font);
+
+  std::uint16_t glyph_width(const unsigned char code) const { return widths_[code]; }
+  std::uint32_t width_units(std::string_view text) const;
+  float width(std::string_view text, float font_size) const;
+
+  // Length of the longest prefix of `text` no wider than `max_width` points.
+  std::size_t fit(std::string_view text, float font_size, float max_width) const;
+  // Like `fit`, but backs up to just after the last space so words stay whole; falls back to
+  // `fit` when the first word alone is too wide. Mirrors `HPDF_Font_MeasureText` wordwrap.
+  std::size_t break_position(std::string_view text, float font_size, float max_width) const;
+  // Writes `text` to `out`, or the longest prefix that fits followed by `ellipsis`.
+  void fit_with_ellipsis(std::string_view text,
+                         float font_size,
+                         float max_width,
+                         std::string& out,
+                         std::string_view ellipsis = "...") const;
+
+ private:
+  explicit FontMetrics(const std::array<std::uint16_t, 256>& widths) : widths_(widths) {}
+
+  const std::array<std::uint16_t, 256>& widths_;
+};
+
+}  // namespace libharu_examples
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libharu_examples {
+
+// A TrueType font file, read and parsed once per process. `load` keeps every font it returns
+// for the life of the process, so renderers on any thread share one copy of the file bytes and
+// of the tables measurement needs (glyph advances and the Unicode cmap). Instances are
+// immutable and safe to use from any number of threads.
+//
+// Documents embed the font with `HPDF_LoadTTFontFromMemory` from the shared bytes and select
+// it with the UTF-8 encoder, so text is passed as UTF-8. libHaru writes only the glyphs a
+// document actually uses into its embedded font program.
+//
+// Measurement mirrors FontMetrics, on UTF-8 text: widths are in 1/1000 text-space units,
+// rounded per glyph the way libHaru computes CID font widths, code points without a glyph
+// measure as `.notdef`, and no returned length splits a UTF-8 sequence.
+class TrueTypeFont {
+ public:
+  // The font at `path`, loaded on first use. Later calls with the same path return the same
+  // instance without touching the file. On failure returns nullptr and, when `error` is set,
+  // says why ("fonts/x.ttf: no cmap table"); failures are not cached.
+  static std::shared_ptr<const TrueTypeFont> load(const std::string& path,
+                                                  std::string* error = nullptr);
+
+  const std::string& path() const { return path_; }
+  // The whole font file, as handed to libHaru.
+  const std::vector<unsigned char>& data() const { return data_; }
+  // SHA-256 of `data()` in hex; render cache keys name the font by content, not by path.
+  const std::string& digest() const { return digest_; }
+  std::size_t glyph_count() const { return glyph_units_.size(); }
+
+  bool has_glyph(char32_t code_point) const { return glyph_index(code_point) != 0; }
+  std::uint16_t glyph_width(char32_t code_point) const {
+    return glyph_units_[glyph_index(code_point)];
+  }
+
+  std::uint32_t width_units(std::string_view text) const;
+  float width(std::string_view text, float font_size) const;
+
+  // Byte length of the longest prefix of `text` no wider than `max_width` points.
+  std::size_t fit(std::string_view text, float font_size, float max_width) const;
+  // Like `fit`, but backs up to just after the last space so words stay whole; falls back to
+  // `fit` when the first word alone is too wide.
+  std::size_t break_position(std::string_view text, float font_size, float max_width) const;
+  // Writes `text` to `out`, or the longest prefix that fits followed by `ellipsis`.
+  void fit_with_ellipsis(std::string_view text,
+                         float font_size,
+                         float max_width,
+                         std::string& out,
+                         std::string_view ellipsis = "...") const;
+
+ private:
+  struct Range {
+    char32_t first;
+    char32_t last;
+    std::uint32_t first_glyph;
+  };
+
+  TrueTypeFont() = default;
+
+  bool parse(std::string* error);
+  std::uint16_t glyph_index(char32_t code_point) const;
+
+  std::string path_;
+  std::vector<unsigned char> data_;
+  std::string digest_;
+  // Advance width of every glyph in 1/1000 em.
+  std::vector<std::uint16_t> glyph_units_;
+  // Glyph index per BMP code point; code points above U+FFFF go through `ranges_`.
+  std::vector<std::uint16_t> bmp_glyphs_;
+  std::vector<Range> ranges_;
+};
+
+// TrueType faces for a renderer. With `regular` set the renderer draws all text with these
+// fonts as UTF-8 instead of the base-14 Helvetica family; `bold` and `italic` fall back to
+// `regular` when unset.
+struct TrueTypeFontSet {
+  std::shared_ptr<const TrueTypeFont> regular;
+  std::shared_ptr<const TrueTypeFont> bold;
+  std::shared_ptr<const TrueTypeFont> italic;
+};
+
+}  // namespace libharu_examples
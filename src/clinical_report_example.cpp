@@ -5,199 +5,1033 @@ This file creates a clinical ultrasound-style report PDF using libHaru drawing p
 The document is intentionally template-like: fixed margins, fixed text blocks, and consistent
 horizontal separators to mirror typical diagnostic report formatting.
 
-1) Validate report inputs and initialize libHaru document/page/font resources.
+1) Validate report inputs and initialize libHaru document/page/font resources. Coordinates
+   come from `ReportLayout<Format>` (portrait A4 or Letter), fixed at compile time.
 2) Draw the static template structure (brand header, patient strip, section headings, footer).
-3) Fill clinical content and reserve an explicit empty square for ultrasound image data.
+3) Fill clinical content and reserve an explicit square for ultrasound image data: empty with a
+   placeholder label, or with the caller's frames tiled into it. With `ImageOptions::box_frames`
+   the frames that do not go into the box follow on contact-sheet pages.
+
+Raw frames are prepared before libHaru sees them: Gray16 samples are windowed to 8 bits, and
+with `ImageOptions::dpi` every raw frame is area-averaged down to that resolution at its drawn
+size (src/image_kernels.cpp), which shortens both embedding and the saved file.
+
+Under a `ScopedRenderCache` single unencrypted reports are keyed by patient, doctor, frame
+bytes, format and fonts, and a report rendered before is served from src/render_cache.cpp.
+
+With `Encryption` the finished document gets its passwords and permissions just before it is
+saved: a shared user password, or one derived per document from its patient.
 
 libHaru logic addressed in this example
 ---------------------------------------
 - Text placement is absolute; we use measured y offsets to maintain clean medical-report spacing.
-- Horizontal rules are plain vector strokes (`MoveTo` + `LineTo` + `Stroke`).
+- Helvetica text is in StandardEncoding (bullets are 0xB7). With a TrueTypeFontSet the report
+  is drawn in those fonts with UTF-8 text instead, so any patient name renders; centered and
+  right-aligned labels are then re-measured at draw time.
+- Horizontal rules are plain vector strokes (`MoveTo` + `LineTo` + `Stroke`); all drawing goes
+  through `detail::PageWriter`, so the findings block shares one text object.
 - Visual bands are filled rectangles to create report identity strips.
 - Placeholder imaging area is drawn as an unfilled square, as requested.
+- Frames come in as borrowed memory: raw Gray8/RGB8 rows go through
+  `HPDF_LoadRawImageFromMem`, JPEG bytes through `HPDF_LoadJpegImageFromMem`, which embeds the
+  DCT stream unchanged (no decode/re-encode). libHaru copies the bytes into its own stream
+  once; frames that need preparing pass through one reused scratch buffer first.
+- `HPDF_LoadRawImageFromMem` takes 8 bits per component, hence the Gray16 window.
+- `HPDF_SetPassword` turns on encryption, `HPDF_SetPermission` restricts the user password and
+  `HPDF_SetEncryptionMode(HPDF_ENCRYPT_R3, 16)` selects 128-bit RC4, the strongest mode
+  libHaru offers (it has no AES). The key is derived and every string and stream encrypted
+  during `HPDF_SaveToStream`, so the cost lands in the Serialize phase.
+- Multi-report documents draw the static chrome once into its own content stream
+  (`HPDF_Page_New_Content_Stream`) and attach that stream to every further page with
+  `HPDF_Page_Insert_Shared_Content_Stream`; only patient fields are emitted per page.
 */
 #include "libharu_examples/clinical_report_example.h"
 
 #include <hpdf.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "font_face.h"
+#include "font_width_tables.h"
+#include "image_kernels.h"
+#include "page_geometry.h"
+#include "page_writer.h"
+#include "pdf_document.h"
+#include "render_cache_state.h"
+#include "sha256.h"
 
 namespace libharu_examples {
 namespace {
 
-void error_handler(HPDF_STATUS, HPDF_STATUS, void*) {
+constexpr detail::RgbColor kBrandBlue{0.06F, 0.23F, 0.56F};
+constexpr detail::RgbColor kBodyInk{0.1F, 0.1F, 0.1F};
+constexpr detail::RgbColor kRuleGray{0.75F, 0.75F, 0.78F};
+constexpr detail::RgbColor kBoxGray{0.2F, 0.2F, 0.2F};
+
+void draw_hline(detail::PageWriter& writer, const float x1, const float x2, const float y) {
+  writer.set_line_width(0.8F);
+  writer.set_stroke(kRuleGray);
+  writer.line(x1, y, x2, y);
 }
 
-void draw_text(HPDF_Page page,
-               HPDF_Font font,
-               const float size,
-               const float x,
-               const float y,
-               const std::string& text) {
-  HPDF_Page_BeginText(page);
-  HPDF_Page_SetFontAndSize(page, font, size);
-  HPDF_Page_TextOut(page, x, y, text.c_str());
-  HPDF_Page_EndText(page);
+bool valid_report_inputs(const ClinicalReportExample::Patient& patient,
+                         const ClinicalReportExample::ReferringDoctor& doctor) {
+  return !patient.full_name.empty() && !patient.patient_id.empty() && !doctor.name.empty();
 }
 
-void draw_hline(HPDF_Page page, const float x1, const float x2, const float y) {
-  HPDF_Page_SetLineWidth(page, 0.8F);
-  HPDF_Page_SetRGBStroke(page, 0.75F, 0.75F, 0.78F);
-  HPDF_Page_MoveTo(page, x1, y);
-  HPDF_Page_LineTo(page, x2, y);
-  HPDF_Page_Stroke(page);
+constexpr float kGap = 10.0F;
+constexpr float kFrameGap = 4.0F;
+constexpr float kFooterRuleY = 95.0F;
+
+constexpr const char* kPlaceholderLabel = "Ultrasound image placeholder";
+// Helvetica draws in StandardEncoding, which has the bullet at 0xB7; TrueType faces take the
+// UTF-8 bullet.
+constexpr const char* kStandardBullet = "\xB7 ";
+constexpr const char* kUtf8Bullet = "\xE2\x80\xA2 ";
+// Revision 3 of the standard security handler with its longest (128-bit) RC4 key.
+constexpr HPDF_UINT kEncryptionKeyBytes = 16;
+constexpr const char* kWidestFinding =
+    "Both kidneys are visualized and normal in size, shape and echotexture.";
+constexpr const char* kImpression = "NO SIGNIFICANT ABNORMALITY DETECTED";
+constexpr const char* kRadiologist = "Dr. Vimal Shah";
+
+constexpr float width_of(const StandardFont font, const std::string_view text, const float size) {
+  return detail::static_text_width(font, text, size);
 }
 
-}  // namespace
+// Every coordinate of the report for one portrait page format, fixed at compile time. The
+// findings stack down from the header; the imaging box sits beside the impression and advice
+// blocks, as large as the space above the footer allows (at most 250 pt). Landscape pages are
+// too short for the findings stack, so they have no layout.
+template <PageFormat Format>
+struct ReportLayout {
+  static constexpr detail::PageGeometry kPage = detail::page_geometry(Format);
+  static constexpr float kWidth = kPage.width;
+  static constexpr float kHeight = kPage.height;
+  static constexpr float kLeft = 40.0F;
+  static constexpr float kRight = kWidth - 40.0F;
 
-bool ClinicalReportExample::create_clinical_report_pdf(const Patient& patient,
-                                                       const ReferringDoctor& doctor,
-                                                       const std::string& output_pdf_path) const {
-  // Step 1: Validate minimal required payload before allocating libHaru objects.
-  if (output_pdf_path.empty() || patient.full_name.empty() || patient.patient_id.empty() ||
-      doctor.name.empty()) {
+  // Patient strip: name block on the left, PID / referrer captions and values on the right.
+  static constexpr float kCaptionX = kLeft + 290.0F;
+  static constexpr float kCaptionValueX = kLeft + 360.0F;
+  static constexpr float kCaptionValueWidth = kRight - kCaptionValueX;
+  static constexpr float kPatientWidth = kCaptionX - kGap - kLeft;
+
+  static constexpr float kExamTitleX =
+      (kWidth - width_of(StandardFont::HelveticaBold, "ULTRASOUND KUB", 36.0F)) / 2.0F;
+  static constexpr float kFindingsTop = kHeight - 305.0F;
+  static constexpr float kImpressionY = kHeight - 479.0F;
+  static constexpr float kAdviceY = kHeight - 555.0F;
+
+  // Imaging box beside the impression/advice text, clear of the footer rule.
+  static constexpr float kImageLeftLimit =
+      kLeft + width_of(StandardFont::HelveticaBold, kImpression, 13.0F) + 2.0F * kGap;
+  static constexpr float kImageTop = kImpressionY + 12.0F;
+  static constexpr float kImageBoxSize =
+      std::min({250.0F, kRight - kImageLeftLimit, kImageTop - kFooterRuleY - 2.0F * kGap});
+  static constexpr float kImageBoxX = kRight - kImageBoxSize;
+  static constexpr float kImageBoxY = kImageTop - kImageBoxSize;
+  static constexpr float kPlaceholderX =
+      kImageBoxX +
+      (kImageBoxSize - width_of(StandardFont::Helvetica, kPlaceholderLabel, 11.0F)) / 2.0F;
+
+  // Footer: captions left, centered end marker, referrer and radiologist signatures.
+  static constexpr float kEndMarkerX =
+      (kWidth - width_of(StandardFont::Helvetica, "****End of Report****", 11.0F)) / 2.0F;
+  static constexpr float kReferrerX = kLeft + 240.0F;
+  static constexpr float kRadiologistX =
+      kRight - width_of(StandardFont::HelveticaBold, kRadiologist, 11.0F);
+  static constexpr float kReferrerWidth = kRadiologistX - kGap - kReferrerX;
+
+  // Contact sheets: a title and patient line, then the frame grid down to the footer rule.
+  static constexpr float kSheetTitleY = kHeight - 60.0F;
+  static constexpr float kSheetPatientY = kHeight - 84.0F;
+  static constexpr float kSheetRuleY = kHeight - 98.0F;
+  static constexpr float kSheetTop = kSheetRuleY - kGap;
+  static constexpr float kSheetBottom = kFooterRuleY + kGap;
+
+  static_assert(!kPage.landscape(), "clinical reports are portrait only");
+  static_assert(kLeft + width_of(StandardFont::HelveticaBold, "DRLOGY IMAGING CENTER", 28.0F) <=
+                    kRight,
+                "brand title crosses the right margin");
+  static_assert(kCaptionX + width_of(StandardFont::HelveticaBold, "Ref. By", 14.0F) + kGap <=
+                    kCaptionValueX,
+                "captions run into their values");
+  static_assert(kExamTitleX >= kLeft, "exam title crosses the margins");
+  static_assert(kLeft + 10.0F + width_of(StandardFont::Helvetica, kStandardBullet, 12.0F) +
+                        width_of(StandardFont::Helvetica, kWidestFinding, 12.0F) <=
+                    kRight,
+                "findings cross the right margin");
+  static_assert(kImageBoxSize >= 200.0F, "imaging box too small");
+  static_assert(kAdviceY - 20.0F > kFooterRuleY + kGap, "advice runs into the footer");
+  static_assert(kLeft + width_of(StandardFont::HelveticaBold, "Radiologic Technologists", 11.0F) +
+                        kGap <=
+                    kReferrerX,
+                "footer captions run into the referrer");
+  static_assert(kReferrerWidth >= 100.0F, "referrer signature too narrow");
+  static_assert(kSheetTop - kSheetBottom >= 2.0F * kImageBoxSize,
+                "contact sheets hold less than two imaging boxes of height");
+};
+
+// Only portrait formats have a report layout.
+template <PageFormat Format>
+constexpr bool kHasReportLayout = !detail::page_geometry(Format).landscape();
+
+// Instantiates `render` for the compile-time layout of `format`; false for formats without one.
+template <typename RenderFn>
+bool with_report_layout(const PageFormat format, RenderFn&& render) {
+  return detail::dispatch_page_format(format, [&render](auto tag) {
+    if constexpr (kHasReportLayout<decltype(tag)::value>) {
+      return render(ReportLayout<decltype(tag)::value>{});
+    } else {
+      return false;
+    }
+  });
+}
+
+using ImageFrame = ClinicalReportExample::ImageFrame;
+
+bool valid_frame(const ImageFrame& frame) {
+  if (frame.data == nullptr || frame.size == 0 ||
+      frame.size > std::numeric_limits<HPDF_UINT>::max()) {
     return false;
   }
+  if (frame.format == ImageFrame::Format::Jpeg) {
+    return true;
+  }
+  std::uint64_t bytes_per_pixel = 1;
+  if (frame.format == ImageFrame::Format::Rgb8) {
+    bytes_per_pixel = 3;
+  } else if (frame.format == ImageFrame::Format::Gray16) {
+    bytes_per_pixel = 2;
+    if (!std::isfinite(frame.window_center) || !std::isfinite(frame.window_width) ||
+        frame.window_width <= 0.0F) {
+      return false;
+    }
+  }
+  return frame.width > 0 && frame.height > 0 &&
+         frame.size >= std::uint64_t{frame.width} * frame.height * bytes_per_pixel;
+}
 
-  // Step 2: Initialize libHaru document and a single A4 page to host the report.
-  HPDF_Doc pdf = HPDF_New(error_handler, nullptr);
-  if (pdf == nullptr) {
-    return false;
+bool valid_frames(const std::vector<ImageFrame>& frames) {
+  return std::all_of(frames.begin(), frames.end(), valid_frame);
+}
+
+using ImageOptions = ClinicalReportExample::ImageOptions;
+
+bool valid_image_options(const ImageOptions& options) {
+  return std::isfinite(options.dpi) && options.dpi >= 0.0F &&
+         (options.box_frames == 0 || (options.sheet_columns > 0 && options.sheet_rows > 0));
+}
+
+using Encryption = ClinicalReportExample::Encryption;
+using Passwords = Encryption::Passwords;
+
+bool valid_encryption(const Encryption& encryption) {
+  switch (encryption.passwords) {
+    case Passwords::None:
+      return true;
+    case Passwords::Shared:
+      return !encryption.owner_password.empty() &&
+             encryption.user_password != encryption.owner_password;
+    case Passwords::PerDocument:
+      return !encryption.owner_password.empty() && bool(encryption.user_password_for);
   }
+  return false;
+}
 
-  HPDF_Page page = HPDF_AddPage(pdf);
-  if (page == nullptr) {
-    HPDF_Free(pdf);
+// Reports rendered before are only served from the render cache when unencrypted: an
+// encrypted document's bytes depend on libHaru's time-based file ID, and its key on secrets
+// the cache key should not carry.
+bool cacheable(const Encryption& encryption) {
+  return detail::cache_active() && encryption.passwords == Passwords::None;
+}
+
+// Turns on the standard security handler before the document is saved; libHaru derives the
+// key and encrypts every string and stream while serializing.
+bool apply_encryption(HPDF_Doc pdf,
+                      const Encryption& encryption,
+                      const ClinicalReportExample::Patient& patient) {
+  if (encryption.passwords == Passwords::None) {
+    return true;
+  }
+  const std::string user_password = encryption.passwords == Passwords::Shared
+                                        ? encryption.user_password
+                                        : encryption.user_password_for(patient);
+  if (user_password == encryption.owner_password) {
     return false;
   }
 
-  HPDF_Page_SetSize(page, HPDF_PAGE_SIZE_A4, HPDF_PAGE_PORTRAIT);
+  HPDF_UINT permission = HPDF_ENABLE_READ;
+  if (encryption.allow_print) {
+    permission |= HPDF_ENABLE_PRINT;
+  }
+  if (encryption.allow_copy) {
+    permission |= HPDF_ENABLE_COPY;
+  }
+  if (encryption.allow_edit) {
+    permission |= HPDF_ENABLE_EDIT | HPDF_ENABLE_EDIT_ALL;
+  }
+  return HPDF_SetPassword(pdf, encryption.owner_password.c_str(), user_password.c_str()) ==
+             HPDF_OK &&
+         HPDF_SetPermission(pdf, permission) == HPDF_OK &&
+         HPDF_SetEncryptionMode(pdf, HPDF_ENCRYPT_R3, kEncryptionKeyBytes) == HPDF_OK;
+}
+
+// Images already embedded in the current document, keyed by the borrowed bytes and the
+// preparation applied, so a frame shared by several reports in one document is stored once.
+// Prepared pixels go through one scratch buffer that libHaru copies from.
+class FrameCache {
+ public:
+  explicit FrameCache(HPDF_Doc pdf) : pdf_(pdf) {}
 
-  HPDF_Font bold_font = HPDF_GetFont(pdf, "Helvetica-Bold", nullptr);
-  HPDF_Font regular_font = HPDF_GetFont(pdf, "Helvetica", nullptr);
+  // `factor` > 1 area-averages a raw frame by that factor before embedding it; Gray16 frames
+  // are always windowed down to 8 bits. JPEG frames ignore `factor`.
+  HPDF_Image load(const ImageFrame& frame, const unsigned factor) {
+    for (const Entry& entry : images_) {
+      const ImageFrame& cached = entry.frame;
+      if (cached.data == frame.data && cached.size == frame.size &&
+          cached.format == frame.format && cached.width == frame.width &&
+          cached.height == frame.height && cached.window_center == frame.window_center &&
+          cached.window_width == frame.window_width && entry.factor == factor) {
+        return entry.image;
+      }
+    }
 
-  const float width = HPDF_Page_GetWidth(page);
-  const float height = HPDF_Page_GetHeight(page);
-  const float left = 40.0F;
-  const float right = width - 40.0F;
+    HPDF_Image image = nullptr;
+    switch (frame.format) {
+      case ImageFrame::Format::Jpeg:
+        image = HPDF_LoadJpegImageFromMem(pdf_, frame.data, static_cast<HPDF_UINT>(frame.size));
+        break;
+      case ImageFrame::Format::Rgb8:
+        image = load_raw(frame, factor, 3, HPDF_CS_DEVICE_RGB);
+        break;
+      case ImageFrame::Format::Gray8:
+        image = load_raw(frame, factor, 1, HPDF_CS_DEVICE_GRAY);
+        break;
+      case ImageFrame::Format::Gray16:
+        image = load_gray16(frame, factor);
+        break;
+    }
+    if (image != nullptr) {
+      images_.push_back({frame, factor, image});
+    }
+    return image;
+  }
+
+ private:
+  struct Entry {
+    ImageFrame frame;
+    unsigned factor;
+    HPDF_Image image;
+  };
+
+  HPDF_Image load_raw(const ImageFrame& frame,
+                      const unsigned factor,
+                      const unsigned channels,
+                      const HPDF_ColorSpace color_space) {
+    if (factor <= 1) {
+      return HPDF_LoadRawImageFromMem(
+          pdf_, frame.data, frame.width, frame.height, color_space, 8);
+    }
+    const unsigned width = detail::downscaled_size(frame.width, factor);
+    const unsigned height = detail::downscaled_size(frame.height, factor);
+    pixels_.resize(std::size_t{width} * height * channels);
+    detail::downscale_u8(
+        frame.data, frame.width, frame.height, channels, factor, sums_, pixels_.data());
+    return HPDF_LoadRawImageFromMem(pdf_, pixels_.data(), width, height, color_space, 8);
+  }
+
+  // Averages first, then windows, so only the samples that are kept get mapped.
+  HPDF_Image load_gray16(const ImageFrame& frame, const unsigned factor) {
+    const unsigned char* samples = frame.data;
+    unsigned width = frame.width;
+    unsigned height = frame.height;
+    if (factor > 1) {
+      width = detail::downscaled_size(frame.width, factor);
+      height = detail::downscaled_size(frame.height, factor);
+      averaged_.resize(std::size_t{width} * height);
+      detail::downscale_u16(
+          frame.data, frame.width, frame.height, factor, sums_, averaged_.data());
+      samples = reinterpret_cast<const unsigned char*>(averaged_.data());
+    }
+    pixels_.resize(std::size_t{width} * height);
+    detail::window_level(
+        samples, pixels_.size(), frame.window_center, frame.window_width, pixels_.data());
+    return HPDF_LoadRawImageFromMem(pdf_, pixels_.data(), width, height, HPDF_CS_DEVICE_GRAY, 8);
+  }
+
+  HPDF_Doc pdf_;
+  std::vector<Entry> images_;
+  std::vector<unsigned char> pixels_;
+  std::vector<std::uint16_t> averaged_;
+  std::vector<std::uint32_t> sums_;
+};
+
+struct ReportFonts {
+  detail::FontFace bold;
+  detail::FontFace regular;
+  const char* bullet = kStandardBullet;
+
+  bool loaded() const { return bold.font() != nullptr && regular.font() != nullptr; }
+};
+
+ReportFonts load_report_fonts(HPDF_Doc pdf, const TrueTypeFontSet& truetype) {
+  ReportFonts fonts{detail::load_face(pdf, truetype, StandardFont::HelveticaBold),
+                    detail::load_face(pdf, truetype, StandardFont::Helvetica)};
+  if (fonts.regular.truetype()) {
+    fonts.bullet = kUtf8Bullet;
+  }
+  return fonts;
+}
+
+void draw_finding(detail::PageWriter& writer,
+                  const ReportFonts& fonts,
+                  const float x,
+                  const float y,
+                  const char* finding) {
+  writer.text(fonts.regular, 12.0F, x, y, fonts.bullet + std::string(finding));
+}
+
+// Static chrome shared by every report: branding, labels, findings, imaging frame and footer.
+// Nothing here depends on the patient, so it can be emitted once and reused across pages.
+template <typename Layout>
+void draw_report_template(detail::PageWriter& writer, const ReportFonts& fonts) {
+  constexpr float kHeight = Layout::kHeight;
+  constexpr float kLeft = Layout::kLeft;
 
   // Step 3: Draw top branding/header area (title + modality line + blue bar).
-  HPDF_Page_SetRGBFill(page, 0.06F, 0.23F, 0.56F);
-  draw_text(page, bold_font, 28.0F, left, height - 58.0F, "DRLOGY IMAGING CENTER");
-  HPDF_Page_SetRGBFill(page, 0.1F, 0.1F, 0.1F);
-  draw_text(page, bold_font, 14.0F, left, height - 82.0F, "X-Ray | CT-Scan | MRI | USG");
-  draw_text(page, regular_font, 10.0F, left, height - 100.0F, "Healthcare Road, Mumbai");
+  writer.set_fill(kBrandBlue);
+  writer.text(fonts.bold, 28.0F, kLeft, kHeight - 58.0F, "DRLOGY IMAGING CENTER");
+  writer.set_fill(kBodyInk);
+  writer.text(fonts.bold, 14.0F, kLeft, kHeight - 82.0F, "X-Ray | CT-Scan | MRI | USG");
+  writer.text(fonts.regular, 10.0F, kLeft, kHeight - 100.0F, "Healthcare Road, Mumbai");
 
-  HPDF_Page_SetRGBFill(page, 0.06F, 0.23F, 0.56F);
-  HPDF_Page_Rectangle(page, 0.0F, height - 126.0F, width, 18.0F);
-  HPDF_Page_Fill(page);
+  writer.set_fill(kBrandBlue);
+  writer.fill_rectangle(0.0F, kHeight - 126.0F, Layout::kWidth, 18.0F);
 
-  // Step 4: Draw patient/referring-doctor summary strip.
-  HPDF_Page_SetRGBFill(page, 0.1F, 0.1F, 0.1F);
-  draw_text(page, bold_font, 16.0F, left, height - 170.0F, patient.full_name);
-  draw_text(page,
-            regular_font,
-            12.0F,
-            left,
-            height - 192.0F,
-            "Age: " + std::to_string(patient.age) + " Years");
-  draw_text(page, regular_font, 12.0F, left, height - 210.0F, "Sex: " + patient.sex);
-
-  draw_text(page, bold_font, 14.0F, left + 290.0F, height - 170.0F, "PID");
-  draw_text(page, regular_font, 14.0F, left + 360.0F, height - 170.0F, ": " + patient.patient_id);
-  draw_text(page, bold_font, 14.0F, left + 290.0F, height - 194.0F, "Ref. By");
-  draw_text(page, regular_font, 14.0F, left + 360.0F, height - 194.0F, ": " + doctor.name);
-
-  draw_hline(page, left, right, height - 226.0F);
+  // Step 4 (labels): Patient/referring-doctor strip captions; values come per patient.
+  writer.set_fill(kBodyInk);
+  writer.text(fonts.bold, 14.0F, Layout::kCaptionX, kHeight - 170.0F, "PID");
+  writer.text(fonts.bold, 14.0F, Layout::kCaptionX, kHeight - 194.0F, "Ref. By");
+
+  draw_hline(writer, kLeft, Layout::kRight, kHeight - 226.0F);
 
   // Step 5: Draw central exam title and narrative findings sections.
-  draw_text(page, bold_font, 36.0F, left + 160.0F, height - 272.0F, "ULTRASOUND KUB");
+  constexpr const char* kExamTitle = "ULTRASOUND KUB";
+  writer.text(fonts.bold,
+              36.0F,
+              fonts.bold.centered(Layout::kExamTitleX, kExamTitle, 36.0F),
+              kHeight - 272.0F,
+              kExamTitle);
 
   // Findings sections
-  float y = height - 305.0F;
-  draw_text(page, bold_font, 13.0F, left, y, "KIDNEYS");
+  float y = Layout::kFindingsTop;
+  writer.text(fonts.bold, 13.0F, kLeft, y, "KIDNEYS");
   y -= 22.0F;
-  draw_text(page,
-            regular_font,
-            12.0F,
-            left + 10.0F,
-            y,
-            "• Both kidneys are visualized and normal in size, shape and echotexture.");
+  draw_finding(writer, fonts, kLeft + 10.0F, y, kWidestFinding);
   y -= 20.0F;
-  draw_text(page,
-            regular_font,
-            12.0F,
-            left + 10.0F,
-            y,
-            "• Right kidney measures 10.0 x 3.2 cm. Left kidney measures 9.7 x 4.2 cm.");
+  draw_finding(writer,
+               fonts,
+               kLeft + 10.0F,
+               y,
+               "Right kidney measures 10.0 x 3.2 cm. Left kidney measures 9.7 x 4.2 cm.");
   y -= 20.0F;
-  draw_text(page,
-            regular_font,
-            12.0F,
-            left + 10.0F,
-            y,
-            "• No calculus, hydronephrosis, or focal lesion seen.");
+  draw_finding(
+      writer, fonts, kLeft + 10.0F, y, "No calculus, hydronephrosis, or focal lesion seen.");
 
   y -= 36.0F;
-  draw_text(page, bold_font, 13.0F, left, y, "URINARY BLADDER & UTERUS");
-  y -= 22.0F;
-  draw_text(page,
-            regular_font,
-            12.0F,
-            left + 10.0F,
-            y,
-            "• Urinary bladder is distended, lumen echo-free.");
-  y -= 20.0F;
-  draw_text(page,
-            regular_font,
-            12.0F,
-            left + 10.0F,
-            y,
-            "• Uterus appears normal in size and echotexture. Bilateral adnexa clear.");
-
-  y -= 34.0F;
-  draw_text(page, bold_font, 13.0F, left, y, "IMPRESSION");
+  writer.text(fonts.bold, 13.0F, kLeft, y, "URINARY BLADDER & UTERUS");
   y -= 22.0F;
-  draw_text(page,
-            bold_font,
-            13.0F,
-            left,
-            y,
-            "NO SIGNIFICANT ABNORMALITY DETECTED");
-
-  y -= 34.0F;
-  draw_text(page, bold_font, 13.0F, left, y, "ADVICE");
+  draw_finding(writer, fonts, kLeft + 10.0F, y, "Urinary bladder is distended, lumen echo-free.");
   y -= 20.0F;
-  draw_text(page, regular_font, 12.0F, left, y, "CLINICAL CORRELATION");
-
-  // Step 6: Reserve imaging area with an empty square placeholder (requested).
-  const float box_x = left + 170.0F;
-  const float box_y = y - 250.0F;
-  const float box_size = 250.0F;
-  HPDF_Page_SetRGBStroke(page, 0.2F, 0.2F, 0.2F);
-  HPDF_Page_SetLineWidth(page, 1.2F);
-  HPDF_Page_Rectangle(page, box_x, box_y, box_size, box_size);
-  HPDF_Page_Stroke(page);
-  draw_text(page,
-            regular_font,
-            11.0F,
-            box_x + 56.0F,
-            box_y + box_size / 2.0F,
-            "Ultrasound image placeholder");
-
-  // Step 7: Draw footer markers/signature labels and finalize output.
-  draw_hline(page, left, right, 95.0F);
-  draw_text(page, regular_font, 11.0F, left, 78.0F, "Thanks for Reference");
-  draw_text(page, regular_font, 11.0F, left + 250.0F, 78.0F, "****End of Report****");
-
-  draw_text(page, bold_font, 11.0F, left, 50.0F, "Radiologic Technologists");
-  draw_text(page, bold_font, 11.0F, left + 240.0F, 50.0F, doctor.name);
-  draw_text(page, bold_font, 11.0F, left + 450.0F, 50.0F, "Dr. Vimal Shah");
-
-  const HPDF_STATUS save_result = HPDF_SaveToFile(pdf, output_pdf_path.c_str());
-  HPDF_Free(pdf);
-
-  return save_result == HPDF_OK;
+  draw_finding(writer,
+               fonts,
+               kLeft + 10.0F,
+               y,
+               "Uterus appears normal in size and echotexture. Bilateral adnexa clear.");
+
+  writer.text(fonts.bold, 13.0F, kLeft, Layout::kImpressionY, "IMPRESSION");
+  writer.text(fonts.bold, 13.0F, kLeft, Layout::kImpressionY - 22.0F, kImpression);
+
+  writer.text(fonts.bold, 13.0F, kLeft, Layout::kAdviceY + 20.0F, "ADVICE");
+  writer.text(fonts.regular, 12.0F, kLeft, Layout::kAdviceY, "CLINICAL CORRELATION");
+
+  // Step 6: Reserve imaging area as a square; its content is drawn per report.
+  writer.set_stroke(kBoxGray);
+  writer.set_line_width(1.2F);
+  writer.stroke_rectangle(
+      Layout::kImageBoxX, Layout::kImageBoxY, Layout::kImageBoxSize, Layout::kImageBoxSize);
+
+  // Step 7: Draw footer markers/signature labels.
+  draw_hline(writer, kLeft, Layout::kRight, kFooterRuleY);
+  writer.text(fonts.regular, 11.0F, kLeft, 78.0F, "Thanks for Reference");
+  constexpr const char* kEndMarker = "****End of Report****";
+  writer.text(fonts.regular,
+              11.0F,
+              fonts.regular.centered(Layout::kEndMarkerX, kEndMarker, 11.0F),
+              78.0F,
+              kEndMarker);
+
+  writer.text(fonts.bold, 11.0F, kLeft, 50.0F, "Radiologic Technologists");
+  writer.text(fonts.bold,
+              11.0F,
+              fonts.bold.right_aligned(Layout::kRadiologistX, kRadiologist, 11.0F),
+              50.0F,
+              kRadiologist);
+}
+
+// Equal cells over a box, filled row by row from the top. Captioned grids keep
+// `caption_height` at the bottom of each cell for the frame number.
+struct FrameGrid {
+  float x;
+  float y;
+  float width;
+  float height;
+  std::size_t columns;
+  std::size_t rows;
+  float caption_height;
+};
+
+// Area-average factor that brings a frame drawn at `scale` points per pixel down to about
+// `dpi` without going below it; 1 when `dpi` is 0 or the frame is already coarser.
+unsigned downscale_factor(const float scale, const float dpi) {
+  if (dpi <= 0.0F) {
+    return 1;
+  }
+  const float factor = std::min(std::floor(72.0F / (scale * dpi)),
+                                static_cast<float>(detail::kMaxDownscaleFactor));
+  return factor > 1.0F ? static_cast<unsigned>(factor) : 1U;
+}
+
+// Draws `count` frames from `frames` into `grid`, each scaled to its cell with the aspect
+// ratio kept and prepared for `dpi` at that size. With `first_number` > 0 every frame is
+// captioned "Frame N", numbered from it.
+bool draw_frame_grid(detail::PageWriter& writer,
+                     const ReportFonts& fonts,
+                     FrameCache& cache,
+                     const ImageFrame* frames,
+                     const std::size_t count,
+                     const FrameGrid& grid,
+                     const float dpi,
+                     const std::size_t first_number) {
+  const float cell_width = (grid.width - kFrameGap) / static_cast<float>(grid.columns);
+  const float cell_height = (grid.height - kFrameGap) / static_cast<float>(grid.rows);
+  const float max_width = cell_width - kFrameGap;
+  const float max_height = cell_height - kFrameGap - grid.caption_height;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const ImageFrame& frame = frames[i];
+    // Raw frames are sized from their own dimensions, so the preparation factor is known
+    // before anything is embedded; JPEG dimensions come from the loaded image.
+    const bool raw = frame.format != ImageFrame::Format::Jpeg;
+    unsigned factor = 1;
+    if (raw) {
+      factor = downscale_factor(std::min(max_width / static_cast<float>(frame.width),
+                                         max_height / static_cast<float>(frame.height)),
+                                dpi);
+    }
+    HPDF_Image image = cache.load(frame, factor);
+    if (image == nullptr) {
+      return false;
+    }
+    const auto image_width = static_cast<float>(raw ? frame.width : HPDF_Image_GetWidth(image));
+    const auto image_height =
+        static_cast<float>(raw ? frame.height : HPDF_Image_GetHeight(image));
+    if (image_width <= 0.0F || image_height <= 0.0F) {
+      return false;
+    }
+
+    const float scale = std::min(max_width / image_width, max_height / image_height);
+    const float width = image_width * scale;
+    const float height = image_height * scale;
+    // Rows fill from the top of the box, as they would on a contact sheet.
+    const float cell_x = grid.x + kFrameGap + static_cast<float>(i % grid.columns) * cell_width;
+    const float cell_y =
+        grid.y + grid.height - static_cast<float>(i / grid.columns + 1) * cell_height;
+    const float image_y = cell_y + grid.caption_height;
+    writer.image(image,
+                 cell_x + (max_width - width) / 2.0F,
+                 image_y + (max_height - height) / 2.0F,
+                 width,
+                 height);
+    if (first_number > 0) {
+      writer.set_fill(kBodyInk);
+      writer.text(
+          fonts.regular, 9.0F, cell_x, cell_y + 3.0F, "Frame " + std::to_string(first_number + i));
+    }
+  }
+  return true;
+}
+
+// Step 6 (content): Tile the frames over a near-square grid inside the imaging box; without
+// frames, label the empty placeholder.
+template <typename Layout>
+bool draw_imaging_area(detail::PageWriter& writer,
+                       const ReportFonts& fonts,
+                       const ImageFrame* frames,
+                       const std::size_t count,
+                       const float dpi,
+                       FrameCache& cache) {
+  constexpr float kBoxX = Layout::kImageBoxX;
+  constexpr float kBoxY = Layout::kImageBoxY;
+  constexpr float kBoxSize = Layout::kImageBoxSize;
+  if (count == 0) {
+    writer.set_fill(kBodyInk);
+    writer.text(fonts.regular,
+                11.0F,
+                fonts.regular.centered(Layout::kPlaceholderX, kPlaceholderLabel, 11.0F),
+                kBoxY + kBoxSize / 2.0F,
+                kPlaceholderLabel);
+    return true;
+  }
+
+  const auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+  const std::size_t rows = (count + columns - 1) / columns;
+  return draw_frame_grid(writer,
+                         fonts,
+                         cache,
+                         frames,
+                         count,
+                         {kBoxX, kBoxY, kBoxSize, kBoxSize, columns, rows, 0.0F},
+                         dpi,
+                         0);
+}
+
+// Frames left over from the imaging box, on pages of their own after the report: the patient
+// line on top, then a fixed grid of numbered frames.
+template <typename Layout>
+bool draw_contact_sheets(HPDF_Doc pdf,
+                         detail::PageWriter& writer,
+                         const ReportFonts& fonts,
+                         const ClinicalReportExample::Patient& patient,
+                         const std::vector<ImageFrame>& frames,
+                         const std::size_t first,
+                         const ImageOptions& options,
+                         FrameCache& cache) {
+  constexpr float kLeft = Layout::kLeft;
+  const std::size_t per_page = std::size_t{options.sheet_columns} * options.sheet_rows;
+  const FrameGrid grid{kLeft,
+                       Layout::kSheetBottom,
+                       Layout::kRight - kLeft,
+                       Layout::kSheetTop - Layout::kSheetBottom,
+                       options.sheet_columns,
+                       options.sheet_rows,
+                       14.0F};
+
+  for (std::size_t start = first; start < frames.size(); start += per_page) {
+    HPDF_Page page = detail::add_page(pdf, Layout::kPage);
+    if (page == nullptr) {
+      return false;
+    }
+    writer.reset(page);
+    const std::size_t count = std::min(per_page, frames.size() - start);
+
+    writer.set_fill(kBrandBlue);
+    writer.text(fonts.bold, 20.0F, kLeft, Layout::kSheetTitleY, "IMAGES");
+    writer.set_fill(kBodyInk);
+    writer.fitted_text(fonts.bold,
+                       12.0F,
+                       kLeft,
+                       Layout::kSheetPatientY,
+                       Layout::kPatientWidth,
+                       patient.full_name);
+    writer.fitted_text(fonts.regular,
+                       12.0F,
+                       Layout::kCaptionX,
+                       Layout::kSheetPatientY,
+                       Layout::kRight - Layout::kCaptionX,
+                       "PID: " + patient.patient_id);
+    draw_hline(writer, kLeft, Layout::kRight, Layout::kSheetRuleY);
+
+    draw_hline(writer, kLeft, Layout::kRight, kFooterRuleY);
+    writer.set_fill(kBodyInk);
+    writer.text(fonts.regular,
+                11.0F,
+                kLeft,
+                78.0F,
+                "Frames " + std::to_string(start + 1) + "-" + std::to_string(start + count) +
+                    " of " + std::to_string(frames.size()));
+
+    if (!draw_frame_grid(
+            writer, fonts, cache, &frames[start], count, grid, options.dpi, start + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The imaging box and, when `options` limits it, the contact sheets for the other frames.
+template <typename Layout>
+bool draw_report_frames(HPDF_Doc pdf,
+                        detail::PageWriter& writer,
+                        const ReportFonts& fonts,
+                        const ClinicalReportExample::Patient& patient,
+                        const std::vector<ImageFrame>& frames,
+                        const ImageOptions& options,
+                        FrameCache& cache) {
+  const std::size_t in_box =
+      options.box_frames > 0 ? std::min(options.box_frames, frames.size()) : frames.size();
+  return draw_imaging_area<Layout>(writer, fonts, frames.data(), in_box, options.dpi, cache) &&
+         draw_contact_sheets<Layout>(pdf, writer, fonts, patient, frames, in_box, options, cache);
+}
+
+// Patient-specific fields layered on top of the template, each cut to its column.
+template <typename Layout>
+void draw_patient_content(detail::PageWriter& writer,
+                          const ReportFonts& fonts,
+                          const ClinicalReportExample::Patient& patient,
+                          const ClinicalReportExample::ReferringDoctor& doctor) {
+  constexpr float kHeight = Layout::kHeight;
+  constexpr float kLeft = Layout::kLeft;
+  constexpr float kValueX = Layout::kCaptionValueX;
+  constexpr float kValueWidth = Layout::kCaptionValueWidth;
+
+  // Step 4: Draw patient/referring-doctor summary strip.
+  writer.set_fill(kBodyInk);
+  writer.fitted_text(fonts.bold,
+                     16.0F,
+                     kLeft,
+                     kHeight - 170.0F,
+                     Layout::kPatientWidth,
+                     patient.full_name);
+  writer.text(fonts.regular,
+              12.0F,
+              kLeft,
+              kHeight - 192.0F,
+              "Age: " + std::to_string(patient.age) + " Years");
+  writer.text(fonts.regular, 12.0F, kLeft, kHeight - 210.0F, "Sex: " + patient.sex);
+
+  writer.fitted_text(fonts.regular,
+                     14.0F,
+                     kValueX,
+                     kHeight - 170.0F,
+                     kValueWidth,
+                     ": " + patient.patient_id);
+  writer.fitted_text(fonts.regular,
+                     14.0F,
+                     kValueX,
+                     kHeight - 194.0F,
+                     kValueWidth,
+                     ": " + doctor.name);
+
+  // Step 7 (signature): The referring doctor signs next to the fixed footer labels.
+  writer.fitted_text(fonts.bold,
+                     11.0F,
+                     Layout::kReferrerX,
+                     50.0F,
+                     Layout::kReferrerWidth,
+                     doctor.name);
+}
+
+// Draws the full report into `pdf`, which must hold a fresh (empty) document.
+template <typename Layout>
+bool render_clinical_report(HPDF_Doc pdf,
+                            const TrueTypeFontSet& truetype,
+                            const ClinicalReportExample::Patient& patient,
+                            const ClinicalReportExample::ReferringDoctor& doctor,
+                            const std::vector<ImageFrame>& frames,
+                            const ImageOptions& options) {
+  // Step 2: Add a page to host the report; contact sheets add their own.
+  HPDF_Page page = detail::add_page(pdf, Layout::kPage);
+  if (page == nullptr) {
+    return false;
+  }
+
+  const ReportFonts fonts = load_report_fonts(pdf, truetype);
+  detail::mark_phase(detail::RenderPhase::Setup);
+  if (!fonts.loaded()) {
+    return false;
+  }
+  detail::PageWriter writer(page);
+  FrameCache cache(pdf);
+  draw_report_template<Layout>(writer, fonts);
+  draw_patient_content<Layout>(writer, fonts, patient, doctor);
+  return draw_report_frames<Layout>(pdf, writer, fonts, patient, frames, options, cache);
+}
+
+// Selecting every font once, in a fixed order, gives each page the same resource names
+// (F1, F2) that the shared template stream refers to.
+void register_report_fonts(HPDF_Page page, const ReportFonts& fonts) {
+  HPDF_Page_BeginText(page);
+  HPDF_Page_SetFontAndSize(page, fonts.bold.font(), 12.0F);
+  HPDF_Page_SetFontAndSize(page, fonts.regular.font(), 12.0F);
+  HPDF_Page_EndText(page);
+}
+
+// One page per report, plus its contact sheets. The template is drawn once into its own
+// content stream on the first page; every later report page references that same stream
+// instead of re-emitting it, and gets a fresh stream for its patient fields.
+template <typename Layout>
+bool render_clinical_reports(HPDF_Doc pdf,
+                             const TrueTypeFontSet& truetype,
+                             const std::vector<ClinicalReportExample::Report>& reports,
+                             const ImageOptions& options) {
+  HPDF_SetPagesConfiguration(pdf, 64);
+  const ReportFonts fonts = load_report_fonts(pdf, truetype);
+  detail::mark_phase(detail::RenderPhase::Setup);
+  if (!fonts.loaded()) {
+    return false;
+  }
+  HPDF_Dict template_stream = nullptr;
+  FrameCache cache(pdf);
+
+  for (const ClinicalReportExample::Report& report : reports) {
+    HPDF_Page page = detail::add_page(pdf, Layout::kPage);
+    if (page == nullptr) {
+      return false;
+    }
+    register_report_fonts(page, fonts);
+    detail::PageWriter writer(page);
+
+    if (template_stream == nullptr) {
+      if (HPDF_Page_New_Content_Stream(page, &template_stream) != HPDF_OK) {
+        return false;
+      }
+      // Bracket the template so its colors and line widths never leak into patient content.
+      HPDF_Page_GSave(page);
+      draw_report_template<Layout>(writer, fonts);
+      writer.flush();
+      HPDF_Page_GRestore(page);
+      writer.invalidate();
+    } else if (HPDF_Page_Insert_Shared_Content_Stream(page, template_stream) != HPDF_OK) {
+      return false;
+    }
+
+    if (HPDF_Page_New_Content_Stream(page, nullptr) != HPDF_OK) {
+      return false;
+    }
+    draw_patient_content<Layout>(writer, fonts, report.patient, report.doctor);
+    if (!draw_report_frames<Layout>(
+            pdf, writer, fonts, report.patient, report.frames, options, cache)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Step 1 + document lifecycle shared by the file, buffer and sink entry points.
+template <typename SaveFn>
+bool render_report_document(const PageFormat format,
+                            const TrueTypeFontSet& truetype,
+                            const ClinicalReportExample::Patient& patient,
+                            const ClinicalReportExample::ReferringDoctor& doctor,
+                            const std::vector<ImageFrame>& frames,
+                            const ImageOptions& options,
+                            const Encryption& encryption,
+                            SaveFn&& save) {
+  // Step 1: Validate minimal required payload before allocating libHaru objects.
+  if (!valid_report_inputs(patient, doctor) || !valid_frames(frames) ||
+      !valid_image_options(options) || !valid_encryption(encryption)) {
+    return false;
+  }
+
+  HPDF_Doc pdf = detail::new_document();
+  if (pdf == nullptr) {
+    return false;
+  }
+
+  const bool rendered = with_report_layout(format, [&](auto layout) {
+    return render_clinical_report<decltype(layout)>(
+        pdf, truetype, patient, doctor, frames, options);
+  });
+  detail::mark_phase(detail::RenderPhase::Draw);
+  const bool saved = rendered && apply_encryption(pdf, encryption, patient) && save(pdf);
+  detail::free_document(pdf);
+  return saved;
+}
+
+// Floats are keyed by their bits.
+void add_float(detail::FieldHash& key, const float value) {
+  std::uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  key.add(std::int64_t{bits});
+}
+
+// Serves the report from the thread's render cache, rendering into a buffer on a miss. Frame
+// bytes are part of the key, so each frame is hashed once per call.
+template <typename Output>
+bool cached_report(const PageFormat format,
+                   const TrueTypeFontSet& truetype,
+                   const ClinicalReportExample::Patient& patient,
+                   const ClinicalReportExample::ReferringDoctor& doctor,
+                   const std::vector<ImageFrame>& frames,
+                   const ImageOptions& options,
+                   Output& output) {
+  // Invalid frames may not point at their bytes; reject them before hashing.
+  if (!valid_report_inputs(patient, doctor) || !valid_frames(frames) ||
+      !valid_image_options(options)) {
+    return false;
+  }
+
+  detail::FieldHash key = detail::begin_key("clinical", format, truetype);
+  key.add(patient.full_name);
+  key.add(std::int64_t{patient.age});
+  key.add(patient.sex);
+  key.add(patient.patient_id);
+  key.add(doctor.name);
+  key.add(doctor.specialty);
+  add_float(key, options.dpi);
+  key.add(static_cast<std::int64_t>(options.box_frames));
+  key.add(std::int64_t{options.sheet_columns});
+  key.add(std::int64_t{options.sheet_rows});
+  key.add(static_cast<std::int64_t>(frames.size()));
+  for (const ImageFrame& frame : frames) {
+    key.add(static_cast<std::int64_t>(frame.format));
+    key.add(std::int64_t{frame.width});
+    key.add(std::int64_t{frame.height});
+    add_float(key, frame.window_center);
+    add_float(key, frame.window_width);
+    key.add_bytes(frame.data, frame.size);
+  }
+
+  return detail::cached_render(detail::finish_key(key), output, [&](PdfBuffer& rendered) {
+    return render_report_document(format,
+                                  truetype,
+                                  patient,
+                                  doctor,
+                                  frames,
+                                  options,
+                                  Encryption{},
+                                  [&rendered](HPDF_Doc pdf) {
+                                    return detail::save_to_buffer(pdf, rendered);
+                                  });
+  });
+}
+
+template <typename SaveFn>
+bool render_reports_document(const PageFormat format,
+                             const TrueTypeFontSet& truetype,
+                             const std::vector<ClinicalReportExample::Report>& reports,
+                             const ImageOptions& options,
+                             const Encryption& encryption,
+                             SaveFn&& save) {
+  const bool all_valid =
+      std::all_of(reports.begin(), reports.end(), [](const ClinicalReportExample::Report& r) {
+        return valid_report_inputs(r.patient, r.doctor) && valid_frames(r.frames);
+      });
+  if (reports.empty() || !all_valid || !valid_image_options(options) ||
+      !valid_encryption(encryption)) {
+    return false;
+  }
+
+  HPDF_Doc pdf = detail::new_document();
+  if (pdf == nullptr) {
+    return false;
+  }
+
+  const bool rendered = with_report_layout(format, [&](auto layout) {
+    return render_clinical_reports<decltype(layout)>(pdf, truetype, reports, options);
+  });
+  detail::mark_phase(detail::RenderPhase::Draw);
+  // One key for the whole batch.
+  const bool saved =
+      rendered && apply_encryption(pdf, encryption, reports.front().patient) && save(pdf);
+  detail::free_document(pdf);
+  return saved;
+}
+
+}  // namespace
+
+bool ClinicalReportExample::create_clinical_report_pdf(const Patient& patient,
+                                                       const ReferringDoctor& doctor,
+                                                       const std::string& output_pdf_path) const {
+  return create_clinical_report_pdf(patient, doctor, {}, output_pdf_path);
+}
+
+bool ClinicalReportExample::create_clinical_report_pdf(const Patient& patient,
+                                                       const ReferringDoctor& doctor,
+                                                       PdfBuffer& output) const {
+  return create_clinical_report_pdf(patient, doctor, {}, output);
+}
+
+bool ClinicalReportExample::create_clinical_report_pdf(const Patient& patient,
+                                                       const ReferringDoctor& doctor,
+                                                       const PdfSink& sink) const {
+  return create_clinical_report_pdf(patient, doctor, {}, sink);
+}
+
+bool ClinicalReportExample::create_clinical_report_pdf(const Patient& patient,
+                                                       const ReferringDoctor& doctor,
+                                                       const std::vector<ImageFrame>& frames,
+                                                       const std::string& output_pdf_path) const {
+  if (output_pdf_path.empty()) {
+    return false;
+  }
+  if (cacheable(encryption_)) {
+    return cached_report(format_, fonts_, patient, doctor, frames, images_, output_pdf_path);
+  }
+
+  return render_report_document(format_,
+                                fonts_,
+                                patient,
+                                doctor,
+                                frames,
+                                images_,
+                                encryption_,
+                                [&output_pdf_path](HPDF_Doc pdf) {
+                                  return detail::save_to_file(pdf, output_pdf_path);
+                                });
+}
+
+bool ClinicalReportExample::create_clinical_report_pdf(const Patient& patient,
+                                                       const ReferringDoctor& doctor,
+                                                       const std::vector<ImageFrame>& frames,
+                                                       PdfBuffer& output) const {
+  output.clear();
+  if (cacheable(encryption_)) {
+    return cached_report(format_, fonts_, patient, doctor, frames, images_, output);
+  }
+  return render_report_document(
+      format_, fonts_, patient, doctor, frames, images_, encryption_, [&output](HPDF_Doc pdf) {
+        return detail::save_to_buffer(pdf, output);
+      });
+}
+
+bool ClinicalReportExample::create_clinical_report_pdf(const Patient& patient,
+                                                       const ReferringDoctor& doctor,
+                                                       const std::vector<ImageFrame>& frames,
+                                                       const PdfSink& sink) const {
+  if (!sink) {
+    return false;
+  }
+  if (cacheable(encryption_)) {
+    return cached_report(format_, fonts_, patient, doctor, frames, images_, sink);
+  }
+
+  return render_report_document(
+      format_, fonts_, patient, doctor, frames, images_, encryption_, [&sink](HPDF_Doc pdf) {
+        return detail::save_to_sink(pdf, sink);
+      });
+}
+
+bool ClinicalReportExample::create_clinical_reports_pdf(const std::vector<Report>& reports,
+                                                        const std::string& output_pdf_path) const {
+  if (output_pdf_path.empty()) {
+    return false;
+  }
+
+  return render_reports_document(
+      format_, fonts_, reports, images_, encryption_, [&output_pdf_path](HPDF_Doc pdf) {
+        return detail::save_to_file(pdf, output_pdf_path);
+      });
+}
+
+bool ClinicalReportExample::create_clinical_reports_pdf(const std::vector<Report>& reports,
+                                                        PdfBuffer& output) const {
+  output.clear();
+  return render_reports_document(
+      format_, fonts_, reports, images_, encryption_, [&output](HPDF_Doc pdf) {
+        return detail::save_to_buffer(pdf, output);
+      });
 }
 
 }  // namespace libharu_examples
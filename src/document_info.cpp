@@ -0,0 +1,72 @@
+/*
+High-level overview
+-------------------
+Reproducible document metadata. Two renders of the same inputs should produce the same bytes,
+so a cache can hand out stored documents and a build can diff its output. libHaru itself adds
+no clock reading or random ID to an unencrypted document; what varies is the Producer string
+(the libHaru version) and any dates a caller sets.
+
+1) `ScopedDocumentInfo` points the thread-local `active_info` at the caller's values.
+2) `new_document`/`reset_document` (src/pdf_document.cpp) call `apply_document_info` on every
+   fresh or recycled document, so the kept document of a RenderContext is covered too.
+
+libHaru logic addressed in this file
+------------------------------------
+- `HPDF_SetInfoAttr` sets the string entries of the Info dictionary.
+- `HPDF_SetInfoDateAttr` sets CreationDate from an `HPDF_Date`; 'Z' marks it as UTC.
+- Encrypted documents still get a file ID that libHaru derives from the time of day; they
+  cannot be byte-for-byte reproducible.
+*/
+#include "document_info_state.h"
+
+namespace libharu_examples {
+namespace detail {
+
+thread_local const DocumentInfo* active_info = nullptr;
+
+namespace {
+
+void set_text(HPDF_Doc pdf, const HPDF_InfoType type, const std::string& value) {
+  if (!value.empty()) {
+    HPDF_SetInfoAttr(pdf, type, value.c_str());
+  }
+}
+
+}  // namespace
+
+void apply_document_info(HPDF_Doc pdf) {
+  const DocumentInfo* info = active_info;
+  if (info == nullptr || pdf == nullptr) {
+    return;
+  }
+  set_text(pdf, HPDF_INFO_PRODUCER, info->producer);
+  set_text(pdf, HPDF_INFO_CREATOR, info->creator);
+  set_text(pdf, HPDF_INFO_AUTHOR, info->author);
+  set_text(pdf, HPDF_INFO_TITLE, info->title);
+  set_text(pdf, HPDF_INFO_SUBJECT, info->subject);
+  if (info->creation_date) {
+    const DocumentDate& date = *info->creation_date;
+    HPDF_Date value{};
+    value.year = date.year;
+    value.month = date.month;
+    value.day = date.day;
+    value.hour = date.hour;
+    value.minutes = date.minute;
+    value.seconds = date.second;
+    value.ind = 'Z';
+    HPDF_SetInfoDateAttr(pdf, HPDF_INFO_CREATION_DATE, value);
+  }
+}
+
+}  // namespace detail
+
+ScopedDocumentInfo::ScopedDocumentInfo(const DocumentInfo& info)
+    : previous_(detail::active_info) {
+  detail::active_info = &info;
+}
+
+ScopedDocumentInfo::~ScopedDocumentInfo() {
+  detail::active_info = previous_;
+}
+
+}  // namespace libharu_examples
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "libharu_examples/document_info.h"
+
+#include <hpdf.h>
+
+namespace libharu_examples {
+namespace detail {
+
+extern thread_local const DocumentInfo* active_info;
+
+// Writes the active DocumentInfo into `pdf`; a no-op without a ScopedDocumentInfo.
+void apply_document_info(HPDF_Doc pdf);
+
+}  // namespace detail
+}  // namespace libharu_examples
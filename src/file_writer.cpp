@@ -0,0 +1,430 @@
+/*
+High-level overview
+-------------------
+Durable file output for every renderer. A document never goes straight to its path:
+
+1) `begin_file` creates `<path>.<pid>.<n>.tmp` exclusively in the target directory, so the
+   rename below stays within one file system.
+2) Bytes are collected in one user-space buffer (1 MiB by default) and written when it fills
+   or the file ends, so a typical invoice costs a single `write` instead of the many small
+   writes libHaru's own file stream issues.
+3) `finish_file` applies the FsyncPolicy: Never closes and renames; PerFile fsyncs the file,
+   renames it and fsyncs the directory; PerBatch keeps the descriptor open and stages the
+   file. `commit_staged` fsyncs the staged files back to back, renames them all and fsyncs
+   each directory once, so a batch pays one directory sync instead of one per file. A file
+   counts as written only once its directory is synced; if that sync fails the file is
+   already in place, so it is reported as failed but not removed.
+4) Any failure removes the temporary file. Leftover `.tmp` files only come from a process
+   that died before publishing them; they never carry the final name.
+
+POSIX uses `open`/`write`/`fsync`; other platforms use the CRT equivalents and skip the
+directory sync, which they cannot express.
+
+libHaru logic addressed in this file
+------------------------------------
+- None directly: `save_to_file` (src/pdf_document.cpp) serializes with `HPDF_SaveToStream`
+  and reads the stream into this writer's buffer, replacing `HPDF_SaveToFile`.
+*/
+#include "libharu_examples/file_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include "file_writer_state.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <sys/stat.h>
+#endif
+
+namespace libharu_examples {
+namespace detail {
+
+thread_local WriterState* active_writer = nullptr;
+
+namespace {
+
+constexpr std::size_t kMinBufferBytes = 4U * 1024U;
+// Pieces handed to a FileFill stay within 32 bits (libHaru reads with HPDF_UINT32 sizes).
+constexpr std::size_t kMaxBufferBytes = std::size_t{1} << 30;
+constexpr int kNameAttempts = 16;
+
+std::atomic<unsigned long> temporary_sequence{0};
+
+#if !defined(_WIN32)
+
+int open_exclusive(const std::string& path) {
+  return ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+}
+
+long write_some(const int fd, const unsigned char* data, const std::size_t size) {
+  long written;
+  do {
+    written = static_cast<long>(::write(fd, data, size));
+  } while (written < 0 && errno == EINTR);
+  return written;
+}
+
+bool sync_descriptor(const int fd) {
+  return ::fsync(fd) == 0;
+}
+
+bool close_descriptor(const int fd) {
+  return ::close(fd) == 0;
+}
+
+bool sync_directory(WriterState& writer, const std::string& directory) {
+  const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  ++writer.stats.fsync_calls;
+  const bool synced = ::fsync(fd) == 0;
+  ::close(fd);
+  return synced;
+}
+
+unsigned long process_id() {
+  return static_cast<unsigned long>(::getpid());
+}
+
+#else
+
+int open_exclusive(const std::string& path) {
+  return ::_open(path.c_str(),
+                 _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY | _O_NOINHERIT,
+                 _S_IREAD | _S_IWRITE);
+}
+
+long write_some(const int fd, const unsigned char* data, const std::size_t size) {
+  const auto chunk = static_cast<unsigned int>(std::min<std::size_t>(size, 1U << 30));
+  return static_cast<long>(::_write(fd, data, chunk));
+}
+
+bool sync_descriptor(const int fd) {
+  return ::_commit(fd) == 0;
+}
+
+bool close_descriptor(const int fd) {
+  return ::_close(fd) == 0;
+}
+
+bool sync_directory(WriterState&, const std::string&) {
+  return true;
+}
+
+unsigned long process_id() {
+  return static_cast<unsigned long>(::_getpid());
+}
+
+#endif
+
+bool write_all(WriterState& writer, const int fd, const unsigned char* data, std::size_t size) {
+  while (size > 0) {
+    ++writer.stats.write_calls;
+    const long written = write_some(fd, data, size);
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+bool sync_file(WriterState& writer, const int fd) {
+  ++writer.stats.fsync_calls;
+  return sync_descriptor(fd);
+}
+
+std::string directory_of(const std::string& path) {
+  const std::string parent = std::filesystem::path(path).parent_path().string();
+  return parent.empty() ? std::string(".") : parent;
+}
+
+void remove_temporary(const std::string& temporary) {
+  std::error_code error;
+  std::filesystem::remove(temporary, error);
+}
+
+// Drops a file that will not be published: its descriptor and its temporary name.
+void discard(WriterState& writer, WriterState::Staged& file) {
+  if (file.fd >= 0) {
+    close_descriptor(file.fd);
+    file.fd = -1;
+  }
+  remove_temporary(file.temporary);
+  ++writer.stats.failed;
+}
+
+void discard_current(WriterState& writer) {
+  if (writer.current.fd >= 0) {
+    discard(writer, writer.current);
+  }
+  writer.buffered = 0;
+}
+
+bool flush_buffer(WriterState& writer) {
+  const bool written =
+      write_all(writer, writer.current.fd, writer.buffer.data(), writer.buffered);
+  writer.buffered = 0;
+  return written;
+}
+
+// The descriptor is already closed. The caller counts the file once it is durable enough
+// for the policy.
+bool rename_into_place(WriterState& writer, const WriterState::Staged& file) {
+  std::error_code error;
+  std::filesystem::rename(file.temporary, file.path, error);
+  if (error) {
+    remove_temporary(file.temporary);
+    ++writer.stats.failed;
+    return false;
+  }
+  return true;
+}
+
+void count_published(WriterState& writer, const WriterState::Staged& file) {
+  ++writer.stats.files;
+  writer.stats.bytes += file.bytes;
+}
+
+}  // namespace
+
+WriterState::WriterState(FileWriterOptions writer_options) : options(writer_options) {}
+
+WriterState::~WriterState() {
+  discard_current(*this);
+  commit_staged(*this);
+}
+
+WriterState& current_writer() {
+  if (active_writer != nullptr) {
+    return *active_writer;
+  }
+  thread_local WriterState fallback(FileWriterOptions{FsyncPolicy::Never});
+  return fallback;
+}
+
+bool begin_file(WriterState& writer, const std::string& path) {
+  discard_current(writer);
+  if (path.empty()) {
+    ++writer.stats.failed;
+    errno = ENOENT;
+    return false;
+  }
+
+  // Step 1: A fresh temporary name; O_EXCL skips names a crashed process left behind.
+  const std::string prefix = path + "." + std::to_string(process_id()) + ".";
+  for (int attempt = 0; attempt < kNameAttempts; ++attempt) {
+    std::string temporary = prefix + std::to_string(++temporary_sequence) + ".tmp";
+    const int fd = open_exclusive(temporary);
+    if (fd >= 0) {
+      writer.current = {fd, std::move(temporary), path, 0};
+      return true;
+    }
+    if (errno != EEXIST) {
+      break;
+    }
+  }
+  ++writer.stats.failed;
+  return false;
+}
+
+bool append_file(WriterState& writer, std::size_t size, const FileFill& fill) {
+  if (writer.current.fd < 0) {
+    return false;
+  }
+  if (writer.buffer.empty()) {
+    writer.buffer.resize(
+        std::clamp(writer.options.buffer_bytes, kMinBufferBytes, kMaxBufferBytes));
+  }
+
+  // Step 2: Fill the buffer in place and write it out only when it is full.
+  writer.current.bytes += size;
+  while (size > 0) {
+    if (writer.buffered == writer.buffer.size() && !flush_buffer(writer)) {
+      discard_current(writer);
+      return false;
+    }
+    const std::size_t piece = std::min(size, writer.buffer.size() - writer.buffered);
+    if (!fill(writer.buffer.data() + writer.buffered, piece)) {
+      discard_current(writer);
+      return false;
+    }
+    writer.buffered += piece;
+    size -= piece;
+  }
+  return true;
+}
+
+bool finish_file(WriterState& writer) {
+  if (writer.current.fd < 0) {
+    return false;
+  }
+  if (writer.buffered > 0 && !flush_buffer(writer)) {
+    discard_current(writer);
+    return false;
+  }
+  WriterState::Staged file = std::move(writer.current);
+  writer.current = {};
+
+  // Step 3: Publish according to the policy.
+  switch (writer.options.fsync) {
+    case FsyncPolicy::Never: {
+      const bool closed = close_descriptor(file.fd);
+      file.fd = -1;
+      if (!closed) {
+        discard(writer, file);
+        return false;
+      }
+      if (!rename_into_place(writer, file)) {
+        return false;
+      }
+      count_published(writer, file);
+      return true;
+    }
+    case FsyncPolicy::PerFile: {
+      const bool synced = sync_file(writer, file.fd) && close_descriptor(file.fd);
+      file.fd = -1;
+      if (!synced) {
+        discard(writer, file);
+        return false;
+      }
+      if (!rename_into_place(writer, file)) {
+        return false;
+      }
+      // The file is already in place, but its name may not survive a power loss.
+      if (!sync_directory(writer, directory_of(file.path))) {
+        ++writer.stats.failed;
+        return false;
+      }
+      count_published(writer, file);
+      return true;
+    }
+    case FsyncPolicy::PerBatch:
+      writer.staged.push_back(std::move(file));
+      if (writer.staged.size() >= std::max<std::size_t>(writer.options.batch_files, 1)) {
+        commit_staged(writer);
+      }
+      return true;
+  }
+  return false;
+}
+
+void abort_file(WriterState& writer) {
+  discard_current(writer);
+}
+
+bool write_file(WriterState& writer,
+                const std::string& path,
+                const unsigned char* data,
+                const std::size_t size) {
+  if (!begin_file(writer, path)) {
+    return false;
+  }
+  writer.current.bytes = size;
+  if (!write_all(writer, writer.current.fd, data, size)) {
+    discard_current(writer);
+    return false;
+  }
+  return finish_file(writer);
+}
+
+bool commit_staged(WriterState& writer) {
+  if (writer.staged.empty()) {
+    return true;
+  }
+
+  // Step 4: Every file's data reaches the disk before any of them is renamed, then each
+  // directory is synced once for all the renames in it.
+  bool committed = true;
+  for (WriterState::Staged& file : writer.staged) {
+    const bool synced = sync_file(writer, file.fd) && close_descriptor(file.fd);
+    file.fd = -1;
+    if (!synced) {
+      discard(writer, file);
+      file.temporary.clear();  // skipped by the rename pass
+      committed = false;
+    }
+  }
+  // Renamed files remember their directory's index; they count as published once it syncs.
+  constexpr std::size_t kNotRenamed = static_cast<std::size_t>(-1);
+  std::vector<std::string> directories;
+  std::vector<std::size_t> renamed(writer.staged.size(), kNotRenamed);
+  for (std::size_t i = 0; i < writer.staged.size(); ++i) {
+    const WriterState::Staged& file = writer.staged[i];
+    if (file.temporary.empty()) {
+      continue;
+    }
+    if (!rename_into_place(writer, file)) {
+      committed = false;
+      continue;
+    }
+    std::string directory = directory_of(file.path);
+    const auto found = std::find(directories.begin(), directories.end(), directory);
+    renamed[i] = static_cast<std::size_t>(found - directories.begin());
+    if (found == directories.end()) {
+      directories.push_back(std::move(directory));
+    }
+  }
+  std::vector<bool> synced;
+  for (const std::string& directory : directories) {
+    synced.push_back(sync_directory(writer, directory));
+  }
+  for (std::size_t i = 0; i < writer.staged.size(); ++i) {
+    if (renamed[i] == kNotRenamed) {
+      continue;
+    }
+    if (synced[renamed[i]]) {
+      count_published(writer, writer.staged[i]);
+    } else {
+      ++writer.stats.failed;
+      committed = false;
+    }
+  }
+  writer.staged.clear();
+  return committed;
+}
+
+}  // namespace detail
+
+FileWriter::FileWriter(FileWriterOptions options)
+    : state_(std::make_unique<detail::WriterState>(options)) {}
+
+FileWriter::~FileWriter() = default;
+
+bool FileWriter::write(const std::string& path, const PdfBuffer& document) {
+  return detail::write_file(*state_, path, document.data(), document.size());
+}
+
+bool FileWriter::commit() {
+  return detail::commit_staged(*state_);
+}
+
+const FileWriterOptions& FileWriter::options() const {
+  return state_->options;
+}
+
+FileWriterStats FileWriter::stats() const {
+  return state_->stats;
+}
+
+ScopedFileWriter::ScopedFileWriter(FileWriter& writer) : previous_(detail::active_writer) {
+  detail::active_writer = writer.state_.get();
+}
+
+ScopedFileWriter::~ScopedFileWriter() {
+  detail::active_writer = previous_;
+}
+
+}  // namespace libharu_examples
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "libharu_examples/file_writer.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace libharu_examples {
+namespace detail {
+
+struct WriterState {
+  // A file written but not yet renamed into place.
+  struct Staged {
+    int fd = -1;
+    std::string temporary;
+    std::string path;
+    std::size_t bytes = 0;
+  };
+
+  explicit WriterState(FileWriterOptions writer_options);
+  ~WriterState();
+
+  const FileWriterOptions options;
+  FileWriterStats stats;
+  // Allocated on first use, then kept.
+  std::vector<unsigned char> buffer;
+  std::size_t buffered = 0;
+  // The file being written; `fd < 0` when there is none.
+  Staged current;
+  std::vector<Staged> staged;
+};
+
+extern thread_local WriterState* active_writer;
+
+// The writer renders on this thread save through: the innermost ScopedFileWriter's, or the
+// thread's own FsyncPolicy::Never writer.
+WriterState& current_writer();
+
+// Streams one file: `begin_file` opens a temporary file next to `path`, `append_file` adds
+// `size` bytes, and `finish_file` publishes it according to the fsync policy (or stages it).
+// `fill` is handed successive pieces of the writer's buffer and must fill each completely.
+// After any failure the temporary file is gone and `finish_file` returns false; `errno`
+// still describes a failed `begin_file`.
+using FileFill = std::function<bool(unsigned char* data, std::size_t size)>;
+bool begin_file(WriterState& writer, const std::string& path);
+bool append_file(WriterState& writer, std::size_t size, const FileFill& fill);
+bool finish_file(WriterState& writer);
+// Drops the file being written, counting it as failed.
+void abort_file(WriterState& writer);
+
+// `begin_file`, the bytes and `finish_file` in one call, without copying through the buffer.
+bool write_file(WriterState& writer,
+                const std::string& path,
+                const unsigned char* data,
+                std::size_t size);
+
+// Renames the staged files into place (see FsyncPolicy::PerBatch).
+bool commit_staged(WriterState& writer);
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,172 @@
+/*
+High-level overview
+-------------------
+Font selection shared by the renderers. A renderer asks for a style (regular, bold, italic)
+and gets a `FontFace`: the libHaru font handle plus the metrics that measure it, so wrapping,
+truncation and alignment work the same for Helvetica and for TrueType fonts.
+
+1) Without TrueType fonts the face is the base-14 Helvetica variant, measured by the
+   compile-time FontMetrics tables.
+2) With them, `load_truetype_font` hands libHaru the process-wide font bytes and the face
+   measures through the shared TrueTypeFont tables.
+3) A small registry remembers which fonts each live `HPDF_Doc` object already holds, so a
+   document recycled by a RenderContext or a batch worker selects the font by name instead
+   of having libHaru parse the file again.
+
+libHaru logic addressed in this file
+------------------------------------
+- `HPDF_LoadTTFontFromMemory` parses the whole font on every call, even when the same font is
+  already registered; the font definition it creates outlives `HPDF_FreeDoc`/`HPDF_NewDoc`
+  and is only dropped by `HPDF_Free`.
+- Embedding is always on: a TrueType font that is not embedded renders with whatever the
+  viewer substitutes, and libHaru embeds only the used glyphs anyway.
+- UTF-8 text needs `HPDF_UseUTFEncodings` and the "UTF-8" encoding name in `HPDF_GetFont`.
+  The encoder registration survives `HPDF_NewDoc` too, so recycled documents see a duplicate
+  registration, which is harmless.
+*/
+#include "font_face.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace libharu_examples {
+namespace detail {
+namespace {
+
+// Fonts loaded into each live document object, keyed by the document handle.
+struct DocumentFontRegistry {
+  std::mutex mutex;
+  std::unordered_map<HPDF_Doc, std::vector<std::pair<const TrueTypeFont*, std::string>>> fonts;
+};
+
+DocumentFontRegistry& registry() {
+  static DocumentFontRegistry instance;
+  return instance;
+}
+
+const char* standard_font_name(const StandardFont style) {
+  switch (style) {
+    case StandardFont::HelveticaBold:
+      return "Helvetica-Bold";
+    case StandardFont::HelveticaOblique:
+      return "Helvetica-Oblique";
+    case StandardFont::Helvetica:
+      break;
+  }
+  return "Helvetica";
+}
+
+const TrueTypeFont* truetype_for(const TrueTypeFontSet& fonts, const StandardFont style) {
+  const std::shared_ptr<const TrueTypeFont>* choice = &fonts.regular;
+  if (style == StandardFont::HelveticaBold && fonts.bold) {
+    choice = &fonts.bold;
+  } else if (style == StandardFont::HelveticaOblique && fonts.italic) {
+    choice = &fonts.italic;
+  }
+  return choice->get();
+}
+
+bool use_utf_encodings(HPDF_Doc pdf) {
+  const HPDF_STATUS status = HPDF_UseUTFEncodings(pdf);
+  if (status == kDuplicateRegistration) {
+    HPDF_ResetError(pdf);
+    return true;
+  }
+  return status == HPDF_OK;
+}
+
+}  // namespace
+
+float FontFace::width(const std::string_view text, const float font_size) const {
+  return truetype_ != nullptr ? truetype_->width(text, font_size)
+                              : FontMetrics::get(style_).width(text, font_size);
+}
+
+std::size_t FontFace::break_position(const std::string_view text,
+                                     const float font_size,
+                                     const float max_width) const {
+  return truetype_ != nullptr ? truetype_->break_position(text, font_size, max_width)
+                              : FontMetrics::get(style_).break_position(text, font_size, max_width);
+}
+
+void FontFace::fit_with_ellipsis(const std::string_view text,
+                                 const float font_size,
+                                 const float max_width,
+                                 std::string& out) const {
+  if (truetype_ != nullptr) {
+    truetype_->fit_with_ellipsis(text, font_size, max_width, out);
+  } else {
+    FontMetrics::get(style_).fit_with_ellipsis(text, font_size, max_width, out);
+  }
+}
+
+float FontFace::right_aligned(const float standard_x,
+                              const std::string_view text,
+                              const float font_size) const {
+  if (truetype_ == nullptr) {
+    return standard_x;
+  }
+  const float right = standard_x + FontMetrics::get(style_).width(text, font_size);
+  return right - truetype_->width(text, font_size);
+}
+
+float FontFace::centered(const float standard_x,
+                         const std::string_view text,
+                         const float font_size) const {
+  if (truetype_ == nullptr) {
+    return standard_x;
+  }
+  const float center = standard_x + FontMetrics::get(style_).width(text, font_size) / 2.0F;
+  return center - truetype_->width(text, font_size) / 2.0F;
+}
+
+FontFace load_face(HPDF_Doc pdf, const TrueTypeFontSet& fonts, const StandardFont style) {
+  if (!fonts.regular) {
+    return {HPDF_GetFont(pdf, standard_font_name(style), nullptr), style};
+  }
+  const TrueTypeFont* truetype = truetype_for(fonts, style);
+  return {load_truetype_font(pdf, *truetype), style, truetype};
+}
+
+HPDF_Font load_truetype_font(HPDF_Doc pdf, const TrueTypeFont& font) {
+  if (!use_utf_encodings(pdf)) {
+    return nullptr;
+  }
+
+  std::string name;
+  {
+    DocumentFontRegistry& fonts = registry();
+    const std::lock_guard<std::mutex> lock(fonts.mutex);
+    for (const auto& [loaded, loaded_name] : fonts.fonts[pdf]) {
+      if (loaded == &font) {
+        name = loaded_name;
+        break;
+      }
+    }
+  }
+
+  if (name.empty()) {
+    const std::vector<unsigned char>& data = font.data();
+    const char* loaded_name = HPDF_LoadTTFontFromMemory(
+        pdf, data.data(), static_cast<HPDF_UINT>(data.size()), HPDF_TRUE);
+    if (loaded_name == nullptr) {
+      return nullptr;
+    }
+    name = loaded_name;
+    DocumentFontRegistry& fonts = registry();
+    const std::lock_guard<std::mutex> lock(fonts.mutex);
+    fonts.fonts[pdf].emplace_back(&font, name);
+  }
+  return HPDF_GetFont(pdf, name.c_str(), "UTF-8");
+}
+
+void forget_document_fonts(HPDF_Doc pdf) {
+  DocumentFontRegistry& fonts = registry();
+  const std::lock_guard<std::mutex> lock(fonts.mutex);
+  fonts.fonts.erase(pdf);
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "libharu_examples/text_metrics.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <hpdf.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace libharu_examples {
+namespace detail {
+
+// `HPDF_DUPLICATE_REGISTRATION`: raised when a recycled document registers the UTF-8 encoder
+// it already kept from an earlier document. Expected, so it is not reported as an error.
+inline constexpr HPDF_STATUS kDuplicateRegistration = 0x100E;
+
+// A font selected into a document together with the metrics that measure it: a Helvetica
+// variant through FontMetrics, or a TrueType font through its shared tables. `style` is the
+// Helvetica variant the renderers' compile-time positions were measured with.
+class FontFace {
+ public:
+  FontFace() = default;
+  FontFace(HPDF_Font font, StandardFont style, const TrueTypeFont* truetype = nullptr)
+      : font_(font), style_(style), truetype_(truetype) {}
+
+  HPDF_Font font() const { return font_; }
+  bool truetype() const { return truetype_ != nullptr; }
+
+  float width(std::string_view text, float font_size) const;
+  std::size_t break_position(std::string_view text, float font_size, float max_width) const;
+  void fit_with_ellipsis(std::string_view text,
+                         float font_size,
+                         float max_width,
+                         std::string& out) const;
+
+  // `standard_x` is a compile-time position measured with the Helvetica metrics. TrueType
+  // faces move it so `text` still ends on (`right_aligned`) or is centered on (`centered`) the
+  // same point; Helvetica faces return it unchanged.
+  float right_aligned(float standard_x, std::string_view text, float font_size) const;
+  float centered(float standard_x, std::string_view text, float font_size) const;
+
+ private:
+  HPDF_Font font_ = nullptr;
+  StandardFont style_ = StandardFont::Helvetica;
+  const TrueTypeFont* truetype_ = nullptr;
+};
+
+// Selects the `style` face into `pdf`: the matching font of `fonts` when `fonts.regular` is
+// set, else the Helvetica variant. `font()` is nullptr if libHaru fails.
+FontFace load_face(HPDF_Doc pdf, const TrueTypeFontSet& fonts, StandardFont style);
+
+// Embeds `font` into `pdf` (libHaru subsets it on save) and selects it with the UTF-8 encoder;
+// nullptr on failure. A document object recycled with `HPDF_NewDoc` keeps libHaru's parsed
+// font definition, so only the first document on it parses the font; later ones just select
+// it by name.
+HPDF_Font load_truetype_font(HPDF_Doc pdf, const TrueTypeFont& font);
+
+// Forgets the fonts `load_truetype_font` put into `pdf`; call right before `HPDF_Free`.
+void forget_document_fonts(HPDF_Doc pdf);
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "libharu_examples/text_metrics.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace libharu_examples {
+namespace detail {
+
+using WidthTable = std::array<std::uint16_t, 256>;
+
+// AFM widths for codes 0x20-0x7E. StandardEncoding maps 0x27 and 0x60 to quoteright and
+// quoteleft (not quotesingle/grave as in WinAnsi).
+inline constexpr std::uint16_t kHelveticaAscii[95] = {
+    278, 278, 355, 556, 556, 889, 667, 222, 333, 333, 389, 584, 278, 333, 278, 278,
+    556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556,
+    1015, 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778,
+    667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 278, 278, 278, 469, 556,
+    222, 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222, 833, 556, 556,
+    556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584};
+
+inline constexpr std::uint16_t kHelveticaBoldAscii[95] = {
+    278, 333, 474, 556, 556, 889, 722, 278, 333, 333, 389, 584, 278, 333, 278, 278,
+    556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 333, 333, 584, 584, 584, 611,
+    975, 722, 722, 722, 722, 667, 611, 778, 722, 278, 556, 722, 611, 833, 722, 778,
+    667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 333, 278, 333, 584, 556,
+    278, 556, 611, 556, 611, 556, 333, 611, 611, 278, 278, 556, 278, 889, 611, 611,
+    611, 611, 389, 556, 333, 611, 556, 778, 556, 556, 500, 389, 280, 389, 584};
+
+// StandardEncoding codes above 0x7E: {code, Helvetica width, Helvetica-Bold width}.
+struct HighGlyph {
+  unsigned char code;
+  std::uint16_t regular;
+  std::uint16_t bold;
+};
+
+inline constexpr HighGlyph kHighGlyphs[] = {
+    {0xA1, 333, 333},   // exclamdown
+    {0xA2, 556, 556},   // cent
+    {0xA3, 556, 556},   // sterling
+    {0xA4, 167, 167},   // fraction
+    {0xA5, 556, 556},   // yen
+    {0xA6, 556, 556},   // florin
+    {0xA7, 556, 556},   // section
+    {0xA8, 556, 556},   // currency
+    {0xA9, 191, 238},   // quotesingle
+    {0xAA, 333, 500},   // quotedblleft
+    {0xAB, 556, 556},   // guillemotleft
+    {0xAC, 333, 333},   // guilsinglleft
+    {0xAD, 333, 333},   // guilsinglright
+    {0xAE, 500, 611},   // fi
+    {0xAF, 500, 611},   // fl
+    {0xB1, 556, 556},   // endash
+    {0xB2, 556, 556},   // dagger
+    {0xB3, 556, 556},   // daggerdbl
+    {0xB4, 278, 278},   // periodcentered
+    {0xB6, 537, 556},   // paragraph
+    {0xB7, 350, 350},   // bullet
+    {0xB8, 222, 278},   // quotesinglbase
+    {0xB9, 333, 500},   // quotedblbase
+    {0xBA, 333, 500},   // quotedblright
+    {0xBB, 556, 556},   // guillemotright
+    {0xBC, 1000, 1000}, // ellipsis
+    {0xBD, 1000, 1000}, // perthousand
+    {0xBF, 611, 611},   // questiondown
+    {0xC1, 333, 333},   // grave
+    {0xC2, 333, 333},   // acute
+    {0xC3, 333, 333},   // circumflex
+    {0xC4, 333, 333},   // tilde
+    {0xC5, 333, 333},   // macron
+    {0xC6, 333, 333},   // breve
+    {0xC7, 333, 333},   // dotaccent
+    {0xC8, 333, 333},   // dieresis
+    {0xCA, 333, 333},   // ring
+    {0xCB, 333, 333},   // cedilla
+    {0xCD, 333, 333},   // hungarumlaut
+    {0xCE, 333, 333},   // ogonek
+    {0xCF, 333, 333},   // caron
+    {0xD0, 1000, 1000}, // emdash
+    {0xE1, 1000, 1000}, // AE
+    {0xE3, 370, 370},   // ordfeminine
+    {0xE8, 556, 611},   // Lslash
+    {0xE9, 778, 778},   // Oslash
+    {0xEA, 1000, 1000}, // OE
+    {0xEB, 365, 365},   // ordmasculine
+    {0xF1, 889, 889},   // ae
+    {0xF5, 278, 278},   // dotlessi
+    {0xF8, 222, 278},   // lslash
+    {0xF9, 611, 611},   // oslash
+    {0xFA, 944, 944},   // oe
+    {0xFB, 611, 611},   // germandbls
+};
+
+constexpr WidthTable build_table(const std::uint16_t (&ascii)[95], const bool bold) {
+  WidthTable table{};
+  for (std::size_t i = 0; i < 95; ++i) {
+    table[0x20 + i] = ascii[i];
+  }
+  for (const HighGlyph& glyph : kHighGlyphs) {
+    table[glyph.code] = bold ? glyph.bold : glyph.regular;
+  }
+  return table;
+}
+
+inline constexpr WidthTable kHelveticaWidths = build_table(kHelveticaAscii, false);
+inline constexpr WidthTable kHelveticaBoldWidths = build_table(kHelveticaBoldAscii, true);
+
+static_assert(kHelveticaWidths['W'] == 944 && kHelveticaBoldWidths['W'] == 944,
+              "AFM width table misaligned");
+static_assert(kHelveticaWidths[0xFB] == 611 && kHelveticaWidths[0x80] == 0,
+              "StandardEncoding high codes misplaced");
+
+// Width of a fixed string at compile time, for layout checks such as
+// `static_assert(x + static_text_width(...) <= right)`. Helvetica-Oblique shares Helvetica's
+// widths. Runtime text goes through `FontMetrics`.
+constexpr float static_text_width(const StandardFont font,
+                                  const std::string_view text,
+                                  const float font_size) {
+  const WidthTable& table = font == StandardFont::HelveticaBold ? kHelveticaBoldWidths
+                                                                : kHelveticaWidths;
+  std::uint32_t units = 0;
+  for (const char c : text) {
+    units += table[static_cast<unsigned char>(c)];
+  }
+  return static_cast<float>(units) * font_size / 1000.0F;
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,298 @@
+/*
+High-level overview
+-------------------
+Pixel kernels for the clinical report's image preparation: area-average downscaling of 8-bit
+and 16-bit frames, and window/level mapping of 16-bit samples to 8 bits.
+
+1) Downscaling walks the output rows. For each one, the `factor` source rows of its blocks are
+   added column by column into a row of 32-bit sums (the vectorized part: every source sample
+   is touched exactly once), then each block's columns are summed and divided with rounding.
+2) Window/level converts eight samples per step to float (two SSE2 registers or one AVX2
+   register), scales and clamps them to 0..255 and packs them back to bytes. The scalar path does the same
+   float operations in the same order, and both round to nearest even, so the variants agree
+   byte for byte.
+3) `kernels()` picks the variant once per process: AVX2 when the compiler can target it and
+   the CPU reports it, otherwise SSE2 on x86-64 (always present there), otherwise scalar.
+
+libHaru logic addressed in this file
+------------------------------------
+- `HPDF_LoadRawImageFromMem` takes 8 bits per component only, so 16-bit frames must be
+  mapped to 8 bits before they are embedded; doing it here, after downscaling, keeps libHaru's
+  copy and its Flate pass to the pixels the page can show.
+*/
+#include "image_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LIBHARU_EXAMPLES_HAVE_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBHARU_EXAMPLES_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace libharu_examples {
+namespace detail {
+namespace {
+
+using AccumulateU8 = void (*)(const unsigned char* row, std::size_t count, std::uint32_t* sums);
+using AccumulateU16 = void (*)(const unsigned char* row, std::size_t count, std::uint32_t* sums);
+using WindowLevel = void (*)(const unsigned char* src,
+                             std::size_t count,
+                             float low,
+                             float scale,
+                             unsigned char* dst);
+
+struct Kernels {
+  AccumulateU8 accumulate_u8;
+  AccumulateU16 accumulate_u16;
+  WindowLevel window_level;
+  const char* isa;
+};
+
+std::uint16_t load_u16(const unsigned char* src) {
+  std::uint16_t value = 0;
+  std::memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+// Scalar kernels; the vector variants finish their tails with these.
+void accumulate_u8_scalar(const unsigned char* row, const std::size_t count, std::uint32_t* sums) {
+  for (std::size_t i = 0; i < count; ++i) {
+    sums[i] += row[i];
+  }
+}
+
+void accumulate_u16_scalar(const unsigned char* row,
+                           const std::size_t count,
+                           std::uint32_t* sums) {
+  for (std::size_t i = 0; i < count; ++i) {
+    sums[i] += load_u16(row + 2 * i);
+  }
+}
+
+void window_level_scalar(const unsigned char* src,
+                         const std::size_t count,
+                         const float low,
+                         const float scale,
+                         unsigned char* dst) {
+  for (std::size_t i = 0; i < count; ++i) {
+    float value = (static_cast<float>(load_u16(src + 2 * i)) - low) * scale;
+    value = std::min(std::max(value, 0.0F), 255.0F);
+    dst[i] = static_cast<unsigned char>(std::nearbyint(value));
+  }
+}
+
+#if defined(LIBHARU_EXAMPLES_HAVE_SSE2)
+void accumulate_u8_sse2(const unsigned char* row, const std::size_t count, std::uint32_t* sums) {
+  const __m128i zero = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+    const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+    const __m128i words[4] = {_mm_unpacklo_epi16(low, zero),
+                              _mm_unpackhi_epi16(low, zero),
+                              _mm_unpacklo_epi16(high, zero),
+                              _mm_unpackhi_epi16(high, zero)};
+    for (int k = 0; k < 4; ++k) {
+      auto* out = reinterpret_cast<__m128i*>(sums + i + 4 * k);
+      _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), words[k]));
+    }
+  }
+  accumulate_u8_scalar(row + i, count - i, sums + i);
+}
+
+void accumulate_u16_sse2(const unsigned char* row, const std::size_t count, std::uint32_t* sums) {
+  const __m128i zero = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2 * i));
+    auto* out = reinterpret_cast<__m128i*>(sums + i);
+    _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), _mm_unpacklo_epi16(samples, zero)));
+    _mm_storeu_si128(out + 1,
+                     _mm_add_epi32(_mm_loadu_si128(out + 1), _mm_unpackhi_epi16(samples, zero)));
+  }
+  accumulate_u16_scalar(row + 2 * i, count - i, sums + i);
+}
+
+void window_level_sse2(const unsigned char* src,
+                       const std::size_t count,
+                       const float low,
+                       const float scale,
+                       unsigned char* dst) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 low4 = _mm_set1_ps(low);
+  const __m128 scale4 = _mm_set1_ps(scale);
+  const __m128 min4 = _mm_setzero_ps();
+  const __m128 max4 = _mm_set1_ps(255.0F);
+  const auto map = [&](const __m128i words) {
+    const __m128 value = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(words), low4), scale4);
+    return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(value, min4), max4));
+  };
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+    const __m128i mapped = _mm_packs_epi32(map(_mm_unpacklo_epi16(samples, zero)),
+                                           map(_mm_unpackhi_epi16(samples, zero)));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(mapped, mapped));
+  }
+  window_level_scalar(src + 2 * i, count - i, low, scale, dst + i);
+}
+#endif
+
+#if defined(LIBHARU_EXAMPLES_HAVE_AVX2)
+__attribute__((target("avx2"))) void accumulate_u8_avx2(const unsigned char* row,
+                                                        const std::size_t count,
+                                                        std::uint32_t* sums) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i widened =
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i)));
+    auto* out = reinterpret_cast<__m256i*>(sums + i);
+    _mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), widened));
+  }
+  accumulate_u8_scalar(row + i, count - i, sums + i);
+}
+
+__attribute__((target("avx2"))) void accumulate_u16_avx2(const unsigned char* row,
+                                                         const std::size_t count,
+                                                         std::uint32_t* sums) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i widened =
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2 * i)));
+    auto* out = reinterpret_cast<__m256i*>(sums + i);
+    _mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), widened));
+  }
+  accumulate_u16_scalar(row + 2 * i, count - i, sums + i);
+}
+
+__attribute__((target("avx2"))) void window_level_avx2(const unsigned char* src,
+                                                       const std::size_t count,
+                                                       const float low,
+                                                       const float scale,
+                                                       unsigned char* dst) {
+  const __m256 low8 = _mm256_set1_ps(low);
+  const __m256 scale8 = _mm256_set1_ps(scale);
+  const __m256 min8 = _mm256_setzero_ps();
+  const __m256 max8 = _mm256_set1_ps(255.0F);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i samples =
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i)));
+    const __m256 value = _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(samples), low8), scale8);
+    const __m256i mapped = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(value, min8), max8));
+    const __m128i words =
+        _mm_packs_epi32(_mm256_castsi256_si128(mapped), _mm256_extracti128_si256(mapped, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(words, words));
+  }
+  window_level_scalar(src + 2 * i, count - i, low, scale, dst + i);
+}
+#endif
+
+Kernels select_kernels() {
+#if defined(LIBHARU_EXAMPLES_HAVE_AVX2)
+  if (__builtin_cpu_supports("avx2")) {
+    return {accumulate_u8_avx2, accumulate_u16_avx2, window_level_avx2, "avx2"};
+  }
+#endif
+#if defined(LIBHARU_EXAMPLES_HAVE_SSE2)
+  return {accumulate_u8_sse2, accumulate_u16_sse2, window_level_sse2, "sse2"};
+#else
+  return {accumulate_u8_scalar, accumulate_u16_scalar, window_level_scalar, "scalar"};
+#endif
+}
+
+const Kernels& kernels() {
+  static const Kernels selected = select_kernels();
+  return selected;
+}
+
+// Step 1 (second half): sums each block's columns out of the accumulated row and writes the
+// rounded means of one output row.
+template <typename Sample>
+void average_blocks(const std::vector<std::uint32_t>& sums,
+                    const unsigned width,
+                    const unsigned channels,
+                    const unsigned factor,
+                    const unsigned rows,
+                    Sample* dst) {
+  const unsigned out_width = downscaled_size(width, factor);
+  for (unsigned ox = 0; ox < out_width; ++ox) {
+    const unsigned x0 = ox * factor;
+    const unsigned columns = std::min(factor, width - x0);
+    const std::uint32_t count = columns * rows;
+    for (unsigned c = 0; c < channels; ++c) {
+      std::uint32_t sum = 0;
+      for (unsigned x = 0; x < columns; ++x) {
+        sum += sums[(std::size_t{x0} + x) * channels + c];
+      }
+      dst[std::size_t{ox} * channels + c] = static_cast<Sample>((sum + count / 2) / count);
+    }
+  }
+}
+
+template <typename Sample, typename Accumulate>
+void downscale(const unsigned char* src,
+               const unsigned width,
+               const unsigned height,
+               const unsigned channels,
+               const unsigned factor,
+               std::vector<std::uint32_t>& sums,
+               Sample* dst,
+               Accumulate accumulate) {
+  const std::size_t row_samples = std::size_t{width} * channels;
+  const std::size_t row_bytes = row_samples * sizeof(Sample);
+  const std::size_t out_row_samples = std::size_t{downscaled_size(width, factor)} * channels;
+  sums.resize(row_samples);
+  for (unsigned oy = 0; oy < downscaled_size(height, factor); ++oy) {
+    const unsigned y0 = oy * factor;
+    const unsigned rows = std::min(factor, height - y0);
+    std::fill(sums.begin(), sums.end(), 0U);
+    for (unsigned r = 0; r < rows; ++r) {
+      accumulate(src + (std::size_t{y0} + r) * row_bytes, row_samples, sums.data());
+    }
+    average_blocks(sums, width, channels, factor, rows, dst + oy * out_row_samples);
+  }
+}
+
+}  // namespace
+
+void downscale_u8(const unsigned char* src,
+                  const unsigned width,
+                  const unsigned height,
+                  const unsigned channels,
+                  const unsigned factor,
+                  std::vector<std::uint32_t>& sums,
+                  unsigned char* dst) {
+  downscale(src, width, height, channels, factor, sums, dst, kernels().accumulate_u8);
+}
+
+void downscale_u16(const unsigned char* src,
+                   const unsigned width,
+                   const unsigned height,
+                   const unsigned factor,
+                   std::vector<std::uint32_t>& sums,
+                   std::uint16_t* dst) {
+  downscale(src, width, height, 1, factor, sums, dst, kernels().accumulate_u16);
+}
+
+void window_level(const unsigned char* src,
+                  const std::size_t count,
+                  const float center,
+                  const float width,
+                  unsigned char* dst) {
+  kernels().window_level(src, count, center - width / 2.0F, 255.0F / width, dst);
+}
+
+const char* image_kernel_isa() {
+  return kernels().isa;
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace libharu_examples {
+namespace detail {
+
+// Largest area-average factor: a block of 256 x 256 16-bit samples still sums within 32 bits.
+constexpr unsigned kMaxDownscaleFactor = 256;
+
+// Output size of an area-average by `factor`. Partial blocks at the right and bottom edges are
+// averaged over the pixels they have.
+constexpr unsigned downscaled_size(const unsigned size, const unsigned factor) {
+  return (size + factor - 1) / factor;
+}
+
+// Pixel kernels for preparing raw frames before libHaru embeds them. Each runs as AVX2 or
+// SSE2 on x86-64 (AVX2 chosen at run time) and as scalar code elsewhere; every variant gives
+// identical bytes.
+//
+// Area-averages tightly packed 8-bit rows with `channels` interleaved samples per pixel over
+// `factor` x `factor` blocks (1 <= factor <= kMaxDownscaleFactor), rounding to nearest.
+// `sums` is scratch, kept by the caller so repeated calls do not allocate.
+void downscale_u8(const unsigned char* src,
+                  unsigned width,
+                  unsigned height,
+                  unsigned channels,
+                  unsigned factor,
+                  std::vector<std::uint32_t>& sums,
+                  unsigned char* dst);
+
+// The same for one-channel 16-bit samples in host byte order; `src` need not be aligned. The
+// averages stay 16-bit so they can be windowed afterwards.
+void downscale_u16(const unsigned char* src,
+                   unsigned width,
+                   unsigned height,
+                   unsigned factor,
+                   std::vector<std::uint32_t>& sums,
+                   std::uint16_t* dst);
+
+// Window/level: maps the 16-bit samples (host byte order, unaligned) in
+// [center - width / 2, center + width / 2] linearly onto 0..255, clamping outside. `width`
+// must be positive.
+void window_level(const unsigned char* src,
+                  std::size_t count,
+                  float center,
+                  float width,
+                  unsigned char* dst);
+
+// "avx2", "sse2" or "scalar": the kernels this process uses.
+const char* image_kernel_isa();
+
+}  // namespace detail
+}  // namespace libharu_examples
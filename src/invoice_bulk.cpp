@@ -0,0 +1,946 @@
+/*
+High-level overview
+-------------------
+Bulk invoice generation from one large CSV or JSON Lines export: one PDF per invoice, written
+into an output directory, with memory bounded independently of the input size.
+
+1) Map the input file (`detail::MappedFile`) and read rows with a zero-copy reader. Fields are
+   `std::string_view`s into the mapping; only quoted fields with escapes are unescaped, into a
+   per-column scratch string that is reused for every row.
+2) Group consecutive rows with the same invoice_id into one invoice and validate it while
+   parsing, so bad records are rejected with a line number before reaching libHaru.
+3) Three stages connected by `detail::BoundedQueue`s:
+     parse (calling thread) -> render (N workers) -> write (one thread)
+   Each render worker keeps one warm `RenderContext` and renders into an in-memory
+   `PdfBuffer`; the writer does all file IO, so slow disks never stall rendering directly and
+   rendering never waits on the parser for longer than one invoice. It writes through a
+   `FileWriter` with `InvoiceBulkOptions::output`, so every PDF appears whole under its name
+   and fsyncs happen per file, per batch or not at all.
+4) Work items carry their strings, item vector and PDF buffer through the pipeline and come
+   back to the parser through a free list, so after warm-up no stage allocates per invoice
+   beyond what libHaru itself does and the parser's set of file stems already used. A
+   repeated invoice_id (or any other id mapping to a used stem) is rejected rather than
+   overwriting the earlier PDF.
+
+libHaru logic addressed in this file
+------------------------------------
+- None directly: rendering goes through `InvoiceExample::createInvoidcw(..., PdfBuffer&)`,
+  which owns the document lifecycle. A libHaru document is single-threaded, so parallelism
+  comes from one document (and one RenderContext) per render worker.
+*/
+#include "libharu_examples/invoice_bulk.h"
+
+#include "libharu_examples/file_writer.h"
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/render_context.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "mapped_file.h"
+#include "sha256.h"
+
+namespace libharu_examples {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kMaxStemBytes = 120;
+
+enum Field : std::size_t {
+  kInvoiceId,
+  kProviderName,
+  kProviderAddress,
+  kProviderEmail,
+  kClientName,
+  kClientAddress,
+  kClientEmail,
+  kDescription,
+  kQuantity,
+  kUnitPrice,
+  kFieldCount,
+};
+
+constexpr std::array<std::string_view, kFieldCount> kFieldNames = {
+    "invoice_id",
+    "provider_name",
+    "provider_address",
+    "provider_email",
+    "client_name",
+    "client_address",
+    "client_email",
+    "description",
+    "quantity",
+    "unit_price",
+};
+
+// Addresses and emails may be left out of a CSV header; everything else must be there.
+constexpr std::array<Field, 6> kRequiredColumns = {
+    kInvoiceId, kProviderName, kClientName, kDescription, kQuantity, kUnitPrice};
+
+std::size_t field_index(const std::string_view name) {
+  for (std::size_t i = 0; i < kFieldCount; ++i) {
+    if (kFieldNames[i] == name) {
+      return i;
+    }
+  }
+  return kFieldCount;
+}
+
+double seconds_since(const Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// One input row: views into the mapping or into the reader's scratch strings, valid until
+// the next call to `next`.
+struct BulkRow {
+  std::array<std::string_view, kFieldCount> fields;
+  std::size_t line = 0;
+  // Set when the row is malformed; the reader has skipped to the next record.
+  const char* error = nullptr;
+};
+
+// RFC 4180 CSV: comma separated, optional double quotes with "" as an escaped quote, quoted
+// fields may span lines, LF or CRLF line ends. Blank lines are skipped.
+class CsvReader {
+ public:
+  explicit CsvReader(const std::string_view data) : data_(data) {}
+
+  bool read_header(std::string* error) {
+    // Step 1: Optional UTF-8 byte order mark, then the first non-blank record.
+    if (data_.substr(0, 3) == "\xEF\xBB\xBF") {
+      pos_ = 3;
+    }
+    skip_blank_lines();
+    if (pos_ >= data_.size()) {
+      *error = "input is empty";
+      return false;
+    }
+
+    std::array<bool, kFieldCount> seen{};
+    for (std::size_t column = 0;; ++column) {
+      std::string_view name;
+      bool end_of_record = false;
+      const char* field_error = nullptr;
+      if (!read_field(column, name, end_of_record, field_error)) {
+        *error = "line 1: " + std::string(field_error);
+        return false;
+      }
+      while (!name.empty() && (name.front() == ' ' || name.front() == '\t')) {
+        name.remove_prefix(1);
+      }
+      while (!name.empty() && (name.back() == ' ' || name.back() == '\t')) {
+        name.remove_suffix(1);
+      }
+      const std::size_t field = field_index(name);
+      columns_.push_back(field);
+      if (field != kFieldCount) {
+        seen[field] = true;
+      }
+      if (end_of_record) {
+        break;
+      }
+    }
+
+    // Step 2: Every required column must be named.
+    for (const Field field : kRequiredColumns) {
+      if (!seen[field]) {
+        *error = "line 1: missing column '" + std::string(kFieldNames[field]) + "'";
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool next(BulkRow& row) {
+    skip_blank_lines();
+    if (pos_ >= data_.size()) {
+      return false;
+    }
+    row.fields = {};
+    row.line = line_;
+    row.error = nullptr;
+
+    for (std::size_t column = 0;; ++column) {
+      std::string_view value;
+      bool end_of_record = false;
+      if (!read_field(column, value, end_of_record, row.error)) {
+        skip_line();
+        return true;
+      }
+      if (column >= columns_.size()) {
+        row.error = "row has more columns than the header";
+        if (!end_of_record) {
+          skip_line();
+        }
+        return true;
+      }
+      if (columns_[column] != kFieldCount) {
+        row.fields[columns_[column]] = value;
+      }
+      if (end_of_record) {
+        return true;
+      }
+    }
+  }
+
+ private:
+  void skip_blank_lines() {
+    while (pos_ < data_.size()) {
+      if (data_[pos_] == '\n') {
+        ++pos_;
+        ++line_;
+      } else if (data_[pos_] == '\r' && pos_ + 1 < data_.size() && data_[pos_ + 1] == '\n') {
+        pos_ += 2;
+        ++line_;
+      } else {
+        break;
+      }
+    }
+  }
+
+  void skip_line() {
+    const std::size_t end = data_.find('\n', pos_);
+    pos_ = (end == std::string_view::npos) ? data_.size() : end + 1;
+    ++line_;
+  }
+
+  // Reads the field at `pos_` and the separator after it.
+  bool read_field(const std::size_t column,
+                  std::string_view& value,
+                  bool& end_of_record,
+                  const char*& error) {
+    if (pos_ < data_.size() && data_[pos_] == '"') {
+      if (!read_quoted(column, value, error)) {
+        return false;
+      }
+      if (pos_ >= data_.size()) {
+        end_of_record = true;
+      } else if (data_[pos_] == ',') {
+        ++pos_;
+      } else if (data_[pos_] == '\n' ||
+                 (data_[pos_] == '\r' && pos_ + 1 < data_.size() && data_[pos_ + 1] == '\n')) {
+        pos_ += (data_[pos_] == '\r') ? 2 : 1;
+        ++line_;
+        end_of_record = true;
+      } else {
+        error = "unexpected character after a quoted field";
+        return false;
+      }
+      return true;
+    }
+
+    std::size_t stop = pos_;
+    while (stop < data_.size() && data_[stop] != ',' && data_[stop] != '\n') {
+      ++stop;
+    }
+    value = data_.substr(pos_, stop - pos_);
+    if (value.find('"') != std::string_view::npos) {
+      error = "quote inside an unquoted field";
+      pos_ = stop;
+      return false;
+    }
+    if (stop >= data_.size()) {
+      pos_ = data_.size();
+      end_of_record = true;
+    } else if (data_[stop] == ',') {
+      pos_ = stop + 1;
+    } else {
+      if (!value.empty() && value.back() == '\r') {
+        value.remove_suffix(1);
+      }
+      pos_ = stop + 1;
+      ++line_;
+      end_of_record = true;
+    }
+    return true;
+  }
+
+  // Leaves `pos_` just past the closing quote. Fields without "" are views into the input.
+  bool read_quoted(const std::size_t column, std::string_view& value, const char*& error) {
+    const std::size_t start = pos_ + 1;
+    std::size_t cursor = start;
+    bool escaped = false;
+    for (;;) {
+      const std::size_t quote = data_.find('"', cursor);
+      if (quote == std::string_view::npos) {
+        error = "unterminated quoted field";
+        pos_ = data_.size();
+        return false;
+      }
+      line_ += static_cast<std::size_t>(
+          std::count(data_.begin() + cursor, data_.begin() + quote, '\n'));
+      if (quote + 1 < data_.size() && data_[quote + 1] == '"') {
+        escaped = true;
+        cursor = quote + 2;
+        continue;
+      }
+      value = data_.substr(start, quote - start);
+      pos_ = quote + 1;
+      break;
+    }
+
+    if (escaped) {
+      if (scratch_.size() <= column) {
+        scratch_.resize(column + 1);
+      }
+      std::string& unescaped = scratch_[column];
+      unescaped.clear();
+      for (std::size_t i = 0; i < value.size(); ++i) {
+        unescaped.push_back(value[i]);
+        if (value[i] == '"') {
+          ++i;  // the second quote of ""
+        }
+      }
+      value = unescaped;
+    }
+    return true;
+  }
+
+  std::string_view data_;
+  std::size_t pos_ = 0;
+  std::size_t line_ = 1;
+  // Header column -> Field, kFieldCount for columns this pipeline does not use.
+  std::vector<std::size_t> columns_;
+  std::vector<std::string> scratch_;
+};
+
+// JSON Lines: one flat object per line. String values with escapes are decoded into a
+// per-field scratch string; numbers, booleans and null are taken as their raw token (null is
+// empty). Nested objects and arrays are rejected.
+class JsonlReader {
+ public:
+  explicit JsonlReader(const std::string_view data) : data_(data) {}
+
+  bool next(BulkRow& row) {
+    for (;;) {
+      skip_spaces();
+      if (pos_ >= data_.size()) {
+        return false;
+      }
+      if (data_[pos_] != '\n') {
+        break;
+      }
+      ++pos_;
+      ++line_;
+    }
+
+    row.fields = {};
+    row.line = line_;
+    row.error = nullptr;
+    const std::size_t line_end = data_.find('\n', pos_);
+    end_ = (line_end == std::string_view::npos) ? data_.size() : line_end;
+    parse_object(row);
+    pos_ = (line_end == std::string_view::npos) ? data_.size() : line_end + 1;
+    ++line_;
+    return true;
+  }
+
+ private:
+  char peek() const { return pos_ < end_ ? data_[pos_] : '\0'; }
+
+  void skip_spaces() {
+    while (pos_ < data_.size() &&
+           (data_[pos_] == ' ' || data_[pos_] == '\t' || data_[pos_] == '\r')) {
+      ++pos_;
+    }
+  }
+
+  bool parse_object(BulkRow& row) {
+    if (peek() != '{') {
+      row.error = "expected a JSON object";
+      return false;
+    }
+    ++pos_;
+    skip_spaces();
+    if (peek() == '}') {
+      ++pos_;
+    } else {
+      for (;;) {
+        std::string_view key;
+        if (peek() != '"' || !parse_string(key, key_scratch_, row.error)) {
+          row.error = (row.error != nullptr) ? row.error : "expected a quoted key";
+          return false;
+        }
+        skip_spaces();
+        if (peek() != ':') {
+          row.error = "expected ':' after a key";
+          return false;
+        }
+        ++pos_;
+        skip_spaces();
+
+        const std::size_t field = field_index(key);
+        std::string_view value;
+        if (!parse_value(field, value, row.error)) {
+          return false;
+        }
+        if (field != kFieldCount) {
+          row.fields[field] = value;
+        }
+
+        skip_spaces();
+        if (peek() == ',') {
+          ++pos_;
+          skip_spaces();
+          continue;
+        }
+        if (peek() == '}') {
+          ++pos_;
+          break;
+        }
+        row.error = "expected ',' or '}'";
+        return false;
+      }
+    }
+    skip_spaces();
+    if (pos_ < end_) {
+      row.error = "unexpected data after the object";
+      return false;
+    }
+    return true;
+  }
+
+  bool parse_value(const std::size_t field, std::string_view& value, const char*& error) {
+    const char c = peek();
+    if (c == '"') {
+      return parse_string(value, field != kFieldCount ? scratch_[field] : key_scratch_, error);
+    }
+    if (c == '{' || c == '[') {
+      error = "nested values are not supported";
+      return false;
+    }
+    const std::size_t start = pos_;
+    while (pos_ < end_ && data_[pos_] != ',' && data_[pos_] != '}' && data_[pos_] != ' ' &&
+           data_[pos_] != '\t' && data_[pos_] != '\r') {
+      ++pos_;
+    }
+    value = data_.substr(start, pos_ - start);
+    if (value.empty()) {
+      error = "expected a value";
+      return false;
+    }
+    if (value == "null") {
+      value = {};
+    }
+    return true;
+  }
+
+  // `pos_` is on the opening quote. Strings without escapes are views into the input.
+  bool parse_string(std::string_view& out, std::string& scratch, const char*& error) {
+    const std::size_t start = ++pos_;
+    while (pos_ < end_ && data_[pos_] != '"' && data_[pos_] != '\\') {
+      ++pos_;
+    }
+    if (pos_ >= end_) {
+      error = "unterminated string";
+      return false;
+    }
+    if (data_[pos_] == '"') {
+      out = data_.substr(start, pos_ - start);
+      ++pos_;
+      return true;
+    }
+
+    scratch.assign(data_.data() + start, pos_ - start);
+    while (pos_ < end_ && data_[pos_] != '"') {
+      if (data_[pos_] != '\\') {
+        scratch.push_back(data_[pos_++]);
+        continue;
+      }
+      if (pos_ + 1 >= end_) {
+        break;
+      }
+      const char escape = data_[pos_ + 1];
+      pos_ += 2;
+      switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+          scratch.push_back(escape);
+          break;
+        case 'b':
+          scratch.push_back('\b');
+          break;
+        case 'f':
+          scratch.push_back('\f');
+          break;
+        case 'n':
+          scratch.push_back('\n');
+          break;
+        case 'r':
+          scratch.push_back('\r');
+          break;
+        case 't':
+          scratch.push_back('\t');
+          break;
+        case 'u':
+          if (!append_code_point(scratch)) {
+            error = "invalid \\u escape";
+            return false;
+          }
+          break;
+        default:
+          error = "invalid escape in string";
+          return false;
+      }
+    }
+    if (pos_ >= end_) {
+      error = "unterminated string";
+      return false;
+    }
+    ++pos_;
+    out = scratch;
+    return true;
+  }
+
+  bool read_hex4(std::uint32_t& value) {
+    if (pos_ + 4 > end_) {
+      return false;
+    }
+    const char* first = data_.data() + pos_;
+    const auto result = std::from_chars(first, first + 4, value, 16);
+    if (result.ec != std::errc() || result.ptr != first + 4) {
+      return false;
+    }
+    pos_ += 4;
+    return true;
+  }
+
+  // Decodes the XXXX of \uXXXX (and a following low surrogate) as UTF-8.
+  bool append_code_point(std::string& out) {
+    std::uint32_t code = 0;
+    if (!read_hex4(code) || (code >= 0xDC00U && code <= 0xDFFFU)) {
+      return false;
+    }
+    if (code >= 0xD800U && code <= 0xDBFFU) {
+      std::uint32_t low = 0;
+      if (pos_ + 2 > end_ || data_[pos_] != '\\' || data_[pos_ + 1] != 'u') {
+        return false;
+      }
+      pos_ += 2;
+      if (!read_hex4(low) || low < 0xDC00U || low > 0xDFFFU) {
+        return false;
+      }
+      code = 0x10000U + ((code - 0xD800U) << 10U) + (low - 0xDC00U);
+    }
+
+    if (code < 0x80U) {
+      out.push_back(static_cast<char>(code));
+    } else if (code < 0x800U) {
+      out.push_back(static_cast<char>(0xC0U | (code >> 6U)));
+      out.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+    } else if (code < 0x10000U) {
+      out.push_back(static_cast<char>(0xE0U | (code >> 12U)));
+      out.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+      out.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+    } else {
+      out.push_back(static_cast<char>(0xF0U | (code >> 18U)));
+      out.push_back(static_cast<char>(0x80U | ((code >> 12U) & 0x3FU)));
+      out.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+      out.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+    }
+    return true;
+  }
+
+  std::string_view data_;
+  std::size_t pos_ = 0;
+  std::size_t end_ = 0;
+  std::size_t line_ = 1;
+  std::array<std::string, kFieldCount> scratch_;
+  std::string key_scratch_;
+};
+
+bool parse_quantity(const std::string_view text, int& quantity) {
+  const auto result = std::from_chars(text.data(), text.data() + text.size(), quantity);
+  return result.ec == std::errc() && result.ptr == text.data() + text.size() && quantity > 0;
+}
+
+// Locale-independent, like the quantity: "12.50" parses whatever LC_NUMERIC the host set.
+bool parse_unit_price(std::string_view text, double& price) {
+  // from_chars takes no leading '+'.
+  if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+    text.remove_prefix(1);
+  }
+  const auto result = std::from_chars(text.data(), text.data() + text.size(), price);
+  return result.ec == std::errc() && result.ptr == text.data() + text.size() &&
+         std::isfinite(price) && price >= 0.0;
+}
+
+// File stem for an invoice id: letters, digits, '-', '_' and '.' are kept, anything else
+// (path separators included) becomes '_', as does a leading '.'. An id that does not survive
+// this unchanged, or is cut to kMaxStemBytes, gets '-' and the first eight hex digits of its
+// SHA-256 appended, so `a/b` and `a_b` (or two long ids with a common prefix) name
+// different files.
+void sanitize_file_stem(const std::string_view id, std::string& stem) {
+  stem.clear();
+  bool changed = id.size() > kMaxStemBytes;
+  for (const char c : id.substr(0, kMaxStemBytes)) {
+    const bool keep = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                      c == '-' || c == '_' || c == '.';
+    stem.push_back(keep ? c : '_');
+    changed = changed || !keep;
+  }
+  if (stem.front() == '.') {
+    stem.front() = '_';
+    changed = true;
+  }
+  if (changed) {
+    detail::Sha256 hash;
+    hash.update(id);
+    stem += '-';
+    stem += detail::to_hex(hash.finish(), 4);
+  }
+}
+
+// One invoice on its way through the pipeline, recycled through the free list.
+struct BulkWork {
+  std::string file_stem;
+  std::size_t line = 0;
+  InvoiceExample::Provider provider;
+  InvoiceExample::Client client;
+  std::vector<InvoiceExample::Item> items;
+  PdfBuffer pdf;
+};
+
+using WorkPtr = std::unique_ptr<BulkWork>;
+
+class BulkPipeline {
+ public:
+  BulkPipeline(const InvoiceBulkOptions& options,
+               std::filesystem::path output_dir,
+               const std::size_t render_workers,
+               const std::size_t input_bytes)
+      : options_(options),
+        output_dir_(std::move(output_dir)),
+        input_bytes_(input_bytes),
+        render_workers_(render_workers),
+        render_queue_(options.queue_depth),
+        write_queue_(options.queue_depth),
+        free_list_(2 * std::max<std::size_t>(options.queue_depth, 1) + render_workers + 2) {}
+
+  template <typename Reader>
+  void run(Reader& reader, InvoiceBulkStats& stats) {
+    const Clock::time_point start = Clock::now();
+    live_renderers_ = render_workers_;
+    std::vector<std::thread> threads;
+    threads.reserve(render_workers_ + 1);
+    for (std::size_t i = 0; i < render_workers_; ++i) {
+      threads.emplace_back([this] { render_loop(); });
+    }
+    threads.emplace_back([this] { write_loop(); });
+
+    parse_loop(reader);
+    render_queue_.close();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    snapshot(stats);
+    stats.seconds = seconds_since(start);
+    stats.parse_seconds = parse_seconds_;
+    stats.render_seconds = static_cast<double>(render_nanoseconds_.load()) * 1e-9;
+    stats.write_seconds = write_seconds_;
+    if (options_.progress) {
+      options_.progress(stats);
+    }
+  }
+
+ private:
+  void note_error(const std::size_t line, const char* message) {
+    note_failure("line " + std::to_string(line) + ": " + message);
+  }
+
+  void note_failure(std::string message) {
+    const std::lock_guard<std::mutex> lock(error_mutex_);
+    if (first_error_.empty()) {
+      first_error_ = std::move(message);
+    }
+  }
+
+  // Counters only: the stage times are complete once the stages have finished.
+  void snapshot(InvoiceBulkStats& stats) {
+    stats.input_bytes = input_bytes_;
+    stats.rows = rows_.load();
+    stats.invoices = invoices_.load();
+    stats.rejected = rejected_.load();
+    stats.failed = failed_.load();
+    stats.output_bytes = output_bytes_.load();
+    const std::lock_guard<std::mutex> lock(error_mutex_);
+    stats.first_error = first_error_;
+  }
+
+  WorkPtr acquire() {
+    WorkPtr work;
+    if (!free_list_.try_pop(work)) {
+      work = std::make_unique<BulkWork>();
+    }
+    return work;
+  }
+
+  void recycle(WorkPtr& work) {
+    // The free list holds every work item that can exist at once, so this never blocks.
+    free_list_.push(work);
+  }
+
+  // Step 1 and 2: Rows -> validated invoices, on the calling thread.
+  template <typename Reader>
+  void parse_loop(Reader& reader) {
+    const Clock::time_point start = Clock::now();
+    double waited = 0.0;
+    WorkPtr work;
+    bool rejected = false;
+    std::string current_id;
+    // Every file stem used so far: a second invoice with the same stem would overwrite the
+    // first one's PDF.
+    std::unordered_set<std::string> used_stems;
+
+    const auto finish_invoice = [&] {
+      if (work == nullptr) {
+        return;
+      }
+      if (rejected) {
+        ++rejected_;
+        recycle(work);
+      } else {
+        const Clock::time_point push_start = Clock::now();
+        render_queue_.push(work);
+        waited += seconds_since(push_start);
+      }
+      work.reset();
+      current_id.clear();
+    };
+    const auto reject = [&](const std::size_t line, const char* message) {
+      rejected = true;
+      note_error(line, message);
+    };
+
+    BulkRow row;
+    while (reader.next(row)) {
+      ++rows_;
+      const std::string_view id = row.fields[kInvoiceId];
+      if (id.empty()) {
+        finish_invoice();
+        ++rejected_;
+        note_error(row.line, row.error != nullptr ? row.error : "missing invoice_id");
+        continue;
+      }
+
+      if (work == nullptr || id != current_id) {
+        finish_invoice();
+        work = acquire();
+        current_id.assign(id);
+        rejected = false;
+        sanitize_file_stem(id, work->file_stem);
+        work->line = row.line;
+        work->provider.name.assign(row.fields[kProviderName]);
+        work->provider.address.assign(row.fields[kProviderAddress]);
+        work->provider.email.assign(row.fields[kProviderEmail]);
+        work->client.name.assign(row.fields[kClientName]);
+        work->client.address.assign(row.fields[kClientAddress]);
+        work->client.email.assign(row.fields[kClientEmail]);
+        work->items.clear();
+        if (!used_stems.insert(work->file_stem).second) {
+          reject(row.line, "invoice_id names the same file as an earlier invoice");
+        } else if (row.error == nullptr && work->provider.name.empty()) {
+          reject(row.line, "provider_name is empty");
+        } else if (row.error == nullptr && work->client.name.empty()) {
+          reject(row.line, "client_name is empty");
+        }
+      }
+
+      if (row.error != nullptr) {
+        reject(row.line, row.error);
+        continue;
+      }
+      if (rejected) {
+        continue;
+      }
+      int quantity = 0;
+      double unit_price = 0.0;
+      if (!parse_quantity(row.fields[kQuantity], quantity)) {
+        reject(row.line, "quantity is not a positive integer");
+        continue;
+      }
+      if (!parse_unit_price(row.fields[kUnitPrice], unit_price)) {
+        reject(row.line, "unit_price is not a non-negative number");
+        continue;
+      }
+      work->items.push_back({std::string(row.fields[kDescription]), quantity, unit_price});
+    }
+    finish_invoice();
+    parse_seconds_ = seconds_since(start) - waited;
+  }
+
+  // Step 3: One warm RenderContext per worker; each invoice renders into its own buffer.
+  void render_loop() {
+    const InvoiceExample example(options_.page_format, options_.fonts);
+    RenderContext context;
+    const ScopedRenderContext scope(context);
+
+    WorkPtr work;
+    while (render_queue_.pop(work)) {
+      const Clock::time_point start = Clock::now();
+      const bool rendered =
+          example.createInvoidcw(work->provider, work->client, work->items, work->pdf);
+      render_nanoseconds_ += static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+      if (!rendered) {
+        ++failed_;
+        note_error(work->line, "invoice could not be rendered");
+        recycle(work);
+        continue;
+      }
+      write_queue_.push(work);
+    }
+
+    if (--live_renderers_ == 0) {
+      write_queue_.close();
+    }
+  }
+
+  // All file IO happens here, so one slow write never holds up more than the queue depth.
+  // Files go through one FileWriter: temporary name, the configured fsync policy, rename.
+  void write_loop() {
+    const Clock::time_point start = Clock::now();
+    double waited = 0.0;
+    FileWriter writer(options_.output);
+    std::size_t failed_writes = 0;
+    std::string path;
+    WorkPtr work;
+    for (;;) {
+      const Clock::time_point pop_start = Clock::now();
+      if (!write_queue_.pop(work)) {
+        break;
+      }
+      waited += seconds_since(pop_start);
+
+      path = (output_dir_ / (work->file_stem + ".pdf")).string();
+      if (writer.write(path, work->pdf)) {
+        output_bytes_ += work->pdf.size();
+        const std::size_t invoices = ++invoices_;
+        if (options_.progress && options_.progress_interval > 0 &&
+            invoices % options_.progress_interval == 0) {
+          InvoiceBulkStats progress;
+          snapshot(progress);
+          progress.seconds = seconds_since(start);
+          options_.progress(progress);
+        }
+      } else {
+        ++failed_;
+        ++failed_writes;
+        note_error(work->line, "invoice PDF could not be written");
+      }
+      recycle(work);
+    }
+
+    // PerBatch files are only published (or lost) when their batch commits, so the counts are
+    // settled against the writer once the last batch is in.
+    writer.commit();
+    if (options_.output.fsync == FsyncPolicy::PerBatch) {
+      const FileWriterStats written = writer.stats();
+      const std::size_t lost = written.failed - failed_writes;
+      if (lost > 0) {
+        failed_ += lost;
+        invoices_ -= lost;
+        output_bytes_ = written.bytes;
+        note_failure(std::to_string(lost) + " invoice PDFs could not be committed");
+      }
+    }
+    write_seconds_ = seconds_since(start) - waited;
+  }
+
+  const InvoiceBulkOptions& options_;
+  const std::filesystem::path output_dir_;
+  const std::size_t input_bytes_;
+  const std::size_t render_workers_;
+
+  detail::BoundedQueue<WorkPtr> render_queue_;
+  detail::BoundedQueue<WorkPtr> write_queue_;
+  detail::BoundedQueue<WorkPtr> free_list_;
+  std::atomic<std::size_t> live_renderers_{0};
+
+  std::atomic<std::size_t> rows_{0};
+  std::atomic<std::size_t> invoices_{0};
+  std::atomic<std::size_t> rejected_{0};
+  std::atomic<std::size_t> failed_{0};
+  std::atomic<std::size_t> output_bytes_{0};
+  std::atomic<std::uint64_t> render_nanoseconds_{0};
+  // Each written by its own stage and read after the threads are joined.
+  double parse_seconds_ = 0.0;
+  double write_seconds_ = 0.0;
+
+  std::mutex error_mutex_;
+  std::string first_error_;
+};
+
+bool is_jsonl_path(const std::string& path) {
+  std::string extension = std::filesystem::path(path).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](const char c) {
+    return static_cast<char>((c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c);
+  });
+  return extension == ".jsonl" || extension == ".ndjson";
+}
+
+}  // namespace
+
+bool create_invoices_from_file(const std::string& input_path,
+                               const std::string& output_dir,
+                               const InvoiceBulkOptions& options,
+                               InvoiceBulkStats* stats) {
+  InvoiceBulkStats local_stats;
+  InvoiceBulkStats& out = (stats != nullptr) ? *stats : local_stats;
+  out = {};
+
+  // Step 1: Map the input and prepare the output directory.
+  detail::MappedFile input;
+  if (!input.open(input_path)) {
+    out.first_error = "cannot read " + input_path;
+    return false;
+  }
+  out.input_bytes = input.view().size();
+
+  std::error_code ec;
+  std::filesystem::create_directories(output_dir, ec);
+  if (!std::filesystem::is_directory(output_dir, ec)) {
+    out.first_error = "cannot create output directory " + output_dir;
+    return false;
+  }
+
+  std::size_t workers = options.render_workers;
+  if (workers == 0) {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    workers = (hardware > 3) ? hardware - 2 : 1;
+  }
+
+  // Step 2: Run the pipeline with the reader for the input format.
+  BulkPipeline pipeline(options, output_dir, workers, out.input_bytes);
+  const bool jsonl = options.input_format == BulkInputFormat::Jsonl ||
+                     (options.input_format == BulkInputFormat::Auto && is_jsonl_path(input_path));
+  if (jsonl) {
+    JsonlReader reader(input.view());
+    pipeline.run(reader, out);
+  } else {
+    CsvReader reader(input.view());
+    if (!reader.read_header(&out.first_error)) {
+      return false;
+    }
+    pipeline.run(reader, out);
+  }
+  return true;
+}
+
+}  // namespace libharu_examples
@@ -4,76 +4,1217 @@ High-level overview
 This file implements a full invoice renderer using libHaru primitives (text, lines,
 simple vector shapes, and page metrics). The overall flow is:
 
-1) Validate invoice inputs and initialize the `HPDF_Doc` + A4 page.
-2) Build visual structure using reusable drawing helpers (`draw_text`, `draw_line`).
+1) Validate invoice inputs and initialize the `HPDF_Doc` + a page of the instance's
+   `PageFormat`. Every coordinate comes from `InvoiceLayout<Format>`, a set of compile-time
+   constants checked by `static_assert`, so drawing does no geometry arithmetic.
+2) Build visual structure through a `detail::PageWriter`, which keeps text objects open and
+   skips redundant font/color/line-width operators.
 3) Render business content (header, parties, item table, totals, footer), save, free.
 
+`createInvoidcw` has every item before it draws, so its table is a `detail::TableLayout`
+(src/table_layout.cpp): columns are sized from the measured cells, descriptions wrap onto up
+to six lines, and rows that run past the bottom margin continue on a new page.
+
+The paginated variant reuses the same section helpers but pulls items from a callback, keeps
+the fixed grid (columns cannot be fitted to rows not yet seen), and starts a new page
+(continuation header + repeated table header) whenever rows reach the bottom margin,
+carrying the running subtotal across the break.
+
+`InvoiceStatement` appends paginated invoices to one long-lived document. Its fonts are looked
+up once, and the static header (title, logo, labels, first table header) and footer are drawn
+into content streams that every later invoice references instead of re-emitting.
+`createStatement` renders runs of invoices into separate statements on worker threads and
+joins them with `assemble_pdf`, which keeps one copy of those fonts and shared streams.
+
+Invoice numbers are derived from a SHA-256 of the parties and items, so a reprint carries the
+same number. Under a `ScopedRenderCache` the createInvoidcw overloads are keyed by that same
+content plus format and fonts, and served from src/render_cache.cpp when already rendered.
+
 libHaru logic addressed in this example
 ---------------------------------------
 - Coordinate system: positions are expressed in points from bottom-left.
 - Styling is explicit: fill color, stroke color, line width, and font are set before draw calls.
-- Text is rendered through text objects; this file wraps repetitive calls in helpers.
+- Text is rendered through text objects; consecutive strings share one BT/ET pair.
 - Layout is deterministic: fixed margins/columns enable repeatable output similar to form templates.
+- Streamed and statement tables right-align amounts on fixed column edges using precomputed
+  glyph widths and cut descriptions with an ellipsis; the measured table aligns prices on
+  their decimal points. Parties and the signature are always cut to their columns.
+- With a TrueTypeFontSet every string is UTF-8 in the embedded fonts, measured with their
+  shared tables; right-aligned and centered labels are re-measured at draw time.
+- Batch rendering: an `HPDF_Doc` is never shared between threads. Each batch worker owns one
+  document and recycles it with `HPDF_NewDoc` between jobs, or, when a `PdfAllocator` policy
+  is selected, recreates it through `HPDF_NewEx` on the worker's own allocator.
+- Statements: shared streams use `HPDF_Page_New_Content_Stream` /
+  `HPDF_Page_Insert_Shared_Content_Stream`, and each invoice gets an outline entry
+  (`HPDF_CreateOutline` + `HPDF_Page_CreateDestination`) pointing at its first page.
 */
 #include "libharu_examples/invoice_example.h"
+#include "libharu_examples/money.h"
+#include "libharu_examples/pdf_assembler.h"
+#include "libharu_examples/text_metrics.h"
 
 #include <hpdf.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <cstddef>
-#include <iomanip>
-#include <sstream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "font_face.h"
+#include "font_width_tables.h"
+#include "page_geometry.h"
+#include "page_writer.h"
+#include "pdf_document.h"
+#include "render_cache_state.h"
+#include "sha256.h"
+#include "table_layout.h"
 
 namespace libharu_examples {
+namespace detail {
+
+struct InvoiceFonts {
+  FontFace bold;
+  FontFace regular;
+  FontFace italic;
+
+  bool loaded() const {
+    return bold.font() != nullptr && regular.font() != nullptr && italic.font() != nullptr;
+  }
+};
+
+// Everything an InvoiceStatement keeps between invoices.
+struct StatementState {
+  PageFormat format = PageFormat::A4Portrait;
+  TrueTypeFontSet truetype;
+  HPDF_Doc pdf = nullptr;
+  InvoiceFonts fonts;
+  // Drawn by the first invoice and referenced by every later one.
+  HPDF_Dict header_stream = nullptr;
+  HPDF_Dict footer_stream = nullptr;
+  // First page of the invoice rendered last, for its outline entry.
+  HPDF_Page first_page = nullptr;
+  std::size_t invoices = 0;
+  std::size_t pages = 0;
+  bool failed = false;
+};
+
+}  // namespace detail
+
 namespace {
 
-void error_handler(HPDF_STATUS, HPDF_STATUS, void*) {
+using detail::InvoiceFonts;
+
+// Table cells group thousands; the grand total also carries the currency symbol.
+constexpr MoneyFormat kAmountFormat{};
+constexpr MoneyFormat kTotalFormat{"$"};
+constexpr std::int32_t kSalesTaxBasisPoints = 500;
+
+// Unit price rounded to the cent and the exact line amount; false if either is unrepresentable.
+bool item_amounts(const InvoiceExample::Item& item, Money& unit_price, Money& amount) {
+  return Money::from_double(item.unit_price, unit_price) &&
+         unit_price.multiply(item.quantity, amount);
+}
+
+void draw_label_value(detail::PageWriter& writer,
+                      const detail::FontFace& label_font,
+                      const detail::FontFace& value_font,
+                      const float x_label,
+                      const float x_value,
+                      const float y,
+                      const char* label,
+                      const char* value) {
+  writer.text(label_font, 10.5F, x_label, y, label);
+  writer.text(value_font, 10.5F, x_value, y, value);
+}
+
+bool valid_item(const InvoiceExample::Item& item) {
+  Money unit_price;
+  Money amount;
+  return item.quantity > 0 && item.unit_price >= 0.0 && item_amounts(item, unit_price, amount);
+}
+
+bool valid_invoice_inputs(const InvoiceExample::Provider& provider,
+                          const InvoiceExample::Client& client,
+                          const std::vector<InvoiceExample::Item>& items) {
+  if (provider.name.empty() || client.name.empty() || items.empty()) {
+    return false;
+  }
+
+  return std::all_of(items.begin(), items.end(), valid_item);
+}
+
+// Theme colors (deep navy + accent red + near-black ink)
+constexpr detail::RgbColor kNavy{0.11F, 0.16F, 0.35F};
+constexpr detail::RgbColor kAccent{0.86F, 0.33F, 0.29F};
+constexpr detail::RgbColor kInk{0.05F, 0.07F, 0.12F};
+constexpr detail::RgbColor kLogoGray{0.70F, 0.72F, 0.76F};
+constexpr detail::RgbColor kWhite{1.0F, 1.0F, 1.0F};
+
+constexpr float kMargin = 50.0F;
+constexpr float kGap = 10.0F;
+constexpr float kRowHeight = 28.0F;
+// From the table's top rule down to the first row's baseline.
+constexpr float kTableHeaderDepth = 55.0F;
+
+// Paginated mode packs rows tighter and stops above the bottom margin.
+constexpr float kPaginatedRowHeight = 20.0F;
+constexpr float kPaginatedRowsBottom = 80.0F;
+
+// The measured items table of `createInvoidcw`: columns sized from their cells, descriptions
+// wrapped at 13pt leading onto at most six lines.
+constexpr float kColumnGap = 2.0F * kGap;
+constexpr float kMinDescriptionWidth = 100.0F;
+constexpr float kDescriptionLeading = 13.0F;
+constexpr std::size_t kMaxDescriptionLines = 6;
+constexpr float kMaxItemRowHeight =
+    kRowHeight + static_cast<float>(kMaxDescriptionLines - 1) * kDescriptionLeading;
+
+constexpr const char* kCarriedForward = "Subtotal carried forward";
+constexpr const char* kBroughtForward = "Brought forward";
+
+constexpr float width_of(const StandardFont font, const std::string_view text, const float size) {
+  return detail::static_text_width(font, text, size);
+}
+
+// Every coordinate of the invoice for one page format, fixed at compile time. Columns hang off
+// both margins, so a narrower page narrows the description and party columns instead of
+// pushing amounts past the right margin; landscape pages tighten the header and move the
+// footer beside the totals. The static_asserts reject any format whose grid would overlap or
+// leave the page.
+template <PageFormat Format>
+struct InvoiceLayout {
+  static constexpr detail::PageGeometry kPage = detail::page_geometry(Format);
+  static constexpr bool kLandscape = kPage.landscape();
+  static constexpr float kHeight = kPage.height;
+  static constexpr float kLeft = kMargin;
+  static constexpr float kRight = kPage.width - kMargin;
+  static constexpr float kContentWidth = kRight - kLeft;
+  // Pages shorter than A4 portrait use a tighter header to leave room for rows.
+  static constexpr bool kCompact = kHeight < 800.0F;
+
+  // Header: title, logo placeholder and the provider lines.
+  static constexpr float kTitleSize = kCompact ? 40.0F : 52.0F;
+  static constexpr float kTitleY = kHeight - (kCompact ? 62.0F : 90.0F);
+  static constexpr float kLogoRadius = kCompact ? 28.0F : 35.0F;
+  static constexpr float kLogoX = kRight - kLogoRadius;
+  static constexpr float kLogoY = kHeight - (kCompact ? 55.0F : 70.0F);
+  static constexpr float kLogoTextX =
+      kLogoX - width_of(StandardFont::HelveticaBold, "LOGO", 16.0F) / 2.0F;
+  static constexpr float kLogoTextY = kLogoY - 6.0F;
+  static constexpr float kLine1 = kCompact ? 16.0F : 20.0F;
+  static constexpr float kLine2 = kCompact ? 30.0F : 38.0F;
+  static constexpr float kLine3 = kCompact ? 44.0F : 56.0F;
+  static constexpr float kProviderY = kHeight - (kCompact ? 95.0F : 140.0F);
+
+  // Bill-to / ship-to columns and the invoice meta block against the right margin.
+  static constexpr float kBlockTop = kHeight - (kCompact ? 150.0F : 235.0F);
+  static constexpr float kBillToX = kLeft;
+  static constexpr float kShipToX = kLeft + (kLandscape ? 220.0F : 165.0F);
+  static constexpr float kMetaValueX = kRight - 85.0F;
+  static constexpr float kMetaLabelX = kMetaValueX - 90.0F;
+  static constexpr float kBillToWidth = kShipToX - kGap - kBillToX;
+  static constexpr float kShipToWidth = kMetaLabelX - kGap - kShipToX;
+
+  // Items table. Money columns are right-aligned on fixed edges.
+  static constexpr float kTableTop = kHeight - (kCompact ? 215.0F : 330.0F);
+  static constexpr float kContinuationTableTop = kHeight - 110.0F;
+  static constexpr float kQtyX = kLeft + 28.0F;
+  static constexpr float kDescriptionX = kLeft + 80.0F;
+  static constexpr float kAmountRight = kRight;
+  static constexpr float kUnitPriceRight = kRight - 110.0F;
+  static constexpr float kDescriptionWidth = kUnitPriceRight - 100.0F - kDescriptionX;
+  static constexpr float kUnitPriceHeaderX =
+      kUnitPriceRight - width_of(StandardFont::HelveticaBold, "UNIT PRICE", 11.5F);
+  static constexpr float kAmountHeaderX =
+      kAmountRight - width_of(StandardFont::HelveticaBold, "AMOUNT", 11.5F);
+  static constexpr float kCarriedForwardX =
+      kUnitPriceRight - width_of(StandardFont::HelveticaOblique, kCarriedForward, 11.0F);
+  static constexpr float kBroughtForwardX =
+      kUnitPriceRight - width_of(StandardFont::HelveticaOblique, kBroughtForward, 11.0F);
+
+  // Totals: labels end on the unit-price edge, values on the amount edge.
+  static constexpr float kSubtotalLabelX =
+      kUnitPriceRight - width_of(StandardFont::Helvetica, "Subtotal", 11.0F);
+  static constexpr float kTaxLabelX =
+      kUnitPriceRight - width_of(StandardFont::Helvetica, "Sales Tax 5.0%", 11.0F);
+  static constexpr float kTotalLabelX =
+      kUnitPriceRight - width_of(StandardFont::HelveticaBold, "TOTAL", 18.0F);
+
+  // Footer: "Thank you", a vertical rule and the terms column.
+  static constexpr float kFooterY = kLandscape ? 80.0F : 120.0F;
+  static constexpr float kFooterTop = kFooterY + 110.0F;
+  static constexpr float kThankYouWidth =
+      width_of(StandardFont::HelveticaOblique, "Thank you", 56.0F);
+  static constexpr float kTermsWidth =
+      std::max({width_of(StandardFont::HelveticaBold, "TERMS & CONDITIONS", 15.0F),
+                width_of(StandardFont::Helvetica, "Payment is due within 15 days", 11.0F),
+                width_of(StandardFont::Helvetica, "Account number: 1234567890", 11.0F)});
+  static constexpr float kTermsX =
+      kLandscape ? kLeft + kThankYouWidth + 3.0F * kGap : kRight - kTermsWidth;
+  static constexpr float kFooterRuleX = kTermsX - kGap;
+  static constexpr float kThankYouX =
+      kLandscape ? kLeft + kGap : kLeft + (kFooterRuleX - kLeft - kThankYouWidth) / 2.0F;
+  static constexpr float kFooterRight = kTermsX + kTermsWidth;
+
+  // The closing block hangs below the last row: totals at -10/-32/-60, signature at -100.
+  static constexpr float kClosingBlockBottom = kLandscape ? 190.0F : 350.0F;
+  static constexpr float kClosingDepth = 108.0F;
+  static constexpr float kSignatureLeft = kLandscape ? kFooterRight + kGap : kLeft + 150.0F;
+  static constexpr float kSignatureWidth = kRight - kSignatureLeft;
+  static constexpr float kClosingLeft = std::min(kTaxLabelX, kSignatureLeft);
+
+  static_assert(kLeft + width_of(StandardFont::HelveticaBold, "INVOICE", kTitleSize) + kGap <=
+                    kLogoX - kLogoRadius,
+                "title runs into the logo");
+  static_assert(kMetaLabelX + width_of(StandardFont::HelveticaBold, "INVOICE DATE", 10.5F) +
+                        kGap <=
+                    kMetaValueX,
+                "meta labels run into their values");
+  static_assert(kMetaValueX + width_of(StandardFont::Helvetica, "25/02/2026", 10.5F) <= kRight,
+                "meta values cross the right margin");
+  static_assert(kMetaValueX + width_of(StandardFont::Helvetica, "INV-DDDDDDDD", 10.5F) <= kRight,
+                "the widest invoice number crosses the right margin");
+  static_assert(kShipToWidth >= 120.0F, "party columns too narrow");
+  static_assert(kDescriptionWidth >= 180.0F, "description column too narrow");
+  static_assert(kDescriptionX + kDescriptionWidth + kGap <= kUnitPriceHeaderX,
+                "description column overlaps the unit price");
+  static_assert(kUnitPriceRight + kGap <= kAmountHeaderX, "unit price overlaps the amount");
+  static_assert(kTableTop - 55.0F - kRowHeight >= kClosingBlockBottom,
+                "no item row fits above the closing block");
+  static_assert(kContinuationTableTop - 55.0F - kPaginatedRowHeight >= kClosingBlockBottom,
+                "a continuation page cannot hold the closing block; pagination would not end");
+  static_assert(kTableTop - 55.0F - kPaginatedRowHeight >= kPaginatedRowsBottom,
+                "no paginated row fits on the first page");
+  static_assert(kLeft + kThankYouWidth + 2.0F * kGap <= kFooterRuleX,
+                "'Thank you' runs into the terms rule");
+  static_assert(kFooterRight <= kRight, "terms cross the right margin");
+  static_assert(kClosingBlockBottom + kPaginatedRowHeight - 4.0F >= kFooterTop + kGap,
+                "the last item row runs into the footer");
+  static_assert(kFooterRight + kGap <= kClosingLeft ||
+                    kClosingBlockBottom - kClosingDepth >= kFooterTop + kGap,
+                "totals or signature overlap the footer");
+  static_assert(kClosingBlockBottom - kClosingDepth >= 30.0F, "signature leaves the page");
+  // The widest cells Money and int allow (all Helvetica digits are equally wide).
+  static_assert(kContentWidth - width_of(StandardFont::Helvetica, "2147483647", 11.0F) -
+                        width_of(StandardFont::Helvetica, "999,999,999,999,999.99", 11.0F) -
+                        width_of(StandardFont::Helvetica, "92,233,720,368,547,758.07", 11.0F) -
+                        3.0F * kColumnGap >=
+                    kMinDescriptionWidth,
+                "the widest numbers leave the measured table no description column");
+  static_assert(kTableTop - kTableHeaderDepth - kMaxItemRowHeight >= kPaginatedRowsBottom,
+                "the tallest wrapped row does not fit on the first page");
+  static_assert(kContinuationTableTop - kTableHeaderDepth - kRowHeight - kMaxItemRowHeight >=
+                    kPaginatedRowsBottom,
+                "the tallest wrapped row does not fit on a continuation page");
+};
+
+// Invoice numbers and cache keys are digests of the inputs. Parties go in first and items one
+// at a time, so a streamed invoice hashes as it draws and ends with the same digest as the
+// same items passed as a vector. Prices are hashed as the cents that get printed.
+void hash_invoice_parties(detail::FieldHash& hash,
+                          const InvoiceExample::Provider& provider,
+                          const InvoiceExample::Client& client) {
+  for (const std::string* field : {&provider.name,
+                                   &provider.address,
+                                   &provider.email,
+                                   &client.name,
+                                   &client.address,
+                                   &client.email}) {
+    hash.add(*field);
+  }
+}
+
+void hash_invoice_item(detail::FieldHash& hash, const InvoiceExample::Item& item) {
+  Money unit_price;
+  Money::from_double(item.unit_price, unit_price);
+  hash.add(item.description);
+  hash.add(std::int64_t{item.quantity});
+  hash.add(unit_price.cents());
+}
+
+// "INV-" and the first 32 bits of the content digest in hex: the same invoice keeps its
+// number across runs, batches and statements, wherever it is rendered.
+std::string invoice_number_text(detail::FieldHash& hash) {
+  std::string number = "INV-" + detail::to_hex(hash.finish(), 4);
+  std::transform(number.begin(), number.end(), number.begin(), [](const char c) {
+    return (c >= 'a' && c <= 'f') ? static_cast<char>(c - 'a' + 'A') : c;
+  });
+  return number;
+}
+
+// Draws an amount so that it ends at `right`.
+void draw_amount(detail::PageWriter& writer,
+                 const detail::FontFace& font,
+                 const float size,
+                 const float right,
+                 const float y,
+                 const MoneyText& text) {
+  writer.text(font, size, right - font.width(text.view(), size), y, text.c_str());
+}
+
+// Step 3: Header parts that are the same on every invoice: title, branding placeholder,
+// column labels and the invoice meta block (except the invoice number).
+template <typename Layout>
+void draw_header_chrome(detail::PageWriter& writer, const InvoiceFonts& fonts) {
+  writer.set_fill(kNavy);
+  writer.text(fonts.bold, Layout::kTitleSize, Layout::kLeft, Layout::kTitleY, "INVOICE");
+
+  // Logo placeholder circle
+  writer.set_stroke(kLogoGray);
+  writer.set_fill(kLogoGray);
+  writer.fill_circle(Layout::kLogoX, Layout::kLogoY, Layout::kLogoRadius);
+  writer.set_fill(kWhite);
+  writer.text(fonts.bold,
+              16.0F,
+              fonts.bold.centered(Layout::kLogoTextX, "LOGO", 16.0F),
+              Layout::kLogoTextY,
+              "LOGO");
+
+  constexpr float kTop = Layout::kBlockTop;
+  writer.set_fill(kNavy);
+  writer.text(fonts.bold, 11.5F, Layout::kBillToX, kTop, "BILL TO");
+  writer.text(fonts.bold, 11.5F, Layout::kShipToX, kTop, "SHIP TO");
+
+  // The invoice number value is drawn separately (see `draw_invoice_number`) so streamed
+  // invoices can fill it in once every item has been hashed.
+  constexpr float kLabelX = Layout::kMetaLabelX;
+  constexpr float kValueX = Layout::kMetaValueX;
+  writer.text(fonts.bold, 10.5F, kLabelX, kTop, "INVOICE #");
+  draw_label_value(writer,
+                   fonts.bold,
+                   fonts.regular,
+                   kLabelX,
+                   kValueX,
+                   kTop - Layout::kLine1,
+                   "INVOICE DATE",
+                   "10/02/2026");
+  draw_label_value(writer,
+                   fonts.bold,
+                   fonts.regular,
+                   kLabelX,
+                   kValueX,
+                   kTop - Layout::kLine2,
+                   "P.O.#",
+                   "PO-4821");
+  draw_label_value(writer,
+                   fonts.bold,
+                   fonts.regular,
+                   kLabelX,
+                   kValueX,
+                   kTop - Layout::kLine3,
+                   "DUE DATE",
+                   "25/02/2026");
+}
+
+// Step 4: Render provider/client sections as aligned columns.
+template <typename Layout>
+void draw_header_parties(detail::PageWriter& writer,
+                         const InvoiceFonts& fonts,
+                         const InvoiceExample::Provider& provider,
+                         const InvoiceExample::Client& client) {
+  constexpr float kProviderY = Layout::kProviderY;
+  constexpr float kWidth = Layout::kContentWidth;
+  writer.set_fill(kInk);
+  writer.fitted_text(fonts.bold,
+                     12.0F,
+                     Layout::kLeft,
+                     kProviderY,
+                     kWidth,
+                     provider.name);
+  writer.fitted_text(fonts.regular,
+                     11.0F,
+                     Layout::kLeft,
+                     kProviderY - Layout::kLine1,
+                     kWidth,
+                     provider.address);
+  writer.fitted_text(fonts.regular,
+                     11.0F,
+                     Layout::kLeft,
+                     kProviderY - Layout::kLine2,
+                     kWidth,
+                     provider.email);
+
+  // Reuse client as ship-to to keep the same class model.
+  constexpr float kTop = Layout::kBlockTop;
+  for (const auto& [x, width] : {std::pair{Layout::kBillToX, Layout::kBillToWidth},
+                                 std::pair{Layout::kShipToX, Layout::kShipToWidth}}) {
+    writer.fitted_text(fonts.bold,
+                       11.0F,
+                       x,
+                       kTop - Layout::kLine1,
+                       width,
+                       client.name);
+    writer.fitted_text(fonts.regular,
+                       11.0F,
+                       x,
+                       kTop - Layout::kLine2,
+                       width,
+                       client.address);
+    writer.fitted_text(fonts.regular,
+                       11.0F,
+                       x,
+                       kTop - Layout::kLine3,
+                       width,
+                       client.email);
+  }
+}
+
+// Step 3 + 4: Returns the y coordinate where the items table starts.
+template <typename Layout>
+float draw_invoice_header(detail::PageWriter& writer,
+                          const InvoiceFonts& fonts,
+                          const InvoiceExample::Provider& provider,
+                          const InvoiceExample::Client& client) {
+  draw_header_chrome<Layout>(writer, fonts);
+  draw_header_parties<Layout>(writer, fonts, provider, client);
+  return Layout::kTableTop;
+}
+
+template <typename Layout>
+void draw_invoice_number(detail::PageWriter& writer,
+                         const InvoiceFonts& fonts,
+                         const std::string& invoice_number) {
+  writer.set_fill(kInk);
+  writer.text(fonts.regular, 10.5F, Layout::kMetaValueX, Layout::kBlockTop, invoice_number);
 }
 
-std::string money_string(double value) {
-  std::ostringstream stream;
-  stream << std::fixed << std::setprecision(2) << value;
-  return stream.str();
+// Compact header for continuation pages of a paginated invoice. Returns the table top.
+template <typename Layout>
+float draw_continuation_header(detail::PageWriter& writer,
+                               const InvoiceFonts& fonts,
+                               const InvoiceExample::Provider& provider,
+                               const std::size_t page_number) {
+  constexpr float kHeight = Layout::kHeight;
+
+  writer.set_fill(kNavy);
+  writer.text(fonts.bold, 24.0F, Layout::kLeft, kHeight - 60.0F, "INVOICE");
+  writer.set_fill(kInk);
+  writer.fitted_text(
+      fonts.bold, 11.0F, Layout::kLeft, kHeight - 82.0F, Layout::kContentWidth, provider.name);
+  writer.text(fonts.regular,
+              11.0F,
+              Layout::kMetaLabelX,
+              kHeight - 60.0F,
+              "Page " + std::to_string(page_number) + " (continued)");
+
+  return Layout::kContinuationTableTop;
+}
+
+// Step 5: Build the items table structure (header separators + headings). Returns the y
+// coordinate of the first row.
+template <typename Layout>
+float draw_table_header(detail::PageWriter& writer,
+                        const InvoiceFonts& fonts,
+                        const float table_top) {
+  writer.set_line_width(1.5F);
+  writer.set_stroke(kAccent);
+  writer.line(Layout::kLeft, table_top, Layout::kRight, table_top);
+
+  const float heading_y = table_top - 20.0F;
+  writer.set_fill(kNavy);
+  writer.text(fonts.bold, 11.5F, Layout::kLeft + 20.0F, heading_y, "QTY");
+  writer.text(fonts.bold, 11.5F, Layout::kDescriptionX, heading_y, "DESCRIPTION");
+  writer.text(fonts.bold,
+              11.5F,
+              fonts.bold.right_aligned(Layout::kUnitPriceHeaderX, "UNIT PRICE", 11.5F),
+              heading_y,
+              "UNIT PRICE");
+  writer.text(fonts.bold,
+              11.5F,
+              fonts.bold.right_aligned(Layout::kAmountHeaderX, "AMOUNT", 11.5F),
+              heading_y,
+              "AMOUNT");
+
+  writer.line(Layout::kLeft, table_top - 28.0F, Layout::kRight, table_top - 28.0F);
+
+  writer.set_fill(kInk);
+  return table_top - kTableHeaderDepth;
 }
 
-void draw_text(HPDF_Page page,
-               HPDF_Font font,
-               const float size,
-               const float x,
-               const float y,
-               const std::string& text) {
+// Step 6 (one row): Draws an item row and adds its amount to `subtotal`. False if the item
+// is invalid or the subtotal would overflow.
+template <typename Layout>
+bool draw_item_row(detail::PageWriter& writer,
+                   const InvoiceFonts& fonts,
+                   const float y,
+                   const InvoiceExample::Item& item,
+                   Money& subtotal) {
+  Money unit_price;
+  Money amount;
+  if (!item_amounts(item, unit_price, amount) || !subtotal.add(amount, subtotal)) {
+    return false;
+  }
+
+  writer.text(fonts.regular, 11.0F, Layout::kQtyX, y, std::to_string(item.quantity));
+
+  writer.fitted_text(fonts.regular,
+                     11.0F,
+                     Layout::kDescriptionX,
+                     y,
+                     Layout::kDescriptionWidth,
+                     item.description.empty() ? std::string_view("(no description)")
+                                              : std::string_view(item.description));
+
+  draw_amount(writer,
+              fonts.regular,
+              11.0F,
+              Layout::kUnitPriceRight,
+              y,
+              format_money(unit_price, kAmountFormat));
+  draw_amount(writer,
+              fonts.regular,
+              11.0F,
+              Layout::kAmountRight,
+              y,
+              format_money(amount, kAmountFormat));
+  return true;
+}
+
+// Running-subtotal line used at page breaks of a paginated invoice; `label_x` is the label's
+// precomputed right-aligned position.
+template <typename Layout>
+void draw_carry_row(detail::PageWriter& writer,
+                    const InvoiceFonts& fonts,
+                    const float y,
+                    const float label_x,
+                    const char* label,
+                    const Money running_subtotal) {
+  writer.set_fill(kNavy);
+  writer.text(fonts.italic, 11.0F, fonts.italic.right_aligned(label_x, label, 11.0F), y, label);
+  draw_amount(writer,
+              fonts.bold,
+              11.0F,
+              Layout::kAmountRight,
+              y,
+              format_money(running_subtotal, kAmountFormat));
+  writer.set_fill(kInk);
+}
+
+// Step 7 + 8: Totals (subtotal, tax, grand total) and the provider's signature. False if
+// the total overflows.
+template <typename Layout>
+bool draw_totals(detail::PageWriter& writer,
+                 const InvoiceFonts& fonts,
+                 const InvoiceExample::Provider& provider,
+                 const float y,
+                 const Money subtotal) {
+  // Step 7: Compute and render financial totals (subtotal, tax, grand total) in exact cents.
+  Money tax;
+  Money total;
+  if (!subtotal.percentage(kSalesTaxBasisPoints, tax) || !subtotal.add(tax, total)) {
+    return false;
+  }
+  const float totals_y = y - 10.0F;
+  constexpr float kRight = Layout::kAmountRight;
+  constexpr const char* kTaxLabel = "Sales Tax 5.0%";
+
+  writer.text(fonts.regular,
+              11.0F,
+              fonts.regular.right_aligned(Layout::kSubtotalLabelX, "Subtotal", 11.0F),
+              totals_y,
+              "Subtotal");
+  draw_amount(writer,
+              fonts.regular,
+              11.0F,
+              kRight,
+              totals_y,
+              format_money(subtotal, kAmountFormat));
+
+  writer.text(fonts.regular,
+              11.0F,
+              fonts.regular.right_aligned(Layout::kTaxLabelX, kTaxLabel, 11.0F),
+              totals_y - 22.0F,
+              kTaxLabel);
+  draw_amount(writer,
+              fonts.regular,
+              11.0F,
+              kRight,
+              totals_y - 22.0F,
+              format_money(tax, kAmountFormat));
+
+  writer.set_fill(kNavy);
+  writer.text(fonts.bold,
+              18.0F,
+              fonts.bold.right_aligned(Layout::kTotalLabelX, "TOTAL", 18.0F),
+              totals_y - 50.0F,
+              "TOTAL");
+  draw_amount(writer,
+              fonts.bold,
+              18.0F,
+              kRight,
+              totals_y - 50.0F,
+              format_money(total, kTotalFormat));
+
+  // Step 8: Draw the signature; it ends on the right margin.
+  writer.set_fill(kInk);
+  std::string signature;
+  fonts.italic.fit_with_ellipsis(provider.name, 28.0F, Layout::kSignatureWidth, signature);
+  writer.text(fonts.italic,
+              28.0F,
+              kRight - fonts.italic.width(signature, 28.0F),
+              totals_y - 90.0F,
+              signature);
+  return true;
+}
+
+// Step 8: The footer is the same on every invoice and sits at a fixed height.
+template <typename Layout>
+void draw_footer(detail::PageWriter& writer, const InvoiceFonts& fonts) {
+  constexpr float kFooterY = Layout::kFooterY;
+  constexpr float kTermsX = Layout::kTermsX;
+  writer.set_fill(kNavy);
+  writer.text(fonts.italic, 56.0F, Layout::kThankYouX, kFooterY, "Thank you");
+
+  writer.set_line_width(1.0F);
+  writer.set_stroke(kNavy);
+  writer.line(Layout::kFooterRuleX, kFooterY - 8.0F, Layout::kFooterRuleX, Layout::kFooterTop);
+
+  writer.set_fill(kAccent);
+  writer.text(fonts.bold, 15.0F, kTermsX, kFooterY + 95.0F, "TERMS & CONDITIONS");
+
+  writer.set_fill(kInk);
+  writer.text(fonts.regular, 11.0F, kTermsX, kFooterY + 62.0F, "Payment is due within 15 days");
+  writer.text(fonts.regular, 11.0F, kTermsX, kFooterY + 38.0F, "Name of Bank");
+  writer.text(fonts.regular, 11.0F, kTermsX, kFooterY + 20.0F, "Account number: 1234567890");
+  writer.text(fonts.regular, 11.0F, kTermsX, kFooterY + 2.0F, "Routing: 098765432");
+}
+
+template <typename Layout>
+bool draw_closing_block(detail::PageWriter& writer,
+                        const InvoiceFonts& fonts,
+                        const InvoiceExample::Provider& provider,
+                        const float y,
+                        const Money subtotal) {
+  if (!draw_totals<Layout>(writer, fonts, provider, y, subtotal)) {
+    return false;
+  }
+  draw_footer<Layout>(writer, fonts);
+  return true;
+}
+
+// Totals and footer always land on the last page: `start_page` opens one more (moving the
+// caller's cursor) when they do not fit below `y`.
+template <typename Layout, typename StartPageFn>
+bool make_room_for_closing_block(const float y, const Money subtotal, StartPageFn&& start_page) {
+  return y >= Layout::kClosingBlockBottom || start_page(subtotal);
+}
+
+InvoiceFonts load_invoice_fonts(HPDF_Doc pdf, const TrueTypeFontSet& truetype) {
+  return {detail::load_face(pdf, truetype, StandardFont::HelveticaBold),
+          detail::load_face(pdf, truetype, StandardFont::Helvetica),
+          detail::load_face(pdf, truetype, StandardFont::HelveticaOblique)};
+}
+
+// Columns of the measured items table, left to right.
+enum ItemColumn : std::size_t { kQtyColumn, kDescriptionColumn, kUnitPriceColumn, kAmountColumn };
+constexpr std::size_t kItemColumns = 4;
+constexpr std::array<const char*, kItemColumns> kItemHeadings{
+    "QTY", "DESCRIPTION", "UNIT PRICE", "AMOUNT"};
+
+// Step 5 (measured table): the same rules as `draw_table_header`, with the headings placed on
+// the fitted columns: numeric headings end on their column's right edge. `heading_widths` are
+// measured once per invoice.
+template <typename Layout>
+float draw_measured_table_header(detail::PageWriter& writer,
+                                 const InvoiceFonts& fonts,
+                                 const detail::TableLayout& table,
+                                 const std::array<float, kItemColumns>& heading_widths,
+                                 const float table_top) {
+  writer.set_line_width(1.5F);
+  writer.set_stroke(kAccent);
+  writer.line(Layout::kLeft, table_top, Layout::kRight, table_top);
+
+  const float heading_y = table_top - 20.0F;
+  writer.set_fill(kNavy);
+  for (std::size_t c = 0; c < kItemColumns; ++c) {
+    const float x = (c == kDescriptionColumn) ? table.column_left(c)
+                                              : table.column_right(c) - heading_widths[c];
+    writer.text(fonts.bold, 11.5F, x, heading_y, kItemHeadings[c]);
+  }
+
+  writer.line(Layout::kLeft, table_top - 28.0F, Layout::kRight, table_top - 28.0F);
+
+  writer.set_fill(kInk);
+  return table_top - kTableHeaderDepth;
+}
+
+// Step 6 (measured table): one row per item with the quantity right-aligned, the description
+// wrapped and both prices aligned on their decimal point. `running_subtotals` gets the
+// subtotal after each row (for carried-forward lines); false if an amount or the subtotal
+// overflows.
+bool layout_item_table(detail::TableLayout& table,
+                       const std::vector<InvoiceExample::Item>& items,
+                       std::vector<Money>& running_subtotals,
+                       Money& subtotal) {
+  std::size_t text_bytes = 0;
+  for (const InvoiceExample::Item& item : items) {
+    text_bytes += item.description.size() + 40;
+  }
+  table.reserve(items.size(), text_bytes);
+  running_subtotals.reserve(items.size());
+
+  for (const InvoiceExample::Item& item : items) {
+    Money unit_price;
+    Money amount;
+    if (!item_amounts(item, unit_price, amount) || !subtotal.add(amount, subtotal)) {
+      return false;
+    }
+    running_subtotals.push_back(subtotal);
+
+    char quantity[16];
+    const std::to_chars_result digits =
+        std::to_chars(quantity, quantity + sizeof(quantity), item.quantity);
+    const MoneyText unit_text = format_money(unit_price, kAmountFormat);
+    const MoneyText amount_text = format_money(amount, kAmountFormat);
+    const std::array<std::string_view, kItemColumns> cells{
+        std::string_view(quantity, static_cast<std::size_t>(digits.ptr - quantity)),
+        item.description.empty() ? std::string_view("(no description)")
+                                 : std::string_view(item.description),
+        unit_text.view(),
+        amount_text.view()};
+    if (!table.add_row(cells.data())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Draws the whole invoice into `pdf`, which must hold a fresh (empty) document.
+template <typename Layout>
+bool render_invoice(HPDF_Doc pdf,
+                    const TrueTypeFontSet& truetype,
+                    const InvoiceExample::Provider& provider,
+                    const InvoiceExample::Client& client,
+                    const std::vector<InvoiceExample::Item>& items) {
+  // Step 2: Allocate page objects and base typography resources.
+  HPDF_SetPagesConfiguration(pdf, 64);
+  HPDF_Page page = detail::add_page(pdf, Layout::kPage);
+  if (page == nullptr) {
+    return false;
+  }
+
+  const InvoiceFonts fonts = load_invoice_fonts(pdf, truetype);
+  detail::mark_phase(detail::RenderPhase::Setup);
+  if (!fonts.loaded()) {
+    return false;
+  }
+
+  // Step 6a: Measure every cell once and fit the columns before anything is drawn. Numeric
+  // columns are at least as wide as their headings.
+  std::array<float, kItemColumns> heading_widths{};
+  for (std::size_t c = 0; c < kItemColumns; ++c) {
+    heading_widths[c] = fonts.bold.width(kItemHeadings[c], 11.5F);
+  }
+  std::vector<detail::TableColumn> columns(kItemColumns);
+  for (std::size_t c = 0; c < kItemColumns; ++c) {
+    columns[c].face = &fonts.regular;
+    columns[c].min_width = heading_widths[c];
+  }
+  columns[kQtyColumn].align = detail::CellAlign::Right;
+  columns[kDescriptionColumn].wraps = true;
+  columns[kUnitPriceColumn].align = detail::CellAlign::Decimal;
+  columns[kAmountColumn].align = detail::CellAlign::Decimal;
+
+  detail::TableLayout table(std::move(columns), kColumnGap);
+  std::vector<Money> running_subtotals;
+  Money subtotal;
+  if (!layout_item_table(table, items, running_subtotals, subtotal) ||
+      !table.fit(Layout::kLeft,
+                 Layout::kRight,
+                 kMinDescriptionWidth,
+                 kRowHeight,
+                 kDescriptionLeading,
+                 kMaxDescriptionLines)) {
+    return false;
+  }
+
+  detail::PageWriter writer(page);
+  const float table_top = draw_invoice_header<Layout>(writer, fonts, provider, client);
+  detail::FieldHash number;
+  hash_invoice_parties(number, provider, client);
+  for (const InvoiceExample::Item& item : items) {
+    hash_invoice_item(number, item);
+  }
+  draw_invoice_number<Layout>(writer, fonts, invoice_number_text(number));
+
+  // Step 6b: Draw the rows, starting a continuation page when the next row (and the
+  // carried-forward line below it) would cross the bottom margin.
+  float y = draw_measured_table_header<Layout>(writer, fonts, table, heading_widths, table_top);
+  std::size_t page_number = 1;
+  const float carry_right = table.column_right(kUnitPriceColumn);
+  const auto start_continuation_page = [&](const Money running_subtotal) {
+    draw_carry_row<Layout>(writer,
+                           fonts,
+                           y,
+                           carry_right - width_of(StandardFont::HelveticaOblique,
+                                                  kCarriedForward,
+                                                  11.0F),
+                           kCarriedForward,
+                           running_subtotal);
+    page = detail::add_page(pdf, Layout::kPage);
+    if (page == nullptr) {
+      return false;
+    }
+    writer.reset(page);
+    ++page_number;
+    y = draw_measured_table_header<Layout>(
+        writer,
+        fonts,
+        table,
+        heading_widths,
+        draw_continuation_header<Layout>(writer, fonts, provider, page_number));
+    draw_carry_row<Layout>(writer,
+                           fonts,
+                           y,
+                           carry_right - width_of(StandardFont::HelveticaOblique,
+                                                  kBroughtForward,
+                                                  11.0F),
+                           kBroughtForward,
+                           running_subtotal);
+    y -= kRowHeight;
+    return true;
+  };
+
+  Money carried;
+  for (std::size_t row = 0; row < table.row_count(); ++row) {
+    const float height = table.row_height(row);
+    if (y - height < kPaginatedRowsBottom && !start_continuation_page(carried)) {
+      return false;
+    }
+    table.draw_row(writer, row, y);
+    y -= height;
+    carried = running_subtotals[row];
+  }
+
+  if (!make_room_for_closing_block<Layout>(y, subtotal, start_continuation_page)) {
+    return false;
+  }
+  return draw_closing_block<Layout>(writer, fonts, provider, y, subtotal);
+}
+
+// Selecting every font once, in a fixed order, gives each statement page the same resource
+// names (F1, F2, F3) that the shared header and footer streams refer to.
+void register_invoice_fonts(HPDF_Page page, const InvoiceFonts& fonts) {
   HPDF_Page_BeginText(page);
-  HPDF_Page_SetFontAndSize(page, font, size);
-  HPDF_Page_TextOut(page, x, y, text.c_str());
+  HPDF_Page_SetFontAndSize(page, fonts.bold.font(), 12.0F);
+  HPDF_Page_SetFontAndSize(page, fonts.regular.font(), 12.0F);
+  HPDF_Page_SetFontAndSize(page, fonts.italic.font(), 12.0F);
   HPDF_Page_EndText(page);
 }
 
-void draw_label_value(HPDF_Page page,
-                      HPDF_Font label_font,
-                      HPDF_Font value_font,
-                      const float x_label,
-                      const float x_value,
-                      const float y,
-                      const std::string& label,
-                      const std::string& value) {
-  draw_text(page, label_font, 10.5F, x_label, y, label);
-  draw_text(page, value_font, 10.5F, x_value, y, value);
-}
-
-void draw_line(HPDF_Page page,
-               const float x1,
-               const float y1,
-               const float x2,
-               const float y2,
-               const float line_width,
-               const float red,
-               const float green,
-               const float blue) {
-  HPDF_Page_SetLineWidth(page, line_width);
-  HPDF_Page_SetRGBStroke(page, red, green, blue);
-  HPDF_Page_MoveTo(page, x1, y1);
-  HPDF_Page_LineTo(page, x2, y2);
-  HPDF_Page_Stroke(page);
+// Adds `stream` to `page`: drawn by `draw` into a new content stream the first time, and
+// referenced by later pages instead of being emitted again. Either way, what follows goes
+// into a fresh stream of its own.
+template <typename DrawFn>
+bool add_shared_stream(HPDF_Page page,
+                       detail::PageWriter& writer,
+                       HPDF_Dict& stream,
+                       DrawFn&& draw) {
+  writer.flush();
+  if (stream == nullptr) {
+    if (HPDF_Page_New_Content_Stream(page, &stream) != HPDF_OK) {
+      return false;
+    }
+    // Bracketed and drawn with no assumed state, so it renders the same wherever it lands.
+    writer.invalidate();
+    HPDF_Page_GSave(page);
+    draw();
+    writer.flush();
+    HPDF_Page_GRestore(page);
+  } else if (HPDF_Page_Insert_Shared_Content_Stream(page, stream) != HPDF_OK) {
+    return false;
+  }
+  writer.invalidate();
+  return HPDF_Page_New_Content_Stream(page, nullptr) == HPDF_OK;
+}
+
+// Multi-page variant: pulls items one at a time, so only the current item is held in memory.
+// Page breaks repeat the table header and carry the running subtotal forward. With
+// `statement` set the invoice is appended to the statement's document, using its fonts and
+// shared header and footer streams.
+template <typename Layout>
+bool render_paginated_invoice(HPDF_Doc pdf,
+                              const TrueTypeFontSet& truetype,
+                              const InvoiceExample::Provider& provider,
+                              const InvoiceExample::Client& client,
+                              const InvoiceExample::ItemSource& next_item,
+                              detail::StatementState* statement = nullptr) {
+  // Page handles are plain pointers into the document libHaru already owns; the number of
+  // pages is deferred until the source is drained.
+  if (statement == nullptr) {
+    HPDF_SetPagesConfiguration(pdf, 64);
+  }
+
+  HPDF_Page first_page = detail::add_page(pdf, Layout::kPage);
+  if (first_page == nullptr) {
+    return false;
+  }
+
+  const InvoiceFonts fonts =
+      (statement != nullptr) ? statement->fonts : load_invoice_fonts(pdf, truetype);
+  detail::mark_phase(detail::RenderPhase::Setup);
+  if (!fonts.loaded()) {
+    return false;
+  }
+  detail::PageWriter writer(first_page);
+  HPDF_Page page = first_page;
+  std::size_t page_number = 1;
+  float y = 0.0F;
+  if (statement != nullptr) {
+    register_invoice_fonts(first_page, fonts);
+    const bool header_added =
+        add_shared_stream(first_page, writer, statement->header_stream, [&] {
+          draw_header_chrome<Layout>(writer, fonts);
+          draw_table_header<Layout>(writer, fonts, Layout::kTableTop);
+        });
+    if (!header_added) {
+      return false;
+    }
+    draw_header_parties<Layout>(writer, fonts, provider, client);
+    y = Layout::kTableTop - kTableHeaderDepth;
+  } else {
+    y = draw_table_header<Layout>(
+        writer, fonts, draw_invoice_header<Layout>(writer, fonts, provider, client));
+  }
+
+  const auto start_continuation_page = [&](const Money running_subtotal) {
+    draw_carry_row<Layout>(
+        writer, fonts, y, Layout::kCarriedForwardX, kCarriedForward, running_subtotal);
+    page = detail::add_page(pdf, Layout::kPage);
+    if (page == nullptr) {
+      return false;
+    }
+    if (statement != nullptr) {
+      register_invoice_fonts(page, fonts);
+    }
+    writer.reset(page);
+    ++page_number;
+    y = draw_table_header<Layout>(
+        writer,
+        fonts,
+        draw_continuation_header<Layout>(writer, fonts, provider, page_number));
+    draw_carry_row<Layout>(
+        writer, fonts, y, Layout::kBroughtForwardX, kBroughtForward, running_subtotal);
+    y -= kPaginatedRowHeight;
+    return true;
+  };
+
+  std::size_t item_count = 0;
+  Money subtotal;
+  detail::FieldHash number;
+  hash_invoice_parties(number, provider, client);
+  InvoiceExample::Item item;
+  while (next_item(item)) {
+    if (!valid_item(item)) {
+      return false;
+    }
+    hash_invoice_item(number, item);
+
+    // Keep one row free below the last item for the carried-forward line.
+    if (y - kPaginatedRowHeight < kPaginatedRowsBottom && !start_continuation_page(subtotal)) {
+      return false;
+    }
+
+    if (!draw_item_row<Layout>(writer, fonts, y, item, subtotal)) {
+      return false;
+    }
+    y -= kPaginatedRowHeight;
+    ++item_count;
+  }
+
+  if (item_count == 0) {
+    return false;
+  }
+
+  if (!make_room_for_closing_block<Layout>(y, subtotal, start_continuation_page)) {
+    return false;
+  }
+
+  if (statement != nullptr) {
+    const bool closed =
+        add_shared_stream(page,
+                          writer,
+                          statement->footer_stream,
+                          [&] { draw_footer<Layout>(writer, fonts); }) &&
+        draw_totals<Layout>(writer, fonts, provider, y, subtotal);
+    if (!closed) {
+      return false;
+    }
+    statement->first_page = first_page;
+    statement->pages += page_number;
+  } else if (!draw_closing_block<Layout>(writer, fonts, provider, y, subtotal)) {
+    return false;
+  }
+
+  // The number covers every item, so it goes back onto the first page once they are drawn.
+  writer.reset(first_page);
+  draw_invoice_number<Layout>(writer, fonts, invoice_number_text(number));
+  return true;
+}
+
+// Instantiates `render` for the compile-time layout of `format`.
+template <typename RenderFn>
+bool with_invoice_layout(const PageFormat format, RenderFn&& render) {
+  return detail::dispatch_page_format(format, [&render](auto tag) {
+    return render(InvoiceLayout<decltype(tag)::value>{});
+  });
+}
+
+InvoiceExample::JobStatus render_job(HPDF_Doc& pdf,
+                                     const PageFormat format,
+                                     const TrueTypeFontSet& truetype,
+                                     const InvoiceExample::BatchJob& job) {
+  if (job.output_pdf_path.empty() || !valid_invoice_inputs(job.provider, job.client, job.items)) {
+    return InvoiceExample::JobStatus::InvalidInput;
+  }
+
+  // Reset the worker-owned document instead of allocating a new HPDF_Doc per job.
+  const bool rendered =
+      detail::reset_document(pdf) && with_invoice_layout(format, [&](auto layout) {
+        return render_invoice<decltype(layout)>(
+            pdf, truetype, job.provider, job.client, job.items);
+      });
+  if (!rendered) {
+    return InvoiceExample::JobStatus::RenderFailed;
+  }
+  detail::mark_phase(detail::RenderPhase::Draw);
+
+  if (!detail::save_to_file(pdf, job.output_pdf_path)) {
+    return InvoiceExample::JobStatus::SaveFailed;
+  }
+  return InvoiceExample::JobStatus::Ok;
+}
+
+// Claims jobs through the shared counter until none are left, rendering them all into one
+// worker-owned document.
+void run_batch_worker(const std::vector<InvoiceExample::BatchJob>& jobs,
+                      const PageFormat format,
+                      const TrueTypeFontSet& truetype,
+                      std::vector<InvoiceExample::JobStatus>& results,
+                      std::atomic<std::size_t>& next_job) {
+  HPDF_Doc pdf = detail::new_document();
+  for (std::size_t i = next_job.fetch_add(1); i < jobs.size(); i = next_job.fetch_add(1)) {
+    results[i] = (pdf == nullptr) ? InvoiceExample::JobStatus::RenderFailed
+                                  : render_job(pdf, format, truetype, jobs[i]);
+  }
+  detail::free_document(pdf);
+}
+
+// Document lifecycle shared by the file, buffer and sink entry points: allocate, draw
+// through `render`, hand the finished document to `save`, release.
+template <typename RenderFn, typename SaveFn>
+bool render_invoice_document(RenderFn&& render, SaveFn&& save) {
+  HPDF_Doc pdf = detail::new_document();
+  if (pdf == nullptr) {
+    return false;
+  }
+
+  // Step 9: Save through the caller's output, then release document memory.
+  const bool rendered = render(pdf);
+  detail::mark_phase(detail::RenderPhase::Draw);
+  const bool saved = rendered && save(pdf);
+  detail::free_document(pdf);
+  return saved;
+}
+
+// One invoice through `save`: the createInvoidcw overloads, and the buffer render behind a
+// render cache.
+template <typename SaveFn>
+bool render_single_invoice(const PageFormat format,
+                           const TrueTypeFontSet& truetype,
+                           const InvoiceExample::Provider& provider,
+                           const InvoiceExample::Client& client,
+                           const std::vector<InvoiceExample::Item>& items,
+                           SaveFn&& save) {
+  return render_invoice_document(
+      [&](HPDF_Doc pdf) {
+        return with_invoice_layout(format, [&](auto layout) {
+          return render_invoice<decltype(layout)>(pdf, truetype, provider, client, items);
+        });
+      },
+      std::forward<SaveFn>(save));
+}
+
+std::string invoice_cache_key(const PageFormat format,
+                              const TrueTypeFontSet& truetype,
+                              const InvoiceExample::Provider& provider,
+                              const InvoiceExample::Client& client,
+                              const std::vector<InvoiceExample::Item>& items) {
+  detail::FieldHash key = detail::begin_key("invoice", format, truetype);
+  hash_invoice_parties(key, provider, client);
+  for (const InvoiceExample::Item& item : items) {
+    hash_invoice_item(key, item);
+  }
+  return detail::finish_key(key);
+}
+
+// Serves the invoice from the thread's render cache, rendering into a buffer on a miss.
+template <typename Output>
+bool cached_invoice(const PageFormat format,
+                    const TrueTypeFontSet& truetype,
+                    const InvoiceExample::Provider& provider,
+                    const InvoiceExample::Client& client,
+                    const std::vector<InvoiceExample::Item>& items,
+                    Output& output) {
+  return detail::cached_render(
+      invoice_cache_key(format, truetype, provider, client, items),
+      output,
+      [&](PdfBuffer& rendered) {
+        return render_single_invoice(
+            format, truetype, provider, client, items, [&rendered](HPDF_Doc pdf) {
+              return detail::save_to_buffer(pdf, rendered);
+            });
+      });
+}
+
+// Renders `entries` as contiguous runs of invoices, one InvoiceStatement per worker thread,
+// so the parts join in entry order.
+bool render_statement_parts(const std::vector<InvoiceExample::StatementEntry>& entries,
+                            const PageFormat format,
+                            const TrueTypeFontSet& truetype,
+                            const std::size_t worker_count,
+                            std::vector<PdfBuffer>& parts) {
+  if (entries.empty()) {
+    return false;
+  }
+
+  std::size_t part_count = worker_count;
+  if (part_count == 0) {
+    part_count = std::max(1U, std::thread::hardware_concurrency());
+  }
+  part_count = std::min(part_count, entries.size());
+
+  parts.assign(part_count, PdfBuffer{});
+  std::vector<char> rendered(part_count, 0);
+  const auto render_part = [&](const std::size_t part) {
+    const std::size_t begin = entries.size() * part / part_count;
+    const std::size_t end = entries.size() * (part + 1) / part_count;
+    InvoiceStatement statement(format, truetype);
+    for (std::size_t i = begin; i < end; ++i) {
+      const InvoiceExample::StatementEntry& entry = entries[i];
+      if (!statement.add_invoice(entry.provider, entry.client, entry.items, entry.bookmark)) {
+        return;
+      }
+    }
+    rendered[part] = statement.save(parts[part]) ? 1 : 0;
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(part_count - 1);
+  for (std::size_t i = 1; i < part_count; ++i) {
+    pool.emplace_back(render_part, i);
+  }
+  render_part(0);
+  for (std::thread& thread : pool) {
+    thread.join();
+  }
+  return std::find(rendered.begin(), rendered.end(), 0) == rendered.end();
 }
 
 }  // namespace
@@ -83,244 +1224,285 @@ bool InvoiceExample::createInvoidcw(const Provider& provider,
                                     const std::vector<Item>& items,
                                     const std::string& output_pdf_path) const {
   // Step 1: Validate semantic inputs before touching libHaru resources.
-  if (output_pdf_path.empty() || provider.name.empty() || client.name.empty() ||
-      items.empty()) {
+  if (output_pdf_path.empty() || !valid_invoice_inputs(provider, client, items)) {
     return false;
   }
+  if (detail::cache_active()) {
+    return cached_invoice(format_, fonts_, provider, client, items, output_pdf_path);
+  }
 
-  for (const Item& item : items) {
-    if (item.quantity <= 0 || item.unit_price < 0.0) {
-      return false;
-    }
+  return render_single_invoice(
+      format_, fonts_, provider, client, items, [&output_pdf_path](HPDF_Doc pdf) {
+        return detail::save_to_file(pdf, output_pdf_path);
+      });
+}
+
+bool InvoiceExample::createInvoidcw(const Provider& provider,
+                                    const Client& client,
+                                    const std::vector<Item>& items,
+                                    PdfBuffer& output) const {
+  output.clear();
+  if (!valid_invoice_inputs(provider, client, items)) {
+    return false;
+  }
+  if (detail::cache_active()) {
+    return cached_invoice(format_, fonts_, provider, client, items, output);
   }
 
-  // Step 2: Allocate libHaru document/page objects and base typography resources.
-  HPDF_Doc pdf = HPDF_New(error_handler, nullptr);
-  if (pdf == nullptr) {
+  return render_single_invoice(format_, fonts_, provider, client, items, [&output](HPDF_Doc pdf) {
+    return detail::save_to_buffer(pdf, output);
+  });
+}
+
+bool InvoiceExample::createInvoidcw(const Provider& provider,
+                                    const Client& client,
+                                    const std::vector<Item>& items,
+                                    const PdfSink& sink) const {
+  if (!sink || !valid_invoice_inputs(provider, client, items)) {
     return false;
   }
+  if (detail::cache_active()) {
+    return cached_invoice(format_, fonts_, provider, client, items, sink);
+  }
 
-  HPDF_Page page = HPDF_AddPage(pdf);
-  if (page == nullptr) {
-    HPDF_Free(pdf);
+  return render_single_invoice(format_, fonts_, provider, client, items, [&sink](HPDF_Doc pdf) {
+    return detail::save_to_sink(pdf, sink);
+  });
+}
+
+bool InvoiceExample::createPaginatedInvoice(const Provider& provider,
+                                            const Client& client,
+                                            const ItemSource& next_item,
+                                            const std::string& output_pdf_path) const {
+  if (output_pdf_path.empty() || provider.name.empty() || client.name.empty() || !next_item) {
     return false;
   }
 
-  HPDF_Page_SetSize(page, HPDF_PAGE_SIZE_A4, HPDF_PAGE_PORTRAIT);
+  return render_invoice_document(
+      [&](HPDF_Doc pdf) {
+        return with_invoice_layout(format_, [&](auto layout) {
+          return render_paginated_invoice<decltype(layout)>(
+              pdf, fonts_, provider, client, next_item);
+        });
+      },
+      [&output_pdf_path](HPDF_Doc pdf) { return detail::save_to_file(pdf, output_pdf_path); });
+}
+
+bool InvoiceExample::createPaginatedInvoice(const Provider& provider,
+                                            const Client& client,
+                                            const ItemSource& next_item,
+                                            PdfBuffer& output) const {
+  output.clear();
+  if (provider.name.empty() || client.name.empty() || !next_item) {
+    return false;
+  }
 
-  HPDF_Font bold_font = HPDF_GetFont(pdf, "Helvetica-Bold", nullptr);
-  HPDF_Font regular_font = HPDF_GetFont(pdf, "Helvetica", nullptr);
-  HPDF_Font italic_font = HPDF_GetFont(pdf, "Helvetica-Oblique", nullptr);
+  return render_invoice_document(
+      [&](HPDF_Doc pdf) {
+        return with_invoice_layout(format_, [&](auto layout) {
+          return render_paginated_invoice<decltype(layout)>(
+              pdf, fonts_, provider, client, next_item);
+        });
+      },
+      [&output](HPDF_Doc pdf) { return detail::save_to_buffer(pdf, output); });
+}
 
-  const float page_width = HPDF_Page_GetWidth(page);
-  const float page_height = HPDF_Page_GetHeight(page);
-  const float margin_left = 50.0F;
-  const float margin_right = page_width - 50.0F;
+bool InvoiceExample::createPaginatedInvoice(const Provider& provider,
+                                            const Client& client,
+                                            const ItemSource& next_item,
+                                            const PdfSink& sink) const {
+  if (!sink || provider.name.empty() || client.name.empty() || !next_item) {
+    return false;
+  }
 
-  // Theme colors (deep navy + accent red)
-  const float navy_r = 0.11F;
-  const float navy_g = 0.16F;
-  const float navy_b = 0.35F;
-  const float accent_r = 0.86F;
-  const float accent_g = 0.33F;
-  const float accent_b = 0.29F;
+  return render_invoice_document(
+      [&](HPDF_Doc pdf) {
+        return with_invoice_layout(format_, [&](auto layout) {
+          return render_paginated_invoice<decltype(layout)>(
+              pdf, fonts_, provider, client, next_item);
+        });
+      },
+      [&sink](HPDF_Doc pdf) { return detail::save_to_sink(pdf, sink); });
+}
 
-  // Step 3: Draw the invoice header region and branding placeholder.
-  HPDF_Page_SetRGBFill(page, navy_r, navy_g, navy_b);
-  draw_text(page, bold_font, 52.0F, margin_left, page_height - 90.0F, "INVOICE");
+std::vector<InvoiceExample::JobStatus> InvoiceExample::createInvoiceBatch(
+    const std::vector<BatchJob>& jobs,
+    const std::size_t worker_count) const {
+  BatchOptions options;
+  options.worker_count = worker_count;
+  return createInvoiceBatch(jobs, options);
+}
 
-  // Logo placeholder circle
-  HPDF_Page_SetRGBStroke(page, 0.70F, 0.72F, 0.76F);
-  HPDF_Page_SetRGBFill(page, 0.70F, 0.72F, 0.76F);
-  HPDF_Page_Circle(page, margin_right - 35.0F, page_height - 70.0F, 35.0F);
-  HPDF_Page_Fill(page);
-  HPDF_Page_SetRGBFill(page, 1.0F, 1.0F, 1.0F);
-  draw_text(page, bold_font, 16.0F, margin_right - 56.0F, page_height - 76.0F, "LOGO");
-
-  // Step 4: Render provider/client/meta sections as aligned columns.
-  HPDF_Page_SetRGBFill(page, 0.05F, 0.07F, 0.12F);
-  draw_text(page, bold_font, 12.0F, margin_left, page_height - 140.0F, provider.name);
-  draw_text(page, regular_font, 11.0F, margin_left, page_height - 160.0F, provider.address);
-  draw_text(page, regular_font, 11.0F, margin_left, page_height - 178.0F, provider.email);
-
-  // Top information columns
-  const float block_top = page_height - 235.0F;
-  const float col1_x = margin_left;
-  const float col2_x = margin_left + 180.0F;
-  const float col3_x = margin_left + 390.0F;
-
-  HPDF_Page_SetRGBFill(page, navy_r, navy_g, navy_b);
-  draw_text(page, bold_font, 11.5F, col1_x, block_top, "BILL TO");
-  draw_text(page, bold_font, 11.5F, col2_x, block_top, "SHIP TO");
-
-  HPDF_Page_SetRGBFill(page, 0.05F, 0.07F, 0.12F);
-  draw_text(page, bold_font, 11.0F, col1_x, block_top - 20.0F, client.name);
-  draw_text(page, regular_font, 11.0F, col1_x, block_top - 38.0F, client.address);
-  draw_text(page, regular_font, 11.0F, col1_x, block_top - 56.0F, client.email);
+std::vector<InvoiceExample::JobStatus> InvoiceExample::createInvoiceBatch(
+    const std::vector<BatchJob>& jobs,
+    const BatchOptions& options) const {
+  std::vector<JobStatus> results(jobs.size(), JobStatus::RenderFailed);
+  if (jobs.empty()) {
+    return results;
+  }
 
-  // Reuse client as ship-to to keep the same class model.
-  draw_text(page, bold_font, 11.0F, col2_x, block_top - 20.0F, client.name);
-  draw_text(page, regular_font, 11.0F, col2_x, block_top - 38.0F, client.address);
-  draw_text(page, regular_font, 11.0F, col2_x, block_top - 56.0F, client.email);
-
-  const std::string invoice_number = "INV-" + std::to_string(items.size()) + "-2026";
-  draw_label_value(page,
-                   bold_font,
-                   regular_font,
-                   col3_x,
-                   col3_x + 100.0F,
-                   block_top,
-                   "INVOICE #",
-                   invoice_number);
-  draw_label_value(page,
-                   bold_font,
-                   regular_font,
-                   col3_x,
-                   col3_x + 100.0F,
-                   block_top - 20.0F,
-                   "INVOICE DATE",
-                   "10/02/2026");
-  draw_label_value(page,
-                   bold_font,
-                   regular_font,
-                   col3_x,
-                   col3_x + 100.0F,
-                   block_top - 40.0F,
-                   "P.O.#",
-                   "PO-4821");
-  draw_label_value(page,
-                   bold_font,
-                   regular_font,
-                   col3_x,
-                   col3_x + 100.0F,
-                   block_top - 60.0F,
-                   "DUE DATE",
-                   "25/02/2026");
+  std::size_t worker_count = options.worker_count;
+  if (worker_count == 0) {
+    worker_count = std::max(1U, std::thread::hardware_concurrency());
+  }
+  worker_count = std::min(worker_count, jobs.size());
 
-  // Step 5: Build the items table structure (header separators + headings).
-  const float table_top = page_height - 330.0F;
-  draw_line(page,
-            margin_left,
-            table_top,
-            margin_right,
-            table_top,
-            1.5F,
-            accent_r,
-            accent_g,
-            accent_b);
-
-  HPDF_Page_SetRGBFill(page, navy_r, navy_g, navy_b);
-  draw_text(page, bold_font, 11.5F, margin_left + 20.0F, table_top - 20.0F, "QTY");
-  draw_text(page, bold_font, 11.5F, margin_left + 140.0F, table_top - 20.0F, "DESCRIPTION");
-  draw_text(page, bold_font, 11.5F, margin_left + 420.0F, table_top - 20.0F, "UNIT PRICE");
-  draw_text(page, bold_font, 11.5F, margin_right - 60.0F, table_top - 20.0F, "AMOUNT");
-
-  draw_line(page,
-            margin_left,
-            table_top - 28.0F,
-            margin_right,
-            table_top - 28.0F,
-            1.5F,
-            accent_r,
-            accent_g,
-            accent_b);
-
-  // Step 6: Iterate invoice items and draw each row with consistent spacing.
-  HPDF_Page_SetRGBFill(page, 0.05F, 0.07F, 0.12F);
-  float y = table_top - 55.0F;
-  double subtotal = 0.0;
-
-  for (std::size_t i = 0; i < items.size(); ++i) {
-    const Item& item = items[i];
-    const double amount = static_cast<double>(item.quantity) * item.unit_price;
-    subtotal += amount;
-
-    draw_text(page, regular_font, 11.0F, margin_left + 28.0F, y, std::to_string(item.quantity));
-
-    std::string description = item.description.empty() ? "(no description)" : item.description;
-    if (description.size() > 42) {
-      description = description.substr(0, 39) + "...";
+  // Workers claim jobs through a shared counter so uneven invoices still balance out.
+  // Each result slot is written by exactly one worker, so `results` needs no lock. Allocators
+  // are per worker as well, so no policy ever sees two threads.
+  std::atomic<std::size_t> next_job{0};
+  std::vector<PdfAllocatorStats> worker_stats(worker_count);
+  const auto worker = [&](const std::size_t worker_index) {
+    const std::unique_ptr<PdfAllocator> allocator = make_pdf_allocator(options.allocator);
+    if (allocator == nullptr) {
+      run_batch_worker(jobs, format_, fonts_, results, next_job);
+      return;
     }
-    draw_text(page, regular_font, 11.0F, margin_left + 80.0F, y, description);
 
-    const std::string unit_price_text = money_string(item.unit_price);
-    const std::string amount_text = money_string(amount);
+    {
+      ScopedPdfAllocator scope(*allocator);
+      run_batch_worker(jobs, format_, fonts_, results, next_job);
+    }
+    worker_stats[worker_index] = allocator->stats();
+  };
 
-    draw_text(page, regular_font, 11.0F, margin_left + 470.0F, y, unit_price_text);
-    draw_text(page, regular_font, 11.0F, margin_left + 560.0F, y, amount_text);
-    y -= 28.0F;
+  std::vector<std::thread> pool;
+  pool.reserve(worker_count - 1);
+  for (std::size_t i = 1; i < worker_count; ++i) {
+    pool.emplace_back(worker, i);
+  }
+  worker(0);
+  for (std::thread& thread : pool) {
+    thread.join();
   }
 
-  // Step 7: Compute and render financial totals (subtotal, tax, grand total).
-  const double tax = subtotal * 0.05;
-  const double total = subtotal + tax;
-  const float totals_y = y - 10.0F;
+  if (options.allocator_stats != nullptr) {
+    for (const PdfAllocatorStats& stats : worker_stats) {
+      *options.allocator_stats += stats;
+    }
+  }
+  return results;
+}
 
-  draw_text(page, regular_font, 11.0F, margin_left + 420.0F, totals_y, "Subtotal");
-  draw_text(page, regular_font, 11.0F, margin_left + 560.0F, totals_y, money_string(subtotal));
-
-  draw_text(page, regular_font, 11.0F, margin_left + 380.0F, totals_y - 22.0F, "Sales Tax 5.0%");
-  draw_text(page,
-            regular_font,
-            11.0F,
-            margin_left + 560.0F,
-            totals_y - 22.0F,
-            money_string(tax));
-
-  HPDF_Page_SetRGBFill(page, navy_r, navy_g, navy_b);
-  draw_text(page, bold_font, 18.0F, margin_left + 430.0F, totals_y - 50.0F, "TOTAL");
-  draw_text(page, bold_font, 18.0F, margin_left + 550.0F, totals_y - 50.0F, "$" + money_string(total));
-
-  // Step 8: Draw signature/footer region, then save and release document memory.
-  HPDF_Page_SetRGBFill(page, 0.05F, 0.07F, 0.12F);
-  draw_text(page, italic_font, 28.0F, margin_left + 470.0F, totals_y - 120.0F, provider.name);
-
-  const float footer_y = 120.0F;
-  HPDF_Page_SetRGBFill(page, navy_r, navy_g, navy_b);
-  draw_text(page, italic_font, 56.0F, margin_left + 60.0F, footer_y, "Thank you");
-
-  draw_line(page,
-            margin_left + 300.0F,
-            footer_y - 8.0F,
-            margin_left + 300.0F,
-            footer_y + 110.0F,
-            1.0F,
-            navy_r,
-            navy_g,
-            navy_b);
-
-  HPDF_Page_SetRGBFill(page, accent_r, accent_g, accent_b);
-  draw_text(page,
-            bold_font,
-            15.0F,
-            margin_left + 310.0F,
-            footer_y + 95.0F,
-            "TERMS & CONDITIONS");
-
-  HPDF_Page_SetRGBFill(page, 0.05F, 0.07F, 0.12F);
-  draw_text(page,
-            regular_font,
-            11.0F,
-            margin_left + 310.0F,
-            footer_y + 62.0F,
-            "Payment is due within 15 days");
-  draw_text(page, regular_font, 11.0F, margin_left + 310.0F, footer_y + 38.0F, "Name of Bank");
-  draw_text(page,
-            regular_font,
-            11.0F,
-            margin_left + 310.0F,
-            footer_y + 20.0F,
-            "Account number: 1234567890");
-  draw_text(page,
-            regular_font,
-            11.0F,
-            margin_left + 310.0F,
-            footer_y + 2.0F,
-            "Routing: 098765432");
-
-  const HPDF_STATUS save_result = HPDF_SaveToFile(pdf, output_pdf_path.c_str());
-  HPDF_Free(pdf);
-  return save_result == HPDF_OK;
+bool InvoiceExample::createStatement(const std::vector<StatementEntry>& entries,
+                                     PdfBuffer& output,
+                                     const std::size_t worker_count) const {
+  output.clear();
+  std::vector<PdfBuffer> parts;
+  if (!render_statement_parts(entries, format_, fonts_, worker_count, parts)) {
+    return false;
+  }
+  if (parts.size() == 1) {
+    output = std::move(parts.front());
+    return true;
+  }
+  return assemble_pdf(parts, output);
+}
+
+bool InvoiceExample::createStatement(const std::vector<StatementEntry>& entries,
+                                     const std::string& output_pdf_path,
+                                     const std::size_t worker_count) const {
+  std::vector<PdfBuffer> parts;
+  return !output_pdf_path.empty() &&
+         render_statement_parts(entries, format_, fonts_, worker_count, parts) &&
+         assemble_pdf(parts, output_pdf_path);
+}
+
+InvoiceStatement::InvoiceStatement(const PageFormat page_format)
+    : InvoiceStatement(page_format, TrueTypeFontSet{}) {
+}
+
+InvoiceStatement::InvoiceStatement(const PageFormat page_format, TrueTypeFontSet fonts)
+    : state_(std::make_unique<detail::StatementState>()) {
+  state_->format = page_format;
+  state_->truetype = std::move(fonts);
+  state_->pdf = detail::new_document();
+  if (state_->pdf == nullptr) {
+    state_->failed = true;
+    return;
+  }
+  // Thousands of pages: a balanced page tree keeps page insertion cheap.
+  HPDF_SetPagesConfiguration(state_->pdf, 64);
+  state_->fonts = load_invoice_fonts(state_->pdf, state_->truetype);
+  state_->failed = !state_->fonts.loaded();
+}
+
+InvoiceStatement::~InvoiceStatement() {
+  if (state_->pdf != nullptr) {
+    detail::free_document(state_->pdf);
+  }
+}
+
+bool InvoiceStatement::add_invoice(const InvoiceExample::Provider& provider,
+                                   const InvoiceExample::Client& client,
+                                   const std::vector<InvoiceExample::Item>& items,
+                                   const std::string& bookmark) {
+  if (state_->failed || !valid_invoice_inputs(provider, client, items)) {
+    return false;
+  }
+
+  std::size_t next = 0;
+  const InvoiceExample::ItemSource source = [&items, &next](InvoiceExample::Item& item) {
+    if (next == items.size()) {
+      return false;
+    }
+    item = items[next++];
+    return true;
+  };
+
+  detail::StatementState& state = *state_;
+  const bool rendered = with_invoice_layout(state.format, [&](auto layout) {
+    return render_paginated_invoice<decltype(layout)>(
+        state.pdf, state.truetype, provider, client, source, &state);
+  });
+
+  // The outline entry jumps to the invoice's first page.
+  HPDF_Outline outline = nullptr;
+  if (rendered) {
+    outline = HPDF_CreateOutline(
+        state.pdf, nullptr, (bookmark.empty() ? client.name : bookmark).c_str(), nullptr);
+  }
+  if (outline == nullptr ||
+      HPDF_Outline_SetDestination(outline, HPDF_Page_CreateDestination(state.first_page)) !=
+          HPDF_OK) {
+    state.failed = true;
+    return false;
+  }
+  ++state.invoices;
+  return true;
+}
+
+std::size_t InvoiceStatement::invoice_count() const {
+  return state_->invoices;
+}
+
+std::size_t InvoiceStatement::page_count() const {
+  return state_->pages;
+}
+
+bool InvoiceStatement::save(const std::string& output_pdf_path) {
+  if (state_->failed || state_->invoices == 0 || output_pdf_path.empty()) {
+    return false;
+  }
+  detail::mark_phase(detail::RenderPhase::Draw);
+  return detail::save_to_file(state_->pdf, output_pdf_path);
+}
+
+bool InvoiceStatement::save(PdfBuffer& output) {
+  output.clear();
+  if (state_->failed || state_->invoices == 0) {
+    return false;
+  }
+  detail::mark_phase(detail::RenderPhase::Draw);
+  return detail::save_to_buffer(state_->pdf, output);
+}
+
+bool InvoiceStatement::save(const PdfSink& sink) {
+  if (state_->failed || state_->invoices == 0 || !sink) {
+    return false;
+  }
+  detail::mark_phase(detail::RenderPhase::Draw);
+  return detail::save_to_sink(state_->pdf, sink);
 }
 
 }  // namespace libharu_examples
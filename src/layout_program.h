@@ -0,0 +1,128 @@
+#pragma once
+
+#include "libharu_examples/layout_template.h"
+#include "libharu_examples/text_metrics.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <hpdf.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "page_writer.h"
+
+namespace libharu_examples {
+namespace detail {
+
+enum class LayoutOp : std::uint8_t {
+  SetFill,
+  SetStroke,
+  SetLineWidth,
+  Text,
+  Line,
+  FillRect,
+  StrokeRect,
+  FillCircle,
+  Table,
+};
+
+enum class TextAlign : std::uint8_t {
+  Left,
+  Right,
+};
+
+// Text pieces are literal runs of `LayoutProgram::literals` followed by an optional value: a
+// record field, or a column of the row being drawn.
+struct LayoutPiece {
+  static constexpr std::uint32_t kNoValue = 0xFFFFFFFFU;
+  static constexpr std::uint32_t kColumnBit = 0x80000000U;
+
+  std::uint32_t literal_offset = 0;
+  std::uint32_t literal_size = 0;
+  std::uint32_t value = kNoValue;
+};
+
+// One draw instruction. Coordinates are final page coordinates except where `flow_y` is set
+// (y is then relative to the flow cursor below the last table) or inside a table body (y is
+// relative to the row baseline).
+struct LayoutInstruction {
+  LayoutOp op;
+  TextAlign align = TextAlign::Left;
+  bool flow_y = false;
+  std::uint16_t font = 0;
+  // Color, text or table index, depending on `op`.
+  std::uint32_t index = 0;
+  float x = 0.0F;
+  float y = 0.0F;
+  float a = 0.0F;  // x2, width, radius, line width or font size
+  float b = 0.0F;  // y2 or height
+  float max_width = 0.0F;
+};
+
+struct LayoutText {
+  std::uint32_t first_piece = 0;
+  std::uint32_t piece_count = 0;
+  // Literal-only text, drawn straight from `literals` without assembling.
+  bool constant = false;
+};
+
+// Rows repeat instructions [first, first + count) once per row; a row that would start below
+// `bottom` moves to a new page where rows continue from `top`.
+struct LayoutTable {
+  std::string name;
+  std::vector<std::string> columns;
+  std::uint32_t first = 0;
+  std::uint32_t count = 0;
+  float top = 0.0F;
+  float row_height = 0.0F;
+  float bottom = 0.0F;
+};
+
+struct LayoutFont {
+  std::string base_name;
+  // Set for TrueType fonts and fonts FontMetrics covers; required by `width=` and
+  // `align=right`.
+  bool has_metrics = false;
+  StandardFont metrics = StandardFont::Helvetica;
+  // Set for `font <name> "<path>"`; `base_name` is then empty.
+  std::shared_ptr<const TrueTypeFont> truetype;
+};
+
+struct LayoutProgram {
+  bool standard_size = true;
+  HPDF_PageSizes page_size = HPDF_PAGE_SIZE_A4;
+  HPDF_PageDirection direction = HPDF_PAGE_PORTRAIT;
+  float page_width = 0.0F;
+  float page_height = 0.0F;
+
+  std::vector<LayoutFont> fonts;
+  std::vector<RgbColor> colors;
+  std::vector<std::string> fields;
+  std::vector<LayoutTable> tables;
+  std::vector<LayoutText> texts;
+  std::vector<LayoutPiece> pieces;
+  std::string literals;
+  // Top-level instructions first; table bodies are stored after them.
+  std::vector<LayoutInstruction> instructions;
+  std::uint32_t top_level_count = 0;
+};
+
+struct LayoutAccess {
+  static const std::shared_ptr<const LayoutProgram>& program(const LayoutRecord& record) {
+    return record.program_;
+  }
+  static const std::vector<std::string>& fields(const LayoutRecord& record) {
+    return record.fields_;
+  }
+  static const std::string* cells(const LayoutRecord& record, std::size_t table) {
+    return record.tables_[table].data();
+  }
+  static std::size_t cell_count(const LayoutRecord& record, std::size_t table) {
+    return record.cell_counts_[table];
+  }
+};
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,299 @@
+/*
+High-level overview
+-------------------
+Executor for compiled layout templates (see `src/layout_template.cpp`). Binding a record does
+no parsing or name lookup: the program is a flat instruction array whose operands are already
+page coordinates, font/color indices and record slots.
+
+1) Create the document and first page, and select every template font once.
+2) Run the top-level instructions through a `detail::PageWriter`. Text with placeholders is
+   assembled into one reused buffer; literal text is drawn straight from the literal pool.
+3) A table instruction replays its row body once per record row, moving the baseline down by
+   the row height and starting a new page (with colors and line width restored) at the bottom.
+4) Instructions positioned with `^` follow the last table; the compiler guaranteed they fit
+   once the table's reserve is honoured.
+
+libHaru logic addressed in this file
+------------------------------------
+- A new page starts with the default graphics state, so fill/stroke colors and line width in
+  effect are re-emitted after each table page break.
+- `width=`/`align=right` measure with `FontMetrics` (or a TrueType font's shared tables) rather
+  than `HPDF_Page_TextWidth`, so no text state needs to be selected before measuring.
+- TrueType fonts are selected with the UTF-8 encoder, so record values are drawn as UTF-8.
+*/
+#include "libharu_examples/layout_template.h"
+
+#include <hpdf.h>
+
+#include <string>
+#include <vector>
+
+#include "font_face.h"
+#include "layout_program.h"
+#include "page_writer.h"
+#include "pdf_document.h"
+
+namespace libharu_examples {
+namespace {
+
+using detail::LayoutAccess;
+using detail::LayoutInstruction;
+using detail::LayoutOp;
+using detail::LayoutPiece;
+using detail::LayoutProgram;
+using detail::LayoutTable;
+using detail::LayoutText;
+using detail::TextAlign;
+
+class LayoutRenderer {
+ public:
+  LayoutRenderer(const LayoutProgram& program, const LayoutRecord& record, HPDF_Doc pdf)
+      : program_(program), record_(record), pdf_(pdf), writer_(nullptr) {}
+
+  bool run() {
+    // Step 1: First page and the template's fonts, selected once per document.
+    HPDF_Page page = add_page();
+    if (page == nullptr) {
+      return false;
+    }
+    fonts_.reserve(program_.fonts.size());
+    for (const detail::LayoutFont& font : program_.fonts) {
+      fonts_.push_back(font.truetype ? detail::load_truetype_font(pdf_, *font.truetype)
+                                     : HPDF_GetFont(pdf_, font.base_name.c_str(), nullptr));
+      if (fonts_.back() == nullptr) {
+        return false;
+      }
+    }
+    detail::mark_phase(detail::RenderPhase::Setup);
+    writer_.reset(page);
+
+    // Step 2: Top-level instructions; tables recurse into their row bodies.
+    for (std::uint32_t i = 0; i < program_.top_level_count; ++i) {
+      if (!execute(program_.instructions[i], 0.0F, nullptr)) {
+        return false;
+      }
+    }
+    writer_.flush();
+    return true;
+  }
+
+ private:
+  HPDF_Page add_page() {
+    HPDF_Page page = HPDF_AddPage(pdf_);
+    if (page == nullptr) {
+      return nullptr;
+    }
+    if (program_.standard_size) {
+      HPDF_Page_SetSize(page, program_.page_size, program_.direction);
+    } else {
+      HPDF_Page_SetWidth(page, program_.page_width);
+      HPDF_Page_SetHeight(page, program_.page_height);
+    }
+    return page;
+  }
+
+  // Continues on a fresh page and restores the template's graphics state there.
+  bool next_page() {
+    HPDF_Page page = add_page();
+    if (page == nullptr) {
+      return false;
+    }
+    writer_.reset(page);
+    if (has_fill_) {
+      writer_.set_fill(fill_);
+    }
+    if (has_stroke_) {
+      writer_.set_stroke(stroke_);
+    }
+    if (has_line_width_) {
+      writer_.set_line_width(line_width_);
+    }
+    return true;
+  }
+
+  // `base_y` is the row baseline inside a table body, 0 elsewhere; `row` points at the row's
+  // cells inside a table body.
+  bool execute(const LayoutInstruction& in, const float base_y, const std::string* row) {
+    const float y = in.y + (in.flow_y ? cursor_ : base_y);
+    switch (in.op) {
+      case LayoutOp::SetFill:
+        fill_ = program_.colors[in.index];
+        has_fill_ = true;
+        writer_.set_fill(fill_);
+        return true;
+      case LayoutOp::SetStroke:
+        stroke_ = program_.colors[in.index];
+        has_stroke_ = true;
+        writer_.set_stroke(stroke_);
+        return true;
+      case LayoutOp::SetLineWidth:
+        line_width_ = in.a;
+        has_line_width_ = true;
+        writer_.set_line_width(line_width_);
+        return true;
+      case LayoutOp::Text:
+        draw_text(in, y, row);
+        return true;
+      case LayoutOp::Line:
+        writer_.line(in.x, y, in.a, in.b + (in.flow_y ? cursor_ : base_y));
+        return true;
+      case LayoutOp::FillRect:
+        writer_.fill_rectangle(in.x, y, in.a, in.b);
+        return true;
+      case LayoutOp::StrokeRect:
+        writer_.stroke_rectangle(in.x, y, in.a, in.b);
+        return true;
+      case LayoutOp::FillCircle:
+        writer_.fill_circle(in.x, y, in.a);
+        return true;
+      case LayoutOp::Table:
+        return run_table(program_.tables[in.index], in.index, in.a);
+    }
+    return false;
+  }
+
+  // Step 3: One pass over the body per row; the baseline walks down from `top`.
+  bool run_table(const LayoutTable& table, const std::size_t index, const float reserve) {
+    const std::string* cells = LayoutAccess::cells(record_, index);
+    const std::size_t columns = table.columns.size();
+    const std::size_t rows = LayoutAccess::cell_count(record_, index) / columns;
+
+    float baseline = table.top;
+    for (std::size_t r = 0; r < rows; ++r) {
+      if (baseline < table.bottom) {
+        if (!next_page()) {
+          return false;
+        }
+        baseline = table.top;
+      }
+      const std::string* row = cells + r * columns;
+      for (std::uint32_t i = table.first; i < table.first + table.count; ++i) {
+        if (!execute(program_.instructions[i], baseline, row)) {
+          return false;
+        }
+      }
+      baseline -= table.row_height;
+    }
+
+    // Step 4: Whatever follows with `^` needs `reserve` points above the table bottom.
+    if (baseline - reserve < table.bottom) {
+      if (!next_page()) {
+        return false;
+      }
+      baseline = table.top;
+    }
+    cursor_ = baseline;
+    return true;
+  }
+
+  void draw_text(const LayoutInstruction& in, const float y, const std::string* row) {
+    const LayoutText& text = program_.texts[in.index];
+    const detail::LayoutFont& font = program_.fonts[in.font];
+    const char* content = nullptr;
+    std::size_t content_size = 0;
+
+    if (text.constant) {
+      const LayoutPiece& piece = program_.pieces[text.first_piece];
+      content = program_.literals.data() + piece.literal_offset;
+      content_size = piece.literal_size;
+    } else {
+      assembled_.clear();
+      const std::vector<std::string>& fields = LayoutAccess::fields(record_);
+      for (std::uint32_t p = text.first_piece; p < text.first_piece + text.piece_count; ++p) {
+        const LayoutPiece& piece = program_.pieces[p];
+        assembled_.append(program_.literals, piece.literal_offset, piece.literal_size);
+        if (piece.value == LayoutPiece::kNoValue) {
+          continue;
+        }
+        if ((piece.value & LayoutPiece::kColumnBit) != 0) {
+          assembled_ += row[piece.value & ~LayoutPiece::kColumnBit];
+        } else {
+          assembled_ += fields[piece.value];
+        }
+      }
+      content = assembled_.c_str();
+      content_size = assembled_.size();
+    }
+
+    float x = in.x;
+    if (font.has_metrics && (in.max_width > 0.0F || in.align == TextAlign::Right)) {
+      const detail::FontFace face(fonts_[in.font], font.metrics, font.truetype.get());
+      const std::string_view view(content, content_size);
+      if (in.max_width > 0.0F) {
+        face.fit_with_ellipsis(view, in.a, in.max_width, fitted_);
+        content = fitted_.c_str();
+        content_size = fitted_.size();
+      }
+      if (in.align == TextAlign::Right) {
+        x -= face.width(std::string_view(content, content_size), in.a);
+      }
+    }
+    writer_.text(fonts_[in.font], in.a, x, y, content);
+  }
+
+  const LayoutProgram& program_;
+  const LayoutRecord& record_;
+  HPDF_Doc pdf_;
+  detail::PageWriter writer_;
+  std::vector<HPDF_Font> fonts_;
+  std::string assembled_;
+  std::string fitted_;
+  float cursor_ = 0.0F;
+
+  detail::RgbColor fill_{0.0F, 0.0F, 0.0F};
+  detail::RgbColor stroke_{0.0F, 0.0F, 0.0F};
+  float line_width_ = 1.0F;
+  bool has_fill_ = false;
+  bool has_stroke_ = false;
+  bool has_line_width_ = false;
+};
+
+template <typename SaveFn>
+bool render_layout_document(const LayoutRecord& record, SaveFn&& save) {
+  const std::shared_ptr<const LayoutProgram>& program = LayoutAccess::program(record);
+  if (program == nullptr) {
+    return false;
+  }
+
+  HPDF_Doc pdf = detail::new_document();
+  if (pdf == nullptr) {
+    return false;
+  }
+
+  bool rendered = false;
+  {
+    LayoutRenderer renderer(*program, record, pdf);
+    rendered = renderer.run();
+  }
+  detail::mark_phase(detail::RenderPhase::Draw);
+  const bool saved = rendered && save(pdf);
+  detail::free_document(pdf);
+  return saved;
+}
+
+}  // namespace
+
+bool render_layout_pdf(const LayoutRecord& record, const std::string& output_pdf_path) {
+  if (output_pdf_path.empty()) {
+    return false;
+  }
+  return render_layout_document(record, [&output_pdf_path](HPDF_Doc pdf) {
+    return detail::save_to_file(pdf, output_pdf_path);
+  });
+}
+
+bool render_layout_pdf(const LayoutRecord& record, PdfBuffer& output) {
+  output.clear();
+  return render_layout_document(
+      record, [&output](HPDF_Doc pdf) { return detail::save_to_buffer(pdf, output); });
+}
+
+bool render_layout_pdf(const LayoutRecord& record, const PdfSink& sink) {
+  if (!sink) {
+    return false;
+  }
+  return render_layout_document(
+      record, [&sink](HPDF_Doc pdf) { return detail::save_to_sink(pdf, sink); });
+}
+
+}  // namespace libharu_examples
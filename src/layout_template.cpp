@@ -0,0 +1,881 @@
+/*
+High-level overview
+-------------------
+Compiler for the layout template language. A template is parsed and checked once; the
+result is a flat `detail::LayoutProgram` that `src/layout_render.cpp` replays per record.
+
+1) Split each line into words and quoted strings (`#` starts a comment outside quotes).
+2) Resolve names as they are declared: fonts and colors to indices, `{field}` placeholders to
+   record slots (or to the enclosing table's columns), tables to their own instruction ranges.
+3) Resolve coordinates: `w-40`/`h-90` against the page size, which is fixed per template, so only
+   row offsets and `^` (below the last table) remain relative at render time.
+4) Validate every position against the page box, including the worst case for row- and
+   flow-relative ones, so rendering needs no geometry checks.
+
+libHaru logic addressed in this file
+------------------------------------
+- Font names are checked against the base-14 set `HPDF_GetFont` accepts without loading a
+  font file. A quoted font is a TrueType file, parsed here once and embedded (subset, UTF-8)
+  by the renderer.
+- Standard page sizes map to `HPDF_PageSizes`/`HPDF_PageDirection`; their point sizes are
+  mirrored here so coordinates can be validated before a document exists.
+*/
+#include "libharu_examples/layout_template.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <system_error>
+#include <utility>
+
+#include "layout_program.h"
+#include "page_geometry.h"
+
+namespace libharu_examples {
+namespace {
+
+using detail::LayoutFont;
+using detail::LayoutInstruction;
+using detail::LayoutOp;
+using detail::LayoutPiece;
+using detail::LayoutProgram;
+using detail::LayoutTable;
+using detail::LayoutText;
+using detail::TextAlign;
+
+constexpr std::array<std::string_view, 14> kBase14Fonts = {
+    "Courier",        "Courier-Bold",        "Courier-Oblique",     "Courier-BoldOblique",
+    "Helvetica",      "Helvetica-Bold",      "Helvetica-Oblique",   "Helvetica-BoldOblique",
+    "Times-Roman",    "Times-Bold",          "Times-Italic",        "Times-BoldItalic",
+    "Symbol",         "ZapfDingbats"};
+
+struct Token {
+  std::string text;
+  bool quoted = false;
+};
+
+// A coordinate as written: relative to 0, the page width/height, or the flow cursor.
+struct Coordinate {
+  enum class Base { Zero, Page, Flow };
+
+  Base base = Base::Zero;
+  float offset = 0.0F;
+};
+
+template <typename T>
+std::size_t find_name(const std::vector<T>& items, std::string_view name) {
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    if (items[i].first == name) {
+      return i;
+    }
+  }
+  return LayoutTemplate::npos;
+}
+
+std::size_t find_string(const std::vector<std::string>& items, std::string_view name) {
+  const auto it = std::find(items.begin(), items.end(), name);
+  return it == items.end() ? LayoutTemplate::npos : static_cast<std::size_t>(it - items.begin());
+}
+
+// Locale-independent: `.` is the decimal separator whatever the host process set.
+bool parse_number(std::string_view text, float& out) {
+  // from_chars takes no leading '+', which `w+40` offsets have.
+  if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+    text.remove_prefix(1);
+  }
+  float value = 0.0F;
+  const char* const end = text.data() + text.size();
+  const auto [ptr, error] = std::from_chars(text.data(), end, value);
+  if (error != std::errc() || ptr != end || !std::isfinite(value)) {
+    return false;
+  }
+  out = value;
+  return true;
+}
+
+class Compiler {
+ public:
+  explicit Compiler(LayoutProgram& program) : program_(program) {}
+
+  bool compile(std::string_view source) {
+    std::size_t line_start = 0;
+    while (line_start <= source.size()) {
+      std::size_t line_end = source.find('\n', line_start);
+      if (line_end == std::string_view::npos) {
+        line_end = source.size();
+      }
+      ++line_number_;
+      if (!tokenize(source.substr(line_start, line_end - line_start)) ||
+          (!tokens_.empty() && !statement())) {
+        return false;
+      }
+      line_start = line_end + 1;
+    }
+
+    if (table_ != nullptr) {
+      return fail("table '" + table_->name + "' is missing 'end'");
+    }
+    if (program_.instructions.empty()) {
+      return fail("template draws nothing");
+    }
+    finish();
+    return true;
+  }
+
+  const std::string& error() const { return error_; }
+
+ private:
+  bool fail(const std::string& message) {
+    error_ = "line " + std::to_string(line_number_) + ": " + message;
+    return false;
+  }
+
+  bool tokenize(std::string_view line) {
+    tokens_.clear();
+    std::size_t i = 0;
+    while (i < line.size()) {
+      const char c = line[i];
+      if (c == ' ' || c == '\t' || c == '\r') {
+        ++i;
+      } else if (c == '#') {
+        break;
+      } else if (c == '"') {
+        Token token{std::string(), true};
+        for (++i; i < line.size() && line[i] != '"'; ++i) {
+          if (line[i] == '\\' && i + 1 < line.size()) {
+            ++i;
+          }
+          token.text.push_back(line[i]);
+        }
+        if (i == line.size()) {
+          return fail("unterminated string");
+        }
+        ++i;
+        tokens_.push_back(std::move(token));
+      } else {
+        const std::size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+          ++i;
+        }
+        tokens_.push_back({std::string(line.substr(start, i - start)), false});
+      }
+    }
+    return true;
+  }
+
+  bool expect_args(const std::size_t minimum, const std::size_t maximum) {
+    const std::size_t args = tokens_.size() - 1;
+    if (args < minimum || args > maximum) {
+      return fail("'" + tokens_[0].text + "' takes " + std::to_string(minimum) +
+                  (minimum == maximum ? "" : " to " + std::to_string(maximum)) + " arguments");
+    }
+    return true;
+  }
+
+  bool word(const std::size_t index, std::string& out) {
+    if (tokens_[index].quoted) {
+      return fail("unexpected string '" + tokens_[index].text + "'");
+    }
+    out = tokens_[index].text;
+    return true;
+  }
+
+  bool number(std::string_view text, float& out) {
+    return parse_number(text, out) || fail("expected a number, got '" + std::string(text) + "'");
+  }
+
+  // `12`, `w-40` (x) / `h-90` (y), or `^-10` (y only: below the last table).
+  bool coordinate(std::string_view text, const bool vertical, Coordinate& out) {
+    out = Coordinate();
+    const char page_base = vertical ? 'h' : 'w';
+    if (!text.empty() && text[0] == page_base) {
+      out.base = Coordinate::Base::Page;
+      text.remove_prefix(1);
+    } else if (!text.empty() && text[0] == '^' && vertical) {
+      out.base = Coordinate::Base::Flow;
+      text.remove_prefix(1);
+    }
+    if (text.empty() && out.base != Coordinate::Base::Zero) {
+      return true;
+    }
+    if (out.base != Coordinate::Base::Zero && text[0] != '+' && text[0] != '-') {
+      return fail("expected '+' or '-' after the coordinate base");
+    }
+    return number(text, out.offset);
+  }
+
+  // Resolves a coordinate into `value` (absolute, row- or flow-relative) and range-checks the
+  // position it can reach. `extent` is how far the drawn element reaches from the position
+  // (positive: right/up); the whole element must stay on the page.
+  bool position(const std::size_t index,
+                const bool vertical,
+                const float extent,
+                float& value,
+                bool& flow) {
+    Coordinate c;
+    if (!coordinate(tokens_[index].text, vertical, c)) {
+      return false;
+    }
+    const float limit = vertical ? program_.page_height : program_.page_width;
+    float lowest = 0.0F;
+    float highest = 0.0F;
+    flow = false;
+    value = c.base == Coordinate::Base::Page ? limit + c.offset : c.offset;
+
+    if (c.base == Coordinate::Base::Flow) {
+      if (table_ != nullptr) {
+        return fail("'^' positions are not allowed inside a table");
+      }
+      if (last_table_ == LayoutTemplate::npos) {
+        return fail("'^' positions need a table above them");
+      }
+      const LayoutTable& table = program_.tables[last_table_];
+      flow = true;
+      lowest = table.bottom + flow_reserve_ + c.offset;
+      highest = table.top + c.offset;
+      if (-c.offset > flow_reserve_) {
+        return fail("'" + tokens_[index].text + "' reaches below the last table's reserve");
+      }
+    } else if (vertical && table_ != nullptr) {
+      // Row-relative: the baseline moves from the table top down to its bottom.
+      if (c.base == Coordinate::Base::Page) {
+        return fail("rows use offsets from the row baseline, not 'h' positions");
+      }
+      lowest = table_->bottom + c.offset;
+      highest = table_->top + c.offset;
+    } else {
+      lowest = value;
+      highest = value;
+    }
+
+    if (std::min(lowest, lowest + extent) < 0.0F || std::max(highest, highest + extent) > limit) {
+      return fail(std::string(vertical ? "y" : "x") + " '" + tokens_[index].text +
+                  "' is outside the page");
+    }
+    return true;
+  }
+
+  // `key=value` options after the positional arguments.
+  bool option(const std::size_t index, std::string& key, std::string& value) {
+    const std::string& text = tokens_[index].text;
+    const std::size_t equals = text.find('=');
+    if (tokens_[index].quoted || equals == std::string::npos) {
+      return fail("expected key=value, got '" + text + "'");
+    }
+    key = text.substr(0, equals);
+    value = text.substr(equals + 1);
+    return true;
+  }
+
+  bool statement() {
+    const std::string& keyword = tokens_[0].text;
+    if (tokens_[0].quoted) {
+      return fail("expected a statement");
+    }
+    if (keyword == "page") {
+      return page();
+    }
+    if (keyword == "font") {
+      return font();
+    }
+    if (keyword == "color") {
+      return color();
+    }
+    if (keyword == "end") {
+      return end_table();
+    }
+
+    if (!page_set_) {
+      apply_page(PageFormat::A4Portrait);
+    }
+    if (keyword == "fill" || keyword == "stroke") {
+      return set_color(keyword == "fill" ? LayoutOp::SetFill : LayoutOp::SetStroke);
+    }
+    if (keyword == "linewidth") {
+      return line_width();
+    }
+    if (keyword == "text") {
+      return text();
+    }
+    if (keyword == "line") {
+      return line();
+    }
+    if (keyword == "rect") {
+      return rect();
+    }
+    if (keyword == "circle") {
+      return circle();
+    }
+    if (keyword == "table") {
+      return begin_table();
+    }
+    return fail("unknown statement '" + keyword + "'");
+  }
+
+  void apply_page(const PageFormat format) {
+    const detail::PageGeometry geometry = detail::page_geometry(format);
+    program_.standard_size = true;
+    program_.page_size = geometry.size;
+    program_.direction = geometry.direction;
+    program_.page_width = geometry.width;
+    program_.page_height = geometry.height;
+    page_set_ = true;
+  }
+
+  bool page() {
+    if (page_set_) {
+      return fail("'page' must come first and only once");
+    }
+    if (!expect_args(1, 2)) {
+      return false;
+    }
+    float width = 0.0F;
+    float height = 0.0F;
+    if (tokens_.size() == 3 && parse_number(tokens_[1].text, width) &&
+        parse_number(tokens_[2].text, height)) {
+      if (width < 72.0F || height < 72.0F || width > 14400.0F || height > 14400.0F) {
+        return fail("page size must be between 72 and 14400 points");
+      }
+      program_.standard_size = false;
+      program_.page_width = width;
+      program_.page_height = height;
+      page_set_ = true;
+      return true;
+    }
+
+    const bool letter = tokens_[1].text == "letter";
+    if (!letter && tokens_[1].text != "a4") {
+      return fail("page size must be 'a4', 'letter' or '<width> <height>'");
+    }
+    bool landscape = false;
+    if (tokens_.size() == 3) {
+      landscape = tokens_[2].text == "landscape";
+      if (!landscape && tokens_[2].text != "portrait") {
+        return fail("orientation must be 'portrait' or 'landscape'");
+      }
+    }
+    if (letter) {
+      apply_page(landscape ? PageFormat::LetterLandscape : PageFormat::LetterPortrait);
+    } else {
+      apply_page(landscape ? PageFormat::A4Landscape : PageFormat::A4Portrait);
+    }
+    return true;
+  }
+
+  bool font() {
+    std::string name;
+    std::string base;
+    if (!expect_args(2, 2) || !word(1, name)) {
+      return false;
+    }
+    if (find_name(fonts_, name) != LayoutTemplate::npos) {
+      return fail("font '" + name + "' is already defined");
+    }
+    if (tokens_[2].quoted) {
+      return truetype_font(name, tokens_[2].text);
+    }
+    if (!word(2, base)) {
+      return false;
+    }
+    if (std::find(kBase14Fonts.begin(), kBase14Fonts.end(), base) == kBase14Fonts.end()) {
+      return fail("'" + base + "' is not a base-14 font");
+    }
+
+    LayoutFont font;
+    font.base_name = base;
+    font.has_metrics = true;
+    if (base == "Helvetica") {
+      font.metrics = StandardFont::Helvetica;
+    } else if (base == "Helvetica-Bold") {
+      font.metrics = StandardFont::HelveticaBold;
+    } else if (base == "Helvetica-Oblique") {
+      font.metrics = StandardFont::HelveticaOblique;
+    } else {
+      font.has_metrics = false;
+    }
+    fonts_.emplace_back(name, program_.fonts.size());
+    program_.fonts.push_back(std::move(font));
+    return true;
+  }
+
+  // `font <name> "<path>"`: a TrueType file, loaded (or taken from the process-wide cache)
+  // now so a bad path fails compilation rather than every render.
+  bool truetype_font(const std::string& name, const std::string& path) {
+    std::string error;
+    LayoutFont font;
+    font.truetype = TrueTypeFont::load(path, &error);
+    if (!font.truetype) {
+      return fail(error);
+    }
+    font.has_metrics = true;
+    fonts_.emplace_back(name, program_.fonts.size());
+    program_.fonts.push_back(std::move(font));
+    return true;
+  }
+
+  bool color() {
+    std::string name;
+    if (!expect_args(4, 4) || !word(1, name)) {
+      return false;
+    }
+    detail::RgbColor rgb{};
+    float* channels[] = {&rgb.red, &rgb.green, &rgb.blue};
+    for (std::size_t i = 0; i < 3; ++i) {
+      if (!number(tokens_[i + 2].text, *channels[i])) {
+        return false;
+      }
+      if (*channels[i] < 0.0F || *channels[i] > 1.0F) {
+        return fail("color channels must be between 0 and 1");
+      }
+    }
+    if (find_name(colors_, name) != LayoutTemplate::npos) {
+      return fail("color '" + name + "' is already defined");
+    }
+    colors_.emplace_back(name, program_.colors.size());
+    program_.colors.push_back(rgb);
+    return true;
+  }
+
+  bool set_color(const LayoutOp op) {
+    std::string name;
+    if (!expect_args(1, 1) || !word(1, name)) {
+      return false;
+    }
+    const std::size_t color = find_name(colors_, name);
+    if (color == LayoutTemplate::npos) {
+      return fail("unknown color '" + name + "'");
+    }
+    LayoutInstruction instruction{op};
+    instruction.index = static_cast<std::uint32_t>(colors_[color].second);
+    emit(instruction);
+    return true;
+  }
+
+  bool line_width() {
+    LayoutInstruction instruction{LayoutOp::SetLineWidth};
+    if (!expect_args(1, 1) || !number(tokens_[1].text, instruction.a)) {
+      return false;
+    }
+    if (instruction.a < 0.0F) {
+      return fail("line width must not be negative");
+    }
+    emit(instruction);
+    return true;
+  }
+
+  // text <font> <size> <x> <y> "<template>" [width=<points>] [align=left|right]
+  bool text() {
+    if (!expect_args(5, 7)) {
+      return false;
+    }
+    std::string font_name;
+    LayoutInstruction instruction{LayoutOp::Text};
+    if (!word(1, font_name) || !number(tokens_[2].text, instruction.a)) {
+      return false;
+    }
+    const std::size_t font = find_name(fonts_, font_name);
+    if (font == LayoutTemplate::npos) {
+      return fail("unknown font '" + font_name + "'");
+    }
+    if (instruction.a <= 0.0F) {
+      return fail("font size must be positive");
+    }
+    instruction.font = static_cast<std::uint16_t>(fonts_[font].second);
+    if (!tokens_[5].quoted) {
+      return fail("text content must be a quoted string");
+    }
+
+    for (std::size_t i = 6; i < tokens_.size(); ++i) {
+      std::string key;
+      std::string value;
+      if (!option(i, key, value)) {
+        return false;
+      }
+      if (key == "width") {
+        if (!number(value, instruction.max_width) || instruction.max_width <= 0.0F) {
+          return fail("width must be a positive number");
+        }
+      } else if (key == "align" && (value == "left" || value == "right")) {
+        instruction.align = value == "right" ? TextAlign::Right : TextAlign::Left;
+      } else {
+        return fail("unknown text option '" + tokens_[i].text + "'");
+      }
+    }
+    const bool needs_metrics =
+        instruction.max_width > 0.0F || instruction.align == TextAlign::Right;
+    if (needs_metrics && !program_.fonts[instruction.font].has_metrics) {
+      return fail("width= and align=right need a Helvetica (regular, bold or oblique) or "
+                  "TrueType font");
+    }
+
+    // Only text with a width limit has a known horizontal extent.
+    const float extent =
+        instruction.align == TextAlign::Right ? -instruction.max_width : instruction.max_width;
+    if (!position(3, false, extent, instruction.x, instruction.flow_y) ||
+        !position(4, true, 0.0F, instruction.y, instruction.flow_y) ||
+        !compile_text(tokens_[5].text, instruction.index)) {
+      return false;
+    }
+    emit(instruction);
+    return true;
+  }
+
+  bool line() {
+    LayoutInstruction instruction{LayoutOp::Line};
+    bool flow_x = false;
+    bool flow_y2 = false;
+    if (!expect_args(4, 4) || !position(1, false, 0.0F, instruction.x, flow_x) ||
+        !position(2, true, 0.0F, instruction.y, instruction.flow_y) ||
+        !position(3, false, 0.0F, instruction.a, flow_x) ||
+        !position(4, true, 0.0F, instruction.b, flow_y2)) {
+      return false;
+    }
+    if (instruction.flow_y != flow_y2) {
+      return fail("both line ends must use '^' or neither");
+    }
+    emit(instruction);
+    return true;
+  }
+
+  bool rect() {
+    LayoutInstruction instruction{LayoutOp::StrokeRect};
+    if (!expect_args(4, 5) || !number(tokens_[3].text, instruction.a) ||
+        !number(tokens_[4].text, instruction.b)) {
+      return false;
+    }
+    if (tokens_.size() == 6) {
+      if (tokens_[5].text == "fill") {
+        instruction.op = LayoutOp::FillRect;
+      } else if (tokens_[5].text != "stroke") {
+        return fail("rect mode must be 'fill' or 'stroke'");
+      }
+    }
+    if (instruction.a <= 0.0F || instruction.b <= 0.0F) {
+      return fail("rect width and height must be positive");
+    }
+    bool flow_x = false;
+    if (!position(1, false, instruction.a, instruction.x, flow_x) ||
+        !position(2, true, instruction.b, instruction.y, instruction.flow_y)) {
+      return false;
+    }
+    emit(instruction);
+    return true;
+  }
+
+  bool circle() {
+    LayoutInstruction instruction{LayoutOp::FillCircle};
+    bool flow_x = false;
+    if (!expect_args(3, 3) || !number(tokens_[3].text, instruction.a)) {
+      return false;
+    }
+    if (instruction.a <= 0.0F) {
+      return fail("circle radius must be positive");
+    }
+    if (!position(1, false, 0.0F, instruction.x, flow_x) ||
+        !position(2, true, 0.0F, instruction.y, instruction.flow_y)) {
+      return false;
+    }
+    emit(instruction);
+    return true;
+  }
+
+  // table <name> columns=a,b,c top=<y> row=<height> bottom=<y> [reserve=<points>]
+  bool begin_table() {
+    if (table_ != nullptr) {
+      return fail("tables cannot be nested");
+    }
+    std::string name;
+    if (tokens_.size() < 2 || !word(1, name)) {
+      return fail("'table' needs a name");
+    }
+    if (find_string(table_names_, name) != LayoutTemplate::npos) {
+      return fail("table '" + name + "' is already defined");
+    }
+
+    LayoutTable table;
+    table.name = name;
+    float reserve = 0.0F;
+    bool has_top = false;
+    bool has_row = false;
+    for (std::size_t i = 2; i < tokens_.size(); ++i) {
+      std::string key;
+      std::string value;
+      if (!option(i, key, value)) {
+        return false;
+      }
+      Coordinate c;
+      if (key == "columns") {
+        for (std::size_t start = 0; start <= value.size();) {
+          const std::size_t comma = std::min(value.find(',', start), value.size());
+          const std::string column = value.substr(start, comma - start);
+          if (column.empty() || find_string(table.columns, column) != LayoutTemplate::npos) {
+            return fail("columns must be distinct, non-empty names");
+          }
+          table.columns.push_back(column);
+          start = comma + 1;
+        }
+      } else if (key == "top" || key == "bottom") {
+        if (!coordinate(value, true, c)) {
+          return false;
+        }
+        if (c.base == Coordinate::Base::Flow) {
+          return fail("table positions cannot use '^'");
+        }
+        const float y = c.base == Coordinate::Base::Page ? program_.page_height + c.offset
+                                                         : c.offset;
+        (key == "top" ? table.top : table.bottom) = y;
+        has_top = has_top || key == "top";
+      } else if (key == "row") {
+        if (!number(value, table.row_height)) {
+          return false;
+        }
+        has_row = true;
+      } else if (key == "reserve") {
+        if (!number(value, reserve) || reserve < 0.0F) {
+          return fail("reserve must be a non-negative number");
+        }
+      } else {
+        return fail("unknown table option '" + key + "'");
+      }
+    }
+
+    if (table.columns.empty() || !has_top || !has_row) {
+      return fail("'table' needs columns=, top= and row=");
+    }
+    if (table.row_height <= 0.0F || table.bottom < 0.0F || table.top > program_.page_height ||
+        table.top - table.row_height < table.bottom) {
+      return fail("table needs row > 0 and room for one row between bottom and top");
+    }
+    if (table.bottom + reserve > table.top) {
+      return fail("reserve does not fit between the table's bottom and top");
+    }
+
+    LayoutInstruction instruction{LayoutOp::Table};
+    instruction.index = static_cast<std::uint32_t>(program_.tables.size());
+    instruction.a = reserve;
+    emit(instruction);
+    table_names_.push_back(name);
+    program_.tables.push_back(std::move(table));
+    table_ = &program_.tables.back();
+    table_reserve_ = reserve;
+    body_instructions_.resize(program_.tables.size());
+    return true;
+  }
+
+  bool end_table() {
+    if (table_ == nullptr) {
+      return fail("'end' without 'table'");
+    }
+    if (!expect_args(0, 0)) {
+      return false;
+    }
+    last_table_ = program_.tables.size() - 1;
+    flow_reserve_ = table_reserve_;
+    table_ = nullptr;
+    return true;
+  }
+
+  // Splits a quoted template into literal runs and `{name}` values; `{{`/`}}` are literal
+  // braces.
+  bool compile_text(const std::string& source, std::uint32_t& text_index) {
+    LayoutText text;
+    text.first_piece = static_cast<std::uint32_t>(program_.pieces.size());
+    LayoutPiece piece;
+    piece.literal_offset = static_cast<std::uint32_t>(program_.literals.size());
+
+    for (std::size_t i = 0; i < source.size(); ++i) {
+      const char c = source[i];
+      if ((c == '{' || c == '}') && i + 1 < source.size() && source[i + 1] == c) {
+        program_.literals.push_back(c);
+        ++i;
+        continue;
+      }
+      if (c == '}') {
+        return fail("unmatched '}' in text");
+      }
+      if (c != '{') {
+        program_.literals.push_back(c);
+        continue;
+      }
+
+      const std::size_t close = source.find('}', i + 1);
+      if (close == std::string::npos || close == i + 1) {
+        return fail("unterminated or empty '{' in text");
+      }
+      const std::string name = source.substr(i + 1, close - i - 1);
+      piece.literal_size =
+          static_cast<std::uint32_t>(program_.literals.size()) - piece.literal_offset;
+      piece.value = value_slot(name);
+      program_.pieces.push_back(piece);
+      piece = LayoutPiece();
+      piece.literal_offset = static_cast<std::uint32_t>(program_.literals.size());
+      i = close;
+    }
+
+    piece.literal_size =
+        static_cast<std::uint32_t>(program_.literals.size()) - piece.literal_offset;
+    if (piece.literal_size > 0 || program_.pieces.size() == text.first_piece) {
+      program_.pieces.push_back(piece);
+    }
+    text.piece_count = static_cast<std::uint32_t>(program_.pieces.size()) - text.first_piece;
+    text.constant =
+        text.piece_count == 1 && program_.pieces.back().value == LayoutPiece::kNoValue;
+    // Constant text is drawn straight from the literal pool, so it keeps a terminator.
+    if (text.constant) {
+      program_.literals.push_back('\0');
+    }
+
+    text_index = static_cast<std::uint32_t>(program_.texts.size());
+    program_.texts.push_back(text);
+    return true;
+  }
+
+  std::uint32_t value_slot(const std::string& name) {
+    if (table_ != nullptr) {
+      const std::size_t column = find_string(table_->columns, name);
+      if (column != LayoutTemplate::npos) {
+        return LayoutPiece::kColumnBit | static_cast<std::uint32_t>(column);
+      }
+    }
+    std::size_t field = find_string(program_.fields, name);
+    if (field == LayoutTemplate::npos) {
+      field = program_.fields.size();
+      program_.fields.push_back(name);
+    }
+    return static_cast<std::uint32_t>(field);
+  }
+
+  // Table bodies are collected separately and appended after the top level by `finish`.
+  void emit(const LayoutInstruction& instruction) {
+    if (table_ != nullptr) {
+      body_instructions_.back().push_back(instruction);
+    } else {
+      program_.instructions.push_back(instruction);
+    }
+  }
+
+  // Appends every table body after the top-level instructions.
+  void finish() {
+    program_.top_level_count = static_cast<std::uint32_t>(program_.instructions.size());
+    for (std::size_t t = 0; t < program_.tables.size(); ++t) {
+      program_.tables[t].first = static_cast<std::uint32_t>(program_.instructions.size());
+      program_.tables[t].count = static_cast<std::uint32_t>(body_instructions_[t].size());
+      program_.instructions.insert(
+          program_.instructions.end(), body_instructions_[t].begin(), body_instructions_[t].end());
+    }
+  }
+
+  LayoutProgram& program_;
+  std::string error_;
+  std::size_t line_number_ = 0;
+  std::vector<Token> tokens_;
+  bool page_set_ = false;
+
+  std::vector<std::pair<std::string, std::size_t>> fonts_;
+  std::vector<std::pair<std::string, std::size_t>> colors_;
+  std::vector<std::string> table_names_;
+  std::vector<std::vector<LayoutInstruction>> body_instructions_;
+  LayoutTable* table_ = nullptr;
+  float table_reserve_ = 0.0F;
+  std::size_t last_table_ = LayoutTemplate::npos;
+  float flow_reserve_ = 0.0F;
+};
+
+}  // namespace
+
+bool LayoutTemplate::compile(std::string_view source, LayoutTemplate& out, std::string* error) {
+  auto program = std::make_shared<LayoutProgram>();
+  Compiler compiler(*program);
+  if (!compiler.compile(source)) {
+    if (error != nullptr) {
+      *error = compiler.error();
+    }
+    return false;
+  }
+  out.program_ = std::move(program);
+  return true;
+}
+
+std::size_t LayoutTemplate::field(std::string_view name) const {
+  return program_ == nullptr ? npos : find_string(program_->fields, name);
+}
+
+std::size_t LayoutTemplate::table(std::string_view name) const {
+  if (program_ == nullptr) {
+    return npos;
+  }
+  for (std::size_t i = 0; i < program_->tables.size(); ++i) {
+    if (program_->tables[i].name == name) {
+      return i;
+    }
+  }
+  return npos;
+}
+
+std::size_t LayoutTemplate::column_count(const std::size_t table) const {
+  return program_ == nullptr || table >= program_->tables.size()
+             ? 0
+             : program_->tables[table].columns.size();
+}
+
+LayoutRecord::LayoutRecord(const LayoutTemplate& layout) : program_(layout.program_) {
+  if (program_ != nullptr) {
+    fields_.resize(program_->fields.size());
+    tables_.resize(program_->tables.size());
+    cell_counts_.resize(program_->tables.size());
+  }
+}
+
+bool LayoutRecord::set(std::string_view field, std::string_view value) {
+  const std::size_t slot = program_ == nullptr ? LayoutTemplate::npos
+                                               : find_string(program_->fields, field);
+  if (slot == LayoutTemplate::npos) {
+    return false;
+  }
+  set(slot, value);
+  return true;
+}
+
+void LayoutRecord::set(const std::size_t field, std::string_view value) {
+  fields_[field].assign(value.data(), value.size());
+}
+
+bool LayoutRecord::add_row(std::string_view table, std::initializer_list<std::string_view> cells) {
+  if (program_ == nullptr) {
+    return false;
+  }
+  for (std::size_t i = 0; i < program_->tables.size(); ++i) {
+    if (program_->tables[i].name == table) {
+      return add_row(i, cells);
+    }
+  }
+  return false;
+}
+
+bool LayoutRecord::add_row(const std::size_t table,
+                           std::initializer_list<std::string_view> cells) {
+  if (program_ == nullptr || table >= tables_.size() ||
+      cells.size() != program_->tables[table].columns.size()) {
+    return false;
+  }
+  // Cells past the used count are kept from earlier records and overwritten in place.
+  std::vector<std::string>& stored = tables_[table];
+  std::size_t& used = cell_counts_[table];
+  for (const std::string_view cell : cells) {
+    if (used == stored.size()) {
+      stored.emplace_back();
+    }
+    stored[used++].assign(cell.data(), cell.size());
+  }
+  return true;
+}
+
+void LayoutRecord::clear() {
+  for (std::string& field : fields_) {
+    field.clear();
+  }
+  std::fill(cell_counts_.begin(), cell_counts_.end(), 0);
+}
+
+}  // namespace libharu_examples
@@ -0,0 +1,94 @@
+/*
+High-level overview
+-------------------
+Whole-file input for the bulk invoice pipeline. Multi-gigabyte exports are mapped rather than
+read, so the parser hands out `std::string_view`s into the mapping and the kernel pages the
+file in behind a sequential-access hint.
+
+1) POSIX: `open` + `fstat` + `mmap(PROT_READ, MAP_PRIVATE)`, then `madvise(MADV_SEQUENTIAL)`;
+   the descriptor is closed right away because the mapping keeps the file alive.
+2) Other platforms: read the file into an owned buffer with the same interface.
+*/
+#include "mapped_file.h"
+
+#include <cstdio>
+#include <memory>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace libharu_examples {
+namespace detail {
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+void MappedFile::close() {
+#if !defined(_WIN32)
+  if (mapped_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+  mapped_ = false;
+  data_ = nullptr;
+  size_ = 0;
+  copy_.clear();
+}
+
+bool MappedFile::open(const std::string& path) {
+  close();
+#if !defined(_WIN32)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    ::close(fd);
+    return false;
+  }
+  if (info.st_size == 0) {
+    ::close(fd);
+    return true;
+  }
+
+  const auto size = static_cast<std::size_t>(info.st_size);
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  madvise(mapping, size, MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(mapping);
+  size_ = size;
+  mapped_ = true;
+  return true;
+#else
+  struct FileCloser {
+    void operator()(std::FILE* file) const { std::fclose(file); }
+  };
+  const std::unique_ptr<std::FILE, FileCloser> file(std::fopen(path.c_str(), "rb"));
+  if (!file) {
+    return false;
+  }
+  char chunk[1 << 16];
+  for (std::size_t read = 0; (read = std::fread(chunk, 1, sizeof(chunk), file.get())) > 0;) {
+    copy_.insert(copy_.end(), chunk, chunk + read);
+  }
+  if (std::ferror(file.get()) != 0) {
+    copy_.clear();
+    return false;
+  }
+  data_ = copy_.data();
+  size_ = copy_.size();
+  return true;
+#endif
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
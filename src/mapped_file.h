@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libharu_examples {
+namespace detail {
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped, so parsing
+// works on the page cache directly and nothing is copied; elsewhere it is read into memory.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // False if the file cannot be opened or mapped. An empty file opens as an empty view.
+  bool open(const std::string& path);
+
+  std::string_view view() const { return {data_, size_}; }
+
+ private:
+  void close();
+
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<char> copy_;
+};
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,181 @@
+/*
+High-level overview
+-------------------
+Fixed-point money for the invoice renderers. Amounts used to be accumulated in `double` and
+printed through a fresh `std::ostringstream` (`std::fixed` + `setprecision(2)`) per cell, which
+allocates for every unit price, amount and total and can drift by a cent on long invoices.
+
+1) `Money::from_double` converts a caller's price once, from its shortest decimal form.
+2) Sums, quantity products and tax are integer operations on cents, with overflow checks.
+3) `format_money` writes digits with `std::to_chars` and inserts the sign, symbol, thousands
+   separators and decimal point in one pass over a fixed inline buffer.
+
+libHaru logic addressed in this file
+------------------------------------
+- None directly; the text is handed to `HPDF_Page_TextOut` as a C string, so `MoneyText`
+  keeps a terminator and the page writer can take `c_str()` without a copy.
+*/
+#include "libharu_examples/money.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <system_error>
+
+namespace libharu_examples {
+namespace {
+
+constexpr std::int64_t kMaxInt64 = std::numeric_limits<std::int64_t>::max();
+constexpr std::int64_t kMinInt64 = std::numeric_limits<std::int64_t>::min();
+constexpr double kMaxUnits = 1e15;
+
+std::uint64_t magnitude(const std::int64_t value) {
+  // Negating in unsigned arithmetic also covers INT64_MIN.
+  return value < 0 ? 0U - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+}
+
+bool checked_multiply(const std::int64_t a, const std::int64_t b, std::int64_t& out) {
+  const std::uint64_t ua = magnitude(a);
+  const std::uint64_t ub = magnitude(b);
+  if (ua != 0 && ub > std::numeric_limits<std::uint64_t>::max() / ua) {
+    return false;
+  }
+  const std::uint64_t product = ua * ub;
+  const bool negative = (a < 0) != (b < 0);
+  const std::uint64_t limit =
+      negative ? magnitude(kMinInt64) : static_cast<std::uint64_t>(kMaxInt64);
+  if (product > limit) {
+    return false;
+  }
+  out = negative ? static_cast<std::int64_t>(0U - product) : static_cast<std::int64_t>(product);
+  return true;
+}
+
+// n / 10000, rounded half away from zero.
+std::int64_t round_per_ten_thousand(const std::int64_t n) {
+  return n >= 0 ? (n + 5000) / 10000 : -((-n + 5000) / 10000);
+}
+
+}  // namespace
+
+bool Money::from_double(const double amount, Money& out) {
+  if (!std::isfinite(amount) || std::fabs(amount) >= kMaxUnits) {
+    return false;
+  }
+  // Below a tenth of a cent the amount rounds to zero; skipping it also keeps the fixed
+  // notation below short.
+  if (std::fabs(amount) < 0.001) {
+    out = Money();
+    return true;
+  }
+
+  // Shortest round-trip fixed notation: at most 15 integer digits plus a few decimals.
+  char digits[48];
+  const std::to_chars_result result =
+      std::to_chars(digits, digits + sizeof(digits), std::fabs(amount), std::chars_format::fixed);
+  if (result.ec != std::errc()) {
+    return false;
+  }
+
+  std::int64_t cents = 0;
+  int decimals = -1;  // Fraction digits consumed so far; -1 until the decimal point.
+  bool round_up = false;
+  for (const char* c = digits; c != result.ptr; ++c) {
+    if (*c == '.') {
+      decimals = 0;
+    } else if (decimals < 0) {
+      cents = cents * 10 + (*c - '0');
+    } else if (decimals < 2) {
+      cents = cents * 10 + (*c - '0');
+      ++decimals;
+    } else {
+      round_up = *c >= '5';
+      break;
+    }
+  }
+  for (decimals = decimals < 0 ? 0 : decimals; decimals < 2; ++decimals) {
+    cents *= 10;
+  }
+  if (round_up) {
+    ++cents;
+  }
+  out = Money(amount < 0.0 ? -cents : cents);
+  return true;
+}
+
+bool Money::add(const Money other, Money& out) const {
+  if ((other.cents_ > 0 && cents_ > kMaxInt64 - other.cents_) ||
+      (other.cents_ < 0 && cents_ < kMinInt64 - other.cents_)) {
+    return false;
+  }
+  out = Money(cents_ + other.cents_);
+  return true;
+}
+
+bool Money::multiply(const std::int64_t factor, Money& out) const {
+  std::int64_t product = 0;
+  if (!checked_multiply(cents_, factor, product)) {
+    return false;
+  }
+  out = Money(product);
+  return true;
+}
+
+bool Money::percentage(const std::int32_t basis_points, Money& out) const {
+  // Split as q * bp + (r * bp) / 10000 so the full cents * bp product is never formed;
+  // |r * bp| stays below 2^45.
+  std::int64_t whole = 0;
+  if (!checked_multiply(cents_ / 10000, basis_points, whole)) {
+    return false;
+  }
+  const std::int64_t part = round_per_ten_thousand((cents_ % 10000) * basis_points);
+  return Money(whole).add(Money(part), out);
+}
+
+MoneyText format_money(const Money amount, const MoneyFormat& format) {
+  MoneyText text;
+  char* out = text.buffer_.data();
+
+  // Step 1: Digits of |cents|, zero-padded to at least "0.00".
+  char digits[20];
+  const std::to_chars_result result =
+      std::to_chars(digits, digits + sizeof(digits), magnitude(amount.cents()));
+  std::size_t digit_count = static_cast<std::size_t>(result.ptr - digits);
+  char padded[20] = {'0', '0', '0'};
+  const char* first = digits;
+  if (digit_count < 3) {
+    for (std::size_t i = 0; i < digit_count; ++i) {
+      padded[3 - digit_count + i] = digits[i];
+    }
+    first = padded;
+    digit_count = 3;
+  }
+
+  // Step 2: Sign and symbol.
+  if (amount.cents() < 0) {
+    *out++ = '-';
+  }
+  const std::size_t symbol_size = std::min(format.symbol.size(), MoneyText::kMaxSymbolSize);
+  for (std::size_t i = 0; i < symbol_size; ++i) {
+    *out++ = format.symbol[i];
+  }
+
+  // Step 3: Integer part with separators every three digits, then the two decimals.
+  const std::size_t integer_digits = digit_count - 2;
+  for (std::size_t i = 0; i < integer_digits; ++i) {
+    if (format.thousands_separator != '\0' && i > 0 && (integer_digits - i) % 3 == 0) {
+      *out++ = format.thousands_separator;
+    }
+    *out++ = first[i];
+  }
+  *out++ = format.decimal_point;
+  *out++ = first[integer_digits];
+  *out++ = first[integer_digits + 1];
+  *out = '\0';
+
+  text.size_ = static_cast<std::size_t>(out - text.buffer_.data());
+  return text;
+}
+
+}  // namespace libharu_examples
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "libharu_examples/page_format.h"
+
+#include <hpdf.h>
+
+#include <type_traits>
+
+namespace libharu_examples {
+namespace detail {
+
+struct PageGeometry {
+  HPDF_PageSizes size;
+  HPDF_PageDirection direction;
+  float width;
+  float height;
+
+  constexpr bool landscape() const { return width > height; }
+};
+
+// The sizes `HPDF_Page_SetSize` applies, in points; landscape swaps width and height.
+constexpr PageGeometry page_geometry(const PageFormat format) {
+  switch (format) {
+    case PageFormat::A4Landscape:
+      return {HPDF_PAGE_SIZE_A4, HPDF_PAGE_LANDSCAPE, 841.89F, 595.276F};
+    case PageFormat::LetterPortrait:
+      return {HPDF_PAGE_SIZE_LETTER, HPDF_PAGE_PORTRAIT, 612.0F, 792.0F};
+    case PageFormat::LetterLandscape:
+      return {HPDF_PAGE_SIZE_LETTER, HPDF_PAGE_LANDSCAPE, 792.0F, 612.0F};
+    case PageFormat::A4Portrait:
+      break;
+  }
+  return {HPDF_PAGE_SIZE_A4, HPDF_PAGE_PORTRAIT, 595.276F, 841.89F};
+}
+
+template <PageFormat Format>
+using PageFormatTag = std::integral_constant<PageFormat, Format>;
+
+// Calls `fn(PageFormatTag<F>{})` for the runtime `format`. This is the only runtime branch on
+// the page format; everything `fn` instantiates sees the geometry as constants.
+template <typename Fn>
+decltype(auto) dispatch_page_format(const PageFormat format, Fn&& fn) {
+  switch (format) {
+    case PageFormat::A4Landscape:
+      return fn(PageFormatTag<PageFormat::A4Landscape>{});
+    case PageFormat::LetterPortrait:
+      return fn(PageFormatTag<PageFormat::LetterPortrait>{});
+    case PageFormat::LetterLandscape:
+      return fn(PageFormatTag<PageFormat::LetterLandscape>{});
+    case PageFormat::A4Portrait:
+      break;
+  }
+  return fn(PageFormatTag<PageFormat::A4Portrait>{});
+}
+
+// Adds a page of the given geometry, or returns nullptr when libHaru cannot allocate it.
+inline HPDF_Page add_page(HPDF_Doc pdf, const PageGeometry& geometry) {
+  HPDF_Page page = HPDF_AddPage(pdf);
+  if (page != nullptr) {
+    HPDF_Page_SetSize(page, geometry.size, geometry.direction);
+  }
+  return page;
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
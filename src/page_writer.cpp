@@ -0,0 +1,184 @@
+/*
+High-level overview
+-------------------
+`PageWriter` replaces the per-file `draw_text`/`draw_line` helpers. Those helpers wrapped
+every string in its own `BeginText`/`SetFontAndSize`/`TextOut`/`EndText` sequence and re-set
+line width and stroke color on every line, which bloats content streams on long tables.
+
+libHaru logic addressed in this file
+------------------------------------
+- Text state (font, size) and colors are part of the PDF graphics state and survive across
+  text objects, so they only need to be re-emitted when they change.
+- Color and line-width operators are legal inside a text object; path construction is not,
+  so path helpers close the open text object first.
+- `HPDF_Page_TextOut` positions relative to the current text matrix, so several absolute
+  placements can share one text object.
+
+Every libHaru drawing call is counted and the count handed to the thread's render metrics on
+`flush`, so the hot path only bumps a member.
+*/
+#include "page_writer.h"
+
+#include "render_metrics_state.h"
+
+namespace libharu_examples {
+namespace detail {
+
+PageWriter::PageWriter(HPDF_Page page) : page_(page) {
+}
+
+PageWriter::~PageWriter() {
+  flush();
+}
+
+float PageWriter::width() const {
+  return HPDF_Page_GetWidth(page_);
+}
+
+float PageWriter::height() const {
+  return HPDF_Page_GetHeight(page_);
+}
+
+void PageWriter::reset(HPDF_Page page) {
+  flush();
+  page_ = page;
+  invalidate();
+}
+
+void PageWriter::flush() {
+  end_text();
+  record_draw_operations(operations_);
+  operations_ = 0;
+}
+
+void PageWriter::invalidate() {
+  font_ = nullptr;
+  fill_known_ = false;
+  stroke_known_ = false;
+  line_width_known_ = false;
+}
+
+void PageWriter::set_fill(const RgbColor& color) {
+  if (fill_known_ && fill_ == color) {
+    return;
+  }
+  HPDF_Page_SetRGBFill(page_, color.red, color.green, color.blue);
+  ++operations_;
+  fill_ = color;
+  fill_known_ = true;
+}
+
+void PageWriter::set_stroke(const RgbColor& color) {
+  if (stroke_known_ && stroke_ == color) {
+    return;
+  }
+  HPDF_Page_SetRGBStroke(page_, color.red, color.green, color.blue);
+  ++operations_;
+  stroke_ = color;
+  stroke_known_ = true;
+}
+
+void PageWriter::set_line_width(const float line_width) {
+  if (line_width_known_ && line_width_ == line_width) {
+    return;
+  }
+  HPDF_Page_SetLineWidth(page_, line_width);
+  ++operations_;
+  line_width_ = line_width;
+  line_width_known_ = true;
+}
+
+void PageWriter::text(HPDF_Font font,
+                      const float size,
+                      const float x,
+                      const float y,
+                      const char* text) {
+  if (!in_text_) {
+    HPDF_Page_BeginText(page_);
+    in_text_ = true;
+    ++operations_;
+  }
+  if (font != font_ || size != font_size_) {
+    HPDF_Page_SetFontAndSize(page_, font, size);
+    font_ = font;
+    font_size_ = size;
+    ++operations_;
+  }
+  HPDF_Page_TextOut(page_, x, y, text);
+  ++operations_;
+}
+
+void PageWriter::fitted_text(const FontFace& face,
+                             const float size,
+                             const float x,
+                             const float y,
+                             const float max_width,
+                             const std::string_view text) {
+  face.fit_with_ellipsis(text, size, max_width, scratch_);
+  this->text(face.font(), size, x, y, scratch_.c_str());
+}
+
+void PageWriter::text(const FontFace& face,
+                      const float size,
+                      const float x,
+                      const float y,
+                      const std::string_view text) {
+  scratch_.assign(text);
+  this->text(face.font(), size, x, y, scratch_.c_str());
+}
+
+void PageWriter::line(const float x1, const float y1, const float x2, const float y2) {
+  end_text();
+  HPDF_Page_MoveTo(page_, x1, y1);
+  HPDF_Page_LineTo(page_, x2, y2);
+  HPDF_Page_Stroke(page_);
+  operations_ += 3;
+}
+
+void PageWriter::fill_rectangle(const float x,
+                                const float y,
+                                const float width,
+                                const float height) {
+  end_text();
+  HPDF_Page_Rectangle(page_, x, y, width, height);
+  HPDF_Page_Fill(page_);
+  operations_ += 2;
+}
+
+void PageWriter::stroke_rectangle(const float x,
+                                  const float y,
+                                  const float width,
+                                  const float height) {
+  end_text();
+  HPDF_Page_Rectangle(page_, x, y, width, height);
+  HPDF_Page_Stroke(page_);
+  operations_ += 2;
+}
+
+void PageWriter::fill_circle(const float x, const float y, const float radius) {
+  end_text();
+  HPDF_Page_Circle(page_, x, y, radius);
+  HPDF_Page_Fill(page_);
+  operations_ += 2;
+}
+
+void PageWriter::image(HPDF_Image image,
+                       const float x,
+                       const float y,
+                       const float width,
+                       const float height) {
+  end_text();
+  HPDF_Page_DrawImage(page_, image, x, y, width, height);
+  ++operations_;
+}
+
+void PageWriter::end_text() {
+  if (in_text_) {
+    HPDF_Page_EndText(page_);
+    in_text_ = false;
+    ++operations_;
+  }
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <hpdf.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "font_face.h"
+
+namespace libharu_examples {
+namespace detail {
+
+struct RgbColor {
+  float red;
+  float green;
+  float blue;
+};
+
+inline bool operator==(const RgbColor& a, const RgbColor& b) {
+  return a.red == b.red && a.green == b.green && a.blue == b.blue;
+}
+
+// Drawing front-end for one page that remembers the graphics state it has emitted.
+//
+// - Consecutive `text` calls share a single BT/ET text object; it is closed lazily by the
+//   next path operation, `flush`, `reset` or the destructor.
+// - Font/size, fill color, stroke color and line width operators are only written when the
+//   value actually changes.
+//
+// The cache starts empty, so the first use of each parameter is always emitted. Operators
+// issued are counted and reported to the thread's render metrics by `flush`. Call
+// `invalidate` after anything that changes page state behind the writer's back (GRestore,
+// attaching a shared content stream), and `flush` before raw libHaru calls that require page
+// description mode.
+class PageWriter {
+ public:
+  explicit PageWriter(HPDF_Page page);
+  ~PageWriter();
+
+  PageWriter(const PageWriter&) = delete;
+  PageWriter& operator=(const PageWriter&) = delete;
+
+  HPDF_Page page() const { return page_; }
+  float width() const;
+  float height() const;
+
+  // Flushes the current page and continues on `page` with an empty cache.
+  void reset(HPDF_Page page);
+  void flush();
+  void invalidate();
+
+  void set_fill(const RgbColor& color);
+  void set_stroke(const RgbColor& color);
+  void set_line_width(float line_width);
+
+  void text(HPDF_Font font, float size, float x, float y, const char* text);
+  void text(HPDF_Font font, float size, float x, float y, const std::string& text) {
+    this->text(font, size, x, y, text.c_str());
+  }
+  void text(const FontFace& face, float size, float x, float y, const char* text) {
+    this->text(face.font(), size, x, y, text);
+  }
+  void text(const FontFace& face, float size, float x, float y, const std::string& text) {
+    this->text(face.font(), size, x, y, text.c_str());
+  }
+  // For text that is not NUL-terminated, e.g. a slice of a larger buffer.
+  void text(const FontFace& face, float size, float x, float y, std::string_view text);
+
+  // Draws `text`, or its longest prefix that fits `max_width` followed by "...", as measured
+  // by `face`.
+  void fitted_text(const FontFace& face,
+                   float size,
+                   float x,
+                   float y,
+                   float max_width,
+                   std::string_view text);
+
+  void line(float x1, float y1, float x2, float y2);
+  void fill_rectangle(float x, float y, float width, float height);
+  void stroke_rectangle(float x, float y, float width, float height);
+  void fill_circle(float x, float y, float radius);
+  void image(HPDF_Image image, float x, float y, float width, float height);
+
+ private:
+  void end_text();
+
+  HPDF_Page page_;
+  bool in_text_ = false;
+  std::size_t operations_ = 0;
+  std::string scratch_;
+
+  HPDF_Font font_ = nullptr;
+  float font_size_ = 0.0F;
+  RgbColor fill_{0.0F, 0.0F, 0.0F};
+  RgbColor stroke_{0.0F, 0.0F, 0.0F};
+  float line_width_ = 0.0F;
+  bool fill_known_ = false;
+  bool stroke_known_ = false;
+  bool line_width_known_ = false;
+};
+
+}  // namespace detail
+}  // namespace libharu_examples
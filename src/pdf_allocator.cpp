@@ -0,0 +1,269 @@
+/*
+High-level overview
+-------------------
+Allocator policies for libHaru documents. libHaru allocates every object, dictionary entry
+and stream buffer separately and `HPDF_Free` releases them one by one, so a document turns
+into thousands of small malloc/free pairs; under batch load that shows up as allocator
+contention and fragmentation.
+
+1) `ScopedPdfAllocator` installs a thread-local allocator.
+2) `new_document` sees it and creates the document with `HPDF_NewEx`, passing the hooks below.
+3) The hooks prefix every block with a 16-byte header holding the owning allocator and the
+   requested size, so frees are routed and sized without user data.
+
+Policies: `SystemPdfAllocator` (malloc with counters), `ArenaPdfAllocator` (bump pointer,
+rewinds when the document is freed) and `PoolPdfAllocator` (power-of-two free lists).
+
+libHaru logic addressed in this file
+------------------------------------
+- `HPDF_Alloc_Func`/`HPDF_Free_Func` take no context pointer and the free hook gets no size.
+- libHaru expects malloc alignment; headers and all policy block sizes are multiples of 16.
+*/
+#include "libharu_examples/pdf_allocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "pdf_allocator_state.h"
+#include "render_metrics_state.h"
+
+namespace libharu_examples {
+namespace detail {
+namespace {
+
+struct alignas(16) BlockHeader {
+  PdfAllocator* owner;
+  std::size_t size;
+};
+
+static_assert(sizeof(BlockHeader) == 16, "block header must preserve 16-byte alignment");
+
+}  // namespace
+
+thread_local PdfAllocator* active_allocator = nullptr;
+
+void* allocator_alloc_hook(const HPDF_UINT size) {
+  record_allocation(size);
+  const std::size_t total = sizeof(BlockHeader) + size;
+  PdfAllocator* const owner = active_allocator;
+  void* raw = owner != nullptr ? owner->allocate(total) : std::malloc(total);
+  if (raw == nullptr) {
+    return nullptr;
+  }
+
+  auto* header = static_cast<BlockHeader*>(raw);
+  header->owner = owner;
+  header->size = total;
+  return header + 1;
+}
+
+void allocator_free_hook(void* block) {
+  if (block == nullptr) {
+    return;
+  }
+
+  BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+  if (header->owner != nullptr) {
+    header->owner->deallocate(header, header->size);
+  } else {
+    std::free(header);
+  }
+}
+
+}  // namespace detail
+
+namespace {
+
+constexpr std::size_t kAlignment = 16;
+constexpr std::size_t kMinClassSize = 16;
+constexpr std::size_t kSlabSize = 64U * 1024U;
+
+std::size_t align_up(const std::size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+std::size_t size_class(const std::size_t size) {
+  std::size_t index = 0;
+  for (std::size_t class_size = kMinClassSize; class_size < size; class_size <<= 1U) {
+    ++index;
+  }
+  return index;
+}
+
+}  // namespace
+
+PdfAllocatorStats& PdfAllocatorStats::operator+=(const PdfAllocatorStats& other) {
+  allocations += other.allocations;
+  deallocations += other.deallocations;
+  bytes_allocated += other.bytes_allocated;
+  bytes_in_use += other.bytes_in_use;
+  peak_bytes_in_use = std::max(peak_bytes_in_use, other.peak_bytes_in_use);
+  system_allocations += other.system_allocations;
+  resets += other.resets;
+  return *this;
+}
+
+void* PdfAllocator::allocate(const std::size_t size) {
+  void* block = do_allocate(size);
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  ++live_blocks_;
+  ++stats_.allocations;
+  stats_.bytes_allocated += size;
+  stats_.bytes_in_use += size;
+  stats_.peak_bytes_in_use = std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  return block;
+}
+
+void PdfAllocator::deallocate(void* block, const std::size_t size) {
+  if (block == nullptr) {
+    return;
+  }
+
+  do_deallocate(block, size);
+  ++stats_.deallocations;
+  stats_.bytes_in_use -= size;
+  if (--live_blocks_ == 0) {
+    on_idle();
+  }
+}
+
+void PdfAllocator::reset_stats() {
+  const std::size_t in_use = stats_.bytes_in_use;
+  stats_ = PdfAllocatorStats{};
+  stats_.bytes_in_use = in_use;
+  stats_.peak_bytes_in_use = in_use;
+}
+
+void* SystemPdfAllocator::do_allocate(const std::size_t size) {
+  ++stats_.system_allocations;
+  return std::malloc(size);
+}
+
+void SystemPdfAllocator::do_deallocate(void* block, std::size_t) {
+  std::free(block);
+}
+
+ArenaPdfAllocator::ArenaPdfAllocator(const std::size_t chunk_size)
+    : chunk_size_(align_up(std::max(chunk_size, kAlignment))) {
+}
+
+ArenaPdfAllocator::~ArenaPdfAllocator() {
+  for (const Chunk& chunk : chunks_) {
+    std::free(chunk.data);
+  }
+}
+
+void* ArenaPdfAllocator::do_allocate(std::size_t size) {
+  size = align_up(size);
+
+  // Walk forward through chunks kept from earlier documents before asking malloc for more.
+  while (current_ < chunks_.size()) {
+    Chunk& chunk = chunks_[current_];
+    if (chunk.size - offset_ >= size) {
+      void* block = chunk.data + offset_;
+      offset_ += size;
+      return block;
+    }
+    ++current_;
+    offset_ = 0;
+  }
+
+  const std::size_t chunk_size = std::max(chunk_size_, size);
+  auto* data = static_cast<unsigned char*>(std::malloc(chunk_size));
+  if (data == nullptr) {
+    return nullptr;
+  }
+  ++stats_.system_allocations;
+  chunks_.push_back({data, chunk_size});
+  current_ = chunks_.size() - 1;
+  offset_ = size;
+  return data;
+}
+
+void ArenaPdfAllocator::do_deallocate(void*, std::size_t) {
+}
+
+void ArenaPdfAllocator::on_idle() {
+  current_ = 0;
+  offset_ = 0;
+  ++stats_.resets;
+}
+
+PoolPdfAllocator::PoolPdfAllocator() = default;
+
+PoolPdfAllocator::~PoolPdfAllocator() {
+  for (unsigned char* slab : slabs_) {
+    std::free(slab);
+  }
+}
+
+void* PoolPdfAllocator::do_allocate(const std::size_t size) {
+  const std::size_t index = size_class(size);
+  if (index >= kClassCount) {
+    ++stats_.system_allocations;
+    return std::malloc(size);
+  }
+
+  if (FreeBlock* block = free_lists_[index]) {
+    free_lists_[index] = block->next;
+    return block;
+  }
+
+  const std::size_t class_size = kMinClassSize << index;
+  if (slab_remaining_ < class_size) {
+    // The tail of the previous slab is abandoned; it is at most 4 KiB out of 64 KiB.
+    auto* slab = static_cast<unsigned char*>(std::malloc(kSlabSize));
+    if (slab == nullptr) {
+      return nullptr;
+    }
+    ++stats_.system_allocations;
+    slabs_.push_back(slab);
+    slab_cursor_ = slab;
+    slab_remaining_ = kSlabSize;
+  }
+
+  void* block = slab_cursor_;
+  slab_cursor_ += class_size;
+  slab_remaining_ -= class_size;
+  return block;
+}
+
+void PoolPdfAllocator::do_deallocate(void* block, const std::size_t size) {
+  const std::size_t index = size_class(size);
+  if (index >= kClassCount) {
+    std::free(block);
+    return;
+  }
+
+  auto* free_block = static_cast<FreeBlock*>(block);
+  free_block->next = free_lists_[index];
+  free_lists_[index] = free_block;
+}
+
+std::unique_ptr<PdfAllocator> make_pdf_allocator(const PdfAllocatorPolicy policy) {
+  switch (policy) {
+    case PdfAllocatorPolicy::Arena:
+      return std::make_unique<ArenaPdfAllocator>();
+    case PdfAllocatorPolicy::Pool:
+      return std::make_unique<PoolPdfAllocator>();
+    case PdfAllocatorPolicy::System:
+      return std::make_unique<SystemPdfAllocator>();
+    case PdfAllocatorPolicy::Default:
+      break;
+  }
+  return nullptr;
+}
+
+ScopedPdfAllocator::ScopedPdfAllocator(PdfAllocator& allocator)
+    : previous_(detail::active_allocator) {
+  detail::active_allocator = &allocator;
+}
+
+ScopedPdfAllocator::~ScopedPdfAllocator() {
+  detail::active_allocator = previous_;
+}
+
+}  // namespace libharu_examples
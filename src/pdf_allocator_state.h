@@ -0,0 +1,18 @@
+#pragma once
+
+#include "libharu_examples/pdf_allocator.h"
+
+#include <hpdf.h>
+
+namespace libharu_examples {
+namespace detail {
+
+extern thread_local PdfAllocator* active_allocator;
+
+// `HPDF_NewEx` hooks. Each block carries a small header naming its allocator, because the
+// free hook receives no size and no user data.
+void* allocator_alloc_hook(HPDF_UINT size);
+void allocator_free_hook(void* block);
+
+}  // namespace detail
+}  // namespace libharu_examples
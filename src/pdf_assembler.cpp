@@ -0,0 +1,809 @@
+/*
+High-level overview
+-------------------
+A libHaru document is built on one thread, so large documents are rendered as several page
+ranges in parallel (one `HPDF_Doc` per worker) and joined here into one PDF.
+
+1) Parse each part: `startxref` -> xref table -> object spans, and the trailer's /Root and
+   /Info. Object bodies are never parsed beyond their dictionary or array head; stream data is
+   copied through untouched.
+2) Walk the part's page tree (/Pages -> /Kids, any depth) to list its leaf pages in order.
+3) Copy every page and what it references, depth first. References in object heads are
+   rewritten to the output numbering; a page's /Parent points at the new page tree root.
+   Objects are written children first, so a small object whose rewritten bytes match one
+   already written (the same Type1 font, a shared template stream) reuses that number.
+4) Chain the top-level outline entries of all parts under one outline root, write one flat
+   page tree, the catalog and the info dictionary, then the xref table and trailer.
+
+libHaru logic addressed in this file
+------------------------------------
+- libHaru writes a classic xref table, `N 0 obj ... endobj` objects, indirect /Length values
+  and /Resources on every page (nothing is inherited from intermediate page tree nodes), so a
+  head-only reader is enough for its output.
+- Outline items are read as children of the catalog's /Outlines (their /Parent), which holds
+  for both the /First-/Next chain and flat outlines; nested outline levels are not copied.
+*/
+#include "libharu_examples/pdf_assembler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "file_writer_state.h"
+
+namespace libharu_examples {
+namespace {
+
+// Objects at most this large are candidates for de-duplication.
+constexpr std::size_t kMaxSharedObjectSize = 4096;
+constexpr std::size_t kSinkChunkSize = 64U * 1024U;
+
+bool is_whitespace(const char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0';
+}
+
+// Skips whitespace, then reads an unsigned decimal that must end before `end`; the part is not
+// NUL-terminated, so nothing may look past it.
+bool read_number(const char*& cursor, const char* const end, std::size_t& value) {
+  while (cursor < end && is_whitespace(*cursor)) {
+    ++cursor;
+  }
+  const auto [parsed, error] = std::from_chars(cursor, end, value);
+  if (error != std::errc()) {
+    return false;
+  }
+  cursor = parsed;
+  return true;
+}
+
+bool is_delimiter(const char c) {
+  return is_whitespace(c) || c == '(' || c == ')' || c == '<' || c == '>' || c == '[' ||
+         c == ']' || c == '{' || c == '}' || c == '/' || c == '%';
+}
+
+bool is_digit(const char c) {
+  return c >= '0' && c <= '9';
+}
+
+enum class TokenKind {
+  Name,
+  String,
+  Number,
+  Ref,
+  Open,
+  Close,
+  Keyword,
+  End,
+};
+
+struct Token {
+  TokenKind kind = TokenKind::End;
+  std::size_t begin = 0;
+  std::size_t end = 0;
+  // Object number of a Ref.
+  std::uint32_t number = 0;
+};
+
+// PDF object syntax tokens; `N G R` references come back as one Ref token.
+class Lexer {
+ public:
+  explicit Lexer(const std::string_view text) : text_(text) {}
+
+  std::size_t position() const { return pos_; }
+
+  Token next() {
+    skip_whitespace();
+    Token token;
+    token.begin = pos_;
+    if (pos_ >= text_.size()) {
+      token.end = pos_;
+      return token;
+    }
+
+    const char c = text_[pos_];
+    if (c == '/') {
+      ++pos_;
+      skip_regular();
+      token.kind = TokenKind::Name;
+    } else if (c == '(') {
+      skip_literal_string();
+      token.kind = TokenKind::String;
+    } else if (c == '<' && peek(1) == '<') {
+      pos_ += 2;
+      token.kind = TokenKind::Open;
+    } else if (c == '>' && peek(1) == '>') {
+      pos_ += 2;
+      token.kind = TokenKind::Close;
+    } else if (c == '<') {
+      const std::size_t close = text_.find('>', pos_);
+      pos_ = (close == std::string_view::npos) ? text_.size() : close + 1;
+      token.kind = TokenKind::String;
+    } else if (c == '[' || c == '{') {
+      ++pos_;
+      token.kind = TokenKind::Open;
+    } else if (c == ']' || c == '}') {
+      ++pos_;
+      token.kind = TokenKind::Close;
+    } else if (is_digit(c) || c == '-' || c == '+' || c == '.') {
+      token.kind = read_number_or_ref(token.number) ? TokenKind::Ref : TokenKind::Number;
+    } else {
+      skip_regular();
+      if (pos_ == token.begin) {
+        ++pos_;  // stray delimiter such as ')'
+      }
+      token.kind = TokenKind::Keyword;
+    }
+    token.end = pos_;
+    return token;
+  }
+
+  // With `open` just read, skips to the end of its matching Close.
+  std::size_t skip_container() {
+    int depth = 1;
+    while (depth > 0) {
+      const Token token = next();
+      if (token.kind == TokenKind::End) {
+        break;
+      }
+      depth += (token.kind == TokenKind::Open) ? 1 : (token.kind == TokenKind::Close) ? -1 : 0;
+    }
+    return pos_;
+  }
+
+ private:
+  char peek(const std::size_t ahead) const {
+    return pos_ + ahead < text_.size() ? text_[pos_ + ahead] : '\0';
+  }
+
+  void skip_whitespace() {
+    while (pos_ < text_.size()) {
+      if (text_[pos_] == '%') {
+        while (pos_ < text_.size() && text_[pos_] != '\n' && text_[pos_] != '\r') {
+          ++pos_;
+        }
+      } else if (is_whitespace(text_[pos_])) {
+        ++pos_;
+      } else {
+        break;
+      }
+    }
+  }
+
+  void skip_regular() {
+    while (pos_ < text_.size() && !is_delimiter(text_[pos_])) {
+      ++pos_;
+    }
+  }
+
+  void skip_literal_string() {
+    int depth = 0;
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_++];
+      if (c == '\\') {
+        ++pos_;
+      } else if (c == '(') {
+        ++depth;
+      } else if (c == ')' && --depth == 0) {
+        return;
+      }
+    }
+  }
+
+  std::size_t read_digits(std::size_t at, std::uint32_t* value) const {
+    std::uint32_t result = 0;
+    const std::size_t start = at;
+    while (at < text_.size() && is_digit(text_[at])) {
+      result = result * 10U + static_cast<std::uint32_t>(text_[at] - '0');
+      ++at;
+    }
+    if (value != nullptr) {
+      *value = result;
+    }
+    return at - start;
+  }
+
+  std::size_t skip_spaces_from(std::size_t at) const {
+    while (at < text_.size() && is_whitespace(text_[at])) {
+      ++at;
+    }
+    return at;
+  }
+
+  // Reads a number; if it is the object number of `N G R`, consumes the whole reference.
+  bool read_number_or_ref(std::uint32_t& number) {
+    const std::size_t digits = read_digits(pos_, &number);
+    const std::size_t after = pos_ + digits;
+    if (digits > 0 && (after >= text_.size() || is_delimiter(text_[after]))) {
+      std::size_t at = skip_spaces_from(after);
+      const std::size_t generation = read_digits(at, nullptr);
+      if (generation > 0 && at > after) {
+        at = skip_spaces_from(at + generation);
+        if (at > after + generation && at < text_.size() && text_[at] == 'R' &&
+            (at + 1 >= text_.size() || is_delimiter(text_[at + 1]))) {
+          pos_ = at + 1;
+          return true;
+        }
+      }
+    }
+    ++pos_;
+    skip_regular();
+    return false;
+  }
+
+  std::string_view text_;
+  std::size_t pos_ = 0;
+};
+
+// The head of an object body: everything before the `stream` keyword.
+std::size_t head_size(const std::string_view body) {
+  Lexer lexer(body);
+  for (;;) {
+    const Token token = lexer.next();
+    if (token.kind == TokenKind::End) {
+      return body.size();
+    }
+    if (token.kind == TokenKind::Keyword &&
+        body.substr(token.begin, token.end - token.begin) == "stream") {
+      return token.begin;
+    }
+  }
+}
+
+// Raw text of the value stored under `key` in the outermost dictionary of `head`.
+std::string_view dict_value(const std::string_view head, const std::string_view key) {
+  Lexer lexer(head);
+  int depth = 0;
+  for (;;) {
+    const Token token = lexer.next();
+    if (token.kind == TokenKind::End) {
+      return {};
+    }
+    if (token.kind == TokenKind::Open) {
+      ++depth;
+    } else if (token.kind == TokenKind::Close) {
+      --depth;
+    } else if (depth == 1 && token.kind == TokenKind::Name &&
+               head.substr(token.begin, token.end - token.begin) == key) {
+      const Token value = lexer.next();
+      const std::size_t end =
+          (value.kind == TokenKind::Open) ? lexer.skip_container() : value.end;
+      return head.substr(value.begin, end - value.begin);
+    }
+    if (depth == 1 && token.kind == TokenKind::Name) {
+      // Skip the value so names inside it are never taken for keys.
+      const Token value = lexer.next();
+      if (value.kind == TokenKind::Open) {
+        lexer.skip_container();
+      } else if (value.kind == TokenKind::Close) {
+        --depth;
+      }
+    }
+  }
+}
+
+std::uint32_t ref_value(const std::string_view value) {
+  Lexer lexer(value);
+  const Token token = lexer.next();
+  return token.kind == TokenKind::Ref ? token.number : 0;
+}
+
+// One input document, indexed but not copied.
+class PdfPart {
+ public:
+  bool parse(const std::string_view data, std::string& error) {
+    data_ = data;
+    if (data_.substr(0, 5) != "%PDF-") {
+      error = "not a PDF";
+      return false;
+    }
+    version_ = data_.substr(5, 3);
+
+    // Step 1: startxref -> xref table -> trailer.
+    const std::size_t startxref = data_.rfind("startxref");
+    if (startxref == std::string_view::npos) {
+      error = "no startxref";
+      return false;
+    }
+    Lexer tail(data_.substr(startxref + 9));
+    const Token offset_token = tail.next();
+    const char* offset_text = data_.data() + startxref + 9 + offset_token.begin;
+    std::size_t xref = 0;
+    if (offset_token.kind != TokenKind::Number ||
+        !read_number(offset_text, offset_text + (offset_token.end - offset_token.begin), xref) ||
+        xref >= data_.size() ||
+        data_.substr(xref, 4) != "xref") {
+      error = "no classic xref table";
+      return false;
+    }
+    if (!read_xref(xref, error)) {
+      return false;
+    }
+    return true;
+  }
+
+  std::string_view version() const { return version_; }
+  std::uint32_t root() const { return root_; }
+  std::uint32_t info() const { return info_; }
+  std::size_t object_count() const { return objects_.size(); }
+
+  // Body between `obj` and `endobj`; empty for free or missing objects.
+  std::string_view body(const std::uint32_t number) const {
+    if (number == 0 || number >= objects_.size()) {
+      return {};
+    }
+    return data_.substr(objects_[number].first, objects_[number].second);
+  }
+
+  std::string_view head(const std::uint32_t number) const {
+    const std::string_view text = body(number);
+    return text.substr(0, head_size(text));
+  }
+
+  // Step 2: Leaf pages in document order.
+  bool collect_pages(std::vector<std::uint32_t>& pages, std::string& error) const {
+    const std::uint32_t tree = ref_value(dict_value(head(root_), "/Pages"));
+    std::vector<bool> seen(objects_.size(), false);
+    return walk_pages(tree, pages, seen, 0, error);
+  }
+
+ private:
+  bool read_xref(const std::size_t xref, std::string& error) {
+    const std::string_view rest = data_.substr(xref + 4);
+    const char* cursor = rest.data();
+    const char* const end = rest.data() + rest.size();
+    std::vector<std::pair<std::size_t, std::uint32_t>> offsets;
+    for (;;) {
+      while (cursor < end && is_whitespace(*cursor)) {
+        ++cursor;
+      }
+      if (end - cursor >= 7 && std::strncmp(cursor, "trailer", 7) == 0) {
+        break;
+      }
+      std::size_t first = 0;
+      std::size_t count = 0;
+      if (!read_number(cursor, end, first) || !read_number(cursor, end, count)) {
+        error = cursor >= end ? "truncated xref table" : "malformed xref table";
+        return false;
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        std::size_t offset = 0;
+        std::size_t generation = 0;
+        if (!read_number(cursor, end, offset) || !read_number(cursor, end, generation)) {
+          error = cursor >= end ? "truncated xref table" : "malformed xref table";
+          return false;
+        }
+        while (cursor < end && is_whitespace(*cursor)) {
+          ++cursor;
+        }
+        if (cursor >= end) {
+          error = "truncated xref table";
+          return false;
+        }
+        if (*cursor == 'n') {
+          offsets.emplace_back(offset, static_cast<std::uint32_t>(first + i));
+        }
+        ++cursor;
+      }
+    }
+
+    const std::string_view trailer = data_.substr(static_cast<std::size_t>(cursor - data_.data()));
+    const std::string_view trailer_dict = trailer.substr(7);
+    if (!dict_value(trailer_dict, "/Encrypt").empty()) {
+      error = "encrypted documents cannot be assembled";
+      return false;
+    }
+    if (!dict_value(trailer_dict, "/Prev").empty()) {
+      error = "incrementally updated documents cannot be assembled";
+      return false;
+    }
+    root_ = ref_value(dict_value(trailer_dict, "/Root"));
+    info_ = ref_value(dict_value(trailer_dict, "/Info"));
+
+    // An object runs from its offset to the last `endobj` before the next object.
+    std::sort(offsets.begin(), offsets.end());
+    std::uint32_t highest = 0;
+    for (const auto& entry : offsets) {
+      highest = std::max(highest, entry.second);
+    }
+    objects_.assign(static_cast<std::size_t>(highest) + 1, {0, 0});
+    for (std::size_t i = 0; i < offsets.size(); ++i) {
+      const std::size_t start = offsets[i].first;
+      const std::size_t limit = (i + 1 < offsets.size()) ? offsets[i + 1].first : xref;
+      const std::size_t obj = data_.find("obj", start);
+      const std::size_t endobj =
+          (limit > start) ? data_.substr(0, limit).rfind("endobj") : std::string_view::npos;
+      if (obj == std::string_view::npos || endobj == std::string_view::npos || obj > endobj ||
+          endobj < start) {
+        error = "object " + std::to_string(offsets[i].second) + " is malformed";
+        return false;
+      }
+      objects_[offsets[i].second] = {obj + 3, endobj - (obj + 3)};
+    }
+    if (root_ == 0 || body(root_).empty()) {
+      error = "no document catalog";
+      return false;
+    }
+    return true;
+  }
+
+  bool walk_pages(const std::uint32_t node,
+                  std::vector<std::uint32_t>& pages,
+                  std::vector<bool>& seen,
+                  const int depth,
+                  std::string& error) const {
+    if (node == 0 || node >= objects_.size() || seen[node] || depth > 64) {
+      error = "malformed page tree";
+      return false;
+    }
+    seen[node] = true;
+    const std::string_view node_head = head(node);
+    const std::string_view kids = dict_value(node_head, "/Kids");
+    if (kids.empty()) {
+      pages.push_back(node);
+      return true;
+    }
+    Lexer lexer(kids);
+    for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+      if (token.kind == TokenKind::Ref &&
+          !walk_pages(token.number, pages, seen, depth + 1, error)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::string_view data_;
+  std::string_view version_;
+  std::uint32_t root_ = 0;
+  std::uint32_t info_ = 0;
+  // Per object number: body offset and size.
+  std::vector<std::pair<std::size_t, std::size_t>> objects_;
+};
+
+// Buffers the output and hands it on in chunks, tracking the byte offset for the xref table.
+class AssemblyOutput {
+ public:
+  AssemblyOutput(PdfBuffer* buffer, const PdfSink* sink) : buffer_(buffer), sink_(sink) {}
+
+  void write(const std::string_view text) {
+    PdfBuffer& target = (buffer_ != nullptr) ? *buffer_ : chunk_;
+    target.insert(target.end(), text.begin(), text.end());
+    offset_ += text.size();
+    if (buffer_ == nullptr && chunk_.size() >= kSinkChunkSize) {
+      flush();
+    }
+  }
+
+  bool flush() {
+    if (buffer_ == nullptr && !chunk_.empty()) {
+      ok_ = ok_ && (*sink_)(chunk_.data(), chunk_.size());
+      chunk_.clear();
+    }
+    return ok_;
+  }
+
+  std::size_t offset() const { return offset_; }
+
+ private:
+  PdfBuffer* buffer_;
+  const PdfSink* sink_;
+  PdfBuffer chunk_;
+  std::size_t offset_ = 0;
+  bool ok_ = true;
+};
+
+class Assembler {
+ public:
+  explicit Assembler(AssemblyOutput& out) : out_(out) {}
+
+  bool run(const std::vector<PdfBuffer>& parts, std::string& error) {
+    if (parts.empty()) {
+      error = "no parts";
+      return false;
+    }
+
+    // Step 1: Index every part before writing anything.
+    std::vector<PdfPart> indexed(parts.size());
+    std::string version = "1.3";
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+      const std::string_view data(reinterpret_cast<const char*>(parts[i].data()),
+                                  parts[i].size());
+      std::string part_error;
+      if (!indexed[i].parse(data, part_error)) {
+        error = "part " + std::to_string(i) + ": " + part_error;
+        return false;
+      }
+      version = std::max(version, std::string(indexed[i].version()));
+    }
+
+    out_.write("%PDF-" + version + "\n%\xB7\xBE\xAD\xAA\n");
+    offsets_.assign(3, 0);  // 1 = catalog, 2 = page tree root
+    std::string kids;
+    std::size_t page_count = 0;
+    for (std::size_t i = 0; i < indexed.size(); ++i) {
+      // Step 2 + 3: Pages in order, each pulling in what it references.
+      std::vector<std::uint32_t> pages;
+      std::string part_error;
+      if (!indexed[i].collect_pages(pages, part_error)) {
+        error = "part " + std::to_string(i) + ": " + part_error;
+        return false;
+      }
+      begin_part(indexed[i]);
+      page_set_.assign(indexed[i].object_count(), false);
+      for (const std::uint32_t page : pages) {
+        page_set_[page] = true;
+      }
+      for (const std::uint32_t page : pages) {
+        kids += std::to_string(copy_object(page)) + " 0 R ";
+      }
+      page_count += pages.size();
+      collect_outline_items(indexed[i]);
+      if (i == 0 && indexed[i].info() != 0) {
+        info_ = copy_object(indexed[i].info());
+      }
+    }
+
+    // Step 4: Outline, page tree, catalog, xref and trailer.
+    const std::uint32_t outlines = write_outlines();
+    write_object(2,
+                 "\n<<\n/Type /Pages\n/Kids [ " + kids + "]\n/Count " +
+                     std::to_string(page_count) + "\n>>\n");
+    write_object(1,
+                 "\n<<\n/Type /Catalog\n/Pages 2 0 R\n" +
+                     (outlines != 0 ? "/Outlines " + std::to_string(outlines) + " 0 R\n"
+                                    : std::string()) +
+                     ">>\n");
+
+    const std::size_t xref = out_.offset();
+    std::string table = "xref\n0 " + std::to_string(offsets_.size()) + "\n0000000000 65535 f\r\n";
+    char entry[32];
+    for (std::size_t i = 1; i < offsets_.size(); ++i) {
+      std::snprintf(entry, sizeof(entry), "%010zu 00000 n\r\n", offsets_[i]);
+      table += entry;
+    }
+    table += "trailer\n<<\n/Root 1 0 R\n";
+    if (info_ != 0) {
+      table += "/Info " + std::to_string(info_) + " 0 R\n";
+    }
+    table += "/Size " + std::to_string(offsets_.size()) + "\n>>\nstartxref\n" +
+             std::to_string(xref) + "\n%%EOF\n";
+    out_.write(table);
+    if (!out_.flush()) {
+      error = "output sink failed";
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  static constexpr std::uint32_t kUnvisited = 0;
+  static constexpr std::uint32_t kInProgress = 0xFFFFFFFFU;
+
+  struct OutlineItem {
+    std::string title;
+    // Already rewritten to the output numbering.
+    std::string target;
+  };
+
+  void begin_part(const PdfPart& part) {
+    part_ = &part;
+    mapping_.assign(part.object_count(), kUnvisited);
+  }
+
+  std::uint32_t reserve() {
+    offsets_.push_back(0);
+    return static_cast<std::uint32_t>(offsets_.size() - 1);
+  }
+
+  void write_object(const std::uint32_t number, const std::string_view body) {
+    offsets_[number] = out_.offset();
+    out_.write(std::to_string(number) + " 0 obj");
+    out_.write(body);
+    out_.write("endobj\n");
+  }
+
+  // Rewrites references in `text` to the output numbering, copying their targets first. With
+  // `page`, the /Parent reference points at the new page tree root instead.
+  std::string rewrite(const std::string_view text, const bool page) {
+    std::string result;
+    result.reserve(text.size() + 16);
+    Lexer lexer(text);
+    std::size_t copied = 0;
+    bool after_parent = false;
+    for (Token token = lexer.next(); token.kind != TokenKind::End; token = lexer.next()) {
+      if (token.kind == TokenKind::Ref) {
+        const std::uint32_t target = (page && after_parent) ? 2U : copy_object(token.number);
+        result.append(text, copied, token.begin - copied);
+        result += std::to_string(target) + " 0 R";
+        copied = token.end;
+      }
+      after_parent = token.kind == TokenKind::Name &&
+                     text.substr(token.begin, token.end - token.begin) == "/Parent";
+    }
+    result.append(text, copied, std::string_view::npos);
+    return result;
+  }
+
+  // Step 3: Depth first, children before parents, so identical small objects can be found
+  // by their rewritten bytes. An object reached again through a cycle gets its number early
+  // and is then never shared.
+  std::uint32_t copy_object(const std::uint32_t old) {
+    if (old == 0 || old >= mapping_.size() || part_->body(old).empty()) {
+      return 0;  // dangling reference; written as "0 0 R", which readers treat as null
+    }
+    std::uint32_t& state = mapping_[old];
+    if (state == kInProgress) {
+      state = reserve();
+      return state;
+    }
+    if (state != kUnvisited) {
+      return state;
+    }
+    state = kInProgress;
+
+    const std::string_view body = part_->body(old);
+    const std::size_t head = head_size(body);
+    std::string rewritten = rewrite(body.substr(0, head), page_set_[old]);
+    rewritten.append(body.substr(head));
+
+    std::uint32_t& current = mapping_[old];
+    if (current != kInProgress) {
+      write_object(current, rewritten);  // reserved while its children were copied
+      return current;
+    }
+    const bool shareable = !page_set_[old] && rewritten.size() <= kMaxSharedObjectSize;
+    if (shareable) {
+      const auto found = shared_.find(rewritten);
+      if (found != shared_.end()) {
+        current = found->second;
+        return current;
+      }
+    }
+    current = reserve();
+    write_object(current, rewritten);
+    if (shareable) {
+      shared_.emplace(std::move(rewritten), current);
+    }
+    return current;
+  }
+
+  void collect_outline_items(const PdfPart& part) {
+    const std::uint32_t root = ref_value(dict_value(part.head(part.root()), "/Outlines"));
+    if (root == 0) {
+      return;
+    }
+    for (std::uint32_t number = 1; number < part.object_count(); ++number) {
+      const std::string_view head = part.head(number);
+      if (head.empty() || ref_value(dict_value(head, "/Parent")) != root) {
+        continue;
+      }
+      const std::string_view title = dict_value(head, "/Title");
+      if (title.empty()) {
+        continue;
+      }
+      OutlineItem item;
+      item.title.assign(title);
+      for (const std::string_view key : {"/Dest", "/A"}) {
+        const std::string_view target = dict_value(head, key);
+        if (!target.empty()) {
+          item.target = std::string(key) + " " + rewrite(target, false) + "\n";
+          break;
+        }
+      }
+      outline_items_.push_back(std::move(item));
+    }
+  }
+
+  std::uint32_t write_outlines() {
+    if (outline_items_.empty()) {
+      return 0;
+    }
+    const std::uint32_t root = reserve();
+    const std::uint32_t first = static_cast<std::uint32_t>(offsets_.size());
+    for (std::size_t i = 0; i < outline_items_.size(); ++i) {
+      reserve();
+    }
+    const std::uint32_t last = static_cast<std::uint32_t>(offsets_.size() - 1);
+    for (std::uint32_t number = first; number <= last; ++number) {
+      const OutlineItem& item = outline_items_[number - first];
+      std::string body = "\n<<\n/Title " + item.title + "\n/Parent " + std::to_string(root) +
+                         " 0 R\n" + item.target;
+      if (number > first) {
+        body += "/Prev " + std::to_string(number - 1) + " 0 R\n";
+      }
+      if (number < last) {
+        body += "/Next " + std::to_string(number + 1) + " 0 R\n";
+      }
+      write_object(number, body + ">>\n");
+    }
+    write_object(root,
+                 "\n<<\n/Type /Outlines\n/First " + std::to_string(first) + " 0 R\n/Last " +
+                     std::to_string(last) + " 0 R\n/Count " +
+                     std::to_string(outline_items_.size()) + "\n>>\n");
+    return root;
+  }
+
+  AssemblyOutput& out_;
+  const PdfPart* part_ = nullptr;
+  // Per object number of the current part: kUnvisited, kInProgress or the output number.
+  std::vector<std::uint32_t> mapping_;
+  std::vector<bool> page_set_;
+  // Output object number -> byte offset; index 0 is the free entry.
+  std::vector<std::size_t> offsets_;
+  std::unordered_map<std::string, std::uint32_t> shared_;
+  std::vector<OutlineItem> outline_items_;
+  std::uint32_t info_ = 0;
+};
+
+bool run_assembler(const std::vector<PdfBuffer>& parts,
+                   AssemblyOutput& out,
+                   std::string* error) {
+  std::string message;
+  Assembler assembler(out);
+  const bool assembled = assembler.run(parts, message);
+  if (!assembled && error != nullptr) {
+    *error = message;
+  }
+  return assembled;
+}
+
+}  // namespace
+
+bool assemble_pdf(const std::vector<PdfBuffer>& parts, PdfBuffer& output, std::string* error) {
+  output.clear();
+  AssemblyOutput out(&output, nullptr);
+  if (!run_assembler(parts, out, error)) {
+    output.clear();
+    return false;
+  }
+  return true;
+}
+
+bool assemble_pdf(const std::vector<PdfBuffer>& parts, const PdfSink& sink, std::string* error) {
+  if (!sink) {
+    return false;
+  }
+  AssemblyOutput out(nullptr, &sink);
+  return run_assembler(parts, out, error);
+}
+
+bool assemble_pdf(const std::vector<PdfBuffer>& parts,
+                  const std::string& output_pdf_path,
+                  std::string* error) {
+  if (output_pdf_path.empty()) {
+    return false;
+  }
+  // Through the thread's file writer, like every rendered file, so the path only ever holds
+  // a complete document.
+  detail::WriterState& writer = detail::current_writer();
+  if (!detail::begin_file(writer, output_pdf_path)) {
+    if (error != nullptr) {
+      *error = "cannot open " + output_pdf_path;
+    }
+    return false;
+  }
+  const bool assembled = assemble_pdf(
+      parts,
+      [&writer](const unsigned char* data, const std::size_t size) {
+        return detail::append_file(
+            writer, size, [&data](unsigned char* piece, const std::size_t piece_size) {
+              std::memcpy(piece, data, piece_size);
+              data += piece_size;
+              return true;
+            });
+      },
+      error);
+  if (!assembled) {
+    detail::abort_file(writer);
+    return false;
+  }
+  return detail::finish_file(writer);
+}
+
+}  // namespace libharu_examples
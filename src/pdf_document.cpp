@@ -0,0 +1,253 @@
+/*
+High-level overview
+-------------------
+Document lifecycle and output helpers shared by every renderer.
+
+`new_document`/`reset_document`/`free_document` wrap `HPDF_New`/`HPDF_NewDoc`/`HPDF_Free` with
+the common error handler, which hands every libHaru error to the thread's metrics, and start
+a metrics document. A `ScopedDocumentInfo` has its metadata written into every new or recycled
+document (src/document_info.cpp). While metrics are collected, new documents allocate through
+counting `malloc` hooks. When a `ScopedPdfAllocator` is
+active the document is created through `HPDF_NewEx` with that allocator's hooks instead; when a
+`ScopedRenderContext` is active (and no allocator is) the context's kept document is handed out
+and `free_document` only clears it with `HPDF_FreeDoc`. Once a document has been drawn:
+
+1) `save_to_file` serializes into libHaru's memory stream and reads it straight into the
+   thread's file writer (src/file_writer.cpp): temporary file, fsync policy, atomic rename.
+   Unlike `HPDF_SaveToFile`, which streams objects to the file as it writes them, this holds
+   the whole serialized PDF in memory next to the document until the document is freed, so a
+   save peaks at roughly document plus file size. `max_pages_per_file` bounds it for large
+   text inputs.
+2) `save_to_buffer` serializes into libHaru's memory stream and copies it once into the
+   caller's buffer.
+3) `save_to_sink` serializes the same way and hands the bytes out in fixed-size chunks.
+
+libHaru logic addressed in this file
+------------------------------------
+- `HPDF_SaveToStream` renders the whole document into an internal memory stream.
+- `HPDF_GetStreamSize` gives the exact byte count, so the caller's buffer is sized once.
+- `HPDF_ReadFromStream` copies bytes out; it reports `HPDF_STREAM_EOF` once drained.
+- libHaru reports failures through the error handler (error and detail number) before the
+  failing call returns, so the handler runs on the rendering thread. A duplicate encoder
+  registration on a recycled document is expected (see `src/font_face.cpp`) and not reported.
+*/
+#include "pdf_document.h"
+
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+
+#include "document_info_state.h"
+#include "file_writer_state.h"
+#include "font_face.h"
+#include "pdf_allocator_state.h"
+#include "render_context_state.h"
+#include "render_metrics_state.h"
+
+namespace libharu_examples {
+namespace detail {
+namespace {
+
+constexpr HPDF_UINT32 kSinkChunkSize = 64U * 1024U;
+
+void error_handler(const HPDF_STATUS error_no, const HPDF_STATUS detail_no, void*) {
+  if (error_no == kDuplicateRegistration) {
+    return;
+  }
+  record_error(error_no, detail_no);
+}
+
+void* counting_alloc(const HPDF_UINT size) {
+  record_allocation(size);
+  return std::malloc(size);
+}
+
+void counting_free(void* block) {
+  std::free(block);
+}
+
+// Plain `HPDF_New` unless metrics are on; then the counting hooks see every allocation.
+HPDF_Doc new_plain_document() {
+  if (metrics_enabled()) {
+    return HPDF_NewEx(error_handler, counting_alloc, counting_free, 0, nullptr);
+  }
+  return HPDF_New(error_handler, nullptr);
+}
+
+bool stream_read_ok(const HPDF_STATUS status) {
+  return status == HPDF_OK || status == HPDF_STREAM_EOF;
+}
+
+// Hands out the active context's document, or nullptr when there is no usable context. The
+// context is skipped under a ScopedPdfAllocator so allocator stats and arena rewinds stay
+// per-document, and while its document is busy (a render nested in a sink callback).
+HPDF_Doc acquire_context_document() {
+  ContextState* context = active_context;
+  if (context == nullptr || context->in_use || active_allocator != nullptr) {
+    return nullptr;
+  }
+
+  if (context->pdf == nullptr) {
+    context->pdf = new_plain_document();
+    if (context->pdf == nullptr) {
+      return nullptr;
+    }
+  } else {
+    HPDF_ResetError(context->pdf);
+    if (HPDF_NewDoc(context->pdf) != HPDF_OK) {
+      return nullptr;
+    }
+    ++context->reused_documents;
+  }
+
+  HPDF_SetCompressionMode(context->pdf, context->compression_mode);
+  context->in_use = true;
+  return context->pdf;
+}
+
+bool is_context_document(HPDF_Doc pdf) {
+  return active_context != nullptr && active_context->in_use && active_context->pdf == pdf;
+}
+
+}  // namespace
+
+HPDF_Doc new_document() {
+  begin_document();
+  HPDF_Doc pdf = acquire_context_document();
+  if (pdf == nullptr) {
+    pdf = (active_allocator != nullptr)
+              ? HPDF_NewEx(error_handler, allocator_alloc_hook, allocator_free_hook, 0, nullptr)
+              : new_plain_document();
+  }
+  apply_document_info(pdf);
+  mark_phase(RenderPhase::Init);
+  return pdf;
+}
+
+bool reset_document(HPDF_Doc& pdf) {
+  if (active_allocator != nullptr) {
+    // Recreate rather than recycle: the allocator only sees the document go idle (and the
+    // arena only rewinds) once `HPDF_Free` has returned every block.
+    free_document(pdf);
+    pdf = new_document();
+    return pdf != nullptr;
+  }
+
+  begin_document();
+  if (is_context_document(pdf)) {
+    HPDF_ResetError(pdf);
+    if (HPDF_NewDoc(pdf) != HPDF_OK) {
+      return false;
+    }
+    HPDF_SetCompressionMode(pdf, active_context->compression_mode);
+    ++active_context->reused_documents;
+  } else if (HPDF_NewDoc(pdf) != HPDF_OK) {
+    return false;
+  }
+  apply_document_info(pdf);
+  mark_phase(RenderPhase::Init);
+  return true;
+}
+
+void free_document(HPDF_Doc pdf) {
+  end_document(false);
+  if (is_context_document(pdf)) {
+    HPDF_FreeDoc(pdf);
+    active_context->in_use = false;
+    return;
+  }
+  if (pdf != nullptr) {
+    forget_document_fonts(pdf);
+    HPDF_Free(pdf);
+  }
+}
+
+bool save_to_file(HPDF_Doc pdf, const std::string& output_pdf_path) {
+  // The temporary file is created first, so an unwritable path fails before serializing and
+  // is reported the way `HPDF_SaveToFile` reported it.
+  WriterState& writer = current_writer();
+  if (!begin_file(writer, output_pdf_path)) {
+    record_error(HPDF_FILE_IO_ERROR, static_cast<unsigned long>(errno));
+    return false;
+  }
+  if (HPDF_SaveToStream(pdf) != HPDF_OK) {
+    abort_file(writer);
+    return false;
+  }
+  mark_phase(RenderPhase::Serialize);
+
+  const HPDF_UINT32 size = HPDF_GetStreamSize(pdf);
+  if (size == 0) {
+    abort_file(writer);
+    return false;
+  }
+  const bool saved =
+      append_file(writer,
+                  size,
+                  [pdf](unsigned char* data, const std::size_t piece) {
+                    HPDF_UINT32 read = static_cast<HPDF_UINT32>(piece);
+                    return stream_read_ok(HPDF_ReadFromStream(pdf, data, &read)) &&
+                           read == piece;
+                  }) &&
+      finish_file(writer);
+  if (!saved) {
+    return false;
+  }
+  record_output_bytes(size);
+  mark_phase(RenderPhase::Write);
+  end_document(true);
+  return true;
+}
+
+bool save_to_buffer(HPDF_Doc pdf, PdfBuffer& output) {
+  output.clear();
+  if (HPDF_SaveToStream(pdf) != HPDF_OK) {
+    return false;
+  }
+  mark_phase(RenderPhase::Serialize);
+
+  const HPDF_UINT32 size = HPDF_GetStreamSize(pdf);
+  if (size == 0) {
+    return false;
+  }
+
+  // `clear()` kept the capacity, so this only reallocates when the document outgrows it.
+  output.resize(size);
+  HPDF_UINT32 read = size;
+  if (!stream_read_ok(HPDF_ReadFromStream(pdf, output.data(), &read)) || read != size) {
+    output.clear();
+    return false;
+  }
+  record_output_bytes(output.size());
+  mark_phase(RenderPhase::Write);
+  end_document(true);
+  return true;
+}
+
+bool save_to_sink(HPDF_Doc pdf, const PdfSink& sink) {
+  if (!sink || HPDF_SaveToStream(pdf) != HPDF_OK) {
+    return false;
+  }
+  mark_phase(RenderPhase::Serialize);
+
+  std::array<HPDF_BYTE, kSinkChunkSize> chunk;
+  for (;;) {
+    HPDF_UINT32 read = kSinkChunkSize;
+    const HPDF_STATUS status = HPDF_ReadFromStream(pdf, chunk.data(), &read);
+    if (!stream_read_ok(status)) {
+      return false;
+    }
+    if (read > 0 && !sink(chunk.data(), read)) {
+      return false;
+    }
+    record_output_bytes(read);
+    if (status == HPDF_STREAM_EOF || read < kSinkChunkSize) {
+      mark_phase(RenderPhase::Write);
+      end_document(true);
+      return true;
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
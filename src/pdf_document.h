@@ -0,0 +1,36 @@
+#pragma once
+
+#include "libharu_examples/pdf_output.h"
+#include "libharu_examples/render_metrics.h"
+
+#include <hpdf.h>
+
+#include <cstddef>
+#include <string>
+
+namespace libharu_examples {
+namespace detail {
+
+using libharu_examples::RenderPhase;
+
+// Document lifecycle shared by all renderers. `new_document` and `reset_document` also start
+// a metrics document (closing its Init phase) when a ScopedRenderMetrics is active on this
+// thread, and allocate through the thread's ScopedPdfAllocator if there is one
+// (`reset_document` may then replace `pdf`). Otherwise a ScopedRenderContext's kept document
+// is reused; `free_document` then clears it. New and reset documents carry the thread's
+// ScopedDocumentInfo. Releasing or resetting a document that was never saved reports it as
+// failed.
+HPDF_Doc new_document();
+bool reset_document(HPDF_Doc& pdf);
+void free_document(HPDF_Doc pdf);
+
+// Closes the current phase; a no-op unless metrics are being collected.
+void mark_phase(RenderPhase phase);
+
+// The save helpers close the Serialize and Write phases and end the metrics document.
+bool save_to_file(HPDF_Doc pdf, const std::string& output_pdf_path);
+bool save_to_buffer(HPDF_Doc pdf, PdfBuffer& output);
+bool save_to_sink(HPDF_Doc pdf, const PdfSink& sink);
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -4,8 +4,23 @@ High-level overview
 This file demonstrates the smallest useful libHaru workflow for creating a PDF:
 
 1) Create an `HPDF_Doc` with `HPDF_New(...)`.
-2) Add one page, select a standard font, and enter text mode.
-3) Draw text at a fixed position and write the PDF to disk.
+2) Add one page, select Helvetica (or the `TextPdfOptions::font` TrueType font), and enter
+   text mode.
+3) Draw text at a fixed position and write the PDF to disk, a caller buffer, or a sink.
+   Under a `ScopedRenderCache` a text rendered before is served from src/render_cache.cpp.
+
+The streaming text-file renderer builds on the same steps for inputs of any size:
+
+1) Read the file in fixed-size chunks and split on '\n'; a partial line is carried into the
+   next chunk, and a line that grows past `kMaxPendingLine` is wrapped early.
+2) Wrap each line to the text width with the precomputed Helvetica metrics (`FontMetrics`), or
+   with the shared tables of `TextPdfOptions::font`, breaking only between UTF-8 code points.
+3) Fill pages row by row; when `max_pages_per_file` is reached, save the volume and start a
+   fresh document.
+
+With `render_threads` above 1, a layout pass wraps every line without drawing to find where
+pages begin, each thread renders a contiguous page range into its own document, and the
+parts are joined by `assemble_pdf` (src/pdf_assembler.cpp).
 
 libHaru logic addressed in this example
 ---------------------------------------
@@ -13,32 +28,54 @@ libHaru logic addressed in this example
 - A page must exist before drawing (`HPDF_AddPage`).
 - Text rendering is stateful: begin text (`HPDF_Page_BeginText`), position cursor,
   show text, then end text.
+- Text leading (`HPDF_Page_SetTextLeading`) lets every row be a single
+  `HPDF_Page_ShowTextNextLine` inside one text object per page.
 - The document must be explicitly freed (`HPDF_Free`) to avoid leaks.
+- An `HPDF_Doc` is not thread-safe, so parallel rendering uses one document per thread.
 */
 #include "libharu_examples/pdf_text_example.h"
+#include "libharu_examples/pdf_assembler.h"
+#include "libharu_examples/text_metrics.h"
 
 #include <hpdf.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "font_face.h"
+#include "mapped_file.h"
+#include "page_geometry.h"
+#include "pdf_document.h"
+#include "render_cache_state.h"
+#include "render_metrics_state.h"
+#include "sha256.h"
+
 namespace libharu_examples {
 namespace {
 
-void error_handler(HPDF_STATUS, HPDF_STATUS, void*) {
-}
-
-}  // namespace
+// Unterminated lines longer than this are wrapped before their newline arrives, so a file
+// without line breaks still renders in bounded memory.
+constexpr std::size_t kMaxPendingLine = 64U * 1024U;
 
-std::string default_example_text() {
-  return "Hello from a libHaru text example.";
-}
-
-bool create_text_pdf(const std::string& output_pdf_path, const std::string& text) {
-  // Step 1: Validate user inputs to avoid producing invalid/empty output.
-  if (output_pdf_path.empty() || text.empty()) {
+// Runs Steps 2-5 and hands the finished document to `save` (file, buffer or sink).
+template <typename SaveFn>
+bool render_text_document(const std::string& text,
+                          const TextPdfOptions& options,
+                          SaveFn&& save) {
+  if (text.empty()) {
     return false;
   }
 
   // Step 2: Create the libHaru document root object.
-  HPDF_Doc pdf = HPDF_New(error_handler, nullptr);
+  HPDF_Doc pdf = detail::new_document();
   if (pdf == nullptr) {
     return false;
   }
@@ -46,24 +83,548 @@ bool create_text_pdf(const std::string& output_pdf_path, const std::string& text
   // Step 3: Add a page and configure text style (font family + size).
   HPDF_Page page = HPDF_AddPage(pdf);
   if (page == nullptr) {
-    HPDF_Free(pdf);
+    detail::free_document(pdf);
     return false;
   }
 
-  HPDF_Font font = HPDF_GetFont(pdf, "Helvetica", nullptr);
-  HPDF_Page_SetFontAndSize(page, font, 12);
+  const detail::FontFace face = detail::load_face(
+      pdf, TrueTypeFontSet{options.font, nullptr, nullptr}, StandardFont::Helvetica);
+  if (face.font() == nullptr) {
+    detail::free_document(pdf);
+    return false;
+  }
+  detail::mark_phase(detail::RenderPhase::Setup);
+  HPDF_Page_SetFontAndSize(page, face.font(), 12);
 
   // Step 4: Enter text mode, position cursor in user units, and draw string data.
   HPDF_Page_BeginText(page);
   HPDF_Page_MoveTextPos(page, 50, 750);
   HPDF_Page_ShowText(page, text.c_str());
   HPDF_Page_EndText(page);
+  detail::record_draw_operations(5);
 
   // Step 5: Persist and clean up document memory.
-  const HPDF_STATUS save_result = HPDF_SaveToFile(pdf, output_pdf_path.c_str());
-  HPDF_Free(pdf);
+  detail::mark_phase(detail::RenderPhase::Draw);
+  const bool saved = save(pdf);
+  detail::free_document(pdf);
+
+  return saved;
+}
+
+using SaveVolumeFn = std::function<bool(HPDF_Doc pdf, std::size_t volume)>;
+
+// Replaces control characters, then splits `text` into rows no wider than `width` and calls
+// `emit(row, length)` for each; an empty final line is one empty row. Unless `final`, the
+// last row is held back and `consumed` tells the caller where it starts.
+template <typename EmitFn>
+bool wrap_text(std::string& text,
+               const bool final,
+               const detail::FontFace& face,
+               const float font_size,
+               const float width,
+               std::size_t& consumed,
+               EmitFn&& emit) {
+  consumed = 0;
+  for (char& c : text) {
+    const auto byte = static_cast<unsigned char>(c);
+    if (byte < 0x20U || byte == 0x7FU) {
+      c = ' ';
+    }
+  }
+
+  if (text.empty()) {
+    return final ? emit(text.data(), 0) : true;
+  }
+
+  while (consumed < text.size()) {
+    const std::string_view remaining = std::string_view(text).substr(consumed);
+    const std::size_t fit =
+        std::max<std::size_t>(face.break_position(remaining, font_size, width), 1U);
+    if (!final && fit == remaining.size()) {
+      break;
+    }
+    if (!emit(remaining.data(), fit)) {
+      return false;
+    }
+    consumed += fit;
+  }
+  return true;
+}
+
+// Lays rows out onto A4 pages and rolls over to a new document every `max_pages` pages
+// (0 = never). Owns at most one live document at a time.
+class TextPager {
+ public:
+  TextPager(const TextPdfOptions& options,
+            const std::size_t max_pages,
+            TextPdfStats& stats,
+            SaveVolumeFn save_volume)
+      : options_(options),
+        max_pages_(max_pages),
+        stats_(stats),
+        save_volume_(std::move(save_volume)) {}
+
+  ~TextPager() { detail::free_document(pdf_); }
+
+  TextPager(const TextPager&) = delete;
+  TextPager& operator=(const TextPager&) = delete;
+
+  // Wraps and emits `text`. Unless `final`, the last row is held back (it may still grow)
+  // and the number of bytes consumed is returned so the caller can keep the rest.
+  bool add_text(std::string& text, const bool final, std::size_t& consumed) {
+    consumed = 0;
+    // The first page fixes the text width that wrapping measures against.
+    if (page_ == nullptr && (!ensure_document() || !start_page())) {
+      return false;
+    }
+    return wrap_text(text,
+                     final,
+                     font_,
+                     options_.font_size,
+                     text_width_,
+                     consumed,
+                     [this](const char* row, const std::size_t length) {
+                       return emit_row(row, length);
+                     });
+  }
+
+  bool finish() {
+    if (pdf_ == nullptr || stats_.output_lines == 0) {
+      return false;
+    }
+    return close_document();
+  }
+
+ private:
+  bool ensure_document() {
+    if (pdf_ != nullptr) {
+      return true;
+    }
+
+    pdf_ = detail::new_document();
+    if (pdf_ == nullptr) {
+      return false;
+    }
+    HPDF_SetPagesConfiguration(pdf_, 64);
+    font_ = detail::load_face(
+        pdf_, TrueTypeFontSet{options_.font, nullptr, nullptr}, StandardFont::Helvetica);
+    detail::mark_phase(detail::RenderPhase::Setup);
+    return font_.font() != nullptr;
+  }
+
+  bool start_page() {
+    if (page_ != nullptr) {
+      HPDF_Page_EndText(page_);
+      page_ = nullptr;
+      if (max_pages_ != 0 && pages_in_document_ == max_pages_ &&
+          (!close_document() || !ensure_document())) {
+        return false;
+      }
+    }
+
+    page_ = HPDF_AddPage(pdf_);
+    if (page_ == nullptr) {
+      return false;
+    }
+    HPDF_Page_SetSize(page_, HPDF_PAGE_SIZE_A4, HPDF_PAGE_PORTRAIT);
+    const float height = HPDF_Page_GetHeight(page_);
+    text_width_ = HPDF_Page_GetWidth(page_) - 2.0F * options_.margin;
+    rows_per_page_ =
+        static_cast<std::size_t>((height - 2.0F * options_.margin) / options_.leading);
+    rows_on_page_ = 0;
+    ++pages_in_document_;
+    ++stats_.pages;
+
+    // Start one leading above the first baseline; every row then advances with `'`.
+    HPDF_Page_BeginText(page_);
+    HPDF_Page_SetFontAndSize(page_, font_.font(), options_.font_size);
+    HPDF_Page_SetTextLeading(page_, options_.leading);
+    HPDF_Page_MoveTextPos(
+        page_, options_.margin, height - options_.margin - options_.font_size + options_.leading);
+    operations_ += 5;  // including the EndText that closes the page
+    return rows_per_page_ > 0;
+  }
+
+  bool emit_row(const char* text, const std::size_t length) {
+    if (rows_on_page_ == rows_per_page_ && !start_page()) {
+      return false;
+    }
+
+    row_.assign(text, length);
+    ++rows_on_page_;
+    ++operations_;
+    ++stats_.output_lines;
+    return HPDF_Page_ShowTextNextLine(page_, row_.c_str()) == HPDF_OK;
+  }
+
+  bool close_document() {
+    if (page_ != nullptr) {
+      HPDF_Page_EndText(page_);
+      page_ = nullptr;
+    }
+    detail::record_draw_operations(operations_);
+    operations_ = 0;
+    detail::mark_phase(detail::RenderPhase::Draw);
+    const bool saved = save_volume_(pdf_, ++stats_.files);
+    detail::free_document(pdf_);
+    pdf_ = nullptr;
+    pages_in_document_ = 0;
+    return saved;
+  }
+
+  const TextPdfOptions& options_;
+  const std::size_t max_pages_;
+  TextPdfStats& stats_;
+  SaveVolumeFn save_volume_;
+
+  HPDF_Doc pdf_ = nullptr;
+  detail::FontFace font_;
+  HPDF_Page page_ = nullptr;
+  float text_width_ = 0.0F;
+  std::size_t rows_per_page_ = 0;
+  std::size_t rows_on_page_ = 0;
+  std::size_t pages_in_document_ = 0;
+  std::size_t operations_ = 0;
+  std::string row_;
+};
+
+struct FileCloser {
+  void operator()(std::FILE* file) const { std::fclose(file); }
+};
+
+// Splits [cursor, end) on '\n' and hands every complete line to `pager`; the unterminated
+// tail is left in `line`.
+bool add_lines(TextPager& pager,
+               const char* cursor,
+               const char* const end,
+               std::string& line,
+               TextPdfStats& stats) {
+  std::size_t consumed = 0;
+  while (cursor < end) {
+    const auto* newline =
+        static_cast<const char*>(std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+    if (newline == nullptr) {
+      line.append(cursor, end);
+      break;
+    }
+
+    line.append(cursor, newline);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    ++stats.source_lines;
+    if (!pager.add_text(line, true, consumed)) {
+      return false;
+    }
+    line.clear();
+    cursor = newline + 1;
+  }
+  return true;
+}
+
+bool add_last_line(TextPager& pager, std::string& line, TextPdfStats& stats) {
+  std::size_t consumed = 0;
+  if (line.empty()) {
+    return true;
+  }
+  ++stats.source_lines;
+  return pager.add_text(line, true, consumed);
+}
+
+bool valid_options(const TextPdfOptions& options) {
+  return options.font_size > 0.0F && options.leading > 0.0F && options.read_chunk_size != 0;
+}
+
+// Streams `input_path` through a TextPager. Memory use is the read chunk, one pending line
+// (at most kMaxPendingLine) and the current libHaru document.
+bool render_text_file(const std::string& input_path,
+                      const TextPdfOptions& options,
+                      const std::size_t max_pages,
+                      TextPdfStats& stats,
+                      SaveVolumeFn save_volume) {
+  if (!valid_options(options)) {
+    return false;
+  }
+
+  const std::unique_ptr<std::FILE, FileCloser> input(std::fopen(input_path.c_str(), "rb"));
+  if (!input) {
+    return false;
+  }
+
+  TextPager pager(options, max_pages, stats, std::move(save_volume));
+  std::vector<char> chunk(options.read_chunk_size);
+  std::string line;
+  std::size_t consumed = 0;
+
+  for (;;) {
+    const std::size_t read = std::fread(chunk.data(), 1, chunk.size(), input.get());
+    if (read == 0) {
+      break;
+    }
+    stats.input_bytes += read;
+    if (!add_lines(pager, chunk.data(), chunk.data() + read, line, stats)) {
+      return false;
+    }
+
+    if (line.size() > kMaxPendingLine) {
+      if (!pager.add_text(line, false, consumed)) {
+        return false;
+      }
+      line.erase(0, consumed);
+    }
+  }
 
-  return save_result == HPDF_OK;
+  if (std::ferror(input.get()) != 0 || stats.input_bytes == 0) {
+    return false;
+  }
+  return add_last_line(pager, line, stats) && pager.finish();
+}
+
+// Byte offsets in the input where a page range starts; the first is always 0.
+struct PageRanges {
+  std::vector<std::size_t> starts;
+  std::size_t source_lines = 0;
+};
+
+// Layout pass for parallel rendering: wraps every line exactly as TextPager will, without
+// drawing, and picks up to `count` ranges of roughly equal page counts. Ranges start at a
+// source line that also starts a page, so each worker's pages match the serial output.
+PageRanges split_pages(const std::string_view text,
+                       const TextPdfOptions& options,
+                       const std::size_t count) {
+  constexpr detail::PageGeometry kA4 = detail::page_geometry(PageFormat::A4Portrait);
+  const float text_width = kA4.width - 2.0F * options.margin;
+  const auto rows_per_page =
+      static_cast<std::size_t>((kA4.height - 2.0F * options.margin) / options.leading);
+
+  PageRanges ranges;
+  if (rows_per_page == 0) {
+    return ranges;
+  }
+
+  // Step 1: Offset of every source line that begins a page (page index -> offset).
+  std::vector<std::pair<std::size_t, std::size_t>> page_starts;
+  std::size_t rows = 0;
+  std::size_t consumed = 0;
+  std::string line;
+  // Measures like the pagers' face; no document is needed for that.
+  const detail::FontFace face(nullptr, StandardFont::Helvetica, options.font.get());
+  const auto count_row = [&rows](const char*, std::size_t) {
+    ++rows;
+    return true;
+  };
+  std::size_t offset = 0;
+  while (offset < text.size()) {
+    if (rows % rows_per_page == 0) {
+      page_starts.emplace_back(rows / rows_per_page, offset);
+    }
+    std::size_t newline = text.find('\n', offset);
+    const std::size_t next = (newline == std::string_view::npos) ? text.size() : newline + 1;
+    newline = (newline == std::string_view::npos) ? text.size() : newline;
+    line.assign(text.data() + offset, newline - offset);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    wrap_text(line, true, face, options.font_size, text_width, consumed, count_row);
+    ++ranges.source_lines;
+    offset = next;
+  }
+
+  // Step 2: Cut at the first clean page boundary at or after each even share of the pages.
+  const std::size_t pages = (rows + rows_per_page - 1) / rows_per_page;
+  ranges.starts.push_back(0);
+  auto candidate = page_starts.begin();
+  for (std::size_t i = 1; i < count; ++i) {
+    const std::size_t target = pages * i / count;
+    while (candidate != page_starts.end() &&
+           (candidate->first < target || candidate->second <= ranges.starts.back())) {
+      ++candidate;
+    }
+    if (candidate == page_starts.end()) {
+      break;
+    }
+    ranges.starts.push_back(candidate->second);
+  }
+  return ranges;
+}
+
+// Renders page ranges of `input_path` on `options.render_threads` threads, one libHaru
+// document each, and joins them with `assemble_pdf`. The whole file is mapped, and every
+// worker's document stays in memory until the parts are assembled.
+bool render_text_file_parallel(const std::string& input_path,
+                               const TextPdfOptions& options,
+                               TextPdfStats& stats,
+                               const std::function<bool(const std::vector<PdfBuffer>&)>& join) {
+  if (!valid_options(options)) {
+    return false;
+  }
+
+  detail::MappedFile input;
+  if (!input.open(input_path) || input.view().empty()) {
+    return false;
+  }
+  const std::string_view text = input.view();
+  const PageRanges ranges = split_pages(text, options, options.render_threads);
+  if (ranges.starts.empty()) {
+    return false;
+  }
+
+  // Each worker pages through its own slice into its own buffer.
+  const std::size_t count = ranges.starts.size();
+  std::vector<PdfBuffer> parts(count);
+  std::vector<TextPdfStats> part_stats(count);
+  std::vector<char> rendered(count, 0);
+  const auto render_range = [&](const std::size_t index) {
+    const std::size_t begin = ranges.starts[index];
+    const std::size_t end = (index + 1 < count) ? ranges.starts[index + 1] : text.size();
+    TextPager pager(options, 0, part_stats[index], [&parts, index](HPDF_Doc pdf, std::size_t) {
+      return detail::save_to_buffer(pdf, parts[index]);
+    });
+    std::string line;
+    rendered[index] =
+        add_lines(pager, text.data() + begin, text.data() + end, line, part_stats[index]) &&
+        add_last_line(pager, line, part_stats[index]) && pager.finish();
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(count - 1);
+  for (std::size_t i = 1; i < count; ++i) {
+    workers.emplace_back(render_range, i);
+  }
+  render_range(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  stats.input_bytes = text.size();
+  stats.source_lines = ranges.source_lines;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (rendered[i] == 0) {
+      return false;
+    }
+    stats.output_lines += part_stats[i].output_lines;
+    stats.pages += part_stats[i].pages;
+  }
+  stats.files = 1;
+  return join(parts);
+}
+
+std::string volume_path(const std::string& output_pdf_path, const std::size_t volume) {
+  const std::filesystem::path path(output_pdf_path);
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), "_%04zu", volume);
+  return (path.parent_path() / (path.stem().string() + suffix + path.extension().string()))
+      .string();
+}
+
+// Serves the one-page document from the thread's render cache, rendering on a miss. The page
+// is always A4, so the text and the font are the only inputs.
+template <typename Output>
+bool cached_text_document(const std::string& text,
+                          const TextPdfOptions& options,
+                          Output& output) {
+  if (text.empty()) {
+    return false;
+  }
+  detail::FieldHash key =
+      detail::begin_key("text", PageFormat::A4Portrait, {options.font, nullptr, nullptr});
+  key.add(text);
+  return detail::cached_render(
+      detail::finish_key(key), output, [&text, &options](PdfBuffer& rendered) {
+        return render_text_document(text, options, [&rendered](HPDF_Doc pdf) {
+          return detail::save_to_buffer(pdf, rendered);
+        });
+      });
+}
+
+}  // namespace
+
+std::string default_example_text() {
+  return "Hello from a libHaru text example.";
+}
+
+bool create_text_pdf(const std::string& output_pdf_path,
+                     const std::string& text,
+                     const TextPdfOptions& options) {
+  // Step 1: Validate user inputs to avoid producing invalid/empty output.
+  if (output_pdf_path.empty()) {
+    return false;
+  }
+  if (detail::cache_active()) {
+    return cached_text_document(text, options, output_pdf_path);
+  }
+
+  return render_text_document(text, options, [&output_pdf_path](HPDF_Doc pdf) {
+    return detail::save_to_file(pdf, output_pdf_path);
+  });
+}
+
+bool create_text_pdf(PdfBuffer& output, const std::string& text, const TextPdfOptions& options) {
+  output.clear();
+  if (detail::cache_active()) {
+    return cached_text_document(text, options, output);
+  }
+  return render_text_document(
+      text, options, [&output](HPDF_Doc pdf) { return detail::save_to_buffer(pdf, output); });
+}
+
+bool create_text_pdf(const PdfSink& sink, const std::string& text, const TextPdfOptions& options) {
+  if (!sink) {
+    return false;
+  }
+  if (detail::cache_active()) {
+    return cached_text_document(text, options, sink);
+  }
+
+  return render_text_document(
+      text, options, [&sink](HPDF_Doc pdf) { return detail::save_to_sink(pdf, sink); });
+}
+
+bool create_text_file_pdf(const std::string& input_path,
+                          const std::string& output_pdf_path,
+                          const TextPdfOptions& options,
+                          TextPdfStats* stats) {
+  if (input_path.empty() || output_pdf_path.empty()) {
+    return false;
+  }
+
+  TextPdfStats local_stats;
+  TextPdfStats& totals = stats != nullptr ? *stats : local_stats;
+  totals = TextPdfStats{};
+  const std::size_t max_pages = options.max_pages_per_file;
+  if (options.render_threads > 1 && max_pages == 0) {
+    return render_text_file_parallel(
+        input_path, options, totals, [&output_pdf_path](const std::vector<PdfBuffer>& parts) {
+          return assemble_pdf(parts, output_pdf_path);
+        });
+  }
+  return render_text_file(
+      input_path, options, max_pages, totals, [&](HPDF_Doc pdf, const std::size_t volume) {
+        return detail::save_to_file(
+            pdf, max_pages == 0 ? output_pdf_path : volume_path(output_pdf_path, volume));
+      });
+}
+
+bool create_text_file_pdf(const std::string& input_path,
+                          const PdfSink& sink,
+                          const TextPdfOptions& options,
+                          TextPdfStats* stats) {
+  if (input_path.empty() || !sink) {
+    return false;
+  }
+
+  TextPdfStats local_stats;
+  TextPdfStats& totals = stats != nullptr ? *stats : local_stats;
+  totals = TextPdfStats{};
+  if (options.render_threads > 1) {
+    return render_text_file_parallel(
+        input_path, options, totals, [&sink](const std::vector<PdfBuffer>& parts) {
+          return assemble_pdf(parts, sink);
+        });
+  }
+  return render_text_file(input_path, options, 0, totals, [&sink](HPDF_Doc pdf, std::size_t) {
+    return detail::save_to_sink(pdf, sink);
+  });
 }
 
 }  // namespace libharu_examples
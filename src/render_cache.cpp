@@ -0,0 +1,304 @@
+/*
+High-level overview
+-------------------
+Content-addressed caching of finished documents. Output is a pure function of the inputs
+(see src/document_info.cpp for the metadata side), so a digest of the inputs names the bytes.
+
+1) The renderers build a key with `begin_key`, add their canonicalized inputs and hand
+   `cached_render` a closure that renders into a buffer.
+2) `cached_render` asks the active cache; on a miss it runs the closure, stores the bytes and
+   delivers them to the caller's buffer, sink or file (through the thread's file writer).
+3) The memory tier is an LRU list plus a hash index, bounded by bytes. Documents are shared
+   immutable buffers, so copies into caller buffers happen outside the lock.
+4) The disk tier keeps `<directory>/<key>.pdf`. Files go through the thread's file writer
+   (a temporary name unique across processes, then a rename), so readers never see a partial
+   document, and a disk hit is promoted into memory.
+
+libHaru logic addressed in this file
+------------------------------------
+- None directly: a hit skips libHaru entirely. The key includes the compression mode that
+  `new_document` will apply and the Info dictionary values, the two document-wide settings
+  that change the bytes libHaru writes for the same drawing.
+*/
+#include "libharu_examples/render_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "document_info_state.h"
+#include "file_writer_state.h"
+#include "pdf_allocator_state.h"
+#include "render_cache_state.h"
+#include "render_context_state.h"
+
+namespace libharu_examples {
+namespace detail {
+
+thread_local RenderCache* active_cache = nullptr;
+
+struct CacheState {
+  using Document = std::shared_ptr<const PdfBuffer>;
+
+  struct Entry {
+    std::string key;
+    Document document;
+  };
+
+  explicit CacheState(RenderCacheOptions cache_options) : options(std::move(cache_options)) {}
+
+  const RenderCacheOptions options;
+  mutable std::mutex mutex;
+  // Most recently used first.
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+  RenderCacheStats stats;
+};
+
+namespace {
+
+// Bump whenever a renderer's output changes for the same inputs, so disk caches written by
+// older builds stop matching.
+constexpr std::int64_t kRenderRevision = 3;
+
+constexpr std::size_t kSinkChunkSize = 64U * 1024U;
+
+struct FileCloser {
+  void operator()(std::FILE* file) const { std::fclose(file); }
+};
+
+// Keys become file names, so only plain names reach the disk tier.
+bool disk_key(const std::string& key) {
+  return !key.empty() && std::all_of(key.begin(), key.end(), [](const char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '-' || c == '_';
+  });
+}
+
+std::filesystem::path disk_path(const CacheState& state, const std::string& key) {
+  return std::filesystem::path(state.options.directory) / (key + ".pdf");
+}
+
+bool read_document(const std::filesystem::path& path, PdfBuffer& output) {
+  std::error_code error;
+  const auto size = std::filesystem::file_size(path, error);
+  if (error || size < 5) {
+    return false;
+  }
+  const std::unique_ptr<std::FILE, FileCloser> file(std::fopen(path.string().c_str(), "rb"));
+  if (!file) {
+    return false;
+  }
+  output.resize(static_cast<std::size_t>(size));
+  if (std::fread(output.data(), 1, output.size(), file.get()) != output.size()) {
+    return false;
+  }
+  // A file some other tool left behind is not trusted as a PDF.
+  return std::equal(output.begin(), output.begin() + 5, "%PDF-");
+}
+
+// Through the thread's file writer: an exclusively created `<key>.pdf.<pid>.<n>.tmp`, then a
+// rename, so processes sharing the directory never write into each other's temporary file.
+void write_document(const std::filesystem::path& path, const PdfBuffer& document) {
+  write_file(current_writer(), path.string(), document.data(), document.size());
+}
+
+// Caller holds the mutex.
+void insert_locked(CacheState& state, const std::string& key, CacheState::Document document) {
+  const std::size_t size = document->size();
+  const auto found = state.index.find(key);
+  if (found != state.index.end()) {
+    state.stats.memory_bytes -= found->second->document->size();
+    state.entries.erase(found->second);
+    state.index.erase(found);
+    --state.stats.entries;
+  }
+  if (size > state.options.memory_bytes) {
+    return;
+  }
+
+  state.entries.push_front({key, std::move(document)});
+  state.index.emplace(key, state.entries.begin());
+  state.stats.memory_bytes += size;
+  ++state.stats.entries;
+  while (state.stats.memory_bytes > state.options.memory_bytes) {
+    const CacheState::Entry& oldest = state.entries.back();
+    state.stats.memory_bytes -= oldest.document->size();
+    state.index.erase(oldest.key);
+    state.entries.pop_back();
+    --state.stats.entries;
+    ++state.stats.evictions;
+  }
+}
+
+HPDF_UINT effective_compression() {
+  // Mirrors `acquire_context_document`: only an idle context without an allocator applies its
+  // compression mode.
+  const ContextState* context = active_context;
+  if (context == nullptr || context->in_use || active_allocator != nullptr) {
+    return HPDF_COMP_NONE;
+  }
+  return context->compression_mode;
+}
+
+}  // namespace
+
+FieldHash begin_key(const std::string_view renderer,
+                    const PageFormat page_format,
+                    const TrueTypeFontSet& fonts) {
+  FieldHash key;
+  key.add(kRenderRevision);
+  key.add(renderer);
+  key.add(static_cast<std::int64_t>(page_format));
+  for (const auto* font : {&fonts.regular, &fonts.bold, &fonts.italic}) {
+    key.add(*font ? std::string_view((*font)->digest()) : std::string_view());
+  }
+
+  const DocumentInfo* info = active_info;
+  key.add(std::int64_t{info != nullptr});
+  if (info != nullptr) {
+    for (const std::string* text :
+         {&info->producer, &info->creator, &info->author, &info->title, &info->subject}) {
+      key.add(*text);
+    }
+    key.add(std::int64_t{info->creation_date.has_value()});
+    if (info->creation_date) {
+      const DocumentDate& date = *info->creation_date;
+      for (const int field :
+           {date.year, date.month, date.day, date.hour, date.minute, date.second}) {
+        key.add(std::int64_t{field});
+      }
+    }
+  }
+  key.add(static_cast<std::int64_t>(effective_compression()));
+  return key;
+}
+
+std::string finish_key(FieldHash& key) {
+  return to_hex(key.finish());
+}
+
+bool cached_render(const std::string& key, PdfBuffer& output, const BufferRender& render) {
+  RenderCache& cache = *active_cache;
+  if (cache.lookup(key, output)) {
+    return true;
+  }
+  if (!render(output)) {
+    return false;
+  }
+  cache.store(key, output);
+  return true;
+}
+
+bool cached_render(const std::string& key,
+                   const std::string& output_pdf_path,
+                   const BufferRender& render) {
+  PdfBuffer document;
+  return cached_render(key, document, render) &&
+         write_file(current_writer(), output_pdf_path, document.data(), document.size());
+}
+
+bool cached_render(const std::string& key, const PdfSink& sink, const BufferRender& render) {
+  PdfBuffer document;
+  if (!sink || !cached_render(key, document, render)) {
+    return false;
+  }
+  for (std::size_t offset = 0; offset < document.size(); offset += kSinkChunkSize) {
+    if (!sink(document.data() + offset, std::min(kSinkChunkSize, document.size() - offset))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace detail
+
+RenderCache::RenderCache(RenderCacheOptions options)
+    : state_(std::make_unique<detail::CacheState>(std::move(options))) {
+  if (!state_->options.directory.empty()) {
+    std::error_code error;
+    std::filesystem::create_directories(state_->options.directory, error);
+  }
+}
+
+RenderCache::~RenderCache() = default;
+
+bool RenderCache::lookup(const std::string& key, PdfBuffer& output) {
+  detail::CacheState& state = *state_;
+  detail::CacheState::Document document;
+  {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    const auto found = state.index.find(key);
+    if (found != state.index.end()) {
+      state.entries.splice(state.entries.begin(), state.entries, found->second);
+      document = found->second->document;
+      ++state.stats.memory_hits;
+    }
+  }
+  if (document) {
+    output.assign(document->begin(), document->end());
+    return true;
+  }
+
+  if (!state.options.directory.empty() && detail::disk_key(key)) {
+    auto loaded = std::make_shared<PdfBuffer>();
+    if (detail::read_document(detail::disk_path(state, key), *loaded)) {
+      output.assign(loaded->begin(), loaded->end());
+      const std::lock_guard<std::mutex> lock(state.mutex);
+      ++state.stats.disk_hits;
+      detail::insert_locked(state, key, std::move(loaded));
+      return true;
+    }
+  }
+
+  const std::lock_guard<std::mutex> lock(state.mutex);
+  ++state.stats.misses;
+  return false;
+}
+
+void RenderCache::store(const std::string& key, const PdfBuffer& document) {
+  detail::CacheState& state = *state_;
+  if (key.empty() || document.empty()) {
+    return;
+  }
+  if (document.size() <= state.options.memory_bytes) {
+    auto copy = std::make_shared<const PdfBuffer>(document);
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    ++state.stats.stores;
+    detail::insert_locked(state, key, std::move(copy));
+  } else {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    ++state.stats.stores;
+  }
+  if (!state.options.directory.empty() && detail::disk_key(key)) {
+    detail::write_document(detail::disk_path(state, key), document);
+  }
+}
+
+void RenderCache::clear() {
+  const std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->entries.clear();
+  state_->index.clear();
+  state_->stats.entries = 0;
+  state_->stats.memory_bytes = 0;
+}
+
+RenderCacheStats RenderCache::stats() const {
+  const std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->stats;
+}
+
+ScopedRenderCache::ScopedRenderCache(RenderCache& cache) : previous_(detail::active_cache) {
+  detail::active_cache = &cache;
+}
+
+ScopedRenderCache::~ScopedRenderCache() {
+  detail::active_cache = previous_;
+}
+
+}  // namespace libharu_examples
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "libharu_examples/page_format.h"
+#include "libharu_examples/pdf_output.h"
+#include "libharu_examples/render_cache.h"
+#include "libharu_examples/truetype_font.h"
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "sha256.h"
+
+namespace libharu_examples {
+namespace detail {
+
+extern thread_local RenderCache* active_cache;
+
+inline bool cache_active() {
+  return active_cache != nullptr;
+}
+
+// Starts a cache key with everything a render depends on besides its own inputs: the render
+// revision, `renderer`, the page format, the fonts' digests, the thread's DocumentInfo and
+// the compression the document will get. The caller adds its inputs and calls `finish_key`.
+FieldHash begin_key(std::string_view renderer,
+                    PageFormat page_format,
+                    const TrueTypeFontSet& fonts = {});
+std::string finish_key(FieldHash& key);
+
+// Serves `key` from the active cache, or runs `render` into a buffer, stores the result and
+// delivers it. `render` must not write anywhere but its argument.
+using BufferRender = std::function<bool(PdfBuffer& output)>;
+bool cached_render(const std::string& key, PdfBuffer& output, const BufferRender& render);
+bool cached_render(const std::string& key,
+                   const std::string& output_pdf_path,
+                   const BufferRender& render);
+bool cached_render(const std::string& key, const PdfSink& sink, const BufferRender& render);
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,74 @@
+/*
+High-level overview
+-------------------
+Warm document reuse. A one-page invoice spends a visible share of its time in `HPDF_New`,
+`HPDF_GetFont` and `HPDF_Free`; a RenderContext keeps one `HPDF_Doc` across renders.
+
+1) `ScopedRenderContext` points the thread-local `active_context` at the context state.
+2) `new_document` hands out the kept document (created on first use, re-initialised with
+   `HPDF_NewDoc` afterwards) and applies the compression mode.
+3) `free_document` recognises the kept document and clears it with `HPDF_FreeDoc` instead of
+   destroying it.
+
+libHaru logic addressed in this file
+------------------------------------
+- `HPDF_FreeDoc` releases pages, fonts and objects but keeps the document object, its error
+  handler and the font-definition/encoder caches (only `HPDF_FreeDocAll`/`HPDF_Free` drop
+  those), so `HPDF_GetFont` in the next document skips font-definition loading. That includes
+  TrueType fonts: `load_truetype_font` (src/font_face.cpp) parses each one once per context.
+- The error state is not part of the document; it is reset before each reuse.
+*/
+#include "libharu_examples/render_context.h"
+
+#include "font_face.h"
+#include "render_context_state.h"
+
+namespace libharu_examples {
+namespace detail {
+
+thread_local ContextState* active_context = nullptr;
+
+}  // namespace detail
+
+namespace {
+
+HPDF_UINT compression_mode(const PdfCompression compression) {
+  switch (compression) {
+    case PdfCompression::Text:
+      return HPDF_COMP_TEXT;
+    case PdfCompression::All:
+      return HPDF_COMP_ALL;
+    case PdfCompression::None:
+      break;
+  }
+  return HPDF_COMP_NONE;
+}
+
+}  // namespace
+
+RenderContext::RenderContext(const RenderContextOptions& options)
+    : state_(std::make_unique<detail::ContextState>()) {
+  state_->compression_mode = compression_mode(options.compression);
+}
+
+RenderContext::~RenderContext() {
+  if (state_->pdf != nullptr) {
+    detail::forget_document_fonts(state_->pdf);
+    HPDF_Free(state_->pdf);
+  }
+}
+
+std::size_t RenderContext::reused_documents() const {
+  return state_->reused_documents;
+}
+
+ScopedRenderContext::ScopedRenderContext(RenderContext& context)
+    : previous_(detail::active_context) {
+  detail::active_context = context.state_.get();
+}
+
+ScopedRenderContext::~ScopedRenderContext() {
+  detail::active_context = previous_;
+}
+
+}  // namespace libharu_examples
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "libharu_examples/render_context.h"
+
+#include <hpdf.h>
+
+#include <cstddef>
+
+namespace libharu_examples {
+namespace detail {
+
+struct ContextState {
+  HPDF_UINT compression_mode = HPDF_COMP_NONE;
+  HPDF_Doc pdf = nullptr;
+  bool in_use = false;
+  std::size_t reused_documents = 0;
+};
+
+extern thread_local ContextState* active_context;
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,139 @@
+/*
+High-level overview
+-------------------
+Thread-scoped render metrics. Each thread keeps a pointer to the active `RenderMetrics`
+(installed by `ScopedRenderMetrics`), the timestamp of the last phase boundary and the
+counters of the document in progress.
+
+1) `new_document`/`reset_document` call `begin_document`, which starts the clock.
+2) Renderers call `mark_phase` at each boundary (init -> setup -> draw -> serialize -> write);
+   the elapsed time goes to both the thread totals and the current document.
+3) Page writers report their operator counts, the allocation hooks every libHaru block, the
+   error handler every libHaru error and the save helpers the produced byte count.
+4) A successful save ends the document; releasing a document that was never saved ends it as
+   failed. Either way the `trace` hook sees its counters.
+
+When no scope is active every hook reduces to a thread-local pointer check, so the hooks stay
+compiled into production builds.
+*/
+#include "libharu_examples/render_metrics.h"
+
+#include <chrono>
+
+#include "pdf_document.h"
+#include "render_metrics_state.h"
+
+namespace libharu_examples {
+namespace detail {
+
+thread_local MetricsState metrics_state;
+
+namespace {
+
+RenderPhase next_phase(const RenderPhase phase) {
+  switch (phase) {
+    case RenderPhase::Init:
+      return RenderPhase::Setup;
+    case RenderPhase::Setup:
+      return RenderPhase::Draw;
+    case RenderPhase::Draw:
+      return RenderPhase::Serialize;
+    case RenderPhase::Serialize:
+    case RenderPhase::Write:
+      break;
+  }
+  return RenderPhase::Write;
+}
+
+std::chrono::nanoseconds& phase_total(RenderMetrics& metrics, const RenderPhase phase) {
+  switch (phase) {
+    case RenderPhase::Init:
+      return metrics.init_time;
+    case RenderPhase::Setup:
+      return metrics.setup_time;
+    case RenderPhase::Draw:
+      return metrics.draw_time;
+    case RenderPhase::Serialize:
+      return metrics.serialize_time;
+    case RenderPhase::Write:
+      break;
+  }
+  return metrics.write_time;
+}
+
+}  // namespace
+
+void begin_document() {
+  if (metrics_state.sink == nullptr) {
+    return;
+  }
+  if (metrics_state.open) {
+    end_document(false);
+  }
+  metrics_state.current = DocumentTrace{};
+  metrics_state.open = true;
+  metrics_state.phase = RenderPhase::Init;
+  metrics_state.last_mark = std::chrono::steady_clock::now();
+}
+
+void end_document(const bool saved) {
+  RenderMetrics* const sink = metrics_state.sink;
+  if (sink == nullptr || !metrics_state.open) {
+    return;
+  }
+  metrics_state.open = false;
+  metrics_state.current.saved = saved;
+  ++(saved ? sink->documents : sink->failed_documents);
+  if (sink->trace) {
+    // Renders from inside the hook are not measured, so they cannot disturb `current`.
+    metrics_state.sink = nullptr;
+    sink->trace(metrics_state.current);
+    metrics_state.sink = sink;
+  }
+}
+
+void mark_phase(const RenderPhase phase) {
+  RenderMetrics* const sink = metrics_state.sink;
+  if (sink == nullptr) {
+    return;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  const auto elapsed = now - metrics_state.last_mark;
+  metrics_state.last_mark = now;
+  metrics_state.phase = next_phase(phase);
+
+  phase_total(*sink, phase) += elapsed;
+  metrics_state.current.phase_time[static_cast<std::size_t>(phase)] += elapsed;
+}
+
+void record_error(const unsigned long code, const unsigned long detail) {
+  RenderMetrics* const sink = metrics_state.sink;
+  if (sink == nullptr) {
+    return;
+  }
+
+  const RenderError error{code, detail, metrics_state.phase};
+  ++sink->errors;
+  sink->last_error = error;
+  if (metrics_state.current.errors++ == 0) {
+    metrics_state.current.first_error = error;
+  }
+}
+
+}  // namespace detail
+
+// A document is only traced into the scope it started in; one still open when the scope
+// changes (e.g. an InvoiceStatement kept across scopes) is not reported.
+ScopedRenderMetrics::ScopedRenderMetrics(RenderMetrics& metrics)
+    : previous_(detail::metrics_state.sink) {
+  detail::metrics_state.sink = &metrics;
+  detail::metrics_state.open = false;
+}
+
+ScopedRenderMetrics::~ScopedRenderMetrics() {
+  detail::metrics_state.sink = previous_;
+  detail::metrics_state.open = false;
+}
+
+}  // namespace libharu_examples
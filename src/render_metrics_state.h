@@ -0,0 +1,58 @@
+#pragma once
+
+#include "libharu_examples/render_metrics.h"
+
+#include <chrono>
+#include <cstddef>
+
+namespace libharu_examples {
+namespace detail {
+
+struct MetricsState {
+  RenderMetrics* sink = nullptr;
+  std::chrono::steady_clock::time_point last_mark;
+  // The phase the current document is in, i.e. the one after the last `mark_phase`.
+  RenderPhase phase = RenderPhase::Init;
+  // Counters of the document between `begin_document` and `end_document`.
+  DocumentTrace current;
+  bool open = false;
+};
+
+extern thread_local MetricsState metrics_state;
+
+inline bool metrics_enabled() {
+  return metrics_state.sink != nullptr;
+}
+
+// Starts counting a new document; a document still open is reported as failed first.
+void begin_document();
+// Closes the open document (if any), counts it as saved or failed and calls the trace hook.
+void end_document(bool saved);
+
+void record_error(unsigned long code, unsigned long detail);
+
+inline void record_output_bytes(const std::size_t bytes) {
+  if (metrics_state.sink != nullptr) {
+    metrics_state.sink->output_bytes += bytes;
+    metrics_state.current.output_bytes += bytes;
+  }
+}
+
+inline void record_draw_operations(const std::size_t count) {
+  if (metrics_state.sink != nullptr) {
+    metrics_state.sink->draw_operations += count;
+    metrics_state.current.draw_operations += count;
+  }
+}
+
+inline void record_allocation(const std::size_t bytes) {
+  if (metrics_state.sink != nullptr) {
+    ++metrics_state.sink->allocations;
+    metrics_state.sink->allocated_bytes += bytes;
+    ++metrics_state.current.allocations;
+    metrics_state.current.allocated_bytes += bytes;
+  }
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
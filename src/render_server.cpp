@@ -0,0 +1,950 @@
+/*
+High-level overview
+-------------------
+A render daemon core: the text, invoice and clinical renderers behind a Unix domain socket,
+so a caller pays for one render per document instead of a process start, font setup and
+cold page faults.
+
+1) One IO thread owns the listening socket and every idle connection. It polls them and hands
+   a connection to the workers (through a `detail::BoundedQueue`) as soon as a request starts
+   to arrive; the connection comes back to the IO thread after the response is sent. The
+   worker polls against one deadline for the whole request and another for the response,
+   so a slow client costs it at most twice `io_timeout_ms`.
+2) Backpressure: while the queue is full the IO thread stops polling client sockets, and at
+   `max_connections` it stops accepting, so waiting requests stay in kernel socket buffers
+   and clients block in `send` instead of the server buffering without bound.
+3) Each worker keeps a `RenderContext` (one warm libHaru document), a request buffer and a
+   `PdfBuffer` for its whole life. Decoded strings and vectors are reused between requests and
+   image frames point into the request buffer, so a steady stream of requests does not
+   allocate in the server beyond what libHaru itself does. With a shared `RenderCache` a
+   repeated request is answered from the cache without rendering.
+4) `RenderClient` speaks the same framing (see `render_server.h`); responses are written with
+   one `sendmsg` of the frame header and the PDF bytes, without copying the PDF.
+
+libHaru logic addressed in this file
+------------------------------------
+- A libHaru document is single-threaded, so concurrency comes from one RenderContext per
+  worker; the shared InvoiceExample / ClinicalReportExample objects hold only read-only state.
+- The warm-up render loads the base-14 fonts (and any TrueType fonts) into each worker's
+  kept document; libHaru keeps those font definitions across `HPDF_NewDoc`.
+*/
+#include "libharu_examples/render_server.h"
+
+#include "libharu_examples/pdf_text_example.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "bounded_queue.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace libharu_examples {
+
+using ImageFrame = ClinicalReportExample::ImageFrame;
+
+namespace {
+
+constexpr std::uint8_t kProtocolVersion = 1;
+constexpr std::size_t kPageFormatCount = 4;
+
+// Appends big-endian fields to a frame.
+class WireWriter {
+ public:
+  explicit WireWriter(std::vector<unsigned char>& out) : out_(out) {}
+
+  void u8(const std::uint8_t value) { out_.push_back(value); }
+  void u32(const std::uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      out_.push_back(static_cast<unsigned char>(value >> shift));
+    }
+  }
+  void f64(const double value) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    u32(static_cast<std::uint32_t>(bits >> 32));
+    u32(static_cast<std::uint32_t>(bits));
+  }
+  void bytes(const void* data, const std::size_t size) {
+    u32(static_cast<std::uint32_t>(size));
+    const auto* begin = static_cast<const unsigned char*>(data);
+    out_.insert(out_.end(), begin, begin + size);
+  }
+  void str(const std::string& text) { bytes(text.data(), text.size()); }
+
+ private:
+  std::vector<unsigned char>& out_;
+};
+
+// Reads big-endian fields from a payload. After the first short read every call fails and
+// `ok()` stays false, so decoders check once at the end.
+class WireReader {
+ public:
+  WireReader(const unsigned char* data, const std::size_t size) : pos_(data), end_(data + size) {}
+
+  bool ok() const { return ok_; }
+  bool at_end() const { return pos_ == end_; }
+
+  std::uint8_t u8() { return available(1) ? *pos_++ : 0; }
+  std::uint32_t u32() {
+    if (!available(4)) {
+      return 0;
+    }
+    const std::uint32_t value = (std::uint32_t{pos_[0]} << 24) | (std::uint32_t{pos_[1]} << 16) |
+                                (std::uint32_t{pos_[2]} << 8) | std::uint32_t{pos_[3]};
+    pos_ += 4;
+    return value;
+  }
+  double f64() {
+    const std::uint64_t high = u32();
+    const std::uint64_t bits = (high << 32) | u32();
+    double value = 0.0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  // A length-prefixed field as a view into the payload.
+  const unsigned char* bytes(std::size_t& size) {
+    size = u32();
+    if (!available(size)) {
+      size = 0;
+      return nullptr;
+    }
+    const unsigned char* data = pos_;
+    pos_ += size;
+    return data;
+  }
+  void str(std::string& out) {
+    std::size_t size = 0;
+    const unsigned char* data = bytes(size);
+    out.assign(reinterpret_cast<const char*>(data), size);
+  }
+
+ private:
+  bool available(const std::size_t size) {
+    ok_ = ok_ && static_cast<std::size_t>(end_ - pos_) >= size;
+    return ok_;
+  }
+
+  const unsigned char* pos_;
+  const unsigned char* end_;
+  bool ok_ = true;
+};
+
+void encode_request(const RenderRequest& request,
+                    const std::string& output_name,
+                    std::vector<unsigned char>& frame) {
+  frame.assign(4, 0);
+  WireWriter writer(frame);
+  writer.u8(kProtocolVersion);
+  writer.u8(static_cast<std::uint8_t>(request.kind));
+  writer.u8(static_cast<std::uint8_t>(request.page_format));
+  writer.str(output_name);
+  switch (request.kind) {
+    case RenderKind::Text:
+      writer.str(request.text);
+      break;
+    case RenderKind::Invoice:
+      for (const std::string* field :
+           {&request.provider.name, &request.provider.address, &request.provider.email,
+            &request.client.name, &request.client.address, &request.client.email}) {
+        writer.str(*field);
+      }
+      writer.u32(static_cast<std::uint32_t>(request.items.size()));
+      for (const InvoiceExample::Item& item : request.items) {
+        writer.str(item.description);
+        writer.u32(static_cast<std::uint32_t>(item.quantity));
+        writer.f64(item.unit_price);
+      }
+      break;
+    case RenderKind::Clinical:
+      writer.str(request.patient.full_name);
+      writer.u32(static_cast<std::uint32_t>(request.patient.age));
+      writer.str(request.patient.sex);
+      writer.str(request.patient.patient_id);
+      writer.str(request.doctor.name);
+      writer.str(request.doctor.specialty);
+      writer.u32(static_cast<std::uint32_t>(request.frames.size()));
+      for (const ImageFrame& frame_data : request.frames) {
+        writer.u8(static_cast<std::uint8_t>(frame_data.format));
+        writer.u32(frame_data.width);
+        writer.u32(frame_data.height);
+        writer.bytes(frame_data.data, frame_data.size);
+      }
+      break;
+  }
+  const std::size_t payload = frame.size() - 4;
+  for (int i = 0; i < 4; ++i) {
+    frame[i] = static_cast<unsigned char>(payload >> (24 - 8 * i));
+  }
+}
+
+// Decodes into `request`, reusing its strings and vectors; frames point into `payload`.
+bool decode_request(const std::vector<unsigned char>& payload,
+                    RenderRequest& request,
+                    std::string& output_name,
+                    const char*& error) {
+  WireReader reader(payload.data(), payload.size());
+  if (reader.u8() != kProtocolVersion) {
+    error = "unsupported protocol version";
+    return false;
+  }
+  const std::uint8_t kind = reader.u8();
+  const std::uint8_t format = reader.u8();
+  reader.str(output_name);
+  if (format >= kPageFormatCount) {
+    error = "unknown page format";
+    return false;
+  }
+  request.page_format = static_cast<PageFormat>(format);
+
+  switch (kind) {
+    case static_cast<std::uint8_t>(RenderKind::Text):
+      request.kind = RenderKind::Text;
+      reader.str(request.text);
+      break;
+    case static_cast<std::uint8_t>(RenderKind::Invoice): {
+      request.kind = RenderKind::Invoice;
+      for (std::string* field : {&request.provider.name, &request.provider.address,
+                                 &request.provider.email, &request.client.name,
+                                 &request.client.address, &request.client.email}) {
+        reader.str(*field);
+      }
+      // Step 1: Each item takes at least 16 bytes, which bounds a hostile count.
+      const std::size_t count = std::min<std::size_t>(reader.u32(), payload.size() / 16);
+      request.items.resize(count);
+      for (InvoiceExample::Item& item : request.items) {
+        reader.str(item.description);
+        item.quantity = static_cast<std::int32_t>(reader.u32());
+        item.unit_price = reader.f64();
+      }
+      break;
+    }
+    case static_cast<std::uint8_t>(RenderKind::Clinical): {
+      request.kind = RenderKind::Clinical;
+      reader.str(request.patient.full_name);
+      request.patient.age = static_cast<int>(reader.u32());
+      reader.str(request.patient.sex);
+      reader.str(request.patient.patient_id);
+      reader.str(request.doctor.name);
+      reader.str(request.doctor.specialty);
+      const std::size_t count = std::min<std::size_t>(reader.u32(), payload.size() / 13);
+      request.frames.resize(count);
+      for (ImageFrame& frame : request.frames) {
+        const std::uint8_t frame_format = reader.u8();
+        if (frame_format > static_cast<std::uint8_t>(ImageFrame::Format::Jpeg)) {
+          error = "unknown image format";
+          return false;
+        }
+        frame.format = static_cast<ImageFrame::Format>(frame_format);
+        frame.width = reader.u32();
+        frame.height = reader.u32();
+        frame.data = reader.bytes(frame.size);
+      }
+      break;
+    }
+    default:
+      error = "unknown render kind";
+      return false;
+  }
+  if (!reader.ok() || !reader.at_end()) {
+    error = "malformed request";
+    return false;
+  }
+  return true;
+}
+
+// Output names are plain file names inside the output directory.
+bool valid_output_name(const std::string& name) {
+  return name != "." && name != ".." && name.find('/') == std::string::npos &&
+         name.find('\0') == std::string::npos;
+}
+
+#if !defined(_WIN32)
+
+using Clock = std::chrono::steady_clock;
+
+// No bound: the socket blocks for as long as the peer takes (the client side).
+constexpr Clock::time_point kNoDeadline = Clock::time_point::max();
+
+Clock::time_point deadline_after(const int timeout_ms) {
+  return timeout_ms > 0 ? Clock::now() + std::chrono::milliseconds(timeout_ms) : kNoDeadline;
+}
+
+// Waits until `fd` is ready for `events`; false once `deadline` has passed.
+bool wait_until(const int fd, const short events, const Clock::time_point deadline) {
+  for (;;) {
+    const auto remaining =
+        std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()).count();
+    if (remaining <= 0) {
+      errno = ETIMEDOUT;
+      return false;
+    }
+    pollfd polled{fd, events, 0};
+    const int ready = ::poll(&polled, 1, static_cast<int>(std::min<long long>(remaining, 60000)));
+    if (ready > 0) {
+      return true;
+    }
+    if (ready < 0 && errno != EINTR) {
+      return false;
+    }
+  }
+}
+
+// With a deadline the calls do not block: a socket with nothing to read (or no room to
+// send) is polled for the time left, so the deadline bounds the whole transfer rather than
+// each call, and a peer trickling bytes cannot extend it.
+bool would_block(const int fd, const short events, const Clock::time_point deadline) {
+  return deadline != kNoDeadline && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+         wait_until(fd, events, deadline);
+}
+
+bool read_exact(const int fd,
+                unsigned char* data,
+                std::size_t size,
+                const Clock::time_point deadline = kNoDeadline) {
+  const int flags = deadline != kNoDeadline ? MSG_DONTWAIT : 0;
+  while (size > 0) {
+    const ssize_t read = ::recv(fd, data, size, flags);
+    if (read < 0 && (errno == EINTR || would_block(fd, POLLIN, deadline))) {
+      continue;
+    }
+    if (read <= 0) {
+      return false;
+    }
+    data += read;
+    size -= static_cast<std::size_t>(read);
+  }
+  return true;
+}
+
+// Sends every byte of the iovecs, continuing after partial writes.
+bool send_all(const int fd,
+              iovec* parts,
+              std::size_t count,
+              const Clock::time_point deadline = kNoDeadline) {
+  const int flags = MSG_NOSIGNAL | (deadline != kNoDeadline ? MSG_DONTWAIT : 0);
+  while (count > 0) {
+    msghdr message{};
+    message.msg_iov = parts;
+    message.msg_iovlen = count;
+    ssize_t sent = ::sendmsg(fd, &message, flags);
+    if (sent < 0 && (errno == EINTR || would_block(fd, POLLOUT, deadline))) {
+      continue;
+    }
+    if (sent < 0) {
+      return false;
+    }
+    while (count > 0 && static_cast<std::size_t>(sent) >= parts->iov_len) {
+      sent -= static_cast<ssize_t>(parts->iov_len);
+      ++parts;
+      --count;
+    }
+    if (count > 0) {
+      parts->iov_base = static_cast<unsigned char*>(parts->iov_base) + sent;
+      parts->iov_len -= static_cast<std::size_t>(sent);
+    }
+  }
+  return true;
+}
+
+bool read_frame_length(const int fd,
+                       std::size_t& length,
+                       const Clock::time_point deadline = kNoDeadline) {
+  unsigned char header[4];
+  if (!read_exact(fd, header, sizeof(header), deadline)) {
+    return false;
+  }
+  length = (std::size_t{header[0]} << 24) | (std::size_t{header[1]} << 16) |
+           (std::size_t{header[2]} << 8) | std::size_t{header[3]};
+  return true;
+}
+
+bool make_address(const std::string& path, sockaddr_un& address, std::string* error) {
+  address = {};
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    if (error != nullptr) {
+      *error = "socket path is empty or longer than " +
+               std::to_string(sizeof(address.sun_path) - 1) + " bytes";
+    }
+    return false;
+  }
+  std::memcpy(address.sun_path, path.data(), path.size());
+  return true;
+}
+
+std::string system_error(const std::string& what) {
+  return what + ": " + std::strerror(errno);
+}
+
+#endif
+
+}  // namespace
+
+namespace detail {
+
+// Connection handed back from a worker: keep it for the next request, or it was closed.
+struct ReturnedConnection {
+  int fd = -1;
+  bool keep = false;
+};
+
+struct ServerState {
+  explicit ServerState(const std::size_t queue_depth) : ready(queue_depth) {}
+
+  int listen_fd = -1;
+  int wake_read = -1;
+  int wake_write = -1;
+  std::atomic<bool> stopping{false};
+
+  // Connections with a request arriving, waiting for a worker.
+  BoundedQueue<int> ready;
+  std::mutex returned_mutex;
+  std::vector<ReturnedConnection> returned;
+
+  std::array<std::unique_ptr<const InvoiceExample>, kPageFormatCount> invoices;
+  std::array<std::unique_ptr<const ClinicalReportExample>, kPageFormatCount> reports;
+
+  std::thread io_thread;
+  std::vector<std::thread> workers;
+
+  std::atomic<std::size_t> connections{0};
+  std::atomic<std::size_t> requests{0};
+  std::atomic<std::size_t> bad_requests{0};
+  std::atomic<std::size_t> failed_requests{0};
+  std::atomic<std::size_t> output_bytes{0};
+};
+
+}  // namespace detail
+
+#if !defined(_WIN32)
+
+namespace {
+
+void wake(const detail::ServerState& state) {
+  const unsigned char byte = 1;
+  // A full pipe already holds a pending wake-up.
+  [[maybe_unused]] const ssize_t written = ::write(state.wake_write, &byte, 1);
+}
+
+// Per-worker state kept for the life of the server.
+class RenderWorker {
+ public:
+  RenderWorker(detail::ServerState& state, const RenderServerOptions& options)
+      : state_(state), options_(options), context_(options.context) {
+    text_options_.font = options.fonts.regular;
+  }
+
+  void run() {
+    ScopedRenderContext scope(context_);
+    std::optional<ScopedDocumentInfo> info;
+    if (options_.document_info) {
+      info.emplace(*options_.document_info);
+    }
+    if (options_.warm_up) {
+      warm_up();
+    }
+    // Opened after the warm-up so its throwaway documents stay out of the cache.
+    std::optional<ScopedRenderCache> cache;
+    if (options_.cache != nullptr) {
+      cache.emplace(*options_.cache);
+    }
+    int fd = -1;
+    while (state_.ready.pop(fd)) {
+      const bool keep = serve(fd);
+      if (!keep) {
+        ::close(fd);
+      }
+      {
+        const std::lock_guard<std::mutex> lock(state_.returned_mutex);
+        state_.returned.push_back({keep ? fd : -1, keep});
+      }
+      wake(state_);
+    }
+  }
+
+ private:
+  void warm_up() {
+    create_text_pdf(output_, default_example_text(), text_options_);
+    request_.provider = {"Provider", "Street 1", "p@x.test"};
+    request_.client = {"Client", "Avenue 2", "c@x.test"};
+    request_.items = {{"Warm-up", 1, 1.0}};
+    state_.invoices[0]->createInvoidcw(
+        request_.provider, request_.client, request_.items, output_);
+    state_.reports[0]->create_clinical_report_pdf({"Patient", 30, "Female", "0"},
+                                                  {"Doctor", "Radiology"},
+                                                  request_.frames,
+                                                  output_);
+  }
+
+  // Serves one request; false when the connection must be closed.
+  bool serve(const int fd) {
+    // The whole request must arrive within the timeout, however the client paces it.
+    const Clock::time_point deadline = deadline_after(options_.io_timeout_ms);
+    std::size_t length = 0;
+    if (!read_frame_length(fd, length, deadline)) {
+      return false;
+    }
+    state_.requests.fetch_add(1, std::memory_order_relaxed);
+    if (length > options_.max_request_bytes) {
+      state_.bad_requests.fetch_add(1, std::memory_order_relaxed);
+      respond(fd, RenderStatus::BadRequest, "request exceeds the server's size limit");
+      return false;
+    }
+    payload_.resize(length);
+    if (!read_exact(fd, payload_.data(), length, deadline)) {
+      return false;
+    }
+
+    // Step 1: Decode and validate the request.
+    const char* error = nullptr;
+    if (!decode_request(payload_, request_, output_name_, error)) {
+      state_.bad_requests.fetch_add(1, std::memory_order_relaxed);
+      return respond(fd, RenderStatus::BadRequest, error);
+    }
+    if (!output_name_.empty()) {
+      if (options_.output_directory.empty()) {
+        state_.bad_requests.fetch_add(1, std::memory_order_relaxed);
+        return respond(fd, RenderStatus::BadRequest, "server does not write files");
+      }
+      if (!valid_output_name(output_name_)) {
+        state_.bad_requests.fetch_add(1, std::memory_order_relaxed);
+        return respond(fd, RenderStatus::BadRequest, "output name must be a plain file name");
+      }
+      output_path_ = options_.output_directory + "/" + output_name_;
+    }
+
+    // Step 2: Render into the worker's buffer or the requested file.
+    if (!render()) {
+      state_.failed_requests.fetch_add(1, std::memory_order_relaxed);
+      return respond(fd, RenderStatus::RenderFailed, "render failed");
+    }
+    if (!output_name_.empty()) {
+      return respond(fd, RenderStatus::Ok, output_path_);
+    }
+    state_.output_bytes.fetch_add(output_.size(), std::memory_order_relaxed);
+    return respond(fd, RenderStatus::Ok, output_.data(), output_.size());
+  }
+
+  bool render() {
+    const std::size_t format = static_cast<std::size_t>(request_.page_format);
+    const bool to_file = !output_name_.empty();
+    switch (request_.kind) {
+      case RenderKind::Text:
+        return to_file ? create_text_pdf(output_path_, request_.text, text_options_)
+                       : create_text_pdf(output_, request_.text, text_options_);
+      case RenderKind::Invoice: {
+        const InvoiceExample& invoice = *state_.invoices[format];
+        return to_file ? invoice.createInvoidcw(
+                             request_.provider, request_.client, request_.items, output_path_)
+                       : invoice.createInvoidcw(
+                             request_.provider, request_.client, request_.items, output_);
+      }
+      case RenderKind::Clinical: {
+        const ClinicalReportExample& report = *state_.reports[format];
+        return to_file ? report.create_clinical_report_pdf(
+                             request_.patient, request_.doctor, request_.frames, output_path_)
+                       : report.create_clinical_report_pdf(
+                             request_.patient, request_.doctor, request_.frames, output_);
+      }
+    }
+    return false;
+  }
+
+  bool respond(const int fd, const RenderStatus status, const std::string& message) {
+    return respond(fd, status, message.data(), message.size());
+  }
+
+  bool respond(const int fd, RenderStatus status, const void* body, const std::size_t size) {
+    const std::size_t payload = size + 1;
+    unsigned char header[5] = {static_cast<unsigned char>(payload >> 24),
+                               static_cast<unsigned char>(payload >> 16),
+                               static_cast<unsigned char>(payload >> 8),
+                               static_cast<unsigned char>(payload),
+                               static_cast<unsigned char>(status)};
+    iovec parts[2] = {{header, sizeof(header)}, {const_cast<void*>(body), size}};
+    // The response gets its own deadline, so render time does not count against the client.
+    return send_all(fd, parts, size > 0 ? 2 : 1, deadline_after(options_.io_timeout_ms));
+  }
+
+  detail::ServerState& state_;
+  const RenderServerOptions& options_;
+  RenderContext context_;
+  TextPdfOptions text_options_;
+  std::vector<unsigned char> payload_;
+  RenderRequest request_;
+  std::string output_name_;
+  std::string output_path_;
+  PdfBuffer output_;
+};
+
+void run_io_loop(detail::ServerState& state, const RenderServerOptions& options) {
+  std::vector<int> idle;
+  std::deque<int> pending;
+  std::vector<pollfd> polled;
+  std::vector<detail::ReturnedConnection> returned;
+  std::size_t open = 0;
+
+  while (!state.stopping.load(std::memory_order_acquire)) {
+    // Step 1: Take back connections the workers are done with.
+    {
+      const std::lock_guard<std::mutex> lock(state.returned_mutex);
+      returned.swap(state.returned);
+    }
+    for (const detail::ReturnedConnection& connection : returned) {
+      if (connection.keep) {
+        idle.push_back(connection.fd);
+      } else {
+        --open;
+      }
+    }
+    returned.clear();
+
+    // Step 2: Hand waiting requests to the workers. While any are left over the queue is
+    // full, so client sockets are not polled and further requests wait in the kernel.
+    while (!pending.empty() && state.ready.try_push(pending.front())) {
+      pending.pop_front();
+    }
+
+    // Step 3: Wait for a wake-up, a new connection or a request on an idle connection.
+    polled.clear();
+    polled.push_back({state.wake_read, POLLIN, 0});
+    const bool accepting = open < options.max_connections;
+    if (accepting) {
+      polled.push_back({state.listen_fd, POLLIN, 0});
+    }
+    if (pending.empty()) {
+      for (const int fd : idle) {
+        polled.push_back({fd, POLLIN, 0});
+      }
+    }
+    if (::poll(polled.data(), polled.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    std::size_t index = 0;
+    if (polled[index++].revents != 0) {
+      unsigned char drain[64];
+      while (::read(state.wake_read, drain, sizeof(drain)) == sizeof(drain)) {
+      }
+    }
+    if (accepting && polled[index++].revents != 0) {
+      for (int fd = -1; open < options.max_connections &&
+                        (fd = ::accept(state.listen_fd, nullptr, nullptr)) >= 0;) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        idle.push_back(fd);
+        ++open;
+        state.connections.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    if (pending.empty()) {
+      std::size_t kept = 0;
+      const std::size_t polled_idle = polled.size() - index;
+      for (std::size_t i = 0; i < idle.size(); ++i) {
+        if (i < polled_idle && polled[index + i].revents != 0) {
+          pending.push_back(idle[i]);
+        } else {
+          idle[kept++] = idle[i];
+        }
+      }
+      idle.resize(kept);
+    }
+  }
+
+  for (const int fd : idle) {
+    ::close(fd);
+  }
+  for (const int fd : pending) {
+    ::close(fd);
+  }
+}
+
+}  // namespace
+
+RenderServer::RenderServer(RenderServerOptions options) : options_(std::move(options)) {}
+
+RenderServer::~RenderServer() {
+  stop();
+}
+
+bool RenderServer::start(std::string* error) {
+  if (state_) {
+    if (error != nullptr) {
+      *error = "server is already running";
+    }
+    return false;
+  }
+
+  // Step 1: Bind the socket, replacing a stale socket file that nobody accepts on.
+  sockaddr_un address{};
+  if (!make_address(options_.socket_path, address, error)) {
+    return false;
+  }
+  auto state = std::make_unique<detail::ServerState>(options_.queue_depth);
+  struct stat existing {};
+  if (::lstat(options_.socket_path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+    const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    const bool live =
+        probe >= 0 &&
+        ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    if (probe >= 0) {
+      ::close(probe);
+    }
+    if (live) {
+      if (error != nullptr) {
+        *error = options_.socket_path + ": another server is listening";
+      }
+      return false;
+    }
+    ::unlink(options_.socket_path.c_str());
+  }
+
+  state->listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  int wake_pipe[2] = {-1, -1};
+  const auto fail = [&](const std::string& what) {
+    if (error != nullptr) {
+      *error = system_error(what);
+    }
+    for (const int fd : {state->listen_fd, wake_pipe[0], wake_pipe[1]}) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+    return false;
+  };
+  if (state->listen_fd < 0) {
+    return fail("socket");
+  }
+  fcntl(state->listen_fd, F_SETFD, FD_CLOEXEC);
+  fcntl(state->listen_fd, F_SETFL, O_NONBLOCK);
+  if (::bind(state->listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) !=
+      0) {
+    return fail(options_.socket_path);
+  }
+  if (::listen(state->listen_fd, SOMAXCONN) != 0 || ::pipe(wake_pipe) != 0) {
+    ::unlink(options_.socket_path.c_str());
+    return fail(options_.socket_path);
+  }
+  for (const int fd : wake_pipe) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+  }
+  state->wake_read = wake_pipe[0];
+  state->wake_write = wake_pipe[1];
+
+  // Step 2: One renderer per page format, shared read-only by every worker.
+  for (std::size_t format = 0; format < kPageFormatCount; ++format) {
+    state->invoices[format] =
+        std::make_unique<const InvoiceExample>(static_cast<PageFormat>(format), options_.fonts);
+    state->reports[format] = std::make_unique<const ClinicalReportExample>(
+        static_cast<PageFormat>(format),
+        options_.fonts,
+        ClinicalReportExample::ImageOptions{},
+        options_.clinical_encryption);
+  }
+
+  // Step 3: Workers warm up before the IO thread starts reading requests.
+  std::size_t worker_count = options_.workers;
+  if (worker_count == 0) {
+    worker_count = std::max(1U, std::thread::hardware_concurrency());
+  }
+  state_ = std::move(state);
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    state_->workers.emplace_back([this] { RenderWorker(*state_, options_).run(); });
+  }
+  state_->io_thread = std::thread([this] { run_io_loop(*state_, options_); });
+  return true;
+}
+
+void RenderServer::stop() {
+  if (!state_) {
+    return;
+  }
+  // Step 1: Stop the IO thread, which closes idle connections, then let the workers finish
+  // the requests already queued.
+  state_->stopping.store(true, std::memory_order_release);
+  wake(*state_);
+  state_->io_thread.join();
+  ::close(state_->listen_fd);
+  ::unlink(options_.socket_path.c_str());
+  state_->ready.close();
+  for (std::thread& worker : state_->workers) {
+    worker.join();
+  }
+
+  // Step 2: Close what the workers handed back after the IO thread stopped.
+  for (const detail::ReturnedConnection& connection : state_->returned) {
+    if (connection.keep) {
+      ::close(connection.fd);
+    }
+  }
+  ::close(state_->wake_read);
+  ::close(state_->wake_write);
+  state_.reset();
+}
+
+RenderServerStats RenderServer::stats() const {
+  RenderServerStats stats;
+  if (state_) {
+    stats.connections = state_->connections.load(std::memory_order_relaxed);
+    stats.requests = state_->requests.load(std::memory_order_relaxed);
+    stats.bad_requests = state_->bad_requests.load(std::memory_order_relaxed);
+    stats.failed_requests = state_->failed_requests.load(std::memory_order_relaxed);
+    stats.output_bytes = state_->output_bytes.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+RenderClient::~RenderClient() {
+  close();
+}
+
+bool RenderClient::connect(const std::string& socket_path, std::string* error) {
+  close();
+  sockaddr_un address{};
+  if (!make_address(socket_path, address, error)) {
+    return false;
+  }
+  fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd_ < 0 ||
+      ::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    if (error != nullptr) {
+      *error = system_error(socket_path);
+    }
+    close();
+    return false;
+  }
+  fcntl(fd_, F_SETFD, FD_CLOEXEC);
+  return true;
+}
+
+void RenderClient::close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool RenderClient::exchange(const RenderRequest& request,
+                            const std::string& output_name,
+                            PdfBuffer& body,
+                            std::string* error) {
+  const auto fail = [&](const char* what) {
+    if (error != nullptr) {
+      *error = what;
+    }
+    close();
+    return false;
+  };
+  if (fd_ < 0) {
+    return fail("not connected");
+  }
+
+  // Step 1: Send the request frame.
+  encode_request(request, output_name, frame_);
+  iovec part{frame_.data(), frame_.size()};
+  if (!send_all(fd_, &part, 1)) {
+    return fail("connection lost while sending");
+  }
+
+  // Step 2: Read the status and the body straight into `body`.
+  std::size_t length = 0;
+  unsigned char status = 0;
+  if (!read_frame_length(fd_, length) || length == 0 || !read_exact(fd_, &status, 1)) {
+    return fail("connection lost while waiting for the response");
+  }
+  body.resize(length - 1);
+  if (!read_exact(fd_, body.data(), body.size())) {
+    return fail("connection lost while reading the response");
+  }
+  last_status_ = static_cast<RenderStatus>(status);
+  if (last_status_ != RenderStatus::Ok) {
+    if (error != nullptr) {
+      error->assign(body.begin(), body.end());
+    }
+    body.clear();
+    return false;
+  }
+  return true;
+}
+
+#else
+
+RenderServer::RenderServer(RenderServerOptions options) : options_(std::move(options)) {}
+
+RenderServer::~RenderServer() = default;
+
+bool RenderServer::start(std::string* error) {
+  if (error != nullptr) {
+    *error = "Unix domain sockets are not supported on this platform";
+  }
+  return false;
+}
+
+void RenderServer::stop() {}
+
+RenderServerStats RenderServer::stats() const {
+  return {};
+}
+
+RenderClient::~RenderClient() = default;
+
+bool RenderClient::connect(const std::string&, std::string* error) {
+  if (error != nullptr) {
+    *error = "Unix domain sockets are not supported on this platform";
+  }
+  return false;
+}
+
+void RenderClient::close() {}
+
+bool RenderClient::exchange(const RenderRequest&,
+                            const std::string&,
+                            PdfBuffer&,
+                            std::string* error) {
+  if (error != nullptr) {
+    *error = "not connected";
+  }
+  return false;
+}
+
+#endif
+
+bool RenderClient::render(const RenderRequest& request, PdfBuffer& output, std::string* error) {
+  return exchange(request, std::string(), output, error);
+}
+
+bool RenderClient::render_to_file(const RenderRequest& request,
+                                  const std::string& output_name,
+                                  std::string& written_path,
+                                  std::string* error) {
+  PdfBuffer body;
+  if (!exchange(request, output_name, body, error)) {
+    return false;
+  }
+  written_path.assign(body.begin(), body.end());
+  return true;
+}
+
+}  // namespace libharu_examples
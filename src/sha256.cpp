@@ -0,0 +1,164 @@
+/*
+High-level overview
+-------------------
+SHA-256 for content addressing: render cache keys and reproducible invoice numbers are
+digests of the canonicalized inputs, so the same inputs map to the same key in every process
+and a disk cache survives restarts.
+
+1) `update` buffers input into 64-byte blocks and compresses each full block.
+2) `finish` appends the 0x80 marker, zero padding and the 64-bit bit length, then writes the
+   eight state words big-endian.
+3) `FieldHash` frames each field (8-byte big-endian integers, length-prefixed bytes) so that
+   different field lists never produce the same byte stream.
+
+libHaru logic addressed in this file
+------------------------------------
+- None; libHaru only sees the documents these keys describe.
+*/
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace libharu_examples {
+namespace detail {
+namespace {
+
+constexpr std::array<std::uint32_t, 64> kRoundConstants = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+constexpr std::uint32_t rotate_right(const std::uint32_t value, const int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+}  // namespace
+
+void Sha256::reset() {
+  state_ = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  buffered_ = 0;
+  length_ = 0;
+}
+
+void Sha256::update(const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  length_ += size;
+  if (buffered_ > 0) {
+    const std::size_t take = std::min(size, buffer_.size() - buffered_);
+    std::memcpy(buffer_.data() + buffered_, bytes, take);
+    buffered_ += take;
+    bytes += take;
+    size -= take;
+    if (buffered_ < buffer_.size()) {
+      return;
+    }
+    compress(buffer_.data());
+    buffered_ = 0;
+  }
+  for (; size >= buffer_.size(); bytes += buffer_.size(), size -= buffer_.size()) {
+    compress(bytes);
+  }
+  std::memcpy(buffer_.data(), bytes, size);
+  buffered_ = size;
+}
+
+Sha256Digest Sha256::finish() {
+  const std::uint64_t bits = length_ * 8;
+  const unsigned char marker = 0x80;
+  update(&marker, 1);
+  const unsigned char zero = 0;
+  while (buffered_ != 56) {
+    update(&zero, 1);
+  }
+  unsigned char length[8];
+  for (int i = 0; i < 8; ++i) {
+    length[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+  }
+  update(length, sizeof(length));
+
+  Sha256Digest digest{};
+  for (std::size_t i = 0; i < state_.size(); ++i) {
+    for (std::size_t b = 0; b < 4; ++b) {
+      digest[4 * i + b] = static_cast<unsigned char>(state_[i] >> (24 - 8 * b));
+    }
+  }
+  return digest;
+}
+
+void Sha256::compress(const unsigned char* block) {
+  std::array<std::uint32_t, 64> w{};
+  for (std::size_t i = 0; i < 16; ++i) {
+    w[i] = (std::uint32_t{block[4 * i]} << 24) | (std::uint32_t{block[4 * i + 1]} << 16) |
+           (std::uint32_t{block[4 * i + 2]} << 8) | std::uint32_t{block[4 * i + 3]};
+  }
+  for (std::size_t i = 16; i < 64; ++i) {
+    const std::uint32_t s0 =
+        rotate_right(w[i - 15], 7) ^ rotate_right(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const std::uint32_t s1 =
+        rotate_right(w[i - 2], 17) ^ rotate_right(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  std::uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+  std::uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+  for (std::size_t i = 0; i < 64; ++i) {
+    const std::uint32_t s1 = rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25);
+    const std::uint32_t choose = (e & f) ^ (~e & g);
+    const std::uint32_t t1 = h + s1 + choose + kRoundConstants[i] + w[i];
+    const std::uint32_t s0 = rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22);
+    const std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+    const std::uint32_t t2 = s0 + majority;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state_[0] += a;
+  state_[1] += b;
+  state_[2] += c;
+  state_[3] += d;
+  state_[4] += e;
+  state_[5] += f;
+  state_[6] += g;
+  state_[7] += h;
+}
+
+void FieldHash::add(const std::int64_t value) {
+  unsigned char bytes[8];
+  for (int i = 0; i < 8; ++i) {
+    bytes[i] = static_cast<unsigned char>(static_cast<std::uint64_t>(value) >> (56 - 8 * i));
+  }
+  sha_.update(bytes, sizeof(bytes));
+}
+
+void FieldHash::add_bytes(const void* data, const std::size_t size) {
+  add(static_cast<std::int64_t>(size));
+  sha_.update(data, size);
+}
+
+std::string to_hex(const Sha256Digest& digest, const std::size_t bytes) {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(2 * bytes);
+  for (std::size_t i = 0; i < bytes && i < digest.size(); ++i) {
+    hex.push_back(kDigits[digest[i] >> 4]);
+    hex.push_back(kDigits[digest[i] & 0x0F]);
+  }
+  return hex;
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
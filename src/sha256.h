@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace libharu_examples {
+namespace detail {
+
+using Sha256Digest = std::array<unsigned char, 32>;
+
+// Streaming SHA-256 (FIPS 180-4). Used to key cached documents and to derive reproducible
+// invoice numbers from invoice contents; not a security boundary.
+class Sha256 {
+ public:
+  Sha256() { reset(); }
+
+  void reset();
+  void update(const void* data, std::size_t size);
+  void update(const std::string_view text) { update(text.data(), text.size()); }
+  // Pads and returns the digest; call `reset` before hashing more data.
+  Sha256Digest finish();
+
+ private:
+  void compress(const unsigned char* block);
+
+  std::array<std::uint32_t, 8> state_{};
+  std::array<unsigned char, 64> buffer_{};
+  std::size_t buffered_ = 0;
+  std::uint64_t length_ = 0;
+};
+
+// SHA-256 over typed fields. Strings and byte runs are length-prefixed and integers have a
+// fixed width, so field boundaries are part of the digest: ("ab", "c") and ("a", "bc") differ.
+class FieldHash {
+ public:
+  void add(std::string_view text) { add_bytes(text.data(), text.size()); }
+  void add(std::int64_t value);
+  void add_bytes(const void* data, std::size_t size);
+  Sha256Digest finish() { return sha_.finish(); }
+
+ private:
+  Sha256 sha_;
+};
+
+// Lowercase hex of the first `bytes` digest bytes.
+std::string to_hex(const Sha256Digest& digest, std::size_t bytes = 32);
+
+}  // namespace detail
+}  // namespace libharu_examples
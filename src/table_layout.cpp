@@ -0,0 +1,208 @@
+/*
+High-level overview
+-------------------
+Measured table layout for tables known up front (the whole-vector invoice). The fixed-grid
+tables elsewhere place every column at a compile-time x and cut long text with an ellipsis;
+this engine sizes columns from the real glyph widths of their cells and wraps the one
+flexible column instead.
+
+1) `add_row` appends each cell's bytes to one arena and measures it with its column's face:
+   the whole cell for left/right columns, the integer and fraction parts separately for
+   decimal columns (their sum is the cell width, so nothing is measured twice). Wrapping
+   cells are not measured here; `fit` measures them while breaking them.
+2) `fit` makes every fixed column as wide as its widest cell (or its minimum) and gives the
+   rest to the wrapping column, then walks the rows once: each wrapping cell is broken with
+   `break_position` (whose first probe is the whole remaining text, so short cells cost one
+   measurement) and the row height follows from its line count.
+3) `draw_row` positions each stored string from the stored widths.
+
+libHaru logic addressed in this file
+------------------------------------
+- Text widths come from the precomputed AFM tables or the shared TrueType tables, which
+  match `HPDF_Font_TextWidth`, so stored widths are exactly what libHaru renders.
+- Widths add up per glyph (libHaru applies no kerning to `HPDF_Page_TextOut`), which is what
+  lets a decimal cell be measured as two parts.
+*/
+#include "table_layout.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace libharu_examples {
+namespace detail {
+
+TableLayout::TableLayout(std::vector<TableColumn> columns, const float column_gap)
+    : columns_(std::move(columns)),
+      column_gap_(column_gap),
+      wrap_column_(columns_.size()),
+      max_widths_(columns_.size(), 0.0F),
+      max_integers_(columns_.size(), 0.0F),
+      max_fractions_(columns_.size(), 0.0F),
+      lefts_(columns_.size(), 0.0F),
+      widths_(columns_.size(), 0.0F) {
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    if (columns_[c].wraps && wrap_column_ == columns_.size()) {
+      wrap_column_ = c;
+    }
+  }
+}
+
+void TableLayout::reserve(const std::size_t rows, const std::size_t text_bytes) {
+  cells_.reserve(rows * columns_.size());
+  text_.reserve(text_bytes);
+}
+
+bool TableLayout::append_text(const std::string_view text, std::uint32_t& offset) {
+  if (text.size() > std::numeric_limits<std::uint32_t>::max() - text_.size()) {
+    return false;
+  }
+  offset = static_cast<std::uint32_t>(text_.size());
+  text_.append(text);
+  return true;
+}
+
+bool TableLayout::add_row(const std::string_view* cells) {
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    const TableColumn& column = columns_[c];
+    const std::string_view value = cells[c];
+    Cell cell{0, static_cast<std::uint32_t>(value.size()), 0.0F, 0.0F};
+    if (!append_text(value, cell.offset)) {
+      return false;
+    }
+
+    if (c == wrap_column_) {
+      // Measured while wrapping, in `fit`.
+    } else if (column.align == CellAlign::Decimal) {
+      const std::size_t point = std::min(value.find('.'), value.size());
+      cell.integer_width = column.face->width(value.substr(0, point), column.font_size);
+      const float fraction = column.face->width(value.substr(point), column.font_size);
+      cell.width = cell.integer_width + fraction;
+      max_integers_[c] = std::max(max_integers_[c], cell.integer_width);
+      max_fractions_[c] = std::max(max_fractions_[c], fraction);
+    } else {
+      cell.width = column.face->width(value, column.font_size);
+    }
+    max_widths_[c] = std::max(max_widths_[c], cell.width);
+    cells_.push_back(cell);
+  }
+  return true;
+}
+
+bool TableLayout::fit(const float left,
+                      const float right,
+                      const float min_wrap_width,
+                      const float row_height,
+                      const float line_height,
+                      const std::size_t max_lines) {
+  // Step 1: Fixed columns take their widest cell; the wrapping column gets what is left.
+  float fixed = column_gap_ * static_cast<float>(columns_.size() - 1);
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    if (c == wrap_column_) {
+      continue;
+    }
+    const float content = (columns_[c].align == CellAlign::Decimal)
+                              ? max_integers_[c] + max_fractions_[c]
+                              : max_widths_[c];
+    widths_[c] = std::max(content, columns_[c].min_width);
+    fixed += widths_[c];
+  }
+  if (wrap_column_ < columns_.size()) {
+    widths_[wrap_column_] = right - left - fixed;
+    if (widths_[wrap_column_] < std::max(min_wrap_width, columns_[wrap_column_].min_width)) {
+      return false;
+    }
+  } else if (right - left < fixed) {
+    return false;
+  }
+
+  float x = left;
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    lefts_[c] = x;
+    x += widths_[c] + column_gap_;
+  }
+
+  // Step 2: One pass over the rows wraps the flexible cells and sets each row's height.
+  line_height_ = line_height;
+  const std::size_t rows = row_count();
+  row_heights_.assign(rows, row_height);
+  lines_.clear();
+  first_lines_.assign(rows + 1, 0);
+  for (std::size_t row = 0; row < rows; ++row) {
+    first_lines_[row] = static_cast<std::uint32_t>(lines_.size());
+    if (wrap_column_ < columns_.size()) {
+      wrap_row(row, widths_[wrap_column_], std::max<std::size_t>(max_lines, 1));
+      const std::size_t extra = lines_.size() - first_lines_[row] - 1;
+      row_heights_[row] += line_height * static_cast<float>(extra);
+    }
+  }
+  first_lines_[rows] = static_cast<std::uint32_t>(lines_.size());
+  return true;
+}
+
+void TableLayout::wrap_row(const std::size_t row, const float width, const std::size_t max_lines) {
+  const TableColumn& column = columns_[wrap_column_];
+  const Cell& cell = cells_[row * columns_.size() + wrap_column_];
+  const std::string_view value = text(cell.offset, cell.size);
+  if (value.empty()) {
+    lines_.push_back({cell.offset, 0});
+    return;
+  }
+
+  std::size_t consumed = 0;
+  for (std::size_t line = 1; consumed < value.size(); ++line) {
+    const std::string_view rest = value.substr(consumed);
+    const std::size_t fit =
+        std::max<std::size_t>(column.face->break_position(rest, column.font_size, width), 1U);
+    if (line == max_lines && fit < rest.size()) {
+      // Out of lines: the rest of the cell is cut to one line ending in "...".
+      column.face->fit_with_ellipsis(rest, column.font_size, width, ellipsis_);
+      std::uint32_t offset = 0;
+      if (append_text(ellipsis_, offset)) {
+        lines_.push_back({offset, static_cast<std::uint32_t>(ellipsis_.size())});
+      }
+      return;
+    }
+    lines_.push_back({static_cast<std::uint32_t>(cell.offset + consumed),
+                      static_cast<std::uint32_t>(fit)});
+    consumed += fit;
+  }
+}
+
+void TableLayout::draw_row(PageWriter& writer, const std::size_t row, const float y) const {
+  const Cell* cells = &cells_[row * columns_.size()];
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    const TableColumn& column = columns_[c];
+    const Cell& cell = cells[c];
+    if (c == wrap_column_) {
+      float line_y = y;
+      for (std::uint32_t i = first_lines_[row]; i < first_lines_[row + 1]; ++i) {
+        if (lines_[i].size > 0) {
+          writer.text(*column.face,
+                      column.font_size,
+                      lefts_[c],
+                      line_y,
+                      text(lines_[i].offset, lines_[i].size));
+        }
+        line_y -= line_height_;
+      }
+      continue;
+    }
+
+    float x = lefts_[c];
+    switch (column.align) {
+      case CellAlign::Left:
+        break;
+      case CellAlign::Right:
+        x = column_right(c) - cell.width;
+        break;
+      case CellAlign::Decimal:
+        x = column_right(c) - max_fractions_[c] - cell.integer_width;
+        break;
+    }
+    writer.text(*column.face, column.font_size, x, y, text(cell.offset, cell.size));
+  }
+}
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "font_face.h"
+#include "page_writer.h"
+
+namespace libharu_examples {
+namespace detail {
+
+enum class CellAlign {
+  Left,
+  Right,
+  // Cells line up on their first '.', or end on it when they have none; the widest integer
+  // and fraction parts set the column width.
+  Decimal,
+};
+
+struct TableColumn {
+  const FontFace* face = nullptr;
+  float font_size = 11.0F;
+  CellAlign align = CellAlign::Left;
+  // A column is never narrower than this (typically its measured heading).
+  float min_width = 0.0F;
+  // The one wrapping column takes the width the others leave and breaks its cells into lines.
+  bool wraps = false;
+};
+
+// Column widths, wrapped lines and row heights of a table whose rows are all known before the
+// first is drawn.
+//
+// - `add_row` copies each cell into one text arena and measures it once; the widest cell of
+//   every column is tracked on the way.
+// - `fit` sizes the columns from those widths, then wraps the wrapping column and sums row
+//   heights in a single pass over the rows.
+// - `draw_row` only places stored text at stored offsets; nothing is measured again.
+//
+// Offsets are 32-bit, so the cell text of one table is limited to 4 GiB.
+class TableLayout {
+ public:
+  TableLayout(std::vector<TableColumn> columns, float column_gap);
+
+  void reserve(std::size_t rows, std::size_t text_bytes);
+  // `cells` holds one string per column. False if the text arena is full.
+  bool add_row(const std::string_view* cells);
+
+  // Lays the columns out between `left` and `right`. Rows are `row_height` tall with one line
+  // and grow by `line_height` per extra line of the wrapping column; a cell that needs more
+  // than `max_lines` lines is cut with an ellipsis on its last one. False if the other
+  // columns leave the wrapping column less than `min_wrap_width`.
+  bool fit(float left,
+           float right,
+           float min_wrap_width,
+           float row_height,
+           float line_height,
+           std::size_t max_lines);
+
+  std::size_t row_count() const { return cells_.size() / columns_.size(); }
+  float row_height(std::size_t row) const { return row_heights_[row]; }
+  float column_left(std::size_t column) const { return lefts_[column]; }
+  float column_right(std::size_t column) const { return lefts_[column] + widths_[column]; }
+
+  // Draws `row` with its first line on baseline `y`, in the writer's current fill color.
+  void draw_row(PageWriter& writer, std::size_t row, float y) const;
+
+ private:
+  struct Cell {
+    std::uint32_t offset;
+    std::uint32_t size;
+    float width;
+    // Decimal columns: width of the part before the '.'.
+    float integer_width;
+  };
+
+  struct Line {
+    std::uint32_t offset;
+    std::uint32_t size;
+  };
+
+  std::string_view text(std::uint32_t offset, std::uint32_t size) const {
+    return std::string_view(text_).substr(offset, size);
+  }
+  bool append_text(std::string_view text, std::uint32_t& offset);
+  void wrap_row(std::size_t row, float width, std::size_t max_lines);
+
+  std::vector<TableColumn> columns_;
+  float column_gap_;
+  std::size_t wrap_column_;
+  float line_height_ = 0.0F;
+
+  // Per column: widest cell, and widest integer and fraction parts for decimal columns.
+  std::vector<float> max_widths_;
+  std::vector<float> max_integers_;
+  std::vector<float> max_fractions_;
+  std::vector<float> lefts_;
+  std::vector<float> widths_;
+
+  // Row-major, `columns_.size()` per row.
+  std::vector<Cell> cells_;
+  // Lines of the wrapping column; row r owns [first_lines_[r], first_lines_[r + 1]).
+  std::vector<Line> lines_;
+  std::vector<std::uint32_t> first_lines_;
+  std::vector<float> row_heights_;
+  std::string text_;
+  std::string ellipsis_;
+};
+
+}  // namespace detail
+}  // namespace libharu_examples
@@ -0,0 +1,135 @@
+/*
+High-level overview
+-------------------
+Text measurement without a libHaru round trip. `HPDF_Font_TextWidth` needs a live document
+and font handle and walks the encoder per call; layout code (wrapping, right-aligning,
+truncating) needs widths for every cell of every row, so the widths are tabulated here.
+
+1) Per-font 256-entry width tables are built at compile time from the base-14 AFM advance
+   widths, mapped through StandardEncoding (libHaru's default for base-14 fonts); they live in
+   `src/font_width_tables.h` so page layouts can measure fixed labels in `static_assert`s.
+2) `width_units` sums table lookups with four independent accumulators: the loop is a plain
+   gather + add without a carried dependency, which compilers unroll and vectorise.
+3) `fit`/`break_position` first try the whole string with that kernel and only walk byte by
+   byte when it does not fit.
+
+libHaru logic addressed in this file
+------------------------------------
+- Widths are in 1/1000 text-space units; the rendered width is `units * font_size / 1000`.
+- Codes StandardEncoding leaves undefined (controls, most of 0x80-0xA0) have zero width.
+- Helvetica-Oblique shares Helvetica's advance widths.
+*/
+#include "libharu_examples/text_metrics.h"
+
+#include "font_width_tables.h"
+
+namespace libharu_examples {
+namespace {
+
+using detail::kHelveticaBoldWidths;
+using detail::kHelveticaWidths;
+using detail::WidthTable;
+
+std::uint32_t sum_widths(const WidthTable& table,
+                         const unsigned char* bytes,
+                         const std::size_t size) {
+  std::uint32_t a0 = 0;
+  std::uint32_t a1 = 0;
+  std::uint32_t a2 = 0;
+  std::uint32_t a3 = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    a0 += table[bytes[i]];
+    a1 += table[bytes[i + 1]];
+    a2 += table[bytes[i + 2]];
+    a3 += table[bytes[i + 3]];
+  }
+  for (; i < size; ++i) {
+    a0 += table[bytes[i]];
+  }
+  return a0 + a1 + a2 + a3;
+}
+
+const unsigned char* as_bytes(const std::string_view text) {
+  return reinterpret_cast<const unsigned char*>(text.data());
+}
+
+// Width budget in table units; strings whose unit width is <= this fit. The small slack
+// keeps a width obtained from `width()` (a float) fitting its own string.
+double unit_limit(const float font_size, const float max_width) {
+  return font_size > 0.0F ? static_cast<double>(max_width) * 1000.0 / font_size + 0.01 : 0.0;
+}
+
+}  // namespace
+
+const FontMetrics& FontMetrics::get(const StandardFont font) {
+  static const FontMetrics helvetica(kHelveticaWidths);
+  static const FontMetrics helvetica_bold(kHelveticaBoldWidths);
+  return font == StandardFont::HelveticaBold ? helvetica_bold : helvetica;
+}
+
+std::uint32_t FontMetrics::width_units(const std::string_view text) const {
+  return sum_widths(widths_, as_bytes(text), text.size());
+}
+
+float FontMetrics::width(const std::string_view text, const float font_size) const {
+  return static_cast<float>(width_units(text)) * font_size / 1000.0F;
+}
+
+std::size_t FontMetrics::fit(const std::string_view text,
+                             const float font_size,
+                             const float max_width) const {
+  const double limit = unit_limit(font_size, max_width);
+  if (width_units(text) <= limit) {
+    return text.size();
+  }
+
+  const unsigned char* bytes = as_bytes(text);
+  std::uint32_t units = 0;
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    units += widths_[bytes[i]];
+    if (units > limit) {
+      return i;
+    }
+  }
+  return text.size();
+}
+
+std::size_t FontMetrics::break_position(const std::string_view text,
+                                        const float font_size,
+                                        const float max_width) const {
+  const std::size_t fitted = fit(text, font_size, max_width);
+  if (fitted == text.size()) {
+    return fitted;
+  }
+  // A space that does not fit still ends the row; it renders as trailing blank.
+  if (text[fitted] == ' ') {
+    return fitted + 1;
+  }
+  for (std::size_t i = fitted; i > 0; --i) {
+    if (text[i - 1] == ' ') {
+      return i;
+    }
+  }
+  return fitted;
+}
+
+void FontMetrics::fit_with_ellipsis(const std::string_view text,
+                                    const float font_size,
+                                    const float max_width,
+                                    std::string& out,
+                                    const std::string_view ellipsis) const {
+  if (width_units(text) <= unit_limit(font_size, max_width)) {
+    out.assign(text.data(), text.size());
+    return;
+  }
+
+  std::size_t length = fit(text, font_size, max_width - width(ellipsis, font_size));
+  while (length > 0 && text[length - 1] == ' ') {
+    --length;
+  }
+  out.assign(text.data(), length);
+  out.append(ellipsis.data(), ellipsis.size());
+}
+
+}  // namespace libharu_examples
@@ -0,0 +1,395 @@
+/*
+High-level overview
+-------------------
+Process-wide TrueType fonts. A font file is read once, the tables measurement needs are
+parsed once, and every document on every thread borrows the same immutable instance.
+
+1) `load` looks the path up in a mutex-guarded cache; a miss reads the file and parses it
+   while holding the lock, so concurrent first uses of one font parse it once.
+2) `parse` walks the table directory and keeps only what layout needs: per-glyph advance
+   widths (`head`, `hhea`, `hmtx`, `maxp`) and the Unicode cmap (format 12, else format 4).
+   BMP code points resolve through a flat 64K table, the rest through sorted ranges.
+   The file's SHA-256 identifies the font in render cache keys.
+3) Measuring decodes UTF-8 on the fly and sums per-glyph widths; fitting stops on code-point
+   boundaries only.
+
+libHaru logic addressed in this file
+------------------------------------
+- `HPDF_LoadTTFontFromMemory` parses the font into a font definition owned by the `HPDF_Doc`
+  object. With `embedding` on, saving writes only the glyphs the document's text used into
+  its `FontFile2` stream, not the whole font.
+- CID font widths are `advance * 1000 / unitsPerEm` with integer division; the same rounding
+  is applied here so measured and rendered widths agree.
+- libHaru reads TrueType outlines only; CFF-based OpenType fonts (`OTTO`) and collections
+  (`ttcf`) are rejected up front instead of failing inside a document.
+*/
+#include "libharu_examples/truetype_font.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+#include "sha256.h"
+
+namespace libharu_examples {
+namespace {
+
+constexpr std::uint32_t kTrueTypeVersion = 0x00010000U;
+constexpr std::uint32_t kAppleTrueType = 0x74727565U;  // 'true'
+constexpr std::uint32_t kOpenTypeCff = 0x4F54544FU;    // 'OTTO'
+constexpr std::uint32_t kCollection = 0x74746366U;     // 'ttcf'
+constexpr char32_t kReplacement = 0xFFFD;
+constexpr std::size_t kBmpSize = 0x10000;
+
+// Big-endian reads; callers check bounds first.
+std::uint16_t u16(const unsigned char* p) {
+  return static_cast<std::uint16_t>((p[0] << 8U) | p[1]);
+}
+
+std::uint32_t u32(const unsigned char* p) {
+  return (std::uint32_t{p[0]} << 24U) | (std::uint32_t{p[1]} << 16U) |
+         (std::uint32_t{p[2]} << 8U) | p[3];
+}
+
+struct Table {
+  const unsigned char* data = nullptr;
+  std::size_t size = 0;
+};
+
+Table find_table(const std::vector<unsigned char>& font, const char* tag) {
+  const std::size_t count = u16(font.data() + 4);
+  for (std::size_t i = 0; i < count; ++i) {
+    const unsigned char* record = font.data() + 12 + 16 * i;
+    if (std::equal(tag, tag + 4, record)) {
+      const std::size_t offset = u32(record + 8);
+      const std::size_t length = u32(record + 12);
+      if (offset > font.size() || length > font.size() - offset) {
+        return {};
+      }
+      return {font.data() + offset, length};
+    }
+  }
+  return {};
+}
+
+// Decodes the code point at `p`, returning its byte length. Malformed sequences decode as
+// U+FFFD one byte at a time, so a measurement always advances.
+std::size_t decode_utf8(const unsigned char* p, const std::size_t remaining, char32_t& out) {
+  const unsigned char lead = p[0];
+  if (lead < 0x80U) {
+    out = lead;
+    return 1;
+  }
+  std::size_t length = 0;
+  char32_t code = 0;
+  if (lead >= 0xC2U && lead <= 0xDFU) {
+    length = 2;
+    code = lead & 0x1FU;
+  } else if (lead >= 0xE0U && lead <= 0xEFU) {
+    length = 3;
+    code = lead & 0x0FU;
+  } else if (lead >= 0xF0U && lead <= 0xF4U) {
+    length = 4;
+    code = lead & 0x07U;
+  }
+  if (length == 0 || length > remaining) {
+    out = kReplacement;
+    return 1;
+  }
+  for (std::size_t i = 1; i < length; ++i) {
+    if ((p[i] & 0xC0U) != 0x80U) {
+      out = kReplacement;
+      return 1;
+    }
+    code = (code << 6U) | (p[i] & 0x3FU);
+  }
+  const bool overlong = (length == 3 && code < 0x800U) || (length == 4 && code < 0x10000U);
+  out = (overlong || code > 0x10FFFFU) ? kReplacement : code;
+  return length;
+}
+
+const unsigned char* as_bytes(const std::string_view text) {
+  return reinterpret_cast<const unsigned char*>(text.data());
+}
+
+// Same budget as FontMetrics: unit widths up to this fit.
+double unit_limit(const float font_size, const float max_width) {
+  return font_size > 0.0F ? static_cast<double>(max_width) * 1000.0 / font_size + 0.01 : 0.0;
+}
+
+bool fail(std::string* error, const std::string& path, const char* reason) {
+  if (error != nullptr) {
+    *error = path + ": " + reason;
+  }
+  return false;
+}
+
+struct FontCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<const TrueTypeFont>> fonts;
+};
+
+FontCache& font_cache() {
+  static FontCache cache;
+  return cache;
+}
+
+}  // namespace
+
+std::shared_ptr<const TrueTypeFont> TrueTypeFont::load(const std::string& path,
+                                                       std::string* error) {
+  FontCache& cache = font_cache();
+  const std::lock_guard<std::mutex> lock(cache.mutex);
+  const auto found = cache.fonts.find(path);
+  if (found != cache.fonts.end()) {
+    return found->second;
+  }
+
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    fail(error, path, "cannot open file");
+    return nullptr;
+  }
+  std::shared_ptr<TrueTypeFont> font(new TrueTypeFont());
+  font->path_ = path;
+  font->data_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  if (input.bad() || !font->parse(error)) {
+    if (input.bad()) {
+      fail(error, path, "read error");
+    }
+    return nullptr;
+  }
+  detail::Sha256 hash;
+  hash.update(font->data_.data(), font->data_.size());
+  font->digest_ = detail::to_hex(hash.finish());
+  cache.fonts.emplace(path, font);
+  return font;
+}
+
+bool TrueTypeFont::parse(std::string* error) {
+  // Step 2a: Offset table and table directory.
+  if (data_.size() < 12) {
+    return fail(error, path_, "not a TrueType font");
+  }
+  const std::uint32_t version = u32(data_.data());
+  if (version == kOpenTypeCff) {
+    return fail(error, path_, "CFF-based OpenType fonts are not supported");
+  }
+  if (version == kCollection) {
+    return fail(error, path_, "font collections are not supported");
+  }
+  if ((version != kTrueTypeVersion && version != kAppleTrueType) ||
+      data_.size() < 12 + 16 * std::size_t{u16(data_.data() + 4)}) {
+    return fail(error, path_, "not a TrueType font");
+  }
+
+  // Step 2b: Glyph count, units per em and the advance widths.
+  const Table head = find_table(data_, "head");
+  const Table hhea = find_table(data_, "hhea");
+  const Table maxp = find_table(data_, "maxp");
+  const Table hmtx = find_table(data_, "hmtx");
+  if (head.size < 54 || hhea.size < 36 || maxp.size < 6 || hmtx.data == nullptr) {
+    return fail(error, path_, "missing or truncated head, hhea, maxp or hmtx table");
+  }
+  const std::uint32_t units_per_em = u16(head.data + 18);
+  const std::size_t glyphs = u16(maxp.data + 4);
+  const std::size_t metrics = u16(hhea.data + 34);
+  if (units_per_em == 0 || glyphs == 0 || metrics == 0 || metrics > glyphs ||
+      hmtx.size < 4 * metrics) {
+    return fail(error, path_, "inconsistent glyph metrics");
+  }
+  glyph_units_.resize(glyphs);
+  for (std::size_t glyph = 0; glyph < glyphs; ++glyph) {
+    // Glyphs past the last long metric share its advance.
+    const std::uint32_t advance = u16(hmtx.data + 4 * std::min(glyph, metrics - 1));
+    glyph_units_[glyph] = static_cast<std::uint16_t>(
+        std::min<std::uint32_t>(advance * 1000U / units_per_em, 0xFFFFU));
+  }
+
+  // Step 2c: The best Unicode cmap subtable: full repertoire (format 12) over BMP (format 4).
+  const Table cmap = find_table(data_, "cmap");
+  if (cmap.size < 4) {
+    return fail(error, path_, "no cmap table");
+  }
+  const std::size_t subtables = u16(cmap.data + 2);
+  if (cmap.size < 4 + 8 * subtables) {
+    return fail(error, path_, "truncated cmap table");
+  }
+  const unsigned char* best = nullptr;
+  std::size_t best_size = 0;
+  int best_score = 0;
+  for (std::size_t i = 0; i < subtables; ++i) {
+    const unsigned char* record = cmap.data + 4 + 8 * i;
+    const std::uint16_t platform = u16(record);
+    const std::uint16_t encoding = u16(record + 2);
+    const std::size_t offset = u32(record + 4);
+    if (offset + 4 > cmap.size) {
+      continue;
+    }
+    const std::uint16_t format = u16(cmap.data + offset);
+    const bool unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+    const int score = !unicode ? 0 : format == 12 ? 2 : format == 4 ? 1 : 0;
+    if (score > best_score) {
+      best = cmap.data + offset;
+      best_size = cmap.size - offset;
+      best_score = score;
+    }
+  }
+  if (best == nullptr) {
+    return fail(error, path_, "no Unicode cmap (format 4 or 12)");
+  }
+
+  bmp_glyphs_.assign(kBmpSize, 0);
+  const auto glyph_or_notdef = [glyphs](const std::uint32_t glyph) {
+    return static_cast<std::uint16_t>(glyph < glyphs ? glyph : 0);
+  };
+  if (best_score == 2) {
+    if (best_size < 16 || (best_size - 16) / 12 < u32(best + 12)) {
+      return fail(error, path_, "truncated cmap format 12");
+    }
+    const std::size_t groups = u32(best + 12);
+    for (std::size_t i = 0; i < groups; ++i) {
+      const unsigned char* group = best + 16 + 12 * i;
+      const char32_t first = u32(group);
+      const char32_t last = std::min<char32_t>(u32(group + 4), 0x10FFFFU);
+      const std::uint32_t first_glyph = u32(group + 8);
+      if (first > last) {
+        continue;
+      }
+      for (char32_t code = first; code <= last && code < kBmpSize; ++code) {
+        bmp_glyphs_[code] = glyph_or_notdef(first_glyph + (code - first));
+      }
+      if (last >= kBmpSize) {
+        const char32_t start = std::max<char32_t>(first, kBmpSize);
+        ranges_.push_back({start, last, first_glyph + (start - first)});
+      }
+    }
+    std::sort(ranges_.begin(), ranges_.end(), [](const Range& a, const Range& b) {
+      return a.first < b.first;
+    });
+  } else {
+    const std::size_t segments = best_size >= 14 ? u16(best + 6) / 2U : 0;
+    if (segments == 0 || best_size < 16 + 8 * segments) {
+      return fail(error, path_, "truncated cmap format 4");
+    }
+    const unsigned char* ends = best + 14;
+    const unsigned char* starts = ends + 2 * segments + 2;
+    const unsigned char* deltas = starts + 2 * segments;
+    const unsigned char* range_offsets = deltas + 2 * segments;
+    const std::size_t table_size = std::min<std::size_t>(best_size, u16(best + 2));
+    const std::size_t range_offsets_at = static_cast<std::size_t>(range_offsets - best);
+    for (std::size_t i = 0; i < segments; ++i) {
+      const std::uint32_t first = u16(starts + 2 * i);
+      const std::uint32_t last = u16(ends + 2 * i);
+      const std::uint16_t delta = u16(deltas + 2 * i);
+      const std::uint16_t range_offset = u16(range_offsets + 2 * i);
+      for (std::uint32_t code = first; code <= last && code != 0xFFFFU; ++code) {
+        std::uint32_t glyph = 0;
+        if (range_offset == 0) {
+          glyph = (code + delta) & 0xFFFFU;
+        } else {
+          // idRangeOffset counts bytes from its own slot into glyphIdArray.
+          const std::size_t slot = range_offsets_at + 2 * i + range_offset + 2 * (code - first);
+          if (slot + 2 <= table_size) {
+            glyph = u16(best + slot);
+            glyph = glyph == 0 ? 0 : (glyph + delta) & 0xFFFFU;
+          }
+        }
+        bmp_glyphs_[code] = glyph_or_notdef(glyph);
+      }
+    }
+  }
+  return true;
+}
+
+std::uint16_t TrueTypeFont::glyph_index(const char32_t code_point) const {
+  if (code_point < kBmpSize) {
+    return bmp_glyphs_[code_point];
+  }
+  auto range = std::upper_bound(
+      ranges_.begin(), ranges_.end(), code_point, [](const char32_t code, const Range& r) {
+        return code < r.first;
+      });
+  if (range == ranges_.begin() || code_point > (--range)->last) {
+    return 0;
+  }
+  const std::uint32_t glyph = range->first_glyph + (code_point - range->first);
+  return static_cast<std::uint16_t>(glyph < glyph_units_.size() ? glyph : 0);
+}
+
+std::uint32_t TrueTypeFont::width_units(const std::string_view text) const {
+  const unsigned char* bytes = as_bytes(text);
+  std::uint32_t units = 0;
+  std::size_t i = 0;
+  while (i < text.size()) {
+    char32_t code = 0;
+    i += decode_utf8(bytes + i, text.size() - i, code);
+    units += glyph_width(code);
+  }
+  return units;
+}
+
+float TrueTypeFont::width(const std::string_view text, const float font_size) const {
+  return static_cast<float>(width_units(text)) * font_size / 1000.0F;
+}
+
+std::size_t TrueTypeFont::fit(const std::string_view text,
+                              const float font_size,
+                              const float max_width) const {
+  const double limit = unit_limit(font_size, max_width);
+  const unsigned char* bytes = as_bytes(text);
+  std::uint32_t units = 0;
+  std::size_t i = 0;
+  while (i < text.size()) {
+    char32_t code = 0;
+    const std::size_t length = decode_utf8(bytes + i, text.size() - i, code);
+    units += glyph_width(code);
+    if (units > limit) {
+      return i;
+    }
+    i += length;
+  }
+  return text.size();
+}
+
+std::size_t TrueTypeFont::break_position(const std::string_view text,
+                                         const float font_size,
+                                         const float max_width) const {
+  const std::size_t fitted = fit(text, font_size, max_width);
+  if (fitted == text.size()) {
+    return fitted;
+  }
+  // ' ' never occurs inside a multi-byte sequence, so breaking after one keeps code points
+  // whole.
+  if (text[fitted] == ' ') {
+    return fitted + 1;
+  }
+  for (std::size_t i = fitted; i > 0; --i) {
+    if (text[i - 1] == ' ') {
+      return i;
+    }
+  }
+  return fitted;
+}
+
+void TrueTypeFont::fit_with_ellipsis(const std::string_view text,
+                                     const float font_size,
+                                     const float max_width,
+                                     std::string& out,
+                                     const std::string_view ellipsis) const {
+  if (width_units(text) <= unit_limit(font_size, max_width)) {
+    out.assign(text.data(), text.size());
+    return;
+  }
+
+  std::size_t length = fit(text, font_size, max_width - width(ellipsis, font_size));
+  while (length > 0 && text[length - 1] == ' ') {
+    --length;
+  }
+  out.assign(text.data(), length);
+  out.append(ellipsis.data(), ellipsis.size());
+}
+
+}  // namespace libharu_examples
@@ -2,6 +2,21 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "test_support.h"
+
+namespace {
+
+using test_support::count_occurrences;
+using test_support::count_pages;
+
+}  // namespace
+
 TEST(ClinicalReportExampleTest, ReturnsFalseForInvalidArguments) {
   libharu_examples::ClinicalReportExample example;
 
@@ -20,3 +35,308 @@ TEST(ClinicalReportExampleTest, ReturnsFalseForInvalidArguments) {
   EXPECT_FALSE(example.create_clinical_report_pdf({}, doctor, "report.pdf"));
   EXPECT_FALSE(example.create_clinical_report_pdf(patient, {}, "report.pdf"));
 }
+
+TEST(ClinicalReportExampleTest, RendersIntoBufferAndSink) {
+  libharu_examples::ClinicalReportExample example;
+
+  const libharu_examples::ClinicalReportExample::Patient patient{"Patient", 21, "Female", "123"};
+  const libharu_examples::ClinicalReportExample::ReferringDoctor doctor{"Doctor", "Radiology"};
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.create_clinical_report_pdf(patient, doctor, buffer));
+  ASSERT_GT(buffer.size(), 4U);
+  EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + 4), "%PDF");
+
+  libharu_examples::PdfBuffer streamed;
+  ASSERT_TRUE(example.create_clinical_report_pdf(
+      patient, doctor, [&streamed](const unsigned char* data, std::size_t size) {
+        streamed.insert(streamed.end(), data, data + size);
+        return true;
+      }));
+  EXPECT_EQ(streamed, buffer);
+  EXPECT_FALSE(example.create_clinical_report_pdf(patient, doctor, libharu_examples::PdfSink{}));
+}
+
+TEST(ClinicalReportExampleTest, MultiReportDocumentEmitsTemplateOnce) {
+  libharu_examples::ClinicalReportExample example;
+
+  std::vector<libharu_examples::ClinicalReportExample::Report> reports;
+  for (int i = 0; i < 200; ++i) {
+    reports.push_back({{"Patient " + std::to_string(i), 30 + i % 40, "Female", std::to_string(i)},
+                       {"Doctor", "Radiology"},
+                       {}});
+  }
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.create_clinical_reports_pdf(reports, buffer));
+
+  const std::string pdf(buffer.begin(), buffer.end());
+  const auto occurrences = [&pdf](const std::string& needle) {
+    std::size_t count = 0;
+    for (std::size_t pos = pdf.find(needle); pos != std::string::npos;
+         pos = pdf.find(needle, pos + 1)) {
+      ++count;
+    }
+    return count;
+  };
+  EXPECT_EQ(occurrences("DRLOGY IMAGING CENTER"), 1U);
+  EXPECT_EQ(occurrences("(Patient 199)"), 1U);
+
+  reports[3].patient.patient_id.clear();
+  EXPECT_FALSE(example.create_clinical_reports_pdf(reports, buffer));
+  EXPECT_FALSE(example.create_clinical_reports_pdf({}, "reports.pdf"));
+}
+
+TEST(ClinicalReportExampleTest, EmbedsRawAndJpegFramesFromMemory) {
+  using Frame = libharu_examples::ClinicalReportExample::ImageFrame;
+  libharu_examples::ClinicalReportExample example;
+  const libharu_examples::ClinicalReportExample::Patient patient{"Patient", 21, "Female", "123"};
+  const libharu_examples::ClinicalReportExample::ReferringDoctor doctor{"Doctor", "Radiology"};
+
+  std::vector<unsigned char> gray(64 * 48, 0x80);
+  std::vector<unsigned char> rgb(32 * 32 * 3, 0x40);
+  // A JPEG marker sequence with a recognisable payload; it must reach the PDF untouched.
+  const std::vector<unsigned char> jpeg{0xFF, 0xD8, 0xFF, 0xE0, 'J', 'P', 'E', 'G', 'x', 0xFF,
+                                        0xD9};
+  const std::vector<Frame> frames{
+      {Frame::Format::Gray8, gray.data(), gray.size(), 64, 48},
+      {Frame::Format::Rgb8, rgb.data(), rgb.size(), 32, 32},
+      {Frame::Format::Jpeg, jpeg.data(), jpeg.size()},
+  };
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.create_clinical_report_pdf(patient, doctor, frames, buffer));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_EQ(count_occurrences(pdf, "/Subtype /Image"), 3U);
+  EXPECT_EQ(count_occurrences(pdf, "/DCTDecode"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, std::string(jpeg.begin(), jpeg.end())), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "Ultrasound image placeholder"), 0U);
+
+  libharu_examples::PdfBuffer placeholder;
+  ASSERT_TRUE(example.create_clinical_report_pdf(patient, doctor, placeholder));
+  EXPECT_EQ(count_occurrences(std::string(placeholder.begin(), placeholder.end()),
+                              "Ultrasound image placeholder"),
+            1U);
+}
+
+TEST(ClinicalReportExampleTest, RejectsShortFramesAndSharesRepeatedOnes) {
+  using Frame = libharu_examples::ClinicalReportExample::ImageFrame;
+  libharu_examples::ClinicalReportExample example;
+  const libharu_examples::ClinicalReportExample::Patient patient{"Patient", 21, "Female", "123"};
+  const libharu_examples::ClinicalReportExample::ReferringDoctor doctor{"Doctor", "Radiology"};
+
+  std::vector<unsigned char> gray(16 * 16, 0x20);
+  libharu_examples::PdfBuffer buffer;
+  EXPECT_FALSE(example.create_clinical_report_pdf(
+      patient, doctor, {{Frame::Format::Rgb8, gray.data(), gray.size(), 16, 16}}, buffer));
+  EXPECT_FALSE(example.create_clinical_report_pdf(
+      patient, doctor, {{Frame::Format::Gray8, nullptr, 0, 16, 16}}, buffer));
+
+  const Frame shared{Frame::Format::Gray8, gray.data(), gray.size(), 16, 16};
+  std::vector<libharu_examples::ClinicalReportExample::Report> reports;
+  for (int i = 0; i < 5; ++i) {
+    reports.push_back({patient, doctor, {shared}});
+  }
+  ASSERT_TRUE(example.create_clinical_reports_pdf(reports, buffer));
+  EXPECT_EQ(count_occurrences(buffer, "/Subtype /Image"), 1U);
+}
+
+TEST(ClinicalReportExampleTest, RendersPortraitFormatsAndRejectsLandscape) {
+  using libharu_examples::PageFormat;
+  const libharu_examples::ClinicalReportExample::Patient patient{
+      std::string(60, 'M'), 21, "Female", "123"};
+  const libharu_examples::ClinicalReportExample::ReferringDoctor doctor{"Doctor", "Radiology"};
+
+  libharu_examples::PdfBuffer buffer;
+  const libharu_examples::ClinicalReportExample letter(PageFormat::LetterPortrait);
+  ASSERT_TRUE(letter.create_clinical_report_pdf(patient, doctor, buffer));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_NE(pdf.find("/MediaBox [ 0 0 612 792 ]"), std::string::npos);
+  // A long name is cut before the PID column.
+  EXPECT_EQ(pdf.find(std::string(60, 'M')), std::string::npos);
+  EXPECT_NE(pdf.find("MMM...)"), std::string::npos);
+  ASSERT_TRUE(letter.create_clinical_reports_pdf({{patient, doctor, {}}}, buffer));
+
+  for (const PageFormat format : {PageFormat::A4Landscape, PageFormat::LetterLandscape}) {
+    const libharu_examples::ClinicalReportExample landscape(format);
+    EXPECT_FALSE(landscape.create_clinical_report_pdf(patient, doctor, buffer));
+    EXPECT_FALSE(landscape.create_clinical_reports_pdf({{patient, doctor, {}}}, buffer));
+  }
+}
+
+namespace {
+
+// A Gray16 frame whose left half is `left` and right half `right`, in host byte order.
+std::vector<unsigned char> gray16_halves(const unsigned width,
+                                         const unsigned height,
+                                         const std::uint16_t left,
+                                         const std::uint16_t right) {
+  std::vector<unsigned char> bytes(std::size_t{width} * height * 2);
+  for (unsigned y = 0; y < height; ++y) {
+    for (unsigned x = 0; x < width; ++x) {
+      const std::uint16_t value = x < width / 2 ? left : right;
+      std::memcpy(&bytes[(std::size_t{y} * width + x) * 2], &value, sizeof(value));
+    }
+  }
+  return bytes;
+}
+
+}  // namespace
+
+TEST(ClinicalReportExampleTest, WindowsAndDownscalesGray16Frames) {
+  using Frame = libharu_examples::ClinicalReportExample::ImageFrame;
+  using libharu_examples::ClinicalReportExample;
+  const ClinicalReportExample::Patient patient{"Patient", 21, "Female", "123"};
+  const ClinicalReportExample::ReferringDoctor doctor{"Doctor", "Radiology"};
+
+  // Window 900..1100: 1050 maps to 191, and the right half (5000) clamps to white.
+  std::vector<unsigned char> samples = gray16_halves(512, 512, 1050, 5000);
+  Frame frame{Frame::Format::Gray16, samples.data(), samples.size(), 512, 512};
+  frame.window_center = 1000.0F;
+  frame.window_width = 200.0F;
+  const std::string full_row = std::string(256, '\xBF') + std::string(256, '\xFF');
+  const std::string half_row = std::string(128, '\xBF') + std::string(128, '\xFF');
+
+  const ClinicalReportExample full_resolution;
+  libharu_examples::PdfBuffer full;
+  ASSERT_TRUE(full_resolution.create_clinical_report_pdf(patient, doctor, {frame}, full));
+  const std::string full_pdf(full.begin(), full.end());
+  EXPECT_NE(full_pdf.find("/Width 512\n/Height 512"), std::string::npos);
+  EXPECT_NE(full_pdf.find(full_row), std::string::npos);
+
+  // The 250 pt box at 72 dpi needs about 242 pixels: every 2 x 2 block becomes one pixel.
+  ClinicalReportExample::ImageOptions options;
+  options.dpi = 72.0F;
+  const ClinicalReportExample screen(libharu_examples::PageFormat::A4Portrait, {}, options);
+  libharu_examples::PdfBuffer reduced;
+  ASSERT_TRUE(screen.create_clinical_report_pdf(patient, doctor, {frame}, reduced));
+  const std::string reduced_pdf(reduced.begin(), reduced.end());
+  EXPECT_NE(reduced_pdf.find("/Width 256\n/Height 256"), std::string::npos);
+  EXPECT_NE(reduced_pdf.find(half_row), std::string::npos);
+  EXPECT_LT(reduced.size() * 3, full.size());
+
+  // 8-bit frames are averaged too: each 3 x 3 block holds one white column, so it becomes 85.
+  std::vector<unsigned char> stripes(750 * 750);
+  for (std::size_t i = 0; i < stripes.size(); ++i) {
+    stripes[i] = (i % 750) % 3 == 0 ? 0xFF : 0x00;
+  }
+  ASSERT_TRUE(screen.create_clinical_report_pdf(
+      patient,
+      doctor,
+      {{Frame::Format::Gray8, stripes.data(), stripes.size(), 750, 750}},
+      reduced));
+  const std::string coarse_pdf(reduced.begin(), reduced.end());
+  EXPECT_NE(coarse_pdf.find("/Width 250\n/Height 250"), std::string::npos);
+  EXPECT_NE(coarse_pdf.find(std::string(250 * 250, '\x55')), std::string::npos);
+
+  frame.window_width = 0.0F;
+  EXPECT_FALSE(screen.create_clinical_report_pdf(patient, doctor, {frame}, reduced));
+  frame.window_width = 200.0F;
+  EXPECT_FALSE(screen.create_clinical_report_pdf(
+      patient, doctor, {{Frame::Format::Gray16, samples.data(), 512 * 512, 512, 512}}, reduced));
+  options.dpi = -1.0F;
+  EXPECT_FALSE(ClinicalReportExample(libharu_examples::PageFormat::A4Portrait, {}, options)
+                   .create_clinical_report_pdf(patient, doctor, {frame}, reduced));
+}
+
+TEST(ClinicalReportExampleTest, ContactSheetsHoldTheFramesBeyondTheBox) {
+  using Frame = libharu_examples::ClinicalReportExample::ImageFrame;
+  using libharu_examples::ClinicalReportExample;
+  const ClinicalReportExample::Patient patient{"Patient", 21, "Female", "123"};
+  const ClinicalReportExample::ReferringDoctor doctor{"Doctor", "Radiology"};
+
+  std::vector<std::vector<unsigned char>> pixels;
+  std::vector<Frame> frames;
+  for (int i = 0; i < 16; ++i) {
+    pixels.emplace_back(32 * 24, static_cast<unsigned char>(i));
+  }
+  for (const std::vector<unsigned char>& frame_pixels : pixels) {
+    frames.push_back({Frame::Format::Gray8, frame_pixels.data(), frame_pixels.size(), 32, 24});
+  }
+
+  ClinicalReportExample::ImageOptions options;
+  options.box_frames = 2;
+  const ClinicalReportExample example(libharu_examples::PageFormat::A4Portrait, {}, options);
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.create_clinical_report_pdf(patient, doctor, frames, buffer));
+  std::string pdf(buffer.begin(), buffer.end());
+  // Two frames in the box, then 12 + 2 on two 3 x 4 sheets.
+  EXPECT_EQ(count_pages(pdf), 3U);
+  EXPECT_EQ(count_occurrences(pdf, "/Subtype /Image"), 16U);
+  EXPECT_EQ(count_occurrences(pdf, "(Frame 2)"), 0U);
+  EXPECT_EQ(count_occurrences(pdf, "(Frame 3)"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "(Frames 3-14 of 16)"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "(Frames 15-16 of 16)"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "(PID: 123)"), 2U);
+
+  // Every report of a multi-report document gets its own sheets; shared frames stay shared.
+  frames.resize(5);
+  ASSERT_TRUE(example.create_clinical_reports_pdf(
+      {{patient, doctor, frames}, {patient, doctor, frames}}, buffer));
+  pdf.assign(buffer.begin(), buffer.end());
+  EXPECT_EQ(count_pages(pdf), 4U);
+  EXPECT_EQ(count_occurrences(pdf, "/Subtype /Image"), 5U);
+  EXPECT_EQ(count_occurrences(pdf, "(Frames 3-5 of 5)"), 2U);
+
+  options.sheet_columns = 0;
+  const ClinicalReportExample empty_grid(libharu_examples::PageFormat::A4Portrait, {}, options);
+  EXPECT_FALSE(empty_grid.create_clinical_report_pdf(patient, doctor, frames, buffer));
+}
+
+TEST(ClinicalReportExampleTest, EncryptsReportsWithSharedOrPerDocumentPasswords) {
+  using Example = libharu_examples::ClinicalReportExample;
+  using Passwords = Example::Encryption::Passwords;
+  const Example::Patient patient{"Patient", 21, "Female", "123"};
+  const Example::ReferringDoctor doctor{"Doctor", "Radiology"};
+  const auto encrypted = [](const libharu_examples::PdfBuffer& pdf) {
+    return std::string(pdf.begin(), pdf.end()).find("/Encrypt ") != std::string::npos;
+  };
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(Example().create_clinical_report_pdf(patient, doctor, buffer));
+  EXPECT_FALSE(encrypted(buffer));
+
+  Example::Encryption shared;
+  shared.passwords = Passwords::Shared;
+  shared.owner_password = "owner";
+  shared.user_password = "nightly";
+  const Example shared_example(libharu_examples::PageFormat::A4Portrait, {}, {}, shared);
+  ASSERT_TRUE(shared_example.create_clinical_report_pdf(patient, doctor, buffer));
+  EXPECT_TRUE(encrypted(buffer));
+
+  // Per document: the password comes from the document's (first) patient.
+  std::vector<std::string> asked;
+  Example::Encryption per_document;
+  per_document.passwords = Passwords::PerDocument;
+  per_document.owner_password = "owner";
+  per_document.user_password_for = [&asked](const Example::Patient& p) {
+    asked.push_back(p.patient_id);
+    return p.patient_id == "owner" ? std::string("owner") : "pid-" + p.patient_id;
+  };
+  const Example per_document_example(libharu_examples::PageFormat::A4Portrait, {}, {},
+                                     per_document);
+  ASSERT_TRUE(per_document_example.create_clinical_report_pdf(patient, doctor, buffer));
+  EXPECT_TRUE(encrypted(buffer));
+  const std::vector<Example::Report> batch{{patient, doctor, {}},
+                                           {{"Other", 40, "Male", "456"}, doctor, {}}};
+  ASSERT_TRUE(per_document_example.create_clinical_reports_pdf(batch, buffer));
+  EXPECT_TRUE(encrypted(buffer));
+  EXPECT_EQ(asked, (std::vector<std::string>{"123", "123"}));
+  // A derived password equal to the owner password cannot be used.
+  EXPECT_FALSE(per_document_example.create_clinical_report_pdf(
+      {"Owner", 50, "Male", "owner"}, doctor, buffer));
+
+  // Incomplete settings fail every render.
+  Example::Encryption no_owner = shared;
+  no_owner.owner_password.clear();
+  Example::Encryption same_passwords = shared;
+  same_passwords.user_password = "owner";
+  Example::Encryption no_callback;
+  no_callback.passwords = Passwords::PerDocument;
+  no_callback.owner_password = "owner";
+  for (const Example::Encryption& invalid : {no_owner, same_passwords, no_callback}) {
+    const Example example(libharu_examples::PageFormat::A4Portrait, {}, {}, invalid);
+    EXPECT_FALSE(example.create_clinical_report_pdf(patient, doctor, buffer));
+    EXPECT_FALSE(example.create_clinical_reports_pdf(batch, buffer));
+  }
+}
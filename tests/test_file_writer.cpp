@@ -0,0 +1,208 @@
+#include "libharu_examples/file_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "libharu_examples/clinical_report_example.h"
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/pdf_text_example.h"
+#include "test_support.h"
+
+#include <unistd.h>
+
+namespace {
+
+using libharu_examples::FileWriter;
+using libharu_examples::FileWriterOptions;
+using libharu_examples::FileWriterStats;
+using libharu_examples::FsyncPolicy;
+using libharu_examples::PdfBuffer;
+using test_support::as_text;
+using test_support::fresh_directory;
+using test_support::read_file;
+
+PdfBuffer document(const std::string& text) {
+  return PdfBuffer(text.begin(), text.end());
+}
+
+// Everything in `directory`, so leftover temporary files show up.
+std::size_t file_count(const std::filesystem::path& directory) {
+  return static_cast<std::size_t>(std::distance(std::filesystem::directory_iterator(directory),
+                                                std::filesystem::directory_iterator()));
+}
+
+}  // namespace
+
+TEST(FileWriterTest, ReplacesFilesWholeThroughATemporaryName) {
+  const std::filesystem::path directory = fresh_directory("file_writer_never");
+  const std::string path = (directory / "out.pdf").string();
+  {
+    std::ofstream existing(path, std::ios::binary);
+    existing << "previous";
+  }
+
+  FileWriter writer(FileWriterOptions{FsyncPolicy::Never});
+  ASSERT_TRUE(writer.write(path, document("%PDF-new")));
+  EXPECT_EQ(read_file(path), "%PDF-new");
+  EXPECT_EQ(file_count(directory), 1U);
+
+  // A file that cannot be created leaves the old one alone and nothing else behind.
+  EXPECT_FALSE(writer.write((directory / "missing" / "out.pdf").string(), document("%PDF-x")));
+  EXPECT_EQ(file_count(directory), 1U);
+
+  const FileWriterStats stats = writer.stats();
+  EXPECT_EQ(stats.files, 1U);
+  EXPECT_EQ(stats.bytes, 8U);
+  EXPECT_EQ(stats.failed, 1U);
+  EXPECT_EQ(stats.write_calls, 1U);
+  EXPECT_EQ(stats.fsync_calls, 0U);
+}
+
+TEST(FileWriterTest, PerFileSyncsTheFileAndItsDirectory) {
+  const std::filesystem::path directory = fresh_directory("file_writer_per_file");
+  FileWriter writer;
+  EXPECT_EQ(writer.options().fsync, FsyncPolicy::PerFile);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(writer.write((directory / (std::to_string(i) + ".pdf")).string(),
+                             document("%PDF-" + std::to_string(i))));
+  }
+  EXPECT_EQ(file_count(directory), 3U);
+  EXPECT_EQ(writer.stats().files, 3U);
+  EXPECT_EQ(writer.stats().fsync_calls, 6U);
+}
+
+TEST(FileWriterTest, PerBatchPublishesFilesWhenTheBatchCommits) {
+  const std::filesystem::path directory = fresh_directory("file_writer_per_batch");
+  FileWriterOptions options;
+  options.fsync = FsyncPolicy::PerBatch;
+  options.batch_files = 3;
+  FileWriter writer(options);
+
+  const auto path = [&directory](const int i) {
+    return (directory / (std::to_string(i) + ".pdf")).string();
+  };
+  ASSERT_TRUE(writer.write(path(0), document("%PDF-0")));
+  ASSERT_TRUE(writer.write(path(1), document("%PDF-1")));
+  // Staged under temporary names only.
+  EXPECT_FALSE(std::filesystem::exists(path(0)));
+  EXPECT_EQ(file_count(directory), 2U);
+
+  // The third file fills the batch: three file syncs and one directory sync.
+  ASSERT_TRUE(writer.write(path(2), document("%PDF-2")));
+  EXPECT_EQ(read_file(path(0)), "%PDF-0");
+  EXPECT_EQ(writer.stats().files, 3U);
+  EXPECT_EQ(writer.stats().fsync_calls, 4U);
+
+  ASSERT_TRUE(writer.write(path(3), document("%PDF-3")));
+  EXPECT_FALSE(std::filesystem::exists(path(3)));
+  EXPECT_TRUE(writer.commit());
+  EXPECT_TRUE(std::filesystem::exists(path(3)));
+  EXPECT_TRUE(writer.commit());  // nothing staged
+  EXPECT_EQ(file_count(directory), 4U);
+  EXPECT_EQ(writer.stats().fsync_calls, 6U);
+}
+
+TEST(FileWriterTest, AFailedDirectorySyncCountsTheFileAsFailed) {
+  if (::geteuid() == 0) {
+    GTEST_SKIP() << "root can open a directory without read permission";
+  }
+  // Writable and searchable but not readable: renames into it work, opening it to fsync fails.
+  const std::filesystem::path directory = fresh_directory("file_writer_unreadable");
+  std::filesystem::permissions(
+      directory, std::filesystem::perms::owner_write | std::filesystem::perms::owner_exec);
+
+  FileWriter per_file;
+  const std::string first = (directory / "0.pdf").string();
+  EXPECT_FALSE(per_file.write(first, document("%PDF-0")));
+  EXPECT_EQ(read_file(first), "%PDF-0");
+  EXPECT_EQ(per_file.stats().files, 0U);
+  EXPECT_EQ(per_file.stats().failed, 1U);
+
+  FileWriterOptions options;
+  options.fsync = FsyncPolicy::PerBatch;
+  FileWriter per_batch(options);
+  const std::string second = (directory / "1.pdf").string();
+  ASSERT_TRUE(per_batch.write(second, document("%PDF-1")));
+  EXPECT_FALSE(per_batch.commit());
+  EXPECT_EQ(read_file(second), "%PDF-1");
+  EXPECT_EQ(per_batch.stats().files, 0U);
+  EXPECT_EQ(per_batch.stats().bytes, 0U);
+  EXPECT_EQ(per_batch.stats().failed, 1U);
+
+  std::filesystem::permissions(directory, std::filesystem::perms::owner_all);
+}
+
+TEST(FileWriterTest, RenderersSaveThroughTheScopedWriter) {
+  const std::filesystem::path directory = fresh_directory("file_writer_renderers");
+  const std::string text_path = (directory / "text.pdf").string();
+  const std::string invoice_path = (directory / "invoice.pdf").string();
+  const std::string report_path = (directory / "report.pdf").string();
+
+  const libharu_examples::InvoiceExample invoice;
+  const libharu_examples::InvoiceExample::Provider provider{"Provider", "Street 1", "p@x.test"};
+  const libharu_examples::InvoiceExample::Client client{"Client", "Avenue 2", "c@x.test"};
+  const std::vector<libharu_examples::InvoiceExample::Item> items{{"Consulting", 2, 150.0}};
+  const libharu_examples::ClinicalReportExample report;
+  const libharu_examples::ClinicalReportExample::Patient patient{"Patient", 30, "Female", "1"};
+  const libharu_examples::ClinicalReportExample::ReferringDoctor doctor{"Doctor", "Radiology"};
+
+  FileWriterOptions options;
+  options.fsync = FsyncPolicy::PerBatch;
+  FileWriter writer(options);
+  {
+    libharu_examples::ScopedFileWriter scope(writer);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(text_path, "durable"));
+    ASSERT_TRUE(invoice.createInvoidcw(provider, client, items, invoice_path));
+    ASSERT_TRUE(report.create_clinical_report_pdf(patient, doctor, report_path));
+    EXPECT_FALSE(std::filesystem::exists(text_path));
+    EXPECT_TRUE(writer.commit());
+  }
+
+  // One write per document: each fits the buffer.
+  const FileWriterStats stats = writer.stats();
+  EXPECT_EQ(stats.files, 3U);
+  EXPECT_EQ(stats.write_calls, 3U);
+  EXPECT_EQ(stats.fsync_calls, 4U);
+  EXPECT_EQ(file_count(directory), 3U);
+
+  PdfBuffer expected;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(expected, "durable"));
+  EXPECT_EQ(read_file(text_path), as_text(expected));
+  ASSERT_TRUE(invoice.createInvoidcw(provider, client, items, expected));
+  EXPECT_EQ(read_file(invoice_path), as_text(expected));
+  ASSERT_TRUE(report.create_clinical_report_pdf(patient, doctor, expected));
+  EXPECT_EQ(read_file(report_path), as_text(expected));
+
+  // Outside the scope files still arrive whole, without touching this writer.
+  ASSERT_TRUE(libharu_examples::create_text_pdf(text_path, "unscoped"));
+  EXPECT_EQ(writer.stats().files, 3U);
+  EXPECT_EQ(file_count(directory), 3U);
+}
+
+TEST(FileWriterTest, SmallBuffersSplitDocumentsIntoSeveralWrites) {
+  const std::filesystem::path directory = fresh_directory("file_writer_small_buffer");
+  const std::string path = (directory / "long.pdf").string();
+  std::string text;
+  for (int i = 0; i < 400; ++i) {
+    text += "line " + std::to_string(i) + "\n";
+  }
+
+  FileWriterOptions options;
+  options.fsync = FsyncPolicy::Never;
+  options.buffer_bytes = 4096;
+  FileWriter writer(options);
+  {
+    libharu_examples::ScopedFileWriter scope(writer);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(path, text));
+  }
+  PdfBuffer expected;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(expected, text));
+  EXPECT_EQ(read_file(path), as_text(expected));
+  EXPECT_EQ(writer.stats().bytes, expected.size());
+  EXPECT_EQ(writer.stats().write_calls, (expected.size() + 4095) / 4096);
+}
@@ -0,0 +1,192 @@
+#include "libharu_examples/invoice_bulk.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+#include "test_support.h"
+
+namespace {
+
+using test_support::fresh_directory;
+using test_support::read_file;
+using test_support::temp_path;
+using test_support::write_temp_file;
+
+// PDFs in `directory` whose name starts with `prefix`.
+std::size_t count_files(const std::filesystem::path& directory, const std::string& prefix) {
+  std::size_t count = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    const std::string name = entry.path().filename().string();
+    if (name.compare(0, prefix.size(), prefix) == 0 && entry.path().extension() == ".pdf") {
+      ++count;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(InvoiceBulkTest, RendersOneFilePerInvoiceFromCsv) {
+  // Columns in a non-default order, an unused column, quoted fields with "" and a line break,
+  // CRLF line ends and a blank line.
+  std::string csv =
+      "quantity,unit_price,invoice_id,notes,description,provider_name,client_name,"
+      "client_address\r\n";
+  for (int i = 0; i < 40; ++i) {
+    const std::string id = "INV-" + std::to_string(100 + i / 2);
+    csv += "2,19.5," + id + ",x,\"Item, \"\"large\"\"\",Provider,Client,\"Line 1\nLine 2\"\r\n";
+  }
+  csv += "\r\n1,5,INV/../evil,,Path id,Provider,Client,\r\n";
+  const std::string input = write_temp_file("bulk_input.csv", csv);
+  const std::filesystem::path output = fresh_directory("bulk_csv_out");
+
+  libharu_examples::InvoiceBulkOptions options;
+  options.render_workers = 3;
+  options.queue_depth = 2;  // keep the stages waiting on each other
+  options.progress_interval = 5;
+  std::size_t progress_calls = 0;
+  options.progress = [&progress_calls](const libharu_examples::InvoiceBulkStats&) {
+    ++progress_calls;
+  };
+
+  libharu_examples::InvoiceBulkStats stats;
+  ASSERT_TRUE(
+      libharu_examples::create_invoices_from_file(input, output.string(), options, &stats));
+  EXPECT_EQ(stats.rows, 41U);
+  EXPECT_EQ(stats.invoices, 21U);
+  EXPECT_EQ(stats.rejected, 0U);
+  EXPECT_EQ(stats.failed, 0U);
+  EXPECT_TRUE(stats.first_error.empty()) << stats.first_error;
+  EXPECT_EQ(stats.input_bytes, csv.size());
+  EXPECT_GT(stats.output_bytes, 0U);
+  EXPECT_EQ(progress_calls, 5U);  // every 5 invoices, plus the final report
+
+  const std::string pdf = read_file(output / "INV-100.pdf");
+  ASSERT_GT(pdf.size(), 4U);
+  EXPECT_EQ(pdf.substr(0, 4), "%PDF");
+  EXPECT_NE(pdf.find("Item, \"large\""), std::string::npos);
+  EXPECT_TRUE(std::filesystem::exists(output / "INV-119.pdf"));
+  EXPECT_EQ(count_files(output, "INV_.._evil-"), 1U);
+}
+
+TEST(InvoiceBulkTest, KeepsEveryInvoiceInItsOwnFile) {
+  // `a/b` and `a_b` sanitize alike, as do two long ids that differ after 120 bytes; the
+  // repeated `a_b` on line 6 would overwrite the first one's PDF.
+  const std::string long_id(130, 'L');
+  std::string csv = "invoice_id,provider_name,client_name,description,quantity,unit_price\n";
+  for (const std::string& id : {std::string("a/b"), std::string("a_b"), long_id + "1",
+                                long_id + "2", std::string("a_b"), std::string("c")}) {
+    csv += id + ",Provider,Client,Item,1,2.5\n";
+  }
+  const std::string input = write_temp_file("bulk_collisions.csv", csv);
+  const std::filesystem::path output = fresh_directory("bulk_collisions_out");
+
+  libharu_examples::InvoiceBulkStats stats;
+  ASSERT_TRUE(libharu_examples::create_invoices_from_file(input, output.string(), {}, &stats));
+  EXPECT_EQ(stats.invoices, 5U);
+  EXPECT_EQ(stats.rejected, 1U);
+  EXPECT_EQ(stats.first_error, "line 6: invoice_id names the same file as an earlier invoice");
+
+  EXPECT_TRUE(std::filesystem::exists(output / "a_b.pdf"));
+  EXPECT_EQ(count_files(output, "a_b-"), 1U);
+  EXPECT_EQ(count_files(output, std::string(120, 'L') + "-"), 2U);
+  EXPECT_EQ(count_files(output, ""), stats.invoices);
+}
+
+TEST(InvoiceBulkTest, CommitsFilesInFsyncBatches) {
+  std::string csv = "invoice_id,provider_name,client_name,description,quantity,unit_price\n";
+  for (int i = 0; i < 10; ++i) {
+    csv += "B-" + std::to_string(i) + ",Provider,Client,Item,1,2.5\n";
+  }
+  const std::string input = write_temp_file("bulk_batches.csv", csv);
+  const std::filesystem::path output = fresh_directory("bulk_batches_out");
+
+  libharu_examples::InvoiceBulkOptions options;
+  options.render_workers = 2;
+  options.output.fsync = libharu_examples::FsyncPolicy::PerBatch;
+  options.output.batch_files = 4;
+
+  libharu_examples::InvoiceBulkStats stats;
+  ASSERT_TRUE(
+      libharu_examples::create_invoices_from_file(input, output.string(), options, &stats));
+  EXPECT_EQ(stats.invoices, 10U);
+  EXPECT_EQ(stats.failed, 0U);
+  EXPECT_TRUE(stats.first_error.empty()) << stats.first_error;
+
+  // Every staged file was committed under its own name; no temporary file is left.
+  std::size_t files = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(output)) {
+    EXPECT_EQ(entry.path().extension(), ".pdf") << entry.path();
+    EXPECT_EQ(read_file(entry.path()).substr(0, 4), "%PDF");
+    ++files;
+  }
+  EXPECT_EQ(files, 10U);
+}
+
+TEST(InvoiceBulkTest, ReadsJsonLinesAndRejectsBadInvoices) {
+  const std::string jsonl =
+      "{\"invoice_id\": \"A-1\", \"provider_name\": \"Provider\", \"client_name\": "
+      "\"Caf\\u00e9 \\\"Nord\\\"\", \"description\": \"Beans\", \"quantity\": 3, "
+      "\"unit_price\": 4.25, \"extra\": null}\n"
+      "{\"invoice_id\": \"A-1\", \"provider_name\": \"Provider\", \"client_name\": \"Cafe\", "
+      "\"description\": \"Cups\", \"quantity\": \"2\", \"unit_price\": \"1.5\"}\n"
+      "\n"
+      "{\"invoice_id\": \"B-2\", \"provider_name\": \"Provider\", \"client_name\": \"Shop\", "
+      "\"description\": \"Broken\", \"quantity\": 0, \"unit_price\": 1}\n"
+      "{\"invoice_id\": \"B-2\", \"provider_name\": \"Provider\", \"client_name\": \"Shop\", "
+      "\"description\": \"Fine\", \"quantity\": 1, \"unit_price\": 1}\n"
+      "{\"invoice_id\": \"C-3\", \"items\": [1, 2]}\n"
+      "not json\n"
+      "{\"invoice_id\": \"D-4\", \"provider_name\": \"Provider\", \"client_name\": \"Shop\", "
+      "\"description\": \"Last\", \"quantity\": 1, \"unit_price\": 9.99}";
+  const std::string input = write_temp_file("bulk_input.jsonl", jsonl);
+  const std::filesystem::path output = fresh_directory("bulk_jsonl_out");
+
+  libharu_examples::InvoiceBulkOptions options;
+  options.render_workers = 2;
+  libharu_examples::InvoiceBulkStats stats;
+  ASSERT_TRUE(
+      libharu_examples::create_invoices_from_file(input, output.string(), options, &stats));
+  EXPECT_EQ(stats.rows, 7U);
+  EXPECT_EQ(stats.invoices, 2U);
+  EXPECT_EQ(stats.rejected, 3U);  // B-2 (bad quantity), C-3 (nested value), "not json"
+  EXPECT_EQ(stats.first_error, "line 4: quantity is not a positive integer");
+
+  EXPECT_TRUE(std::filesystem::exists(output / "A-1.pdf"));
+  EXPECT_TRUE(std::filesystem::exists(output / "D-4.pdf"));
+  EXPECT_FALSE(std::filesystem::exists(output / "B-2.pdf"));
+  EXPECT_NE(read_file(output / "A-1.pdf").find("Caf\xC3\xA9 \"Nord\""), std::string::npos);
+}
+
+TEST(InvoiceBulkTest, ReportsUnusableInputs) {
+  libharu_examples::InvoiceBulkStats stats;
+  const std::string unused = temp_path("bulk_unused_out");
+  EXPECT_FALSE(libharu_examples::create_invoices_from_file(
+      temp_path("bulk_missing_input.csv"), unused, {}, &stats));
+  EXPECT_FALSE(stats.first_error.empty());
+
+  const std::string input =
+      write_temp_file("bulk_bad_header.csv", "invoice_id,provider_name,client_name\nA,B,C\n");
+  EXPECT_FALSE(libharu_examples::create_invoices_from_file(input, unused, {}, &stats));
+  EXPECT_EQ(stats.first_error, "line 1: missing column 'description'");
+
+  // Malformed rows are counted and skipped; the run itself succeeds.
+  const std::string quoted = write_temp_file(
+      "bulk_bad_rows.csv",
+      "invoice_id,provider_name,client_name,description,quantity,unit_price\n"
+      "A,P,C,ok,1,2\n"
+      "B,P,C,\"bad\"x,1,2\n"
+      "C,P,C,ok,1,2,surplus\n"
+      ",P,C,no id,1,2\n"
+      "D,P,C,price,1,abc\n");
+  const std::filesystem::path output = fresh_directory("bulk_bad_rows_out");
+  ASSERT_TRUE(
+      libharu_examples::create_invoices_from_file(quoted, output.string(), {}, &stats));
+  EXPECT_EQ(stats.rows, 5U);
+  EXPECT_EQ(stats.invoices, 1U);
+  EXPECT_EQ(stats.rejected, 4U);
+  EXPECT_EQ(stats.first_error, "line 3: unexpected character after a quoted field");
+}
@@ -2,6 +2,23 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libharu_examples/text_metrics.h"
+#include "test_support.h"
+
+namespace {
+
+using test_support::count_occurrences;
+using test_support::count_pages;
+
+}  // namespace
+
 TEST(InvoiceExampleTest, ReturnsFalseForInvalidArguments) {
   libharu_examples::InvoiceExample example;
 
@@ -27,3 +44,367 @@ TEST(InvoiceExampleTest, ReturnsFalseForInvalidItemValues) {
   EXPECT_FALSE(example.createInvoidcw(provider, client, bad_quantity, "invoice.pdf"));
   EXPECT_FALSE(example.createInvoidcw(provider, client, bad_price, "invoice.pdf"));
 }
+
+TEST(InvoiceExampleTest, BatchRendersThousandsOfInvoicesConcurrently) {
+  libharu_examples::InvoiceExample example;
+
+  const std::string output_dir = ::testing::TempDir();
+  std::vector<libharu_examples::InvoiceExample::BatchJob> jobs;
+  for (int i = 0; i < 2000; ++i) {
+    jobs.push_back({
+        {"Provider " + std::to_string(i), "1 Provider Street", "billing@provider.example"},
+        {"Client " + std::to_string(i), "2 Client Road", "ap@client.example"},
+        {{"Consulting", 1 + i % 7, 90.0}, {"Travel", 1, 12.5 * (i % 3)}},
+        output_dir + "batch_invoice_" + std::to_string(i) + ".pdf",
+    });
+  }
+  jobs[7].items.clear();
+
+  const auto results = example.createInvoiceBatch(jobs, 8);
+
+  ASSERT_EQ(results.size(), jobs.size());
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    if (i == 7) {
+      EXPECT_EQ(results[i], libharu_examples::InvoiceExample::JobStatus::InvalidInput);
+      continue;
+    }
+    ASSERT_EQ(results[i], libharu_examples::InvoiceExample::JobStatus::Ok) << "job " << i;
+    std::ifstream pdf(jobs[i].output_pdf_path, std::ios::binary);
+    char magic[5] = {};
+    pdf.read(magic, 4);
+    EXPECT_STREQ(magic, "%PDF") << jobs[i].output_pdf_path;
+    std::remove(jobs[i].output_pdf_path.c_str());
+  }
+}
+
+TEST(InvoiceExampleTest, BatchReportsSaveFailuresPerJob) {
+  libharu_examples::InvoiceExample example;
+
+  std::vector<libharu_examples::InvoiceExample::BatchJob> jobs{
+      {{"Provider", "", ""}, {"Client", "", ""}, {{"Item", 1, 10.0}}, ""},
+      {{"Provider", "", ""},
+       {"Client", "", ""},
+       {{"Item", 1, 10.0}},
+       ::testing::TempDir() + "missing_dir/invoice.pdf"},
+  };
+
+  const auto results = example.createInvoiceBatch(jobs);
+
+  ASSERT_EQ(results.size(), 2U);
+  EXPECT_EQ(results[0], libharu_examples::InvoiceExample::JobStatus::InvalidInput);
+  EXPECT_EQ(results[1], libharu_examples::InvoiceExample::JobStatus::SaveFailed);
+  EXPECT_TRUE(example.createInvoiceBatch({}).empty());
+}
+
+TEST(InvoiceExampleTest, RendersIntoBufferAndSink) {
+  libharu_examples::InvoiceExample example;
+
+  libharu_examples::InvoiceExample::Provider provider{"Provider", "", ""};
+  libharu_examples::InvoiceExample::Client client{"Client", "", ""};
+  std::vector<libharu_examples::InvoiceExample::Item> items{{"Item", 1, 10.0}};
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.createInvoidcw(provider, client, items, buffer));
+  ASSERT_GT(buffer.size(), 4U);
+  EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + 4), "%PDF");
+
+  std::size_t streamed_bytes = 0;
+  ASSERT_TRUE(example.createInvoidcw(
+      provider, client, items, [&streamed_bytes](const unsigned char*, std::size_t size) {
+        streamed_bytes += size;
+        return true;
+      }));
+  EXPECT_EQ(streamed_bytes, buffer.size());
+
+  EXPECT_FALSE(example.createInvoidcw(provider, client, {}, buffer));
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(InvoiceExampleTest, RowsShareTextObjectsAndFontState) {
+  libharu_examples::InvoiceExample example;
+  libharu_examples::InvoiceExample::Provider provider{"Provider", "Street 1", "p@example.com"};
+  libharu_examples::InvoiceExample::Client client{"Client", "Street 2", "c@example.com"};
+  std::vector<libharu_examples::InvoiceExample::Item> items(
+      100, libharu_examples::InvoiceExample::Item{"Row", 2, 5.0});
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.createInvoidcw(provider, client, items, buffer));
+
+  // 400 row strings would need 400 BT/Tf pairs if every string opened its own text object.
+  // The rows span several pages, and each page opens its own.
+  const std::size_t pages = count_pages(buffer);
+  EXPECT_GT(pages, 1U);
+  EXPECT_LT(count_occurrences(buffer, "BT\n"), 5U * pages);
+  EXPECT_LT(count_occurrences(buffer, " Tf\n"), 15U * pages);
+}
+
+namespace {
+
+struct PlacedText {
+  std::string text;
+  float x;
+  float y;
+};
+
+// Every `(text) Tj` of the content streams with its absolute position, following the `Td`
+// moves from the start of its text object.
+std::vector<PlacedText> placed_texts(const libharu_examples::PdfBuffer& pdf) {
+  std::vector<PlacedText> placed;
+  std::istringstream lines(std::string(pdf.begin(), pdf.end()));
+  std::string line;
+  float x = 0.0F;
+  float y = 0.0F;
+  while (std::getline(lines, line)) {
+    if (line == "BT") {
+      x = 0.0F;
+      y = 0.0F;
+    } else if (line.size() > 3 && line.compare(line.size() - 3, 3, " Td") == 0) {
+      float dx = 0.0F;
+      float dy = 0.0F;
+      if (std::sscanf(line.c_str(), "%f %f Td", &dx, &dy) == 2) {
+        x += dx;
+        y += dy;
+      }
+    } else if (line.size() > 5 && line.front() == '(' &&
+               line.compare(line.size() - 4, 4, ") Tj") == 0) {
+      placed.push_back({line.substr(1, line.size() - 5), x, y});
+    }
+  }
+  return placed;
+}
+
+const PlacedText* find_text(const std::vector<PlacedText>& placed, const std::string& text) {
+  for (const PlacedText& entry : placed) {
+    if (entry.text == text) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+float helvetica_width(const std::string& text) {
+  return libharu_examples::FontMetrics::get(libharu_examples::StandardFont::Helvetica)
+      .width(text, 11.0F);
+}
+
+}  // namespace
+
+TEST(InvoiceExampleTest, ItemTableWrapsDescriptionsAndAlignsNumbers) {
+  libharu_examples::InvoiceExample example;
+  std::string long_description;
+  for (int i = 0; i < 30; ++i) {
+    long_description += "word" + std::to_string(i) + " ";
+  }
+  const std::vector<libharu_examples::InvoiceExample::Item> items{
+      {"Short", 1, 5.0}, {long_description, 12, 1250.5}, {"After", 300, 0.25}};
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.createInvoidcw({"Provider", "", ""}, {"Client", "", ""}, items, buffer));
+  const std::vector<PlacedText> placed = placed_texts(buffer);
+
+  // The long description is broken on spaces into lines that start on the column edge and
+  // together hold every word; nothing is cut.
+  const PlacedText* short_row = find_text(placed, "Short");
+  const PlacedText* after_row = find_text(placed, "After");
+  ASSERT_NE(short_row, nullptr);
+  ASSERT_NE(after_row, nullptr);
+  std::string joined;
+  std::size_t lines = 0;
+  for (const PlacedText& entry : placed) {
+    if (entry.text.rfind("word", 0) == 0) {
+      EXPECT_NEAR(entry.x, short_row->x, 0.05F);
+      joined += entry.text;
+      ++lines;
+    }
+  }
+  EXPECT_GT(lines, 1U);
+  EXPECT_EQ(joined, long_description);
+  EXPECT_EQ(std::string(buffer.begin(), buffer.end()).find("...)"), std::string::npos);
+
+  // The wrapped row pushes the next one down by one leading per extra line.
+  EXPECT_NEAR(short_row->y - after_row->y, 2.0F * 28.0F + 13.0F * (lines - 1), 0.05F);
+
+  // Quantities end on one edge; prices line up on their decimal points.
+  const char* quantities[] = {"1", "12", "300"};
+  const char* prices[] = {"5.00", "1,250.50", "0.25"};
+  const PlacedText* first_quantity = find_text(placed, quantities[0]);
+  const PlacedText* first_price = find_text(placed, prices[0]);
+  ASSERT_NE(first_quantity, nullptr);
+  ASSERT_NE(first_price, nullptr);
+  for (int i = 1; i < 3; ++i) {
+    const PlacedText* quantity = find_text(placed, quantities[i]);
+    const PlacedText* price = find_text(placed, prices[i]);
+    ASSERT_NE(quantity, nullptr);
+    ASSERT_NE(price, nullptr);
+    EXPECT_NEAR(quantity->x + helvetica_width(quantities[i]),
+                first_quantity->x + helvetica_width(quantities[0]),
+                0.05F);
+    const std::string integer(prices[i], std::string_view(prices[i]).find('.'));
+    EXPECT_NEAR(price->x + helvetica_width(integer), first_price->x + helvetica_width("5"), 0.05F);
+  }
+}
+
+TEST(InvoiceExampleTest, LongItemTablesContinueOnNewPages) {
+  libharu_examples::InvoiceExample example;
+  std::vector<libharu_examples::InvoiceExample::Item> items;
+  for (int i = 0; i < 300; ++i) {
+    items.push_back({"Item " + std::to_string(i), 1, 1.0});
+  }
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.createInvoidcw({"Provider", "", ""}, {"Client", "", ""}, items, buffer));
+  const std::size_t pages = count_pages(buffer);
+  EXPECT_GT(pages, 10U);
+  EXPECT_EQ(count_occurrences(buffer, "(Subtotal carried forward) Tj"), pages - 1);
+  EXPECT_EQ(count_occurrences(buffer, "(Brought forward) Tj"), pages - 1);
+  EXPECT_EQ(count_occurrences(buffer, "(TOTAL) Tj"), 1U);
+  EXPECT_EQ(count_occurrences(buffer, "(Item 299) Tj"), 1U);
+
+  // A long provider name is cut to the content width on continuation pages as well: one
+  // header per page, plus the signature.
+  const std::string long_name(200, 'P');
+  ASSERT_TRUE(example.createInvoidcw({long_name, "", ""}, {"Client", "", ""}, items, buffer));
+  EXPECT_EQ(count_occurrences(buffer, long_name), 0U);
+  EXPECT_EQ(count_occurrences(buffer, "PPP...) Tj"), count_pages(buffer) + 1);
+}
+
+TEST(InvoiceExampleTest, PaginatedInvoiceStreamsItemsAcrossPages) {
+  libharu_examples::InvoiceExample example;
+
+  libharu_examples::InvoiceExample::Provider provider{"Provider", "", ""};
+  libharu_examples::InvoiceExample::Client client{"Client", "", ""};
+
+  int produced = 0;
+  const auto source = [&produced](libharu_examples::InvoiceExample::Item& item) {
+    if (produced == 500) {
+      return false;
+    }
+    item = {"Line " + std::to_string(produced), 1 + produced % 4, 2.5};
+    ++produced;
+    return true;
+  };
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.createPaginatedInvoice(provider, client, source, buffer));
+  EXPECT_EQ(produced, 500);
+  EXPECT_GT(count_pages(buffer), 10U);
+
+  produced = 0;
+  libharu_examples::PdfBuffer short_invoice;
+  ASSERT_TRUE(example.createPaginatedInvoice(
+      provider,
+      client,
+      [&produced](libharu_examples::InvoiceExample::Item& item) {
+        item = {"Only line", 1, 1.0};
+        return produced++ == 0;
+      },
+      short_invoice));
+  EXPECT_EQ(count_pages(short_invoice), 1U);
+}
+
+TEST(InvoiceExampleTest, PaginatedInvoiceRejectsEmptyOrInvalidSources) {
+  libharu_examples::InvoiceExample example;
+
+  libharu_examples::InvoiceExample::Provider provider{"Provider", "", ""};
+  libharu_examples::InvoiceExample::Client client{"Client", "", ""};
+  libharu_examples::PdfBuffer buffer;
+
+  EXPECT_FALSE(example.createPaginatedInvoice(
+      provider, client, [](libharu_examples::InvoiceExample::Item&) { return false; }, buffer));
+  EXPECT_FALSE(example.createPaginatedInvoice(
+      provider,
+      client,
+      [](libharu_examples::InvoiceExample::Item& item) {
+        item = {"Bad", 0, 1.0};
+        return true;
+      },
+      buffer));
+  EXPECT_FALSE(example.createPaginatedInvoice(
+      provider, client, libharu_examples::InvoiceExample::ItemSource{}, "invoice.pdf"));
+}
+
+TEST(InvoiceExampleTest, RendersEveryPageFormat) {
+  using libharu_examples::PageFormat;
+  const struct {
+    PageFormat format;
+    const char* media_box;
+  } formats[] = {{PageFormat::A4Portrait, "/MediaBox [ 0 0 595.3 841.9 ]"},
+                 {PageFormat::A4Landscape, "/MediaBox [ 0 0 841.9 595.3 ]"},
+                 {PageFormat::LetterPortrait, "/MediaBox [ 0 0 612 792 ]"},
+                 {PageFormat::LetterLandscape, "/MediaBox [ 0 0 792 612 ]"}};
+
+  libharu_examples::InvoiceExample::Provider provider{"Provider", "Street 1", "p@example.com"};
+  libharu_examples::InvoiceExample::Client client{
+      "Client", std::string(80, 'W'), "c@example.com"};
+  const std::vector<libharu_examples::InvoiceExample::Item> items{{"Consulting", 10, 150.0}};
+
+  for (const auto& [format, media_box] : formats) {
+    const libharu_examples::InvoiceExample example(format);
+    EXPECT_EQ(example.page_format(), format);
+
+    libharu_examples::PdfBuffer buffer;
+    ASSERT_TRUE(example.createInvoidcw(provider, client, items, buffer));
+    const std::string pdf(buffer.begin(), buffer.end());
+    EXPECT_NE(pdf.find(media_box), std::string::npos) << media_box;
+    // The address is cut to its column instead of running into the invoice details.
+    EXPECT_EQ(pdf.find(std::string(80, 'W')), std::string::npos);
+    EXPECT_NE(pdf.find("WWW...)"), std::string::npos);
+
+    // Pagination terminates on every format and closes on its last page.
+    int produced = 0;
+    ASSERT_TRUE(example.createPaginatedInvoice(
+        provider,
+        client,
+        [&produced](libharu_examples::InvoiceExample::Item& item) {
+          item = {"Line", 1, 1.0};
+          return produced++ < 120;
+        },
+        buffer));
+    EXPECT_GT(count_pages(buffer), 2U);
+    EXPECT_EQ(count_occurrences(buffer, "(TOTAL)"), 1U);
+  }
+}
+
+TEST(InvoiceExampleTest, StatementSharesFontsAndStaticContentAcrossInvoices) {
+  libharu_examples::InvoiceStatement statement(libharu_examples::PageFormat::LetterPortrait);
+  libharu_examples::PdfBuffer buffer;
+  EXPECT_FALSE(statement.save(buffer));  // nothing to save yet
+
+  const libharu_examples::InvoiceExample::Provider provider{"Provider", "1 Road", "p@example"};
+  const std::vector<libharu_examples::InvoiceExample::Item> short_items{{"Consulting", 2, 150.0}};
+  const std::vector<libharu_examples::InvoiceExample::Item> long_items(60, {"Line", 1, 1.0});
+  for (int i = 0; i < 50; ++i) {
+    const libharu_examples::InvoiceExample::Client client{
+        "Client " + std::to_string(i), "2 Street", "c@example"};
+    ASSERT_TRUE(statement.add_invoice(provider,
+                                      client,
+                                      (i == 10) ? long_items : short_items,
+                                      (i == 0) ? "January: Client 0" : ""));
+  }
+  EXPECT_FALSE(statement.add_invoice(provider, {}, short_items));
+  EXPECT_FALSE(statement.add_invoice(provider, {"Client", "", ""}, {{"Bad", 0, 1.0}}));
+  EXPECT_EQ(statement.invoice_count(), 50U);
+
+  ASSERT_TRUE(statement.save(buffer));
+  const std::size_t pages = count_pages(buffer);
+  EXPECT_GT(pages, 50U);  // invoice 10 runs over several pages
+  EXPECT_EQ(statement.page_count(), pages);
+  EXPECT_NE(std::string(buffer.begin(), buffer.end()).find("612 792"), std::string::npos);
+
+  // Three fonts and one copy of the static header and footer for the whole document.
+  EXPECT_EQ(count_occurrences(buffer, "/Type /Font"), 3U);
+  EXPECT_EQ(count_occurrences(buffer, "(BILL TO)"), 1U);
+  EXPECT_EQ(count_occurrences(buffer, "(Thank you)"), 1U);
+  EXPECT_EQ(count_occurrences(buffer, "(TOTAL)"), 50U);
+
+  // One bookmark per invoice.
+  EXPECT_EQ(count_occurrences(buffer, "/Title ("), 50U);
+  EXPECT_EQ(count_occurrences(buffer, "/Title (January: Client 0)"), 1U);
+  EXPECT_EQ(count_occurrences(buffer, "/Title (Client 49)"), 1U);
+
+  // A saved statement keeps accepting invoices.
+  ASSERT_TRUE(statement.add_invoice(provider, {"Late client", "", ""}, short_items));
+  libharu_examples::PdfBuffer again;
+  ASSERT_TRUE(statement.save(again));
+  EXPECT_EQ(count_pages(again), pages + 1);
+}
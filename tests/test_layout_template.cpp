@@ -0,0 +1,122 @@
+#include "libharu_examples/layout_template.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+
+#include "test_support.h"
+
+namespace {
+
+using test_support::count_occurrences;
+
+constexpr const char* kTemplate = R"(# header
+page letter
+font bold Helvetica-Bold
+font body Helvetica
+color ink 0.1 0.1 0.1
+fill ink
+text bold 20 40 h-60 "Statement for {customer}"
+table rows columns=label,value top=h-120 row=20 bottom=60 reserve=80
+  text body 11 40 0 "{label}" width=200
+  text body 11 w-40 0 "{value}" align=right
+end
+line 40 ^+10 w-40 ^+10
+text bold 12 w-40 ^-20 "Total {total}" align=right
+)";
+
+std::string compile_error(const std::string& source) {
+  libharu_examples::LayoutTemplate layout;
+  std::string error;
+  EXPECT_FALSE(libharu_examples::LayoutTemplate::compile(source, layout, &error));
+  EXPECT_FALSE(layout.valid());
+  return error;
+}
+
+}  // namespace
+
+TEST(LayoutTemplateTest, BindsFieldsAndRowsIntoThePdf) {
+  libharu_examples::LayoutTemplate layout;
+  std::string error;
+  ASSERT_TRUE(libharu_examples::LayoutTemplate::compile(kTemplate, layout, &error)) << error;
+  ASSERT_NE(layout.field("customer"), libharu_examples::LayoutTemplate::npos);
+  EXPECT_EQ(layout.field("label"), libharu_examples::LayoutTemplate::npos);
+  ASSERT_EQ(layout.column_count(layout.table("rows")), 2U);
+
+  libharu_examples::LayoutRecord record(layout);
+  EXPECT_TRUE(record.set("customer", "Client Co"));
+  record.set(layout.field("total"), "42.00");
+  EXPECT_TRUE(record.add_row("rows", {"Widgets", "40.00"}));
+  EXPECT_TRUE(record.add_row(layout.table("rows"), {"Shipping", "2.00"}));
+  EXPECT_FALSE(record.add_row("rows", {"too", "many", "cells"}));
+  EXPECT_FALSE(record.set("unknown", "x"));
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::render_layout_pdf(record, buffer));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_EQ(count_occurrences(pdf, "Statement for Client Co"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "Widgets"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "Total 42.00"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Page\n"), 1U);
+
+  // A reused record renders only the new rows.
+  record.clear();
+  record.set("customer", "Other");
+  record.add_row("rows", {"Gadgets", "1.00"});
+  ASSERT_TRUE(libharu_examples::render_layout_pdf(record, buffer));
+  const std::string second(buffer.begin(), buffer.end());
+  EXPECT_EQ(count_occurrences(second, "Widgets"), 0U);
+  EXPECT_EQ(count_occurrences(second, "Gadgets"), 1U);
+}
+
+TEST(LayoutTemplateTest, TablesContinueOnNewPagesAndKeepTheReserve) {
+  libharu_examples::LayoutTemplate layout;
+  ASSERT_TRUE(libharu_examples::LayoutTemplate::compile(kTemplate, layout));
+  libharu_examples::LayoutRecord record(layout);
+  record.set("customer", "Client Co");
+  record.set("total", "0.00");
+  // Letter: rows from 672 down to 60 fit 31 per page.
+  for (int i = 0; i < 100; ++i) {
+    record.add_row("rows", {"Row " + std::to_string(i), "0.00"});
+  }
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::render_layout_pdf(record, buffer));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Page\n"), 4U);
+  EXPECT_EQ(count_occurrences(pdf, "(Row 99)"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "Total 0.00"), 1U);
+}
+
+TEST(LayoutTemplateTest, ReportsTheFirstErrorWithItsLine) {
+  EXPECT_EQ(compile_error("font a Helvetica\ntext b 10 1 1 \"x\""), "line 2: unknown font 'b'");
+  EXPECT_EQ(compile_error("font a Helvetica-Narrow"),
+            "line 1: 'Helvetica-Narrow' is not a base-14 font");
+  EXPECT_NE(compile_error("font a Helvetica\ntext a 10 700 10 \"x\"").find("outside the page"),
+            std::string::npos);
+  EXPECT_NE(compile_error("font a Helvetica\ntext a 10 10 ^-5 \"x\"").find("table above"),
+            std::string::npos);
+  EXPECT_NE(compile_error("font a Times-Roman\ntext a 10 10 10 \"x\" align=right").find("Helv"),
+            std::string::npos);
+  EXPECT_NE(compile_error("table t columns=a top=h-10 row=10\n").find("missing 'end'"),
+            std::string::npos);
+  EXPECT_NE(compile_error("font a Helvetica\ntext a 10 10 10 \"{open\"").find("unterminated"),
+            std::string::npos);
+  EXPECT_EQ(compile_error(""), "line 1: template draws nothing");
+  // Numbers use '.' whatever the locale.
+  EXPECT_EQ(compile_error("font a Helvetica\ntext a 10 1,5 10 \"x\""),
+            "line 2: expected a number, got '1,5'");
+
+  // Rows may not reach past the table's reserve.
+  EXPECT_NE(compile_error("font a Helvetica\n"
+                          "table t columns=a top=h-10 row=10 bottom=40 reserve=20\n"
+                          "text a 10 10 0 \"{a}\"\nend\ntext a 10 10 ^-30 \"x\"")
+                .find("reserve"),
+            std::string::npos);
+
+  libharu_examples::LayoutTemplate invalid;
+  libharu_examples::LayoutRecord record(invalid);
+  libharu_examples::PdfBuffer buffer;
+  EXPECT_FALSE(libharu_examples::render_layout_pdf(record, buffer));
+}
@@ -0,0 +1,100 @@
+#include "libharu_examples/money.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "libharu_examples/invoice_example.h"
+
+using libharu_examples::format_money;
+using libharu_examples::Money;
+using libharu_examples::MoneyFormat;
+
+TEST(MoneyTest, FormatsWithSeparatorsSymbolAndSign) {
+  EXPECT_EQ(format_money(Money::from_cents(0)).view(), "0.00");
+  EXPECT_EQ(format_money(Money::from_cents(7)).view(), "0.07");
+  EXPECT_EQ(format_money(Money::from_cents(99999)).view(), "999.99");
+  EXPECT_EQ(format_money(Money::from_cents(100000)).view(), "1,000.00");
+  EXPECT_EQ(format_money(Money::from_cents(-123456789), {"$"}).view(), "-$1,234,567.89");
+  EXPECT_EQ(format_money(Money::from_cents(123456789), {"\xA3", '.', ','}).view(),
+            "\xA3" "1.234.567,89");
+  EXPECT_EQ(format_money(Money::from_cents(123456789), {"", '\0'}).view(), "1234567.89");
+
+  const auto text = format_money(Money::from_cents(std::numeric_limits<std::int64_t>::min()),
+                                 {"USD "});
+  EXPECT_EQ(text.view(), "-USD 92,233,720,368,547,758.08");
+  EXPECT_EQ(std::string(text.c_str()), std::string(text.view()));
+}
+
+TEST(MoneyTest, ConvertsDoublesFromTheirDecimalForm) {
+  Money money;
+  ASSERT_TRUE(Money::from_double(1.005, money));
+  EXPECT_EQ(money.cents(), 101);
+  ASSERT_TRUE(Money::from_double(0.285, money));
+  EXPECT_EQ(money.cents(), 29);
+  ASSERT_TRUE(Money::from_double(-2.5, money));
+  EXPECT_EQ(money.cents(), -250);
+  ASSERT_TRUE(Money::from_double(19.994, money));
+  EXPECT_EQ(money.cents(), 1999);
+  ASSERT_TRUE(Money::from_double(0.0004, money));
+  EXPECT_EQ(money.cents(), 0);
+
+  money = Money::from_cents(42);
+  EXPECT_FALSE(Money::from_double(std::nan(""), money));
+  EXPECT_FALSE(Money::from_double(1e16, money));
+  EXPECT_EQ(money.cents(), 42);
+}
+
+TEST(MoneyTest, ArithmeticIsExactAndChecked) {
+  // A tenth of a dollar a million times: double accumulation drifts, cents do not.
+  Money total;
+  double drifting = 0.0;
+  const Money dime = Money::from_cents(10);
+  for (int i = 0; i < 1000000; ++i) {
+    ASSERT_TRUE(total.add(dime, total));
+    drifting += 0.1;
+  }
+  EXPECT_EQ(total.cents(), 10000000);
+  EXPECT_NE(drifting, 100000.0);
+
+  Money tax;
+  ASSERT_TRUE(Money::from_cents(1010).percentage(500, tax));
+  EXPECT_EQ(tax.cents(), 51);  // 50.5 cents rounds half away from zero.
+  ASSERT_TRUE(Money::from_cents(-1010).percentage(500, tax));
+  EXPECT_EQ(tax.cents(), -51);
+  ASSERT_TRUE(Money::from_cents(123456789012345).percentage(825, tax));
+  EXPECT_EQ(tax.cents(), 10185185093518);
+
+  Money product;
+  ASSERT_TRUE(Money::from_cents(1999).multiply(3, product));
+  EXPECT_EQ(product.cents(), 5997);
+  const Money max = Money::from_cents(std::numeric_limits<std::int64_t>::max());
+  EXPECT_FALSE(max.multiply(2, product));
+  EXPECT_FALSE(max.add(Money::from_cents(1), product));
+  EXPECT_EQ(product.cents(), 5997);
+}
+
+TEST(MoneyTest, InvoiceTotalsUseExactCents) {
+  const libharu_examples::InvoiceExample example;
+  const libharu_examples::InvoiceExample::Provider provider{"Provider", "Street", "p@x.test"};
+  const libharu_examples::InvoiceExample::Client client{"Client", "Avenue", "c@x.test"};
+
+  // 3 x 0.10 + 1 x 1000.20 = 1000.50; 5% tax = 50.025 -> 50.03; total $1,050.53.
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(
+      example.createInvoidcw(provider, client, {{"Dimes", 3, 0.1}, {"Unit", 1, 1000.2}}, buffer));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_NE(pdf.find("(1,000.50)"), std::string::npos);
+  EXPECT_NE(pdf.find("(50.03)"), std::string::npos);
+  EXPECT_NE(pdf.find("($1,050.53)"), std::string::npos);
+
+  EXPECT_FALSE(example.createInvoidcw(provider, client, {{"Huge", 2, 1e15}}, buffer));
+  // Each line fits in int64 cents (9e18); their sum does not.
+  const std::vector<libharu_examples::InvoiceExample::Item> overflow{{"Big", 10000, 9e12},
+                                                                     {"Big", 10000, 9e12}};
+  EXPECT_FALSE(example.createInvoidcw(provider, client, overflow, buffer));
+}
@@ -0,0 +1,111 @@
+#include "libharu_examples/pdf_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/pdf_text_example.h"
+
+TEST(PdfAllocatorTest, EveryPolicyProducesTheSameDocument) {
+  libharu_examples::PdfBuffer expected;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(expected, "allocator"));
+
+  for (const auto policy : {libharu_examples::PdfAllocatorPolicy::System,
+                            libharu_examples::PdfAllocatorPolicy::Arena,
+                            libharu_examples::PdfAllocatorPolicy::Pool}) {
+    const auto allocator = libharu_examples::make_pdf_allocator(policy);
+    ASSERT_NE(allocator, nullptr);
+
+    libharu_examples::PdfBuffer buffer;
+    {
+      libharu_examples::ScopedPdfAllocator scope(*allocator);
+      ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "allocator"));
+    }
+    EXPECT_EQ(buffer, expected);
+
+    const libharu_examples::PdfAllocatorStats& stats = allocator->stats();
+    EXPECT_GT(stats.allocations, 0U);
+    EXPECT_EQ(stats.allocations, stats.deallocations);
+    EXPECT_EQ(stats.bytes_in_use, 0U);
+    EXPECT_GT(stats.peak_bytes_in_use, 0U);
+  }
+
+  EXPECT_EQ(libharu_examples::make_pdf_allocator(libharu_examples::PdfAllocatorPolicy::Default),
+            nullptr);
+}
+
+TEST(PdfAllocatorTest, ArenaRewindsAndReusesChunksBetweenDocuments) {
+  libharu_examples::ArenaPdfAllocator arena;
+  libharu_examples::ScopedPdfAllocator scope(arena);
+  libharu_examples::PdfBuffer buffer;
+
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "first"));
+  const std::size_t chunks_after_first = arena.stats().system_allocations;
+  EXPECT_GE(chunks_after_first, 1U);
+  EXPECT_EQ(arena.stats().resets, 1U);
+
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "again"));
+  }
+  EXPECT_EQ(arena.stats().system_allocations, chunks_after_first);
+  EXPECT_EQ(arena.stats().resets, 51U);
+}
+
+TEST(PdfAllocatorTest, PoolRecyclesBlocksWithinASizeClass) {
+  libharu_examples::PoolPdfAllocator pool;
+
+  void* first = pool.allocate(40);
+  ASSERT_NE(first, nullptr);
+  pool.deallocate(first, 40);
+  EXPECT_EQ(pool.allocate(60), first);
+
+  void* large = pool.allocate(100000);
+  ASSERT_NE(large, nullptr);
+  pool.deallocate(large, 100000);
+  pool.deallocate(first, 60);
+
+  EXPECT_EQ(pool.stats().allocations, 3U);
+  EXPECT_EQ(pool.stats().bytes_in_use, 0U);
+  EXPECT_EQ(pool.stats().system_allocations, 2U);
+}
+
+TEST(PdfAllocatorTest, BatchWorkersUseTheirOwnAllocators) {
+  libharu_examples::InvoiceExample example;
+  std::vector<libharu_examples::InvoiceExample::BatchJob> jobs;
+  for (int i = 0; i < 64; ++i) {
+    jobs.push_back({{"Provider", "", ""},
+                    {"Client " + std::to_string(i), "", ""},
+                    {{"Item", 1, 10.0}},
+                    "allocator_batch_" + std::to_string(i) + ".pdf"});
+  }
+
+  libharu_examples::PdfAllocatorStats stats;
+  libharu_examples::InvoiceExample::BatchOptions options;
+  options.worker_count = 4;
+  options.allocator = libharu_examples::PdfAllocatorPolicy::Arena;
+  options.allocator_stats = &stats;
+
+  const auto results = example.createInvoiceBatch(jobs, options);
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    EXPECT_EQ(results[i], libharu_examples::InvoiceExample::JobStatus::Ok) << "job " << i;
+    std::remove(jobs[i].output_pdf_path.c_str());
+  }
+  EXPECT_GT(stats.allocations, 0U);
+  EXPECT_EQ(stats.allocations, stats.deallocations);
+  // One rewind per job plus one for the document each worker releases when it finishes.
+  EXPECT_EQ(stats.resets, jobs.size() + options.worker_count);
+
+  // Merging keeps the largest worker peak instead of adding the peaks up.
+  libharu_examples::PdfAllocatorStats merged;
+  libharu_examples::PdfAllocatorStats other;
+  merged.allocations = 2;
+  merged.peak_bytes_in_use = 300;
+  other.allocations = 3;
+  other.peak_bytes_in_use = 100;
+  merged += other;
+  EXPECT_EQ(merged.allocations, 5U);
+  EXPECT_EQ(merged.peak_bytes_in_use, 300U);
+}
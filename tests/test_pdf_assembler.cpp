@@ -0,0 +1,194 @@
+#include "libharu_examples/pdf_assembler.h"
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/pdf_text_example.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "test_support.h"
+
+namespace {
+
+using test_support::as_text;
+using test_support::count_occurrences;
+using test_support::write_temp_file;
+
+// Every in-use xref entry must point at the start of its own object.
+bool xref_is_consistent(const std::string& pdf) {
+  const std::size_t startxref = pdf.rfind("startxref\n");
+  if (startxref == std::string::npos) {
+    return false;
+  }
+  const std::size_t xref = std::strtoul(pdf.c_str() + startxref + 10, nullptr, 10);
+  if (pdf.compare(xref, 7, "xref\n0 ") != 0) {
+    return false;
+  }
+  char* cursor = nullptr;
+  const std::size_t size = std::strtoul(pdf.c_str() + xref + 7, &cursor, 10);
+  const char* entry = cursor + 1 + 20;  // skip the free entry
+  for (std::size_t i = 1; i < size; ++i, entry += 20) {
+    const std::size_t offset = std::strtoul(entry, nullptr, 10);
+    if (pdf.compare(offset, std::to_string(i).size() + 6, std::to_string(i) + " 0 obj") != 0) {
+      return false;
+    }
+  }
+  return pdf.find("/Size " + std::to_string(size) + "\n") != std::string::npos;
+}
+
+libharu_examples::PdfSink append_to(libharu_examples::PdfBuffer& buffer) {
+  return [&buffer](const unsigned char* data, std::size_t size) {
+    buffer.insert(buffer.end(), data, data + size);
+    return true;
+  };
+}
+
+}  // namespace
+
+TEST(PdfAssemblerTest, JoinsPagesAndStoresSharedObjectsOnce) {
+  std::vector<libharu_examples::PdfBuffer> parts(3);
+  ASSERT_TRUE(libharu_examples::create_text_pdf(parts[0], "first part"));
+  ASSERT_TRUE(libharu_examples::create_text_pdf(parts[1], "second (part)"));
+  ASSERT_TRUE(libharu_examples::create_text_pdf(parts[2], "third part"));
+
+  libharu_examples::PdfBuffer output;
+  std::string error;
+  ASSERT_TRUE(libharu_examples::assemble_pdf(parts, output, &error)) << error;
+  const std::string pdf = as_text(output);
+  EXPECT_EQ(pdf.compare(0, 5, "%PDF-"), 0);
+  EXPECT_TRUE(xref_is_consistent(pdf));
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Page\n"), 3U);
+  EXPECT_EQ(count_occurrences(pdf, "/Count 3\n"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Font"), 1U);
+  EXPECT_LT(pdf.find("(first part)"), pdf.find("(second \\(part\\))"));
+  EXPECT_LT(pdf.find("(second \\(part\\))"), pdf.find("(third part)"));
+
+  // The sink overload writes the same bytes.
+  libharu_examples::PdfBuffer streamed;
+  ASSERT_TRUE(libharu_examples::assemble_pdf(parts, append_to(streamed)));
+  EXPECT_EQ(streamed, output);
+}
+
+TEST(PdfAssemblerTest, ParallelTextRenderingMatchesSerialOutput) {
+  std::string contents;
+  for (int i = 0; i < 2000; ++i) {
+    const std::string wide = (i % 97 == 0) ? " " + std::string(400, 'x') : "";
+    contents += "row " + std::to_string(i) + wide + "\n";
+  }
+  contents += "tail without newline";
+  const std::string input = write_temp_file("assembler_text_input.txt", contents);
+
+  libharu_examples::TextPdfOptions options;
+  libharu_examples::TextPdfStats serial_stats;
+  libharu_examples::PdfBuffer serial;
+  ASSERT_TRUE(libharu_examples::create_text_file_pdf(
+      input, append_to(serial), options, &serial_stats));
+
+  options.render_threads = 4;
+  libharu_examples::TextPdfStats parallel_stats;
+  libharu_examples::PdfBuffer parallel;
+  ASSERT_TRUE(libharu_examples::create_text_file_pdf(
+      input, append_to(parallel), options, &parallel_stats));
+
+  EXPECT_EQ(parallel_stats.input_bytes, serial_stats.input_bytes);
+  EXPECT_EQ(parallel_stats.source_lines, serial_stats.source_lines);
+  EXPECT_EQ(parallel_stats.output_lines, serial_stats.output_lines);
+  EXPECT_EQ(parallel_stats.pages, serial_stats.pages);
+  EXPECT_EQ(parallel_stats.files, 1U);
+
+  const std::string pdf = as_text(parallel);
+  EXPECT_TRUE(xref_is_consistent(pdf));
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Page\n"), serial_stats.pages);
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Font"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "' "), count_occurrences(as_text(serial), "' "));
+  // Rows keep their order across the part boundaries.
+  std::size_t previous = 0;
+  for (int i = 0; i < 2000; i += 50) {
+    const std::size_t position = pdf.find("(row " + std::to_string(i));
+    ASSERT_NE(position, std::string::npos) << i;
+    EXPECT_GT(position, previous) << i;
+    previous = position;
+  }
+  EXPECT_GT(pdf.find("(tail without newline)"), previous);
+  std::remove(input.c_str());
+}
+
+TEST(PdfAssemblerTest, ParallelStatementSharesFontsStreamsAndOutline) {
+  const libharu_examples::InvoiceExample::Provider provider{"Provider", "1 Road", "p@example"};
+  std::vector<libharu_examples::InvoiceExample::StatementEntry> entries;
+  for (int i = 0; i < 40; ++i) {
+    entries.push_back({provider,
+                       {"Client " + std::to_string(i), "2 Street", "c@example"},
+                       std::vector<libharu_examples::InvoiceExample::Item>(
+                           (i == 7) ? 60 : 2, {"Consulting", i + 1, 10.0}),
+                       ""});
+  }
+
+  const libharu_examples::InvoiceExample invoice;
+  libharu_examples::PdfBuffer serial;
+  ASSERT_TRUE(invoice.createStatement(entries, serial, 1));
+  libharu_examples::PdfBuffer parallel;
+  ASSERT_TRUE(invoice.createStatement(entries, parallel, 4));
+
+  const std::string pdf = as_text(parallel);
+  EXPECT_TRUE(xref_is_consistent(pdf));
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Page\n"),
+            count_occurrences(as_text(serial), "/Type /Page\n"));
+  EXPECT_EQ(count_occurrences(pdf, "/Type /Font"), 3U);
+  EXPECT_EQ(count_occurrences(pdf, "(BILL TO)"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "(Thank you)"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "(TOTAL)"), 40U);
+  EXPECT_EQ(count_occurrences(pdf, "/Title ("), 40U);
+  EXPECT_EQ(count_occurrences(pdf, "/Next "), 39U);
+  EXPECT_LT(pdf.find("/Title (Client 9)"), pdf.find("/Title (Client 10)"));
+
+  entries[20].items.front().quantity = 0;
+  EXPECT_FALSE(invoice.createStatement(entries, parallel, 4));
+  EXPECT_TRUE(parallel.empty());
+}
+
+TEST(PdfAssemblerTest, RejectsInputsItCannotJoin) {
+  libharu_examples::PdfBuffer valid;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(valid, "valid"));
+  libharu_examples::PdfBuffer output;
+  std::string error;
+
+  EXPECT_FALSE(libharu_examples::assemble_pdf({}, output, &error));
+  EXPECT_EQ(error, "no parts");
+
+  const std::string garbage = "not a pdf at all";
+  EXPECT_FALSE(libharu_examples::assemble_pdf(
+      {valid, libharu_examples::PdfBuffer(garbage.begin(), garbage.end())}, output, &error));
+  EXPECT_EQ(error, "part 1: not a PDF");
+  EXPECT_TRUE(output.empty());
+
+  const libharu_examples::PdfBuffer truncated(valid.begin(), valid.begin() + valid.size() / 2);
+  EXPECT_FALSE(libharu_examples::assemble_pdf({truncated}, output, &error));
+  EXPECT_EQ(error, "part 0: no startxref");
+
+  std::string encrypted = as_text(valid);
+  encrypted.replace(encrypted.find("/Root 1 0 R"), 11, "/Root 1 0 R\n/Encrypt 9 0 R");
+  EXPECT_FALSE(libharu_examples::assemble_pdf(
+      {libharu_examples::PdfBuffer(encrypted.begin(), encrypted.end())}, output, &error));
+  EXPECT_EQ(error, "part 0: encrypted documents cannot be assembled");
+
+  // Cut inside the xref table. A `startxref` comment before the table keeps it reachable;
+  // the offset is zero-padded so the comment's length does not depend on it.
+  const std::string text = as_text(valid);
+  const std::size_t xref = text.rfind("\nxref\n") + 1;
+  std::string head = text.substr(0, xref);
+  char comment[32];
+  std::snprintf(comment, sizeof(comment), "%%startxref %010zu\n", head.size() + 22);
+  head += comment;
+  const std::size_t table_size = text.find("trailer", xref) - xref;
+  for (const std::size_t cut : {std::size_t{6}, std::size_t{7}, std::size_t{20}, table_size - 5}) {
+    const std::string part = head + text.substr(xref, cut);
+    EXPECT_FALSE(libharu_examples::assemble_pdf(
+        {libharu_examples::PdfBuffer(part.begin(), part.end())}, output, &error));
+    EXPECT_EQ(error, "part 0: truncated xref table") << "cut " << cut;
+  }
+}
@@ -1,6 +1,16 @@
 #include "libharu_examples/pdf_text_example.h"
+#include "libharu_examples/render_metrics.h"
 
 #include <gtest/gtest.h>
+#include <hpdf.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "test_support.h"
 
 TEST(PdfTextExampleTest, DefaultTextIsNotEmpty) {
   EXPECT_FALSE(libharu_examples::default_example_text().empty());
@@ -10,3 +20,177 @@ TEST(PdfTextExampleTest, ReturnsFalseForInvalidArguments) {
   EXPECT_FALSE(libharu_examples::create_text_pdf("", "example"));
   EXPECT_FALSE(libharu_examples::create_text_pdf("out.pdf", ""));
 }
+
+TEST(PdfTextExampleTest, RendersIntoReusableBufferAndSink) {
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "in-memory text"));
+  ASSERT_GT(buffer.size(), 4U);
+  EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + 4), "%PDF");
+
+  const auto capacity = buffer.capacity();
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "in-memory text"));
+  EXPECT_EQ(buffer.capacity(), capacity);
+
+  libharu_examples::PdfBuffer streamed;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(
+      [&streamed](const unsigned char* data, std::size_t size) {
+        streamed.insert(streamed.end(), data, data + size);
+        return true;
+      },
+      "in-memory text"));
+  EXPECT_EQ(streamed, buffer);
+
+  EXPECT_FALSE(libharu_examples::create_text_pdf(buffer, ""));
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_FALSE(libharu_examples::create_text_pdf(
+      [](const unsigned char*, std::size_t) { return false; }, "aborted by sink"));
+}
+
+TEST(PdfTextExampleTest, ScopedRenderMetricsCollectsPhasesAndBytes) {
+  libharu_examples::RenderMetrics metrics;
+  libharu_examples::PdfBuffer buffer;
+  {
+    libharu_examples::ScopedRenderMetrics scope(metrics);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "measured"));
+    ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "measured"));
+  }
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "not measured"));
+
+  EXPECT_EQ(metrics.documents, 2U);
+  EXPECT_EQ(metrics.failed_documents, 0U);
+  EXPECT_GT(metrics.output_bytes, 0U);
+  EXPECT_GT(metrics.serialize_time.count() + metrics.write_time.count(), 0);
+  EXPECT_EQ(metrics.draw_operations, 10U);  // font, BT, Td, Tj, ET per document
+  EXPECT_GT(metrics.allocations, 0U);
+  EXPECT_EQ(metrics.errors, 0U);
+}
+
+TEST(PdfTextExampleTest, RenderMetricsTraceDocumentsAndCaptureLibharuErrors) {
+  std::vector<libharu_examples::DocumentTrace> traces;
+  libharu_examples::RenderMetrics metrics;
+  metrics.trace = [&traces](const libharu_examples::DocumentTrace& document) {
+    traces.push_back(document);
+  };
+  libharu_examples::PdfBuffer buffer;
+  {
+    libharu_examples::ScopedRenderMetrics scope(metrics);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "traced"));
+    EXPECT_FALSE(libharu_examples::create_text_pdf("missing_dir/nested/out.pdf", "unwritable"));
+    EXPECT_FALSE(libharu_examples::create_text_pdf(
+        [](const unsigned char*, std::size_t) { return false; }, "aborted by sink"));
+  }
+
+  EXPECT_EQ(metrics.documents, 1U);
+  EXPECT_EQ(metrics.failed_documents, 2U);
+  ASSERT_EQ(traces.size(), 3U);
+  EXPECT_TRUE(traces[0].saved);
+  EXPECT_EQ(traces[0].output_bytes, buffer.size());
+  EXPECT_EQ(traces[0].draw_operations, 5U);
+  EXPECT_GT(traces[0].allocations, 0U);
+  EXPECT_GT(traces[0].time(libharu_examples::RenderPhase::Serialize).count(), 0);
+
+  // The file error is the libHaru error code, tagged with the phase it happened in.
+  EXPECT_FALSE(traces[1].saved);
+  EXPECT_EQ(traces[1].errors, 1U);
+  EXPECT_EQ(traces[1].first_error.code, static_cast<unsigned long>(HPDF_FILE_IO_ERROR));
+  EXPECT_EQ(traces[1].first_error.phase, libharu_examples::RenderPhase::Serialize);
+  EXPECT_EQ(metrics.errors, 1U);
+  EXPECT_EQ(metrics.last_error.code, static_cast<unsigned long>(HPDF_FILE_IO_ERROR));
+
+  // A sink refusing the bytes is not a libHaru error, but the document still failed.
+  EXPECT_FALSE(traces[2].saved);
+  EXPECT_EQ(traces[2].errors, 0U);
+}
+
+namespace {
+
+using test_support::temp_path;
+using test_support::write_temp_file;
+
+}  // namespace
+
+TEST(PdfTextExampleTest, StreamsTextFileWithWrappingAndPagination) {
+  std::string contents;
+  for (int i = 0; i < 300; ++i) {
+    contents += "log line " + std::to_string(i) + " ok\r\n";
+  }
+  contents += std::string(500, 'w') + "\n\nlast line without newline";
+  const std::string input = write_temp_file("text_stream_input.txt", contents);
+
+  libharu_examples::TextPdfOptions options;
+  options.read_chunk_size = 97;  // force lines to straddle chunk boundaries
+  libharu_examples::TextPdfStats stats;
+  libharu_examples::PdfBuffer streamed;
+  ASSERT_TRUE(libharu_examples::create_text_file_pdf(
+      input,
+      [&streamed](const unsigned char* data, std::size_t size) {
+        streamed.insert(streamed.end(), data, data + size);
+        return true;
+      },
+      options,
+      &stats));
+
+  EXPECT_EQ(stats.input_bytes, contents.size());
+  EXPECT_EQ(stats.source_lines, 303U);
+  EXPECT_GT(stats.output_lines, stats.source_lines);  // the 500-character line wraps
+  EXPECT_GE(stats.pages, 5U);
+  EXPECT_EQ(stats.files, 1U);
+
+  const std::string pdf(streamed.begin(), streamed.end());
+  EXPECT_EQ(pdf.compare(0, 4, "%PDF"), 0);
+  // CRLF endings are stripped rather than rendered as a trailing blank.
+  EXPECT_NE(pdf.find("(log line 299 ok)"), std::string::npos);
+  std::remove(input.c_str());
+}
+
+TEST(PdfTextExampleTest, SplitsLargeInputsIntoVolumes) {
+  std::string contents;
+  for (int i = 0; i < 1000; ++i) {
+    contents += "entry " + std::to_string(i) + "\n";
+  }
+  const std::string input = write_temp_file("text_volume_input.txt", contents);
+
+  libharu_examples::TextPdfOptions options;
+  options.max_pages_per_file = 3;
+  libharu_examples::TextPdfStats stats;
+  ASSERT_TRUE(libharu_examples::create_text_file_pdf(
+      input, temp_path("text_volume.pdf"), options, &stats));
+
+  EXPECT_EQ(stats.output_lines, 1000U);
+  EXPECT_EQ(stats.files, (stats.pages + 2) / 3);
+  ASSERT_GT(stats.files, 1U);
+  for (std::size_t volume = 1; volume <= stats.files; ++volume) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "text_volume_%04zu.pdf", volume);
+    const std::string path = temp_path(name);
+    std::ifstream output(path);
+    EXPECT_TRUE(output.good()) << path;
+    output.close();
+    std::remove(path.c_str());
+  }
+  std::remove(input.c_str());
+}
+
+TEST(PdfTextExampleTest, WrapsUnterminatedLinesAndRejectsEmptyInput) {
+  const std::string input = write_temp_file("text_unterminated.txt", std::string(200000, 'a'));
+  libharu_examples::TextPdfStats stats;
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::create_text_file_pdf(
+      input,
+      [&buffer](const unsigned char* data, std::size_t size) {
+        buffer.insert(buffer.end(), data, data + size);
+        return true;
+      },
+      {},
+      &stats));
+  EXPECT_EQ(stats.source_lines, 1U);
+  EXPECT_GT(stats.output_lines, 100U);
+  std::remove(input.c_str());
+
+  const std::string empty = write_temp_file("text_empty.txt", "");
+  EXPECT_FALSE(libharu_examples::create_text_file_pdf(empty, temp_path("text_empty.pdf")));
+  EXPECT_FALSE(libharu_examples::create_text_file_pdf(temp_path("does_not_exist.txt"),
+                                                      temp_path("text_missing.pdf")));
+  EXPECT_FALSE(libharu_examples::create_text_file_pdf(input, libharu_examples::PdfSink{}));
+  std::remove(empty.c_str());
+}
@@ -0,0 +1,290 @@
+#include "libharu_examples/render_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "libharu_examples/clinical_report_example.h"
+#include "libharu_examples/document_info.h"
+#include "libharu_examples/file_writer.h"
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/pdf_text_example.h"
+#include "libharu_examples/render_context.h"
+#include "libharu_examples/render_metrics.h"
+#include "test_support.h"
+
+namespace {
+
+using libharu_examples::InvoiceExample;
+using libharu_examples::PdfBuffer;
+using test_support::as_text;
+
+const InvoiceExample::Provider kProvider{"Provider", "Street 1", "p@x.test"};
+const InvoiceExample::Client kClient{"Client", "Avenue 2", "c@x.test"};
+
+std::vector<InvoiceExample::Item> sample_items() {
+  return {{"Consulting", 2, 150.0}, {"Support", 1, 80.0}};
+}
+
+
+// The invoice number drawn on the first page ("INV-" and eight hex digits).
+std::string invoice_number(const PdfBuffer& pdf) {
+  const std::string text = as_text(pdf);
+  const std::size_t at = text.find("(INV-");
+  return at == std::string::npos ? std::string() : text.substr(at + 1, 12);
+}
+
+PdfBuffer fake_document(const std::size_t size, const char fill) {
+  PdfBuffer document(size, static_cast<unsigned char>(fill));
+  const std::string header = "%PDF-";
+  std::copy(header.begin(), header.end(), document.begin());
+  return document;
+}
+
+}  // namespace
+
+TEST(RenderCacheTest, HitReturnsTheStoredBytesWithoutRendering) {
+  const InvoiceExample invoice;
+  PdfBuffer expected;
+  ASSERT_TRUE(invoice.createInvoidcw(kProvider, kClient, sample_items(), expected));
+
+  libharu_examples::RenderCache cache;
+  libharu_examples::ScopedRenderCache scope(cache);
+  libharu_examples::RenderMetrics metrics;
+  {
+    libharu_examples::ScopedRenderMetrics metrics_scope(metrics);
+    PdfBuffer first;
+    ASSERT_TRUE(invoice.createInvoidcw(kProvider, kClient, sample_items(), first));
+    EXPECT_EQ(first, expected);
+
+    PdfBuffer second;
+    ASSERT_TRUE(invoice.createInvoidcw(kProvider, kClient, sample_items(), second));
+    EXPECT_EQ(second, expected);
+
+    PdfBuffer streamed;
+    ASSERT_TRUE(invoice.createInvoidcw(
+        kProvider, kClient, sample_items(), [&streamed](const unsigned char* data, std::size_t n) {
+          streamed.insert(streamed.end(), data, data + n);
+          return true;
+        }));
+    EXPECT_EQ(streamed, expected);
+
+    const std::string path = testing::TempDir() + "libharu_examples_cached_invoice.pdf";
+    ASSERT_TRUE(invoice.createInvoidcw(kProvider, kClient, sample_items(), path));
+    std::ifstream file(path, std::ios::binary);
+    EXPECT_EQ(PdfBuffer(std::istreambuf_iterator<char>(file), {}), expected);
+  }
+  EXPECT_EQ(metrics.documents, 1U);
+
+  const libharu_examples::RenderCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.misses, 1U);
+  EXPECT_EQ(stats.memory_hits, 3U);
+  EXPECT_EQ(stats.stores, 1U);
+  EXPECT_EQ(stats.entries, 1U);
+  EXPECT_EQ(stats.memory_bytes, expected.size());
+
+  // Invalid input is still rejected, and nothing is stored for it.
+  PdfBuffer rejected;
+  EXPECT_FALSE(invoice.createInvoidcw(kProvider, kClient, {}, rejected));
+  EXPECT_EQ(cache.stats().stores, 1U);
+}
+
+TEST(RenderCacheTest, KeysCoverInputsFormatAndMetadata) {
+  libharu_examples::RenderCache cache;
+  libharu_examples::ScopedRenderCache scope(cache);
+  PdfBuffer buffer;
+
+  const InvoiceExample a4;
+  const InvoiceExample letter(libharu_examples::PageFormat::LetterPortrait);
+  ASSERT_TRUE(a4.createInvoidcw(kProvider, kClient, sample_items(), buffer));
+  ASSERT_TRUE(letter.createInvoidcw(kProvider, kClient, sample_items(), buffer));
+  std::vector<InvoiceExample::Item> items = sample_items();
+  items[1].quantity = 2;
+  ASSERT_TRUE(a4.createInvoidcw(kProvider, kClient, items, buffer));
+  // Prices are keyed by the cents that get printed.
+  items[1].unit_price = 80.001;
+  ASSERT_TRUE(a4.createInvoidcw(kProvider, kClient, items, buffer));
+  {
+    const libharu_examples::DocumentInfo info;
+    libharu_examples::ScopedDocumentInfo info_scope(info);
+    ASSERT_TRUE(a4.createInvoidcw(kProvider, kClient, sample_items(), buffer));
+  }
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "cached text"));
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "other text"));
+
+  const libharu_examples::ClinicalReportExample report;
+  const std::vector<unsigned char> pixels(4 * 4, 0x80);
+  std::vector<libharu_examples::ClinicalReportExample::ImageFrame> frames(1);
+  frames[0].data = pixels.data();
+  frames[0].size = pixels.size();
+  frames[0].width = 4;
+  frames[0].height = 4;
+  ASSERT_TRUE(report.create_clinical_report_pdf(
+      {"Patient", 30, "Female", "1"}, {"Doctor", "Radiology"}, frames, buffer));
+  std::vector<unsigned char> other_pixels = pixels;
+  other_pixels[5] = 0;
+  frames[0].data = other_pixels.data();
+  ASSERT_TRUE(report.create_clinical_report_pdf(
+      {"Patient", 30, "Female", "1"}, {"Doctor", "Radiology"}, frames, buffer));
+
+  const libharu_examples::RenderCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.memory_hits, 1U);
+  EXPECT_EQ(stats.misses, 8U);
+  EXPECT_EQ(stats.entries, 8U);
+}
+
+TEST(RenderCacheTest, EncryptedReportsBypassTheCache) {
+  libharu_examples::ClinicalReportExample::Encryption encryption;
+  encryption.passwords = libharu_examples::ClinicalReportExample::Encryption::Passwords::Shared;
+  encryption.owner_password = "owner";
+  const libharu_examples::ClinicalReportExample report(
+      libharu_examples::PageFormat::A4Portrait, {}, {}, encryption);
+
+  libharu_examples::RenderCache cache;
+  libharu_examples::ScopedRenderCache scope(cache);
+  PdfBuffer buffer;
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(report.create_clinical_report_pdf(
+        {"Patient", 30, "Female", "1"}, {"Doctor", "Radiology"}, buffer));
+  }
+  const libharu_examples::RenderCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.misses, 0U);
+  EXPECT_EQ(stats.stores, 0U);
+}
+
+TEST(RenderCacheTest, EvictsLeastRecentlyUsedDocumentsByBytes) {
+  libharu_examples::RenderCacheOptions options;
+  options.memory_bytes = 250;
+  libharu_examples::RenderCache cache(options);
+
+  cache.store("a", fake_document(100, 'a'));
+  cache.store("b", fake_document(100, 'b'));
+  PdfBuffer out;
+  ASSERT_TRUE(cache.lookup("a", out));
+  cache.store("c", fake_document(100, 'c'));
+
+  EXPECT_FALSE(cache.lookup("b", out));
+  ASSERT_TRUE(cache.lookup("a", out));
+  EXPECT_EQ(out, fake_document(100, 'a'));
+  EXPECT_TRUE(cache.lookup("c", out));
+
+  // Larger than the whole budget: not kept in memory at all.
+  cache.store("d", fake_document(300, 'd'));
+  EXPECT_FALSE(cache.lookup("d", out));
+
+  const libharu_examples::RenderCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.evictions, 1U);
+  EXPECT_EQ(stats.entries, 2U);
+  EXPECT_EQ(stats.memory_bytes, 200U);
+
+  cache.clear();
+  EXPECT_EQ(cache.stats().entries, 0U);
+  EXPECT_FALSE(cache.lookup("a", out));
+}
+
+TEST(RenderCacheTest, DiskTierOutlivesTheCache) {
+  const std::string directory = testing::TempDir() + "libharu_examples_render_cache";
+  std::filesystem::remove_all(directory);
+  libharu_examples::RenderCacheOptions options;
+  options.directory = directory;
+
+  // Stores go through the thread's file writer; no temporary file is left behind.
+  PdfBuffer rendered;
+  libharu_examples::FileWriter writer;
+  {
+    libharu_examples::RenderCache cache(options);
+    libharu_examples::ScopedRenderCache scope(cache);
+    libharu_examples::ScopedFileWriter writer_scope(writer);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(rendered, "kept on disk"));
+  }
+  ASSERT_EQ(std::distance(std::filesystem::directory_iterator(directory), {}), 1);
+  EXPECT_EQ(writer.stats().files, 1U);
+
+  libharu_examples::RenderCache cache(options);
+  libharu_examples::ScopedRenderCache scope(cache);
+  libharu_examples::RenderMetrics metrics;
+  {
+    libharu_examples::ScopedRenderMetrics metrics_scope(metrics);
+    for (int i = 0; i < 2; ++i) {
+      PdfBuffer buffer;
+      ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "kept on disk"));
+      EXPECT_EQ(buffer, rendered);
+    }
+  }
+  EXPECT_EQ(metrics.documents, 0U);
+  const libharu_examples::RenderCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.disk_hits, 1U);
+  EXPECT_EQ(stats.memory_hits, 1U);
+  EXPECT_EQ(stats.misses, 0U);
+
+  // Keys that are not plain file names never reach the disk.
+  cache.store("../escape", fake_document(10, 'x'));
+  EXPECT_FALSE(std::filesystem::exists(testing::TempDir() + "escape.pdf"));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(RenderCacheTest, DocumentInfoPinsTheMetadata) {
+  libharu_examples::DocumentInfo info;
+  info.creation_date = libharu_examples::DocumentDate{2026, 10, 17, 9, 30, 0};
+
+  PdfBuffer plain;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(plain, "metadata"));
+  EXPECT_EQ(as_text(plain).find("/CreationDate"), std::string::npos);
+
+  PdfBuffer fresh;
+  PdfBuffer reused;
+  {
+    libharu_examples::ScopedDocumentInfo scope(info);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(fresh, "metadata"));
+
+    libharu_examples::RenderContext context;
+    libharu_examples::ScopedRenderContext context_scope(context);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(reused, "warm-up"));
+    ASSERT_TRUE(libharu_examples::create_text_pdf(reused, "metadata"));
+    EXPECT_EQ(context.reused_documents(), 1U);
+  }
+  EXPECT_EQ(fresh, reused);
+  EXPECT_NE(as_text(fresh).find("/Producer (libHaru_examples)"), std::string::npos);
+  EXPECT_NE(as_text(fresh).find("/CreationDate (D:2026"), std::string::npos);
+}
+
+TEST(RenderCacheTest, InvoiceNumberIsDerivedFromTheContent) {
+  const InvoiceExample invoice;
+  PdfBuffer first;
+  PdfBuffer again;
+  ASSERT_TRUE(invoice.createInvoidcw(kProvider, kClient, sample_items(), first));
+  ASSERT_TRUE(invoice.createInvoidcw(kProvider, kClient, sample_items(), again));
+  const std::string number = invoice_number(first);
+  ASSERT_EQ(number.size(), 12U);
+  EXPECT_EQ(number.find_first_not_of("0123456789ABCDEF", 4), std::string::npos);
+  EXPECT_EQ(invoice_number(again), number);
+
+  // Same item count, different content: a different number.
+  std::vector<InvoiceExample::Item> items = sample_items();
+  items[0].description = "Design";
+  PdfBuffer other;
+  ASSERT_TRUE(invoice.createInvoidcw(kProvider, kClient, items, other));
+  EXPECT_NE(invoice_number(other), number);
+
+  // Streaming the same items yields the same number.
+  const std::vector<InvoiceExample::Item> source = sample_items();
+  std::size_t next = 0;
+  PdfBuffer paginated;
+  ASSERT_TRUE(invoice.createPaginatedInvoice(
+      kProvider,
+      kClient,
+      [&](InvoiceExample::Item& item) {
+        if (next == source.size()) {
+          return false;
+        }
+        item = source[next++];
+        return true;
+      },
+      paginated));
+  EXPECT_EQ(invoice_number(paginated), number);
+}
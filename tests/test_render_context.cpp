@@ -0,0 +1,77 @@
+#include "libharu_examples/render_context.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/pdf_allocator.h"
+#include "libharu_examples/pdf_text_example.h"
+
+namespace {
+
+std::vector<libharu_examples::InvoiceExample::Item> sample_items() {
+  return {{"Consulting", 2, 150.0}, {"Support", 1, 80.0}};
+}
+
+}  // namespace
+
+TEST(RenderContextTest, ReusedDocumentProducesTheSameOutput) {
+  const libharu_examples::InvoiceExample invoice;
+  const libharu_examples::InvoiceExample::Provider provider{"Provider", "Street 1", "p@x.test"};
+  const libharu_examples::InvoiceExample::Client client{"Client", "Avenue 2", "c@x.test"};
+
+  libharu_examples::PdfBuffer expected_invoice;
+  libharu_examples::PdfBuffer expected_text;
+  ASSERT_TRUE(invoice.createInvoidcw(provider, client, sample_items(), expected_invoice));
+  ASSERT_TRUE(libharu_examples::create_text_pdf(expected_text, "context"));
+
+  libharu_examples::RenderContext context;
+  libharu_examples::ScopedRenderContext scope(context);
+  for (int i = 0; i < 3; ++i) {
+    libharu_examples::PdfBuffer buffer;
+    ASSERT_TRUE(invoice.createInvoidcw(provider, client, sample_items(), buffer));
+    EXPECT_EQ(buffer, expected_invoice);
+    ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "context"));
+    EXPECT_EQ(buffer, expected_text);
+  }
+  EXPECT_EQ(context.reused_documents(), 5U);
+}
+
+TEST(RenderContextTest, NestedRenderFallsBackToAFreshDocument) {
+  libharu_examples::RenderContext context;
+  libharu_examples::ScopedRenderContext scope(context);
+
+  libharu_examples::PdfBuffer inner;
+  bool inner_rendered = false;
+  const bool rendered = libharu_examples::create_text_pdf(
+      [&](const unsigned char*, std::size_t) {
+        if (!inner_rendered) {
+          inner_rendered = libharu_examples::create_text_pdf(inner, "inner");
+        }
+        return true;
+      },
+      "outer");
+  EXPECT_TRUE(rendered);
+  EXPECT_TRUE(inner_rendered);
+  EXPECT_FALSE(inner.empty());
+  EXPECT_EQ(context.reused_documents(), 0U);
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "after"));
+  EXPECT_EQ(context.reused_documents(), 1U);
+}
+
+TEST(RenderContextTest, AllocatorScopeTakesPrecedenceOverContext) {
+  libharu_examples::RenderContext context;
+  libharu_examples::ScopedRenderContext context_scope(context);
+  libharu_examples::ArenaPdfAllocator arena;
+  libharu_examples::ScopedPdfAllocator allocator_scope(arena);
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "first"));
+  ASSERT_TRUE(libharu_examples::create_text_pdf(buffer, "second"));
+  EXPECT_EQ(arena.stats().resets, 2U);
+  EXPECT_EQ(context.reused_documents(), 0U);
+}
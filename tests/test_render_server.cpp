@@ -0,0 +1,255 @@
+#include "libharu_examples/render_server.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libharu_examples/pdf_text_example.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::string socket_path(const std::string& name) {
+  return testing::TempDir() + "libharu_examples_" + name + ".sock";
+}
+
+libharu_examples::RenderRequest invoice_request() {
+  libharu_examples::RenderRequest request;
+  request.kind = libharu_examples::RenderKind::Invoice;
+  request.provider = {"Provider", "Street 1", "p@x.test"};
+  request.client = {"Client", "Avenue 2", "c@x.test"};
+  request.items = {{"Consulting", 2, 150.0}, {"Support", 1, 80.5}};
+  return request;
+}
+
+libharu_examples::RenderRequest clinical_request() {
+  libharu_examples::RenderRequest request;
+  request.kind = libharu_examples::RenderKind::Clinical;
+  request.patient = {"Patient", 21, "Female", "123"};
+  request.doctor = {"Doctor", "Radiology"};
+  return request;
+}
+
+}  // namespace
+
+TEST(RenderServerTest, RendersEveryKindOverOneConnection) {
+  libharu_examples::RenderServerOptions options;
+  options.socket_path = socket_path("kinds");
+  options.workers = 2;
+  libharu_examples::RenderServer server(options);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+
+  libharu_examples::RenderClient client;
+  ASSERT_TRUE(client.connect(options.socket_path, &error)) << error;
+
+  libharu_examples::RenderRequest text;
+  text.text = "served text";
+  libharu_examples::PdfBuffer expected;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(expected, "served text"));
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(client.render(text, buffer, &error)) << error;
+  EXPECT_EQ(buffer, expected);
+
+  const libharu_examples::RenderRequest invoice = invoice_request();
+  ASSERT_TRUE(libharu_examples::InvoiceExample().createInvoidcw(
+      invoice.provider, invoice.client, invoice.items, expected));
+  ASSERT_TRUE(client.render(invoice, buffer, &error)) << error;
+  EXPECT_EQ(buffer, expected);
+
+  // A frame travels with the request and is embedded from the server's copy.
+  libharu_examples::RenderRequest clinical = clinical_request();
+  const std::vector<unsigned char> pixels(16 * 16, 0x40);
+  clinical.frames.push_back({libharu_examples::ClinicalReportExample::ImageFrame::Format::Gray8,
+                             pixels.data(), pixels.size(), 16, 16});
+  ASSERT_TRUE(libharu_examples::ClinicalReportExample().create_clinical_report_pdf(
+      clinical.patient, clinical.doctor, clinical.frames, expected));
+  ASSERT_TRUE(client.render(clinical, buffer, &error)) << error;
+  EXPECT_EQ(buffer, expected);
+
+  const libharu_examples::RenderServerStats stats = server.stats();
+  EXPECT_EQ(stats.connections, 1U);
+  EXPECT_EQ(stats.requests, 3U);
+  EXPECT_EQ(stats.failed_requests, 0U);
+  EXPECT_GT(stats.output_bytes, 0U);
+
+  server.stop();
+  EXPECT_FALSE(std::filesystem::exists(options.socket_path));
+  EXPECT_FALSE(client.render(text, buffer, &error));
+}
+
+TEST(RenderServerTest, ReportsFailuresAndKeepsTheConnection) {
+  const std::string output_dir = testing::TempDir() + "libharu_examples_server_out";
+  std::filesystem::create_directories(output_dir);
+  libharu_examples::RenderServerOptions options;
+  options.socket_path = socket_path("failures");
+  options.workers = 1;
+  options.output_directory = output_dir;
+  options.max_request_bytes = 1 << 16;
+  libharu_examples::RenderServer server(options);
+  ASSERT_TRUE(server.start());
+
+  libharu_examples::RenderClient client;
+  ASSERT_TRUE(client.connect(options.socket_path));
+  libharu_examples::PdfBuffer buffer;
+  std::string error;
+
+  libharu_examples::RenderRequest invoice = invoice_request();
+  invoice.items[0].quantity = 0;
+  EXPECT_FALSE(client.render(invoice, buffer, &error));
+  EXPECT_EQ(client.last_status(), libharu_examples::RenderStatus::RenderFailed);
+  EXPECT_EQ(error, "render failed");
+
+  libharu_examples::RenderRequest clinical = clinical_request();
+  clinical.page_format = libharu_examples::PageFormat::A4Landscape;
+  EXPECT_FALSE(client.render(clinical, buffer, &error));
+  EXPECT_EQ(client.last_status(), libharu_examples::RenderStatus::RenderFailed);
+
+  std::string written;
+  EXPECT_FALSE(client.render_to_file(invoice_request(), "../escape.pdf", written, &error));
+  EXPECT_EQ(client.last_status(), libharu_examples::RenderStatus::BadRequest);
+  EXPECT_EQ(error, "output name must be a plain file name");
+
+  // The same connection still serves, and file output lands in the output directory.
+  ASSERT_TRUE(client.render_to_file(invoice_request(), "invoice.pdf", written, &error)) << error;
+  EXPECT_EQ(written, output_dir + "/invoice.pdf");
+  EXPECT_GT(std::filesystem::file_size(written), 0U);
+  ASSERT_TRUE(client.render(clinical_request(), buffer, &error)) << error;
+  EXPECT_EQ(client.last_status(), libharu_examples::RenderStatus::Ok);
+
+  // An oversized request is refused and ends the connection.
+  libharu_examples::RenderRequest text;
+  text.text.assign(1 << 17, 'x');
+  EXPECT_FALSE(client.render(text, buffer, &error));
+  EXPECT_EQ(client.last_status(), libharu_examples::RenderStatus::BadRequest);
+  EXPECT_FALSE(client.render(clinical_request(), buffer, &error));
+  EXPECT_FALSE(client.connected());
+
+  const libharu_examples::RenderServerStats stats = server.stats();
+  EXPECT_EQ(stats.failed_requests, 2U);
+  EXPECT_EQ(stats.bad_requests, 2U);
+  std::filesystem::remove_all(output_dir);
+}
+
+TEST(RenderServerTest, ManyClientsShareASmallQueue) {
+  libharu_examples::RenderServerOptions options;
+  options.socket_path = socket_path("clients");
+  options.workers = 2;
+  options.queue_depth = 1;
+  options.max_connections = 4;
+  libharu_examples::RenderServer server(options);
+  ASSERT_TRUE(server.start());
+
+  constexpr int kClients = 12;
+  constexpr int kRequests = 25;
+  std::atomic<int> rendered{0};
+  std::vector<std::thread> clients;
+  for (int i = 0; i < kClients; ++i) {
+    clients.emplace_back([&options, &rendered, i] {
+      libharu_examples::RenderClient client;
+      if (!client.connect(options.socket_path)) {
+        return;
+      }
+      libharu_examples::RenderRequest request = invoice_request();
+      request.client.name = "Client " + std::to_string(i);
+      libharu_examples::PdfBuffer buffer;
+      for (int r = 0; r < kRequests; ++r) {
+        if (client.render(request, buffer) && buffer.size() > 4) {
+          rendered.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (std::thread& client : clients) {
+    client.join();
+  }
+  EXPECT_EQ(rendered.load(), kClients * kRequests);
+  EXPECT_EQ(server.stats().requests, static_cast<std::size_t>(kClients * kRequests));
+  EXPECT_EQ(server.stats().connections, static_cast<std::size_t>(kClients));
+}
+
+TEST(RenderServerTest, BoundsTheWholeRequestNotEachRead) {
+  libharu_examples::RenderServerOptions options;
+  options.socket_path = socket_path("trickle");
+  options.workers = 1;
+  options.warm_up = false;
+  options.io_timeout_ms = 200;
+  libharu_examples::RenderServer server(options);
+  ASSERT_TRUE(server.start());
+
+  // A raw client announces a 1000-byte request and sends it one byte every 50 ms: every
+  // read completes well within the timeout, the request as a whole never does.
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_GE(fd, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", options.socket_path.c_str());
+  ASSERT_EQ(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+  const unsigned char header[4] = {0, 0, 0x03, 0xE8};
+  ASSERT_EQ(::send(fd, header, sizeof(header), MSG_NOSIGNAL), 4);
+
+  const auto start = std::chrono::steady_clock::now();
+  bool closed = false;
+  for (int i = 0; i < 60 && !closed; ++i) {
+    const unsigned char byte = 'x';
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    unsigned char reply = 0;
+    closed = ::send(fd, &byte, 1, MSG_NOSIGNAL) != 1 ||
+             ::recv(fd, &reply, 1, MSG_DONTWAIT) == 0;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  ::close(fd);
+  EXPECT_TRUE(closed);
+  EXPECT_LT(elapsed, std::chrono::milliseconds(1500));
+
+  // The only worker is free again.
+  libharu_examples::RenderClient client;
+  ASSERT_TRUE(client.connect(options.socket_path));
+  libharu_examples::PdfBuffer buffer;
+  std::string error;
+  EXPECT_TRUE(client.render(invoice_request(), buffer, &error)) << error;
+}
+
+TEST(RenderServerTest, ReplacesAStaleSocketButNotALiveOne) {
+  libharu_examples::RenderServerOptions options;
+  options.socket_path = socket_path("stale");
+  options.warm_up = false;
+  {
+    libharu_examples::RenderServer first(options);
+    ASSERT_TRUE(first.start());
+    libharu_examples::RenderServer second(options);
+    std::string error;
+    EXPECT_FALSE(second.start(&error));
+    EXPECT_EQ(error, options.socket_path + ": another server is listening");
+    EXPECT_FALSE(first.start(&error));
+    EXPECT_EQ(error, "server is already running");
+  }
+
+  // A socket file left behind by a crashed server is replaced.
+  {
+    libharu_examples::RenderServer crashed(options);
+    ASSERT_TRUE(crashed.start());
+    std::filesystem::rename(options.socket_path, options.socket_path + ".keep");
+  }
+  std::filesystem::rename(options.socket_path + ".keep", options.socket_path);
+  libharu_examples::RenderServer restarted(options);
+  std::string error;
+  ASSERT_TRUE(restarted.start(&error)) << error;
+  libharu_examples::RenderClient client;
+  ASSERT_TRUE(client.connect(options.socket_path));
+
+  libharu_examples::RenderServerOptions bad;
+  bad.socket_path = std::string(200, 'x');
+  EXPECT_FALSE(libharu_examples::RenderServer(bad).start(&error));
+  EXPECT_NE(error.find("longer than"), std::string::npos);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "libharu_examples/pdf_output.h"
+
+// Helpers shared by the test files. Everything a test writes goes under
+// `::testing::TempDir()`, never into the working directory.
+namespace test_support {
+
+inline std::string as_text(const libharu_examples::PdfBuffer& pdf) {
+  return std::string(pdf.begin(), pdf.end());
+}
+
+// Non-overlapping occurrences of `needle`.
+inline std::size_t count_occurrences(const std::string& haystack, const std::string& needle) {
+  std::size_t count = 0;
+  for (std::size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+inline std::size_t count_occurrences(const libharu_examples::PdfBuffer& pdf,
+                                     const std::string& needle) {
+  return count_occurrences(as_text(pdf), needle);
+}
+
+// Page objects (`/Type /Page`, not the `/Type /Pages` tree nodes).
+inline std::size_t count_pages(const std::string& pdf) {
+  return count_occurrences(pdf, "/Type /Page") - count_occurrences(pdf, "/Type /Pages");
+}
+
+inline std::size_t count_pages(const libharu_examples::PdfBuffer& pdf) {
+  return count_pages(as_text(pdf));
+}
+
+inline std::string temp_path(const std::string& name) {
+  return ::testing::TempDir() + name;
+}
+
+// Writes `contents` to `name` in the temporary directory and returns its path.
+inline std::string write_temp_file(const std::string& name, const std::string& contents) {
+  const std::string path = temp_path(name);
+  std::ofstream output(path, std::ios::binary);
+  output << contents;
+  return path;
+}
+
+inline std::string read_file(const std::filesystem::path& path) {
+  std::ifstream input(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+// An empty directory `name` in the temporary directory.
+inline std::filesystem::path fresh_directory(const std::string& name) {
+  const std::filesystem::path directory = temp_path(name);
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  return directory;
+}
+
+}  // namespace test_support
@@ -0,0 +1,89 @@
+#include "libharu_examples/text_metrics.h"
+
+#include <gtest/gtest.h>
+#include <hpdf.h>
+
+#include <string>
+
+#include "libharu_examples/invoice_example.h"
+
+namespace {
+
+using libharu_examples::FontMetrics;
+using libharu_examples::StandardFont;
+
+}  // namespace
+
+TEST(TextMetricsTest, MatchesLibharuWidthsForAscii) {
+  HPDF_Doc pdf = HPDF_New(nullptr, nullptr);
+  ASSERT_NE(pdf, nullptr);
+
+  std::string ascii;
+  for (char c = ' '; c <= '~'; ++c) {
+    ascii.push_back(c);
+  }
+  for (const auto& [name, font] : {std::make_pair("Helvetica", StandardFont::Helvetica),
+                                   std::make_pair("Helvetica-Bold", StandardFont::HelveticaBold),
+                                   std::make_pair("Helvetica-Oblique",
+                                                  StandardFont::HelveticaOblique)}) {
+    HPDF_Font hpdf_font = HPDF_GetFont(pdf, name, nullptr);
+    ASSERT_NE(hpdf_font, nullptr);
+    for (const std::string& text : {ascii, std::string("INVOICE #"), std::string("1,234.56")}) {
+      const HPDF_TextWidth expected = HPDF_Font_TextWidth(
+          hpdf_font, reinterpret_cast<const HPDF_BYTE*>(text.data()),
+          static_cast<HPDF_UINT>(text.size()));
+      EXPECT_EQ(FontMetrics::get(font).width_units(text), expected.width) << name << ": " << text;
+    }
+  }
+  HPDF_Free(pdf);
+}
+
+TEST(TextMetricsTest, FitAndBreakPositionRespectTheWidth) {
+  const FontMetrics& metrics = FontMetrics::get(StandardFont::Helvetica);
+  const std::string text = "alpha beta gamma delta";
+
+  EXPECT_FLOAT_EQ(metrics.width("W", 10.0F), 9.44F);
+  EXPECT_EQ(metrics.fit(text, 10.0F, 1000.0F), text.size());
+  EXPECT_EQ(metrics.fit(text, 10.0F, 0.0F), 0U);
+
+  const float width = metrics.width("alpha beta ga", 10.0F);
+  const std::size_t fitted = metrics.fit(text, 10.0F, width);
+  EXPECT_EQ(fitted, 13U);
+  EXPECT_EQ(metrics.break_position(text, 10.0F, width), 11U);  // after "alpha beta "
+
+  // A first word wider than the line is broken mid-word.
+  EXPECT_EQ(metrics.break_position("abcdefghij", 10.0F, metrics.width("abcd", 10.0F)), 4U);
+}
+
+TEST(TextMetricsTest, TruncatesWithEllipsisWithinWidth) {
+  const FontMetrics& metrics = FontMetrics::get(StandardFont::HelveticaBold);
+  std::string out;
+
+  metrics.fit_with_ellipsis("short", 11.0F, 200.0F, out);
+  EXPECT_EQ(out, "short");
+
+  const std::string long_text(200, 'm');
+  metrics.fit_with_ellipsis(long_text, 11.0F, 120.0F, out);
+  ASSERT_GT(out.size(), 3U);
+  EXPECT_EQ(out.substr(out.size() - 3), "...");
+  EXPECT_LE(metrics.width(out, 11.0F), 120.0F);
+}
+
+TEST(TextMetricsTest, InvoiceDescriptionsWrapByWidthNotBytes) {
+  libharu_examples::InvoiceExample example;
+  // 60 narrow characters fit the column on one line; 60 wide ones are broken across lines.
+  const std::string narrow(60, 'i');
+  const std::string wide(60, 'W');
+  std::vector<libharu_examples::InvoiceExample::Item> items{{narrow, 1, 1.0}, {wide, 1, 1.0}};
+
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(example.createInvoidcw({"Provider", "", ""}, {"Client", "", ""}, items, buffer));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_NE(pdf.find("(" + narrow + ")"), std::string::npos);
+  EXPECT_EQ(pdf.find(wide), std::string::npos);
+  EXPECT_EQ(pdf.find("W...)"), std::string::npos);
+  const std::string line_start = "(" + std::string(20, 'W');
+  const std::size_t first_line = pdf.find(line_start);
+  ASSERT_NE(first_line, std::string::npos);
+  EXPECT_NE(pdf.find(line_start, first_line + 1), std::string::npos);
+}
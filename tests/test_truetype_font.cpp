@@ -0,0 +1,360 @@
+#include "libharu_examples/truetype_font.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libharu_examples/invoice_example.h"
+#include "libharu_examples/layout_template.h"
+#include "libharu_examples/pdf_text_example.h"
+#include "libharu_examples/render_context.h"
+#include "libharu_examples/render_server.h"
+#include "test_support.h"
+
+namespace {
+
+using test_support::count_occurrences;
+
+using Bytes = std::vector<unsigned char>;
+
+// Glyphs of the test font: .notdef, printable ASCII, U+00E9, U+2022 and U+1F600.
+constexpr std::uint16_t kAsciiGlyphs = 0x7F - 0x20;
+constexpr std::uint16_t kEAcuteGlyph = 1 + kAsciiGlyphs;
+constexpr std::uint16_t kBulletGlyph = kEAcuteGlyph + 1;
+constexpr std::uint16_t kEmojiGlyph = kBulletGlyph + 1;
+constexpr std::uint16_t kGlyphCount = kEmojiGlyph + 1;
+
+void put16(Bytes& out, const std::uint32_t value) {
+  out.push_back(static_cast<unsigned char>(value >> 8));
+  out.push_back(static_cast<unsigned char>(value));
+}
+
+void put32(Bytes& out, const std::uint32_t value) {
+  put16(out, value >> 16);
+  put16(out, value);
+}
+
+Bytes cmap_format4() {
+  struct Segment {
+    std::uint16_t first, last, glyph;
+  };
+  const Segment segments[] = {{0x20, 0x7E, 1},
+                              {0xE9, 0xE9, kEAcuteGlyph},
+                              {0x2022, 0x2022, kBulletGlyph},
+                              {0xFFFF, 0xFFFF, 0}};
+  const std::uint16_t count = 4;
+  Bytes out;
+  put16(out, 4);
+  put16(out, 16 + 8 * count);
+  put16(out, 0);
+  put16(out, 2 * count);
+  put16(out, 0);
+  put16(out, 0);
+  put16(out, 0);
+  for (const Segment& segment : segments) {
+    put16(out, segment.last);
+  }
+  put16(out, 0);
+  for (const Segment& segment : segments) {
+    put16(out, segment.first);
+  }
+  for (const Segment& segment : segments) {
+    put16(out, segment.first == 0xFFFF ? 1 : (segment.glyph - segment.first) & 0xFFFF);
+  }
+  for (std::uint16_t i = 0; i < count; ++i) {
+    put16(out, 0);
+  }
+  return out;
+}
+
+Bytes cmap_format12() {
+  const std::uint32_t groups[][3] = {
+      {0x20, 0x7E, 1}, {0xE9, 0xE9, kEAcuteGlyph}, {0x2022, 0x2022, kBulletGlyph},
+      {0x1F600, 0x1F600, kEmojiGlyph}};
+  Bytes out;
+  put16(out, 12);
+  put16(out, 0);
+  put32(out, 16 + 12 * 4);
+  put32(out, 0);
+  put32(out, 4);
+  for (const auto& group : groups) {
+    put32(out, group[0]);
+    put32(out, group[1]);
+    put32(out, group[2]);
+  }
+  return out;
+}
+
+// A minimal TrueType file: just the tables measurement reads. 2000 units per em, so
+// advances of 1200 (ASCII, U+00E9), 700 (U+2022), 2000 (U+1F600) and 1000 (.notdef) are
+// 600, 350, 1000 and 500 in 1/1000 em.
+Bytes make_font(const bool with_format12, const bool with_cmap = true) {
+  Bytes head(54, 0);
+  head[18] = 2000 >> 8;
+  head[19] = 2000 & 0xFF;
+  Bytes hhea(36, 0);
+  hhea[34] = kGlyphCount >> 8;
+  hhea[35] = kGlyphCount & 0xFF;
+  Bytes maxp;
+  put32(maxp, 0x00005000);
+  put16(maxp, kGlyphCount);
+  Bytes hmtx;
+  for (std::uint16_t glyph = 0; glyph < kGlyphCount; ++glyph) {
+    put16(hmtx, glyph == 0              ? 1000
+                : glyph == kBulletGlyph ? 700
+                : glyph == kEmojiGlyph  ? 2000
+                                        : 1200);
+    put16(hmtx, 0);
+  }
+  Bytes cmap;
+  const Bytes subtable = with_format12 ? cmap_format12() : cmap_format4();
+  put16(cmap, 0);
+  put16(cmap, 1);
+  put16(cmap, 3);
+  put16(cmap, with_format12 ? 10 : 1);
+  put32(cmap, 12);
+  cmap.insert(cmap.end(), subtable.begin(), subtable.end());
+
+  std::vector<std::pair<const char*, const Bytes*>> tables = {
+      {"head", &head}, {"hhea", &hhea}, {"hmtx", &hmtx}, {"maxp", &maxp}};
+  if (with_cmap) {
+    tables.insert(tables.begin(), {"cmap", &cmap});
+  }
+  Bytes out;
+  put32(out, 0x00010000);
+  put16(out, static_cast<std::uint32_t>(tables.size()));
+  put16(out, 0);
+  put16(out, 0);
+  put16(out, 0);
+  std::uint32_t offset = static_cast<std::uint32_t>(12 + 16 * tables.size());
+  for (const auto& [tag, table] : tables) {
+    out.insert(out.end(), tag, tag + 4);
+    put32(out, 0);
+    put32(out, offset);
+    put32(out, static_cast<std::uint32_t>(table->size()));
+    offset += static_cast<std::uint32_t>((table->size() + 3) & ~std::size_t{3});
+  }
+  for (const auto& entry : tables) {
+    out.insert(out.end(), entry.second->begin(), entry.second->end());
+    out.resize((out.size() + 3) & ~std::size_t{3}, 0);
+  }
+  return out;
+}
+
+std::string write_font(const std::string& name, const Bytes& bytes) {
+  const std::string path = testing::TempDir() + name;
+  std::ofstream(path, std::ios::binary)
+      .write(reinterpret_cast<const char*>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+  return path;
+}
+
+std::shared_ptr<const libharu_examples::TrueTypeFont> test_font() {
+  static const std::string path = write_font("libharu_examples_test.ttf", make_font(true));
+  return libharu_examples::TrueTypeFont::load(path);
+}
+
+std::string load_error(const std::string& path) {
+  std::string error;
+  EXPECT_EQ(libharu_examples::TrueTypeFont::load(path, &error), nullptr);
+  return error;
+}
+
+}  // namespace
+
+TEST(TrueTypeFontTest, LoadsEachFileOnceAndSharesIt) {
+  const auto font = test_font();
+  ASSERT_NE(font, nullptr);
+  EXPECT_EQ(font->glyph_count(), kGlyphCount);
+  EXPECT_EQ(libharu_examples::TrueTypeFont::load(font->path()), font);
+
+  // The cached instance outlives the file.
+  const std::string path = write_font("libharu_examples_removed.ttf", make_font(false));
+  const auto loaded = libharu_examples::TrueTypeFont::load(path);
+  ASSERT_NE(loaded, nullptr);
+  std::remove(path.c_str());
+  EXPECT_EQ(libharu_examples::TrueTypeFont::load(path), loaded);
+}
+
+TEST(TrueTypeFontTest, ReportsWhyAFontCannotBeLoaded) {
+  const std::string missing = testing::TempDir() + "libharu_examples_missing.ttf";
+  EXPECT_EQ(load_error(missing), missing + ": cannot open file");
+
+  Bytes cff = make_font(true);
+  cff[0] = 'O';
+  cff[1] = 'T';
+  cff[2] = 'T';
+  cff[3] = 'O';
+  const std::string cff_path = write_font("libharu_examples_cff.otf", cff);
+  EXPECT_EQ(load_error(cff_path), cff_path + ": CFF-based OpenType fonts are not supported");
+
+  const std::string no_cmap = write_font("libharu_examples_no_cmap.ttf", make_font(true, false));
+  EXPECT_EQ(load_error(no_cmap), no_cmap + ": no cmap table");
+
+  // Failures are not cached: a fixed file loads on the next call.
+  write_font("libharu_examples_no_cmap.ttf", make_font(true));
+  EXPECT_NE(libharu_examples::TrueTypeFont::load(no_cmap), nullptr);
+}
+
+TEST(TrueTypeFontTest, MeasuresUtf8Text) {
+  const auto font = test_font();
+  ASSERT_NE(font, nullptr);
+  EXPECT_TRUE(font->has_glyph(U'A'));
+  EXPECT_TRUE(font->has_glyph(U'•'));
+  EXPECT_TRUE(font->has_glyph(U'\U0001F600'));
+  EXPECT_FALSE(font->has_glyph(U'一'));
+  EXPECT_EQ(font->glyph_width(U'•'), 350U);
+  EXPECT_EQ(font->glyph_width(U'一'), 500U);
+
+  EXPECT_EQ(font->width_units("ab"), 1200U);
+  EXPECT_EQ(font->width_units("\xC3\xA9\xE2\x80\xA2"), 950U);
+  EXPECT_EQ(font->width_units("\xF0\x9F\x98\x80"), 1000U);
+  // A malformed byte measures as one `.notdef`.
+  EXPECT_EQ(font->width_units("\xFF"), 500U);
+  EXPECT_FLOAT_EQ(font->width("abcd", 10.0F), 24.0F);
+
+  // Format 4 only: the emoji falls back to `.notdef`.
+  const std::string bmp_path = write_font("libharu_examples_bmp.ttf", make_font(false));
+  const auto bmp = libharu_examples::TrueTypeFont::load(bmp_path);
+  ASSERT_NE(bmp, nullptr);
+  EXPECT_EQ(bmp->width_units("\xC3\xA9\xE2\x80\xA2"), 950U);
+  EXPECT_FALSE(bmp->has_glyph(U'\U0001F600'));
+}
+
+TEST(TrueTypeFontTest, FittingNeverSplitsAUtf8Sequence) {
+  const auto font = test_font();
+  ASSERT_NE(font, nullptr);
+  // 6 points per ASCII glyph or U+00E9 at size 10.
+  const std::string text = "ab\xC3\xA9\xC3\xA9 cd";
+  EXPECT_EQ(font->fit(text, 10.0F, 12.0F), 2U);
+  EXPECT_EQ(font->fit(text, 10.0F, 17.0F), 2U);
+  EXPECT_EQ(font->fit(text, 10.0F, 18.0F), 4U);
+  EXPECT_EQ(font->fit(text, 10.0F, 1000.0F), text.size());
+  EXPECT_EQ(font->break_position(text, 10.0F, 40.0F), 7U);
+  EXPECT_EQ(font->break_position(text, 10.0F, 20.0F), 4U);
+
+  std::string out;
+  font->fit_with_ellipsis(text, 10.0F, 1000.0F, out);
+  EXPECT_EQ(out, text);
+  font->fit_with_ellipsis(text, 10.0F, 36.0F, out);
+  EXPECT_EQ(out, "ab\xC3\xA9...");
+}
+
+TEST(TrueTypeFontTest, InvoiceEmbedsTheFontAndReusesItInARenderContext) {
+  const auto font = test_font();
+  ASSERT_NE(font, nullptr);
+  const libharu_examples::InvoiceExample invoice(libharu_examples::PageFormat::A4Portrait,
+                                                 {font, nullptr, nullptr});
+  const libharu_examples::InvoiceExample::Provider provider{"Provider", "Street 1", "p@x.test"};
+  const libharu_examples::InvoiceExample::Client client{"Cl\xC3\xA9ment", "Avenue 2", "c@x.test"};
+  const std::vector<libharu_examples::InvoiceExample::Item> items = {
+      {"Caf\xC3\xA9 \xE2\x80\xA2 consulting", 2, 150.0}};
+
+  libharu_examples::PdfBuffer expected;
+  ASSERT_TRUE(invoice.createInvoidcw(provider, client, items, expected));
+  const std::string pdf(expected.begin(), expected.end());
+  EXPECT_NE(pdf.find("/BaseFont /TTF"), std::string::npos);
+  EXPECT_NE(pdf.find("/Encoding /UTF-8"), std::string::npos);
+  EXPECT_EQ(pdf.find("/BaseFont /Helvetica"), std::string::npos);
+  EXPECT_NE(pdf.find("Caf\xC3\xA9 \xE2\x80\xA2 consulting"), std::string::npos);
+
+  libharu_examples::RenderContext context;
+  libharu_examples::ScopedRenderContext scope(context);
+  for (int i = 0; i < 3; ++i) {
+    libharu_examples::PdfBuffer buffer;
+    ASSERT_TRUE(invoice.createInvoidcw(provider, client, items, buffer));
+    EXPECT_EQ(buffer, expected);
+  }
+}
+
+TEST(TrueTypeFontTest, TextFileWrapsWithTheFontMetrics) {
+  const auto font = test_font();
+  ASSERT_NE(font, nullptr);
+  std::string text;
+  for (int i = 0; i < 40; ++i) {
+    text += "\xC3\xA9t\xC3\xA9 caf\xC3\xA9 " + std::to_string(i) + ' ';
+  }
+  const std::string input =
+      test_support::write_temp_file("libharu_examples_ttf_text.txt", text + '\n');
+
+  libharu_examples::TextPdfOptions options;
+  options.font = font;
+  libharu_examples::TextPdfStats stats;
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::create_text_file_pdf(
+      input,
+      [&buffer](const unsigned char* data, std::size_t size) {
+        buffer.insert(buffer.end(), data, data + size);
+        return true;
+      },
+      options, &stats));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_NE(pdf.find("/BaseFont /TTF"), std::string::npos);
+  EXPECT_EQ(pdf.find("/BaseFont /Helvetica"), std::string::npos);
+  // The test font is wider than Helvetica, so the line wraps more often.
+  libharu_examples::TextPdfStats helvetica;
+  ASSERT_TRUE(libharu_examples::create_text_file_pdf(
+      input, [](const unsigned char*, std::size_t) { return true; }, {}, &helvetica));
+  EXPECT_GT(stats.output_lines, helvetica.output_lines);
+  std::remove(input.c_str());
+}
+
+TEST(TrueTypeFontTest, RenderServerDrawsTextRequestsInTheRegularFont) {
+  const auto font = test_font();
+  ASSERT_NE(font, nullptr);
+  libharu_examples::TextPdfOptions text_options;
+  text_options.font = font;
+  libharu_examples::PdfBuffer expected;
+  ASSERT_TRUE(libharu_examples::create_text_pdf(expected, "caf\xC3\xA9", text_options));
+  const std::string pdf(expected.begin(), expected.end());
+  EXPECT_NE(pdf.find("/BaseFont /TTF"), std::string::npos);
+  EXPECT_EQ(pdf.find("/BaseFont /Helvetica"), std::string::npos);
+
+  libharu_examples::RenderServerOptions options;
+  options.socket_path = testing::TempDir() + "libharu_examples_ttf_text.sock";
+  options.workers = 1;
+  options.fonts = {font, nullptr, nullptr};
+  libharu_examples::RenderServer server(options);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+  libharu_examples::RenderClient client;
+  ASSERT_TRUE(client.connect(options.socket_path, &error)) << error;
+  libharu_examples::RenderRequest request;
+  request.text = "caf\xC3\xA9";
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(client.render(request, buffer, &error)) << error;
+  EXPECT_EQ(buffer, expected);
+  server.stop();
+}
+
+TEST(TrueTypeFontTest, LayoutTemplatesLoadFontsByPath) {
+  const auto font = test_font();
+  ASSERT_NE(font, nullptr);
+  libharu_examples::LayoutTemplate layout;
+  std::string error;
+  ASSERT_TRUE(libharu_examples::LayoutTemplate::compile(
+      "font body \"" + font->path() + "\"\n"
+          "text body 12 w-40 h-60 \"Total {total}\" align=right\n",
+      layout, &error))
+      << error;
+  libharu_examples::LayoutRecord record(layout);
+  record.set("total", "\xE2\x82\xAC" "42.00");
+  libharu_examples::PdfBuffer buffer;
+  ASSERT_TRUE(libharu_examples::render_layout_pdf(record, buffer));
+  const std::string pdf(buffer.begin(), buffer.end());
+  EXPECT_EQ(count_occurrences(pdf, "/BaseFont /TTF"), 1U);
+  EXPECT_EQ(count_occurrences(pdf, "Total \xE2\x82\xAC" "42.00"), 1U);
+
+  const std::string missing = testing::TempDir() + "libharu_examples_missing.ttf";
+  libharu_examples::LayoutTemplate invalid;
+  EXPECT_FALSE(libharu_examples::LayoutTemplate::compile(
+      "font body \"" + missing + "\"\ntext body 12 10 10 \"x\"", invalid, &error));
+  EXPECT_EQ(error, "line 1: " + missing + ": cannot open file");
+}